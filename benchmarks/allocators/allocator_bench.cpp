@@ -0,0 +1,231 @@
+#include <nostd/concurrent_pool_allocator.h>
+#include <nostd/default_allocator.h>
+#include <nostd/map.h>
+#include <nostd/monotonic_arena.h>
+#include <nostd/pool_allocator.h>
+#include <nostd/slab_allocator.h>
+#include <nostd/stats_allocator.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+	const int kNumBlocks = 1024;
+
+	/**
+	 * Owns allocator under test, default allocator is the baseline.
+	 */
+	class allocator_holder {
+	public:
+		enum kind_t {
+			kDefault,
+			kPool,
+			kConcurrentPool,
+			kSlab,
+			kArena,
+			kStats
+		};
+
+		explicit allocator_holder(int kind)
+		: kind_(kind)
+		, allocator_(nullptr)
+		{
+			switch (kind_)
+			{
+			case kPool:
+				allocator_ = new nostd::pool_allocator(kNumBlocks);
+				break;
+			case kConcurrentPool:
+				allocator_ = new nostd::concurrent_pool_allocator(kNumBlocks);
+				break;
+			case kSlab:
+				allocator_ = new nostd::slab_allocator();
+				break;
+			case kArena:
+				allocator_ = new nostd::monotonic_arena(1U << 20);
+				break;
+			case kStats:
+				allocator_ = new nostd::stats_allocator(nostd::default_allocator::get_instance());
+				break;
+			default:
+				allocator_ = nostd::default_allocator::get_instance();
+				break;
+			}
+		}
+		~allocator_holder()
+		{
+			if (kind_ != kDefault)
+				delete allocator_;
+		}
+		nostd::allocator * get() const
+		{
+			return allocator_;
+		}
+		/**
+		 * Makes freed memory available again, only arena needs it
+		 */
+		void reset()
+		{
+			if (kind_ == kArena)
+				static_cast<nostd::monotonic_arena*>(allocator_)->reset();
+		}
+
+	private:
+		int kind_;
+		nostd::allocator * allocator_;
+	};
+
+	const char * const kNames[] = {"default", "pool", "concurrent_pool", "slab", "arena", "stats"};
+
+} // namespace
+
+static void BM_AllocateFreeLifo(benchmark::State& state, int kind)
+{
+	allocator_holder holder(kind);
+	nostd::allocator * allocator = holder.get();
+	const nostd::allocator::size_type size = static_cast<nostd::allocator::size_type>(state.range(0));
+	std::vector<void*> blocks(kNumBlocks);
+	for (auto _ : state)
+	{
+		for (int i = 0; i < kNumBlocks; ++i)
+			blocks[i] = allocator->allocate(size);
+		for (int i = kNumBlocks; i != 0; --i)
+			allocator->free(blocks[i - 1], size);
+		holder.reset();
+	}
+	state.SetItemsProcessed(state.iterations() * kNumBlocks);
+}
+
+static void BM_AllocateFreeRandom(benchmark::State& state, int kind)
+{
+	// Blocks are freed in random order, so free lists get shuffled
+	allocator_holder holder(kind);
+	nostd::allocator * allocator = holder.get();
+	const nostd::allocator::size_type size = static_cast<nostd::allocator::size_type>(state.range(0));
+	std::vector<int> order(kNumBlocks);
+	for (int i = 0; i < kNumBlocks; ++i)
+		order[i] = i;
+	std::mt19937 engine(777U);
+	std::shuffle(order.begin(), order.end(), engine);
+	std::vector<void*> blocks(kNumBlocks);
+	for (auto _ : state)
+	{
+		for (int i = 0; i < kNumBlocks; ++i)
+			blocks[i] = allocator->allocate(size);
+		for (int i = 0; i < kNumBlocks; ++i)
+			allocator->free(blocks[order[i]], size);
+		holder.reset();
+	}
+	state.SetItemsProcessed(state.iterations() * kNumBlocks);
+}
+
+static void BM_NewDeleteLifo(benchmark::State& state)
+{
+	const size_t size = static_cast<size_t>(state.range(0));
+	std::vector<void*> blocks(kNumBlocks);
+	for (auto _ : state)
+	{
+		for (int i = 0; i < kNumBlocks; ++i)
+			blocks[i] = ::operator new(size);
+		for (int i = kNumBlocks; i != 0; --i)
+			::operator delete(blocks[i - 1]);
+	}
+	state.SetItemsProcessed(state.iterations() * kNumBlocks);
+}
+
+static void BM_MapWithAllocator(benchmark::State& state, int kind)
+{
+	allocator_holder holder(kind);
+	for (auto _ : state)
+	{
+		{
+			nostd::map<int, int> map(holder.get());
+			for (int i = 0; i < kNumBlocks; ++i)
+				map[(i * 7919) % kNumBlocks] = i;
+			benchmark::DoNotOptimize(map.size());
+		}
+		holder.reset();
+	}
+	state.SetItemsProcessed(state.iterations() * kNumBlocks);
+}
+
+static void BM_MapWithStaticPool(benchmark::State& state)
+{
+	// Pool type is a template parameter, so node allocation isn't a virtual call
+	for (auto _ : state)
+	{
+		nostd::pool_allocator pool(kNumBlocks);
+		nostd::map<int, int, nostd::less<int>, nostd::pool_allocator> map(&pool);
+		for (int i = 0; i < kNumBlocks; ++i)
+			map[(i * 7919) % kNumBlocks] = i;
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.iterations() * kNumBlocks);
+}
+
+static void BM_StdMap(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		std::map<int, int> map;
+		for (int i = 0; i < kNumBlocks; ++i)
+			map[(i * 7919) % kNumBlocks] = i;
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.iterations() * kNumBlocks);
+}
+
+static void BM_ConcurrentAllocateFree(benchmark::State& state, int kind)
+{
+	// The first thread creates shared allocator, others wait for it at the start of the loop
+	static allocator_holder * holder = nullptr;
+	if (state.thread_index() == 0)
+		holder = new allocator_holder(kind);
+	std::vector<void*> blocks(64);
+	for (auto _ : state)
+	{
+		nostd::allocator * allocator = holder->get();
+		for (size_t i = 0; i < blocks.size(); ++i)
+			blocks[i] = allocator->allocate(64U);
+		for (size_t i = 0; i < blocks.size(); ++i)
+			allocator->free(blocks[i], 64U);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<long long>(blocks.size()));
+	if (state.thread_index() == 0)
+	{
+		delete holder;
+		holder = nullptr;
+	}
+}
+
+static int register_benchmarks()
+{
+	for (int kind = allocator_holder::kDefault; kind <= allocator_holder::kStats; ++kind)
+	{
+		const std::string name = kNames[kind];
+		benchmark::RegisterBenchmark(("BM_AllocateFreeLifo/" + name).c_str(), BM_AllocateFreeLifo, kind)
+			->Arg(16)->Arg(64)->Arg(256);
+		benchmark::RegisterBenchmark(("BM_AllocateFreeRandom/" + name).c_str(), BM_AllocateFreeRandom, kind)
+			->Arg(16)->Arg(64)->Arg(256);
+		benchmark::RegisterBenchmark(("BM_MapWithAllocator/" + name).c_str(), BM_MapWithAllocator, kind);
+	}
+	// Only thread-safe allocators may be shared
+	const int shared[] = {allocator_holder::kDefault, allocator_holder::kConcurrentPool, allocator_holder::kStats};
+	for (int kind : shared)
+		benchmark::RegisterBenchmark((std::string("BM_ConcurrentAllocateFree/") + kNames[kind]).c_str(),
+			BM_ConcurrentAllocateFree, kind)->ThreadRange(1, 4)->UseRealTime();
+	return 0;
+}
+
+static const int g_registered = register_benchmarks();
+
+BENCHMARK(BM_NewDeleteLifo)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_MapWithStaticPool);
+BENCHMARK(BM_StdMap);
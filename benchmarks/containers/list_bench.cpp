@@ -0,0 +1,74 @@
+#include <nostd/list.h>
+#include <nostd/stack.h>
+
+#include <benchmark/benchmark.h>
+
+#include <list>
+#include <stack>
+
+template <typename List>
+static void BM_ListQueueChurn(benchmark::State& state)
+{
+	// Queue usage: elements come to the back and leave from the front
+	const int count = static_cast<int>(state.range(0));
+	List list;
+	for (int i = 0; i < count; ++i)
+		list.push_back(i);
+	for (auto _ : state)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			list.push_back(i);
+			list.pop_front();
+		}
+		benchmark::DoNotOptimize(list.front());
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename List>
+static void BM_ListFillClear(benchmark::State& state)
+{
+	const int count = static_cast<int>(state.range(0));
+	for (auto _ : state)
+	{
+		List list;
+		for (int i = 0; i < count; ++i)
+		{
+			if (i & 1)
+				list.push_back(i);
+			else
+				list.push_front(i);
+		}
+		benchmark::DoNotOptimize(list.front());
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename Stack>
+static void BM_StackChurn(benchmark::State& state)
+{
+	// Sawtooth: push a run of elements, then pop them back
+	const int count = static_cast<int>(state.range(0));
+	Stack stack;
+	for (auto _ : state)
+	{
+		for (int i = 0; i < count; ++i)
+			stack.push(i);
+		long long sum = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			sum += stack.top();
+			stack.pop();
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * count * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_ListQueueChurn, nostd::list<int>)->Range(8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_ListQueueChurn, std::list<int>)->Range(8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_ListFillClear, nostd::list<int>)->Range(8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_ListFillClear, std::list<int>)->Range(8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_StackChurn, nostd::stack<int>)->Range(8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_StackChurn, std::stack<int>)->Range(8, 1 << 14);
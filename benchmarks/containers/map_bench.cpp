@@ -0,0 +1,148 @@
+#include <nostd/btree_map.h>
+#include <nostd/flat_hash_map.h>
+#include <nostd/map.h>
+#include <nostd/set.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+	enum key_distribution {
+		kSequential,
+		kRandom,
+		kClustered //!< short sequential runs at random places
+	};
+
+	std::vector<int> make_keys(int count, int distribution)
+	{
+		std::vector<int> keys;
+		keys.reserve(static_cast<size_t>(count));
+		std::mt19937 engine(12345U);
+		for (int i = 0; i < count; ++i)
+		{
+			if (distribution == kSequential)
+				keys.push_back(i);
+			else if (distribution == kRandom)
+				keys.push_back(static_cast<int>(engine() & 0x7fffffffU));
+			else if (i % 16 == 0)
+				keys.push_back(static_cast<int>(engine() & 0x7fffff00U));
+			else
+				keys.push_back(keys.back() + 1);
+		}
+		return keys;
+	}
+
+	std::vector<int> shuffled(std::vector<int> keys)
+	{
+		std::mt19937 engine(54321U);
+		std::shuffle(keys.begin(), keys.end(), engine);
+		return keys;
+	}
+
+	struct map_insert {
+		template <typename Map>
+		static void apply(Map& map, int key)
+		{
+			map[key] = key;
+		}
+	};
+
+	struct set_insert {
+		template <typename Set>
+		static void apply(Set& set, int key)
+		{
+			set.insert(key);
+		}
+	};
+
+	void key_args(benchmark::internal::Benchmark * benchmark)
+	{
+		benchmark->ArgNames({"size", "keys"});
+		for (int count : {64, 4096, 262144})
+			for (int distribution : {kSequential, kRandom, kClustered})
+				benchmark->Args({count, distribution});
+	}
+
+} // namespace
+
+template <typename Container, typename Insert>
+static void BM_Insert(benchmark::State& state)
+{
+	const std::vector<int> keys = make_keys(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+	for (auto _ : state)
+	{
+		Container container;
+		for (int key : keys)
+			Insert::apply(container, key);
+		benchmark::DoNotOptimize(container.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<long long>(keys.size()));
+}
+
+template <typename Container, typename Insert>
+static void BM_Find(benchmark::State& state)
+{
+	const std::vector<int> keys = make_keys(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+	const std::vector<int> lookups = shuffled(keys);
+	Container container;
+	for (int key : keys)
+		Insert::apply(container, key);
+	for (auto _ : state)
+	{
+		long long found = 0;
+		for (int key : lookups)
+			found += (container.find(key) != container.end()) ? 1 : 0;
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<long long>(lookups.size()));
+}
+
+template <typename Container, typename Insert>
+static void BM_Erase(benchmark::State& state)
+{
+	const std::vector<int> keys = make_keys(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+	const std::vector<int> erasures = shuffled(keys);
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		Container container;
+		for (int key : keys)
+			Insert::apply(container, key);
+		state.ResumeTiming();
+		for (int key : erasures)
+			container.erase(key);
+		benchmark::DoNotOptimize(container.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<long long>(erasures.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_Insert, nostd::map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Insert, nostd::btree_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Insert, nostd::flat_hash_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Insert, std::map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Insert, std::unordered_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Insert, nostd::set<int>, set_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Insert, std::set<int>, set_insert)->Apply(key_args);
+
+BENCHMARK_TEMPLATE(BM_Find, nostd::map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Find, nostd::btree_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Find, nostd::flat_hash_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Find, std::map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Find, std::unordered_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Find, nostd::set<int>, set_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Find, std::set<int>, set_insert)->Apply(key_args);
+
+BENCHMARK_TEMPLATE(BM_Erase, nostd::map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Erase, nostd::btree_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Erase, nostd::flat_hash_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Erase, std::map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Erase, std::unordered_map<int, int>, map_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Erase, nostd::set<int>, set_insert)->Apply(key_args);
+BENCHMARK_TEMPLATE(BM_Erase, std::set<int>, set_insert)->Apply(key_args);
@@ -0,0 +1,63 @@
+#include <nostd/vector.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+template <typename Vector, typename T>
+static void BM_VectorPushBack(benchmark::State& state)
+{
+	const int count = static_cast<int>(state.range(0));
+	const T value = T();
+	for (auto _ : state)
+	{
+		Vector vector;
+		for (int i = 0; i < count; ++i)
+			vector.push_back(value);
+		benchmark::DoNotOptimize(vector.data());
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename Vector, typename T>
+static void BM_VectorReservePushBack(benchmark::State& state)
+{
+	const int count = static_cast<int>(state.range(0));
+	const T value = T();
+	for (auto _ : state)
+	{
+		Vector vector;
+		vector.reserve(static_cast<unsigned int>(count));
+		for (int i = 0; i < count; ++i)
+			vector.push_back(value);
+		benchmark::DoNotOptimize(vector.data());
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename Vector>
+static void BM_VectorIterate(benchmark::State& state)
+{
+	const int count = static_cast<int>(state.range(0));
+	Vector vector;
+	for (int i = 0; i < count; ++i)
+		vector.push_back(i);
+	for (auto _ : state)
+	{
+		long long sum = 0;
+		for (typename Vector::iterator it = vector.begin(); it != vector.end(); ++it)
+			sum += *it;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(BM_VectorPushBack, nostd::vector<int>, int)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorPushBack, std::vector<int>, int)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorPushBack, nostd::vector<std::string>, std::string)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorPushBack, std::vector<std::string>, std::string)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorReservePushBack, nostd::vector<int>, int)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorReservePushBack, std::vector<int>, int)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorIterate, nostd::vector<int>)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorIterate, std::vector<int>)->Range(8, 1 << 16);
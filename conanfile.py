@@ -16,12 +16,16 @@ class NoStdRecipe(ConanFile):
 	# Binary configuration
 	settings = "os", "compiler", "build_type", "arch"
 	options = {"shared": [True, False], 
-	           "fPIC": [True, False]}
+	           "fPIC": [True, False],
+	           "portable_hash_group": [True, False],
+	           "benchmarks": [True, False]}
 	default_options = {"shared": False, 
-	                   "fPIC": True}
+	                   "fPIC": True,
+	                   "portable_hash_group": False,
+	                   "benchmarks": False}
 
 	# Sources are located in the same place as this recipe, copy them to the recipe
-	exports_sources = "CMakeLists.txt", "src/*", "include/*", "tests/*"
+	exports_sources = "CMakeLists.txt", "src/*", "include/*", "tests/*", "benchmarks/*"
 
 	def config_options(self):
 		if self.settings.os == "Windows":
@@ -32,6 +36,8 @@ class NoStdRecipe(ConanFile):
 
 	def requirements(self):
 		self.test_requires("gtest/1.15.0")
+		if self.options.benchmarks:
+			self.test_requires("benchmark/1.9.0")
 
 	def layout(self):
 		cmake_layout(self)
@@ -40,6 +46,8 @@ class NoStdRecipe(ConanFile):
 		deps = CMakeDeps(self)
 		deps.generate()
 		tc = CMakeToolchain(self)
+		tc.variables["NOSTD_PORTABLE_HASH_GROUP"] = bool(self.options.portable_hash_group)
+		tc.variables["NOSTD_BUILD_BENCHMARKS"] = bool(self.options.benchmarks)
 		tc.generate()
 
 	def build(self):
@@ -53,4 +61,8 @@ class NoStdRecipe(ConanFile):
 		cmake.install()
 
 	def package_info(self):
-		self.cpp_info.libs = ["nostd"]
\ No newline at end of file
+		self.cpp_info.libs = ["nostd"]
+		if self.options.portable_hash_group:
+			self.cpp_info.defines = ["NOSTD_PORTABLE_HASH_GROUP"]
+		if self.settings.os in ["Linux", "FreeBSD"]:
+			self.cpp_info.system_libs = ["pthread"]
\ No newline at end of file
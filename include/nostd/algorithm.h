@@ -0,0 +1,239 @@
+#ifndef __NOSTD_ALGORITHM_H__
+#define __NOSTD_ALGORITHM_H__
+
+#include "functional.h"
+#include "utility.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Helpers of algorithms, not for direct use.
+	 */
+	namespace algorithm_detail {
+
+		template <typename RandomIt>
+		using value_type = typename std::remove_reference<decltype(*utility::declval<RandomIt>())>::type;
+
+		const std::ptrdiff_t insertion_threshold = 16; //!< ranges up to this length are sorted by insertion
+
+		/**
+		 * Returns number of bad partitions allowed before introsort switches to heapsort.
+		 */
+		inline int depth_limit(std::ptrdiff_t count) noexcept
+		{
+			int depth = 0;
+			for (; count > 1; count >>= 1)
+				depth += 2;
+			return depth;
+		}
+
+		template <typename RandomIt, typename Compare>
+		void insertion_sort(RandomIt first, RandomIt last, Compare& compare)
+		{
+			if (first == last)
+				return;
+			for (RandomIt i = first + 1; i != last; ++i)
+			{
+				value_type<RandomIt> value(utility::move(*i));
+				RandomIt j = i;
+				// Predecessor is formed only after checking j, so first - 1 is never computed
+				while (j != first && compare(value, *(j - 1)))
+				{
+					*j = utility::move(*(j - 1));
+					--j;
+				}
+				*j = utility::move(value);
+			}
+		}
+
+		template <typename RandomIt, typename Compare>
+		void sift_down(RandomIt first, std::ptrdiff_t root, std::ptrdiff_t count, Compare& compare)
+		{
+			for (;;)
+			{
+				std::ptrdiff_t child = 2 * root + 1;
+				if (child >= count)
+					return;
+				if (child + 1 < count && compare(*(first + child), *(first + (child + 1))))
+					++child;
+				if (!compare(*(first + root), *(first + child)))
+					return;
+				utility::swap(*(first + root), *(first + child));
+				root = child;
+			}
+		}
+
+		template <typename RandomIt, typename Compare>
+		void heap_sort(RandomIt first, RandomIt last, Compare& compare)
+		{
+			const std::ptrdiff_t count = last - first;
+			for (std::ptrdiff_t i = count / 2; i > 0; --i)
+				sift_down(first, i - 1, count, compare);
+			for (std::ptrdiff_t i = count; i > 1; --i)
+			{
+				utility::swap(*first, *(first + (i - 1)));
+				sift_down(first, 0, i - 1, compare);
+			}
+		}
+
+		/**
+		 * Moves median of a, b and c to result.
+		 */
+		template <typename RandomIt, typename Compare>
+		void move_median_to_first(RandomIt result, RandomIt a, RandomIt b, RandomIt c, Compare& compare)
+		{
+			if (compare(*a, *b))
+			{
+				if (compare(*b, *c))
+					utility::swap(*result, *b);
+				else if (compare(*a, *c))
+					utility::swap(*result, *c);
+				else
+					utility::swap(*result, *a);
+			}
+			else if (compare(*a, *c))
+				utility::swap(*result, *a);
+			else if (compare(*b, *c))
+				utility::swap(*result, *c);
+			else
+				utility::swap(*result, *b);
+		}
+
+		/**
+		 * Hoare partition around pivot, median of three guarantees both scans stop inside the range.
+		 */
+		template <typename RandomIt, typename Compare>
+		RandomIt unguarded_partition(RandomIt first, RandomIt last, RandomIt pivot, Compare& compare)
+		{
+			for (;;)
+			{
+				while (compare(*first, *pivot))
+					++first;
+				--last;
+				while (compare(*pivot, *last))
+					--last;
+				if (last - first <= 0)
+					return first;
+				utility::swap(*first, *last);
+				++first;
+			}
+		}
+
+		template <typename RandomIt, typename Compare>
+		void introsort(RandomIt first, RandomIt last, int depth, Compare& compare)
+		{
+			while (last - first > insertion_threshold)
+			{
+				if (depth == 0)
+				{
+					// Too many bad pivots, heapsort keeps O(n log n)
+					heap_sort(first, last, compare);
+					return;
+				}
+				--depth;
+				move_median_to_first(first, first + 1, first + (last - first) / 2, last - 1, compare);
+				RandomIt cut = unguarded_partition(first + 1, last, first, compare);
+				// Recursion goes to the smaller part, so stack depth is logarithmic
+				if (cut - first < last - cut)
+				{
+					introsort(first, cut, depth, compare);
+					first = cut;
+				}
+				else
+				{
+					introsort(cut, last, depth, compare);
+					last = cut;
+				}
+			}
+			insertion_sort(first, last, compare);
+		}
+
+	} // namespace algorithm_detail
+
+	/**
+	 * Sorts range with introsort, order of equivalent elements is not preserved.
+	 * Quicksort with median of three pivot falls back to heapsort on bad pivots,
+	 * so complexity is O(n log n) in the worst case. Short ranges are sorted by insertion.
+	 *
+	 * @param[in] first   The beginning of the range.
+	 * @param[in] last    The end of the range.
+	 * @param[in] compare The less comparator.
+	 */
+	template <typename RandomIt, typename Compare>
+	void sort(RandomIt first, RandomIt last, Compare compare)
+	{
+		algorithm_detail::introsort(first, last, algorithm_detail::depth_limit(last - first), compare);
+	}
+
+	/**
+	 * Sorts range with introsort in ascending order.
+	 * @see sort(RandomIt, RandomIt, Compare)
+	 *
+	 * @param[in] first The beginning of the range.
+	 * @param[in] last  The end of the range.
+	 */
+	template <typename RandomIt>
+	void sort(RandomIt first, RandomIt last)
+	{
+		nostd::sort(first, last, less<>());
+	}
+
+	/**
+	 * Calls function for every element of range.
+	 *
+	 * @param[in] first    The beginning of the range.
+	 * @param[in] last     The end of the range.
+	 * @param[in] function The function object.
+	 *
+	 * @return Returns the function object.
+	 */
+	template <typename InputIt, typename F>
+	F for_each(InputIt first, InputIt last, F function)
+	{
+		for (; first != last; ++first)
+			function(*first);
+		return function;
+	}
+
+	/**
+	 * Writes results of operation on every element of range to destination.
+	 *
+	 * @param[in] first     The beginning of the range.
+	 * @param[in] last      The end of the range.
+	 * @param[in] d_first   The beginning of destination, it may be equal to first.
+	 * @param[in] operation The unary operation.
+	 *
+	 * @return Returns iterator past the last written element.
+	 */
+	template <typename InputIt, typename OutputIt, typename F>
+	OutputIt transform(InputIt first, InputIt last, OutputIt d_first, F operation)
+	{
+		for (; first != last; ++first, ++d_first)
+			*d_first = operation(*first);
+		return d_first;
+	}
+
+	/**
+	 * Folds range with binary operation.
+	 *
+	 * @param[in] first     The beginning of the range.
+	 * @param[in] last      The end of the range.
+	 * @param[in] init      The initial value.
+	 * @param[in] operation The binary operation.
+	 *
+	 * @return Returns the result of folding.
+	 */
+	template <typename InputIt, typename T, typename F>
+	T reduce(InputIt first, InputIt last, T init, F operation)
+	{
+		for (; first != last; ++first)
+			init = operation(utility::move(init), *first);
+		return init;
+	}
+
+} // namespace nostd
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef __NOSTD_ALLOCATOR_H__
 #define __NOSTD_ALLOCATOR_H__
 
+#include <cstring>
+#include <new>
+
 namespace nostd {
 
 	/**
@@ -37,6 +40,103 @@ namespace nostd {
 		 * @param[in] ptr Pointer to block of memory
 		 */
 		virtual void free(ptr_type ptr) noexcept = 0;
+
+		/**
+		 * Releases block of memory that was allocated previously.
+		 * Size lets allocator skip looking up the block owner.
+		 * Default implementation ignores size.
+		 *
+		 * @param[in] ptr  Pointer to block of memory
+		 * @param[in] size Size that was passed to allocate
+		 */
+		virtual void free(ptr_type ptr, size_type size) noexcept
+		{
+			(void)size;
+			free(ptr);
+		}
+
+		/**
+		 * Allocates several blocks of memory of the same size.
+		 * Either all blocks are allocated or exception is thrown and nothing is left allocated.
+		 * Default implementation allocates blocks one by one.
+		 *
+		 * @param[in]  size  Size of every memory block
+		 * @param[in]  count Number of blocks
+		 * @param[out] out   Array of count pointers to be filled with blocks
+		 */
+		virtual void allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false)
+		{
+			size_type i = 0;
+			try
+			{
+				for (; i < count; ++i)
+				{
+					out[i] = allocate(size);
+					if (out[i] == nullptr)
+						throw std::bad_alloc();
+				}
+			}
+			catch (...)
+			{
+				free_batch(size, i, out);
+				throw;
+			}
+		}
+
+		/**
+		 * Releases several blocks of memory of the same size.
+		 * Default implementation releases blocks one by one.
+		 *
+		 * @param[in] size  Size that was passed to allocate
+		 * @param[in] count Number of blocks
+		 * @param[in] ptrs  Array of count pointers to blocks
+		 */
+		virtual void free_batch(size_type size, size_type count, ptr_type * ptrs) noexcept
+		{
+			for (size_type i = 0; i < count; ++i)
+				free(ptrs[i], size);
+		}
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Default implementation always fails.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		virtual bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+		{
+			(void)ptr;
+			(void)old_size;
+			(void)new_size;
+			return false;
+		}
+
+		/**
+		 * Changes size of block of memory, block may be moved.
+		 * Contents are moved bitwise, so it should be used only for trivially copyable data.
+		 * Default implementation tries to expand block in place and falls back to allocate, copy and free.
+		 *
+		 * @param[in] ptr      Pointer to block of memory or nullptr
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return Pointer to resized block of memory.
+		 */
+		virtual ptr_type reallocate(ptr_type ptr, size_type old_size, size_type new_size) noexcept(false)
+		{
+			if (ptr == nullptr)
+				return allocate(new_size);
+			if (try_expand(ptr, old_size, new_size))
+				return ptr;
+			ptr_type new_ptr = allocate(new_size);
+			std::memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+			free(ptr, old_size);
+			return new_ptr;
+		}
 	};
 
 } // namespace nostd
@@ -0,0 +1,917 @@
+#ifndef __NOSTD_BTREE_H__
+#define __NOSTD_BTREE_H__
+
+#include "default_allocator.h"
+#include "functional.h"
+#include "utility.h"
+
+#include <new>
+
+namespace nostd {
+
+	/**
+	 * Defines B-tree, the core of btree_map and btree_set.
+	 * Every node stores many values contiguously, so lookup touches a few cache lines per level
+	 * and in-order scan walks arrays instead of chasing a pointer per element.
+	 * Leaf and internal nodes have the same allocation size (about node_target_size bytes),
+	 * so nodes may come from a fixed size pool. Empty tree doesn't allocate.
+	 * Insertion and erasure move values between nodes, so iterators are invalidated by them.
+	 */
+	template <typename Value, typename Key, typename KeyOf, typename Compare>
+	class btree {
+	public:
+
+		using size_type = allocator::size_type;
+		using value_type = Value;
+
+		static const size_type node_target_size = 256U; //!< desired size of node in bytes
+
+	protected:
+
+		/**
+		 * Defines node header. Values follow the header, internal nodes also have children after values.
+		 */
+		struct node_t {
+			node_t * parent;
+			unsigned char position; // index in parent's children
+			unsigned char count; // number of values
+			bool leaf;
+		};
+
+		static const size_type values_offset = (sizeof(node_t) + alignof(Value) - 1U) / alignof(Value) * alignof(Value);
+		static const size_type leaf_fit = (node_target_size - values_offset) / sizeof(Value);
+		static const size_type internal_fit = (node_target_size - values_offset - sizeof(node_t*)) / (sizeof(Value) + sizeof(node_t*));
+		static const size_type leaf_values = leaf_fit < 3U ? 3U : leaf_fit; //!< capacity of leaf node
+		static const size_type internal_values = internal_fit < 3U ? 3U : internal_fit; //!< capacity of internal node
+		static const size_type children_offset = (values_offset + internal_values * sizeof(Value) + alignof(node_t*) - 1U)
+			/ alignof(node_t*) * alignof(node_t*);
+		static const size_type leaf_size = values_offset + leaf_values * sizeof(Value);
+		static const size_type internal_size = children_offset + (internal_values + 1U) * sizeof(node_t*);
+		static const size_type node_size = leaf_size > internal_size ? leaf_size : internal_size;
+
+		static_assert(leaf_values < 256U && internal_values < 255U, "Node counters are bytes");
+
+		static Value * _values(node_t * node) noexcept
+		{
+			return reinterpret_cast<Value*>(reinterpret_cast<unsigned char*>(node) + values_offset);
+		}
+		static node_t ** _children(node_t * node) noexcept
+		{
+			return reinterpret_cast<node_t**>(reinterpret_cast<unsigned char*>(node) + children_offset);
+		}
+		static size_type _max_count(const node_t * node) noexcept
+		{
+			return node->leaf ? size_type(leaf_values) : size_type(internal_values);
+		}
+		static size_type _min_count(const node_t * node) noexcept
+		{
+			return (_max_count(node) - 1U) / 2U;
+		}
+
+	public:
+
+		/**
+		 * Defines iterator class.
+		 * End iterator points past the last value of the root.
+		 */
+		class iterator {
+			friend class btree;
+
+			iterator(node_t * node, size_type position) noexcept
+			: node_(node)
+			, position_(position)
+			{
+			}
+			void _next() noexcept
+			{
+				if (!node_->leaf)
+				{
+					// The leftmost value of the right subtree
+					node_ = _children(node_)[position_ + 1U];
+					while (!node_->leaf)
+						node_ = _children(node_)[0];
+					position_ = 0U;
+					return;
+				}
+				++position_;
+				while (position_ == node_->count && node_->parent != nullptr)
+				{
+					position_ = node_->position;
+					node_ = node_->parent;
+				}
+			}
+		public:
+			iterator(const iterator& other) noexcept
+			: node_(other.node_)
+			, position_(other.position_)
+			{
+			}
+			iterator& operator =(const iterator& other) noexcept
+			{
+				node_ = other.node_;
+				position_ = other.position_;
+				return *this;
+			}
+			bool operator ==(const iterator& other) const noexcept
+			{
+				return node_ == other.node_ && position_ == other.position_;
+			}
+			bool operator !=(const iterator& other) const noexcept
+			{
+				return node_ != other.node_ || position_ != other.position_;
+			}
+			iterator& operator ++() noexcept // prefix increment
+			{
+				_next();
+				return *this;
+			}
+			iterator operator ++(int) noexcept // postfix increment
+			{
+				iterator it(*this);
+				_next();
+				return it;
+			}
+			Value& operator *() const noexcept
+			{
+				return _values(node_)[position_];
+			}
+			Value* operator ->() const noexcept
+			{
+				return _values(node_) + position_;
+			}
+		private:
+			node_t * node_;
+			size_type position_;
+		};
+
+	public:
+
+		/**
+		 * Default constructor.
+		 */
+		btree() noexcept
+		: btree(Compare(), default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate nodes.
+		 */
+		explicit btree(allocator * alloc) noexcept
+		: btree(Compare(), alloc)
+		{
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 *
+		 * @param[in] compare The comparator of keys.
+		 * @param[in] alloc   The allocator to be used to allocate nodes.
+		 */
+		btree(const Compare& compare, allocator * alloc) noexcept
+		: root_(nullptr)
+		, allocator_(alloc)
+		, size_(0U)
+		, compare_(compare)
+		{
+		}
+
+		/**
+		 * Copy constructor.
+		 * Both trees share the allocator.
+		 *
+		 * @param[in] other The other tree.
+		 */
+		btree(const btree& other) noexcept(false)
+		: btree(other.compare_, other.allocator_)
+		{
+			_copy_from(other);
+		}
+
+		/**
+		 * Move constructor.
+		 *
+		 * @param[in] other The other tree.
+		 */
+		btree(btree && other) noexcept
+		: btree(other.compare_, other.allocator_)
+		{
+			swap(other);
+		}
+
+		/**
+		 * Destructor.
+		 */
+		~btree()
+		{
+			clear();
+		}
+
+		/**
+		 * Copy assignment.
+		 *
+		 * @param[in] other The other tree.
+		 */
+		btree& operator =(const btree& other) noexcept(false)
+		{
+			if (this != &other)
+			{
+				clear();
+				compare_ = other.compare_;
+				_copy_from(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other tree.
+		 */
+		btree& operator =(btree && other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				swap(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Checks if tree is empty.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Returns number of elements.
+		 *
+		 * @return Returns tree size.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * Returns iterator to the first element.
+		 *
+		 * @return Returns iterator to the first element.
+		 */
+		iterator begin() noexcept
+		{
+			if (root_ == nullptr)
+				return end();
+			node_t * node = root_;
+			while (!node->leaf)
+				node = _children(node)[0];
+			return iterator(node, 0U);
+		}
+
+		/**
+		 * Returns iterator to the end.
+		 *
+		 * @return Returns iterator to the end.
+		 */
+		iterator end() noexcept
+		{
+			return iterator(root_, root_ != nullptr ? root_->count : 0U);
+		}
+
+		/**
+		 * Removes all elements and releases nodes.
+		 */
+		void clear() noexcept
+		{
+			if (root_ != nullptr)
+				_destroy(root_);
+			root_ = nullptr;
+			size_ = 0U;
+		}
+
+		/**
+		 * Inserts value if there is no element with equivalent key.
+		 *
+		 * @param[in] value  The value.
+		 *
+		 * @return Returns pair of iterator to the element with the key and true if value has been inserted.
+		 */
+		utility::pair<iterator, bool> insert(const Value& value) noexcept(false)
+		{
+			node_t * node;
+			size_type position;
+			if (_find_position(KeyOf::get(value), node, position))
+				return utility::pair<iterator, bool>(iterator(node, position), false);
+			return utility::pair<iterator, bool>(_insert_at(node, position, value), true);
+		}
+
+		/**
+		 * Inserts value if there is no element with equivalent key.
+		 *
+		 * @param[in] value  The value.
+		 *
+		 * @return Returns pair of iterator to the element with the key and true if value has been inserted.
+		 */
+		utility::pair<iterator, bool> insert(Value && value) noexcept(false)
+		{
+			node_t * node;
+			size_type position;
+			if (_find_position(KeyOf::get(value), node, position))
+				return utility::pair<iterator, bool>(iterator(node, position), false);
+			return utility::pair<iterator, bool>(_insert_at(node, position, utility::move(value)), true);
+		}
+
+		/**
+		 * Finds element with key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns iterator to found element or end.
+		 */
+		iterator find(const Key& key) noexcept
+		{
+			return _find(key);
+		}
+
+		/**
+		 * Finds element with key equivalent to a value of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 *
+		 * @return Returns iterator to found element or end.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K& key) noexcept
+		{
+			return _find(key);
+		}
+
+		/**
+		 * Checks if there is element with key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns true if found and false otherwise.
+		 */
+		bool contains(const Key& key) noexcept
+		{
+			return find(key) != end();
+		}
+
+		/**
+		 * Returns iterator to the first element not less than key.
+		 *
+		 * @param[in] key  The key.
+		 */
+		iterator lower_bound(const Key& key) noexcept
+		{
+			return _lower_bound(key);
+		}
+
+		/**
+		 * Returns iterator to the first element not less than key of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K& key) noexcept
+		{
+			return _lower_bound(key);
+		}
+
+		/**
+		 * Returns iterator to the first element greater than key.
+		 *
+		 * @param[in] key  The key.
+		 */
+		iterator upper_bound(const Key& key) noexcept
+		{
+			return _upper_bound(key);
+		}
+
+		/**
+		 * Returns iterator to the first element greater than key of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K& key) noexcept
+		{
+			return _upper_bound(key);
+		}
+
+		/**
+		 * Returns range of elements equivalent to key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns pair of lower and upper bounds.
+		 */
+		utility::pair<iterator, iterator> equal_range(const Key& key) noexcept
+		{
+			return utility::pair<iterator, iterator>(_lower_bound(key), _upper_bound(key));
+		}
+
+		/**
+		 * Returns range of elements equivalent to key of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 *
+		 * @return Returns pair of lower and upper bounds.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		utility::pair<iterator, iterator> equal_range(const K& key) noexcept
+		{
+			return utility::pair<iterator, iterator>(_lower_bound(key), _upper_bound(key));
+		}
+
+		/**
+		 * Erases element at iterator.
+		 * All iterators are invalidated.
+		 *
+		 * @param[in] it  The iterator to element.
+		 */
+		void erase(iterator it) noexcept
+		{
+			_erase_at(it.node_, it.position_);
+		}
+
+		/**
+		 * Erases element with key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns number of erased elements.
+		 */
+		size_type erase(const Key& key) noexcept
+		{
+			node_t * node;
+			size_type position;
+			if (!_find_position(key, node, position))
+				return 0U;
+			_erase_at(node, position);
+			return 1U;
+		}
+
+		/**
+		 * Swaps content with the other tree.
+		 *
+		 * @param[in] other  The other tree.
+		 */
+		void swap(btree& other) noexcept
+		{
+			utility::swap(root_, other.root_);
+			utility::swap(allocator_, other.allocator_);
+			utility::swap(size_, other.size_);
+			utility::swap(compare_, other.compare_);
+		}
+
+	protected:
+
+		/**
+		 * Returns index of the first value in node not less than key.
+		 */
+		template <typename K>
+		size_type _node_lower_bound(node_t * node, const K& key) const noexcept
+		{
+			const Value * values = _values(node);
+			size_type low = 0U;
+			size_type high = node->count;
+			while (low < high)
+			{
+				const size_type middle = (low + high) / 2U;
+				if (compare_(KeyOf::get(values[middle]), key))
+					low = middle + 1U;
+				else
+					high = middle;
+			}
+			return low;
+		}
+
+		/**
+		 * Returns index of the first value in node greater than key.
+		 */
+		template <typename K>
+		size_type _node_upper_bound(node_t * node, const K& key) const noexcept
+		{
+			const Value * values = _values(node);
+			size_type low = 0U;
+			size_type high = node->count;
+			while (low < high)
+			{
+				const size_type middle = (low + high) / 2U;
+				if (compare_(key, KeyOf::get(values[middle])))
+					high = middle;
+				else
+					low = middle + 1U;
+			}
+			return low;
+		}
+
+		/**
+		 * Finds element with key or the leaf position where it would be inserted.
+		 *
+		 * @param[in]  key      The key.
+		 * @param[out] node     The node of element or leaf to insert to.
+		 * @param[out] position The index in node.
+		 *
+		 * @return Returns true if element has been found and false otherwise.
+		 */
+		template <typename K>
+		bool _find_position(const K& key, node_t *& node, size_type& position) const noexcept
+		{
+			node = root_;
+			position = 0U;
+			if (node == nullptr)
+				return false;
+			for (;;)
+			{
+				position = _node_lower_bound(node, key);
+				if (position < node->count && !compare_(key, KeyOf::get(_values(node)[position])))
+					return true;
+				if (node->leaf)
+					return false;
+				node = _children(node)[position];
+			}
+		}
+		template <typename K>
+		iterator _find(const K& key) noexcept
+		{
+			node_t * node;
+			size_type position;
+			if (_find_position(key, node, position))
+				return iterator(node, position);
+			return end();
+		}
+		template <typename K>
+		iterator _lower_bound(const K& key) noexcept
+		{
+			iterator result = end();
+			node_t * node = root_;
+			while (node != nullptr)
+			{
+				const size_type position = _node_lower_bound(node, key);
+				if (position < node->count)
+				{
+					result = iterator(node, position);
+					if (!compare_(key, KeyOf::get(_values(node)[position])))
+						break; // keys are unique
+				}
+				node = node->leaf ? nullptr : _children(node)[position];
+			}
+			return result;
+		}
+		template <typename K>
+		iterator _upper_bound(const K& key) noexcept
+		{
+			iterator result = end();
+			node_t * node = root_;
+			while (node != nullptr)
+			{
+				const size_type position = _node_upper_bound(node, key);
+				if (position < node->count)
+					result = iterator(node, position);
+				node = node->leaf ? nullptr : _children(node)[position];
+			}
+			return result;
+		}
+
+		/**
+		 * Inserts value into leaf at position found by _find_position.
+		 *
+		 * @return Returns iterator to inserted element.
+		 */
+		template <typename... Args>
+		iterator _insert_at(node_t * node, size_type position, Args&&... args) noexcept(false)
+		{
+			if (node == nullptr)
+			{
+				root_ = _make_node(nullptr, true);
+				node = root_;
+			}
+			else if (node->count == _max_count(node))
+			{
+				_split(node);
+				if (position > node->count)
+				{
+					position -= node->count + 1U;
+					node = _children(node->parent)[node->position + 1U];
+				}
+			}
+			_construct_value(node, position, utility::forward<Args>(args)...);
+			++size_;
+			return iterator(node, position);
+		}
+
+		/**
+		 * Erases value at index of node and restores tree balance.
+		 */
+		void _erase_at(node_t * node, size_type position) noexcept
+		{
+			if (!node->leaf)
+			{
+				// Replace value with its predecessor, that is the last value of a leaf
+				node_t * leaf = _children(node)[position];
+				while (!leaf->leaf)
+					leaf = _children(leaf)[leaf->count];
+				Value * target = _values(node) + position;
+				target->~Value();
+				new (target) Value(utility::move(_values(leaf)[leaf->count - 1U]));
+				node = leaf;
+				position = leaf->count - 1U;
+			}
+			_destroy_value(node, position);
+			--size_;
+			_rebalance(node);
+		}
+
+		node_t * _make_node(node_t * parent, bool leaf) noexcept(false)
+		{
+			node_t * node = reinterpret_cast<node_t*>(allocator_->allocate(node_size));
+			node->parent = parent;
+			node->position = 0U;
+			node->count = 0U;
+			node->leaf = leaf;
+			return node;
+		}
+		void _free_node(node_t * node) noexcept
+		{
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(node), node_size);
+		}
+		void _destroy(node_t * node) noexcept
+		{
+			Value * values = _values(node);
+			for (size_type i = 0U; i < node->count; ++i)
+				values[i].~Value();
+			if (!node->leaf)
+			{
+				for (size_type i = 0U; i <= node->count; ++i)
+					_destroy(_children(node)[i]);
+			}
+			_free_node(node);
+		}
+		void _set_child(node_t * node, size_type index, node_t * child) noexcept
+		{
+			_children(node)[index] = child;
+			child->parent = node;
+			child->position = static_cast<unsigned char>(index);
+		}
+
+		/**
+		 * Constructs value at index, values starting at index are shifted right.
+		 * Children are not touched.
+		 */
+		template <typename... Args>
+		void _construct_value(node_t * node, size_type index, Args&&... args) noexcept(false)
+		{
+			Value * values = _values(node);
+			for (size_type i = node->count; i > index; --i)
+			{
+				new (values + i) Value(utility::move(values[i - 1U]));
+				values[i - 1U].~Value();
+			}
+			try
+			{
+				new (values + index) Value(utility::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				// Close the gap back
+				for (size_type i = index; i < node->count; ++i)
+				{
+					new (values + i) Value(utility::move(values[i + 1U]));
+					values[i + 1U].~Value();
+				}
+				throw;
+			}
+			++node->count;
+		}
+
+		/**
+		 * Destroys value at index, values after index are shifted left.
+		 * Children are not touched.
+		 */
+		void _destroy_value(node_t * node, size_type index) noexcept
+		{
+			Value * values = _values(node);
+			values[index].~Value();
+			for (size_type i = index + 1U; i < node->count; ++i)
+			{
+				new (values + i - 1U) Value(utility::move(values[i]));
+				values[i].~Value();
+			}
+			--node->count;
+		}
+
+		/**
+		 * Splits full node in two, the middle value moves up to parent.
+		 * Full parent is split first, the root split makes the tree taller.
+		 */
+		void _split(node_t * node) noexcept(false)
+		{
+			if (node->parent == nullptr)
+			{
+				node_t * root = _make_node(nullptr, false);
+				_set_child(root, 0U, node);
+				root_ = root;
+			}
+			else if (node->parent->count == _max_count(node->parent))
+			{
+				_split(node->parent);
+			}
+			node_t * parent = node->parent;
+			node_t * right = _make_node(parent, node->leaf);
+			const size_type middle = node->count / 2U;
+			Value * values = _values(node);
+			Value * right_values = _values(right);
+			for (size_type i = middle + 1U; i < node->count; ++i)
+			{
+				new (right_values + right->count) Value(utility::move(values[i]));
+				values[i].~Value();
+				++right->count;
+			}
+			if (!node->leaf)
+			{
+				for (size_type i = 0U; i <= right->count; ++i)
+					_set_child(right, i, _children(node)[middle + 1U + i]);
+			}
+			node->count = static_cast<unsigned char>(middle + 1U);
+			// Median goes up, parent has room for it
+			const size_type position = node->position;
+			for (size_type i = parent->count; i > position; --i)
+				_set_child(parent, i + 1U, _children(parent)[i]);
+			_construct_value(parent, position, utility::move(values[middle]));
+			_destroy_value(node, middle);
+			_set_child(parent, position + 1U, right);
+		}
+
+		/**
+		 * Restores minimal fill of node after erasure by borrowing from or merging with a sibling.
+		 */
+		void _rebalance(node_t * node) noexcept
+		{
+			for (;;)
+			{
+				if (node == root_)
+				{
+					if (node->count == 0U)
+					{
+						if (node->leaf)
+							root_ = nullptr;
+						else
+						{
+							root_ = _children(node)[0];
+							root_->parent = nullptr;
+							root_->position = 0U;
+						}
+						_free_node(node);
+					}
+					return;
+				}
+				if (node->count >= _min_count(node))
+					return;
+				node_t * parent = node->parent;
+				const size_type position = node->position;
+				node_t * left = position > 0U ? _children(parent)[position - 1U] : nullptr;
+				node_t * right = position < parent->count ? _children(parent)[position + 1U] : nullptr;
+				if (left != nullptr && left->count > _min_count(left))
+				{
+					_rotate_right(left, node, parent, position - 1U);
+					return;
+				}
+				if (right != nullptr && right->count > _min_count(right))
+				{
+					_rotate_left(node, right, parent, position);
+					return;
+				}
+				if (left != nullptr)
+					_merge(left, node, parent, position - 1U);
+				else
+					_merge(node, right, parent, position);
+				node = parent;
+			}
+		}
+
+		/**
+		 * Moves the last value of left sibling up to parent and the separator down to node.
+		 */
+		void _rotate_right(node_t * left, node_t * node, node_t * parent, size_type separator) noexcept
+		{
+			if (!node->leaf)
+			{
+				for (size_type i = node->count + 1U; i > 0U; --i)
+					_set_child(node, i, _children(node)[i - 1U]);
+				_set_child(node, 0U, _children(left)[left->count]);
+			}
+			Value * separator_value = _values(parent) + separator;
+			_construct_value(node, 0U, utility::move(*separator_value));
+			separator_value->~Value();
+			new (separator_value) Value(utility::move(_values(left)[left->count - 1U]));
+			_destroy_value(left, left->count - 1U);
+		}
+
+		/**
+		 * Moves the first value of right sibling up to parent and the separator down to node.
+		 */
+		void _rotate_left(node_t * node, node_t * right, node_t * parent, size_type separator) noexcept
+		{
+			if (!node->leaf)
+				_set_child(node, node->count + 1U, _children(right)[0]);
+			Value * separator_value = _values(parent) + separator;
+			_construct_value(node, node->count, utility::move(*separator_value));
+			separator_value->~Value();
+			new (separator_value) Value(utility::move(_values(right)[0]));
+			_destroy_value(right, 0U);
+			if (!right->leaf)
+			{
+				for (size_type i = 0U; i <= right->count; ++i)
+					_set_child(right, i, _children(right)[i + 1U]);
+			}
+		}
+
+		/**
+		 * Appends separator and right sibling to left one, right sibling is released.
+		 */
+		void _merge(node_t * left, node_t * right, node_t * parent, size_type separator) noexcept
+		{
+			const size_type offset = left->count + 1U;
+			_construct_value(left, left->count, utility::move(_values(parent)[separator]));
+			Value * left_values = _values(left);
+			Value * right_values = _values(right);
+			for (size_type i = 0U; i < right->count; ++i)
+			{
+				new (left_values + left->count) Value(utility::move(right_values[i]));
+				right_values[i].~Value();
+				++left->count;
+			}
+			if (!left->leaf)
+			{
+				for (size_type i = 0U; i <= right->count; ++i)
+					_set_child(left, offset + i, _children(right)[i]);
+			}
+			_destroy_value(parent, separator);
+			for (size_type i = separator + 1U; i <= parent->count; ++i)
+				_set_child(parent, i, _children(parent)[i + 1U]);
+			_free_node(right);
+		}
+
+		node_t * _clone(node_t * source, node_t * parent) noexcept(false)
+		{
+			// Node stays a leaf until all children are cloned, so it's released correctly on failure
+			node_t * node = _make_node(parent, true);
+			size_type children = 0U;
+			try
+			{
+				Value * values = _values(node);
+				const Value * source_values = _values(source);
+				for (size_type i = 0U; i < source->count; ++i)
+				{
+					new (values + i) Value(source_values[i]);
+					++node->count;
+				}
+				if (!source->leaf)
+				{
+					for (; children <= source->count; ++children)
+						_set_child(node, children, _clone(_children(source)[children], node));
+					node->leaf = false;
+				}
+			}
+			catch (...)
+			{
+				for (size_type i = 0U; i < children; ++i)
+					_destroy(_children(node)[i]);
+				_destroy(node);
+				throw;
+			}
+			return node;
+		}
+		void _copy_from(const btree& other) noexcept(false)
+		{
+			if (other.root_ != nullptr)
+				root_ = _clone(other.root_, nullptr);
+			size_ = other.size_;
+		}
+
+		node_t * root_;
+		allocator * allocator_;
+		size_type size_;
+		Compare compare_;
+	};
+
+	template <typename Value, typename Key, typename KeyOf, typename Compare>
+	const allocator::size_type btree<Value, Key, KeyOf, Compare>::node_target_size;
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef __NOSTD_BTREE_MAP_H__
+#define __NOSTD_BTREE_MAP_H__
+
+#include "btree.h"
+#include "functional.h"
+
+namespace nostd {
+
+	/**
+	 * Defines ordered map container. Implemented as B-tree.
+	 * Has the interface of map, but elements are stored in wide nodes,
+	 * so lookups and in-order scans are cache friendly.
+	 * Insertion and erasure may move elements, all iterators are invalidated by them.
+	 * PoolAllocator may be used as custom allocator, every node has the same size.
+	 * @see btree
+	 * @see map
+	 */
+	template <typename Key, typename T, typename Compare = less<Key>>
+	class btree_map
+	: public btree<utility::pair<Key, T>, Key, key_of_pair<Key, utility::pair<Key, T>>, Compare>
+	{
+		using base_type = btree<utility::pair<Key, T>, Key, key_of_pair<Key, utility::pair<Key, T>>, Compare>;
+
+	public:
+
+		using pair_type = utility::pair<Key, T>;
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		/**
+		 * Default constructor.
+		 */
+		btree_map() noexcept
+		: base_type()
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate nodes.
+		 */
+		btree_map(allocator * alloc) noexcept
+		: base_type(alloc)
+		{
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 *
+		 * @param[in] compare The comparator of keys.
+		 * @param[in] alloc   The allocator to be used to allocate nodes.
+		 */
+		btree_map(const Compare& compare, allocator * alloc) noexcept
+		: base_type(compare, alloc)
+		{
+		}
+
+		/**
+		 * Value access by key.
+		 * Value is default constructed if key is missing.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns reference to found value.
+		 */
+		T& operator [](const Key& key) noexcept(false)
+		{
+			typename base_type::node_t * node;
+			size_type position;
+			if (this->_find_position(key, node, position))
+				return base_type::_values(node)[position].second;
+			return this->_insert_at(node, position, key, T())->second;
+		}
+	};
+
+} // namespace nostd
+
+#endif
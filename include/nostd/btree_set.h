@@ -0,0 +1,62 @@
+#ifndef __NOSTD_BTREE_SET_H__
+#define __NOSTD_BTREE_SET_H__
+
+#include "btree.h"
+#include "functional.h"
+
+namespace nostd {
+
+	/**
+	 * Defines ordered set container. Implemented as B-tree.
+	 * Has the interface of set, but elements are stored in wide nodes,
+	 * so lookups and in-order scans are cache friendly.
+	 * Insertion and erasure may move elements, all iterators are invalidated by them.
+	 * Elements should not be modified through iterators.
+	 * PoolAllocator may be used as custom allocator, every node has the same size.
+	 * @see btree
+	 * @see set
+	 */
+	template <typename T, typename Compare = less<T>>
+	class btree_set
+	: public btree<T, T, key_of_identity<T>, Compare>
+	{
+		using base_type = btree<T, T, key_of_identity<T>, Compare>;
+
+	public:
+
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		/**
+		 * Default constructor.
+		 */
+		btree_set() noexcept
+		: base_type()
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate nodes.
+		 */
+		btree_set(allocator * alloc) noexcept
+		: base_type(alloc)
+		{
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 *
+		 * @param[in] compare The comparator of values.
+		 * @param[in] alloc   The allocator to be used to allocate nodes.
+		 */
+		btree_set(const Compare& compare, allocator * alloc) noexcept
+		: base_type(compare, alloc)
+		{
+		}
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef __NOSTD_CONCURRENT_POOL_ALLOCATOR_H__
+#define __NOSTD_CONCURRENT_POOL_ALLOCATOR_H__
+
+#include "allocator.h"
+#include "vector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace nostd {
+
+	/**
+	 * Thread-safe pool allocator.
+	 * Allocates memory blocks with constant size and may be shared between threads.
+	 * Free chunks are grouped into magazines. Every thread keeps a couple of magazines
+	 * in a thread-local cache, so the common allocate/free path touches no shared data.
+	 * Threads exchange full magazines through a lock-free depot that is ABA-safe
+	 * due to a tag packed next to the head pointer.
+	 * Blocks may be freed by any thread, not only by the allocating one.
+	 */
+	class concurrent_pool_allocator final
+	: public allocator
+	{
+
+		/**
+		 * Structure that represents free chunk.
+		 * Magazine is a chain of chunks, its head also holds depot link and chunk count.
+		 */
+		struct node_t {
+			node_t * next;                      //!< next chunk in magazine
+			std::atomic<node_t*> next_magazine; //!< next magazine in depot
+			size_type count;                    //!< number of chunks in magazine
+		};
+
+		/**
+		 * Per-thread cache of magazines
+		 */
+		struct cache_t {
+			concurrent_pool_allocator * owner;
+			std::uint64_t owner_id;
+			node_t * loaded;
+			node_t * previous;
+			size_type loaded_count;
+			size_type previous_count;
+		};
+
+		struct cache_table_t;
+		friend struct cache_table_t;
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] num_chunks Number of chunks per single buffer
+		 */
+		concurrent_pool_allocator(size_type num_chunks) noexcept;
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] num_chunks    Number of chunks per single buffer
+		 * @param[in] magazine_size Number of chunks cached per magazine
+		 */
+		concurrent_pool_allocator(size_type num_chunks, size_type magazine_size) noexcept;
+
+		/**
+		 * Destructor.
+		 * All blocks should be released and no thread should use allocator at that moment.
+		 */
+		~concurrent_pool_allocator();
+
+		/**
+		 * Allocates block of memory
+		 * Note that allocation size should be constant
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		ptr_type allocate(size_type size) noexcept(false) final;
+
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void free(ptr_type ptr) noexcept final;
+
+		using allocator::free;
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Succeeds if new size fits into the chunk.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final;
+
+		/**
+		 * Returns number of chunks
+		 */
+		size_type num_chunks() const noexcept;
+
+		/**
+		 * Returns number of chunks per magazine
+		 */
+		size_type magazine_size() const noexcept;
+
+	private:
+
+		/**
+		 * Disallow default constructor, copy and move
+		 */
+		concurrent_pool_allocator() = delete;
+		concurrent_pool_allocator(const concurrent_pool_allocator&) = delete;
+		concurrent_pool_allocator& operator =(const concurrent_pool_allocator&) = delete;
+
+		cache_t * _cache() noexcept;
+		node_t * _pop_magazine() noexcept;
+		void _push_magazine(node_t * magazine, size_type count) noexcept;
+		node_t * _grow(size_type size) noexcept(false);
+		void _register() noexcept;
+		void _unregister() noexcept;
+
+		static std::uint64_t _pack(node_t * node, std::uint64_t tag) noexcept;
+		static node_t * _unpack(std::uint64_t value) noexcept;
+		static std::uint64_t _next_tag(std::uint64_t value) noexcept;
+
+		std::atomic<std::uint64_t> depot_; //!< tagged head of full magazines list
+		byte_type padding_[64 - sizeof(std::atomic<std::uint64_t>)]; //!< keeps depot on its own cache line
+		size_type num_chunks_;
+		size_type magazine_size_;
+		std::atomic<size_type> chunk_size_;
+		std::uint64_t id_;
+		concurrent_pool_allocator * registry_prev_;
+		concurrent_pool_allocator * registry_next_;
+		std::mutex grow_mutex_;
+		vector<byte_type*> buffers_;
+	};
+
+} // namespace nostd
+
+#endif
\ No newline at end of file
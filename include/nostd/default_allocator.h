@@ -7,34 +7,107 @@ namespace nostd {
 
 	/**
 	 * Defines default allocator.
+	 * Thread-caching allocator, every thread serves small blocks from own per-size-class free lists
+	 * without locks. Lists are refilled from pages of `page_size` bytes cut from a single address range
+	 * reserved at first use and shared by all threads. Every page starts with a header holding its owner
+	 * and size class, so block is identified by masking its pointer.
+	 * Block freed by other thread is pushed to remote free stack of the owner, which takes the whole
+	 * stack when its free list of the class runs out.
+	 * Caches of exited threads are adopted by new threads, so cached memory isn't lost, but it isn't
+	 * returned to the system either.
+	 * Large blocks and blocks requested when the range is exhausted are forwarded to malloc/realloc/free.
+	 * Every block is aligned to max_align_t, like malloc.
 	 */
 	class default_allocator final
 	: public allocator
 	{
 	public:
 
+		static const size_type page_size = 1U << 16;   //!< size of page
+		static const size_type page_header_size = 64U; //!< space reserved for page header
+		static const size_type max_size = 4096U;       //!< largest size served by caches
+		static const size_type num_size_classes = 28U; //!< number of size classes
+
 		/**
-		 * @brief      Gets the thread-local instance.
+		 * @brief      Gets the instance shared by all threads.
+		 *             Instance is never destroyed, so it may be used by static objects.
 		 *
 		 * @return     The instance.
 		 */
 		static default_allocator * get_instance();
 
 		/**
-		 * Allocates block of memory
+		 * Allocates block of memory from cache of calling thread
 		 *
 		 * @param[in] size Size of memory block
 		 */
 		ptr_type allocate(size_type size) noexcept(false) final;
 
 		/**
-		 * Releases block of memory that was allocated previously
+		 * Releases block of memory that was allocated previously by any thread
 		 *
 		 * @param[in] ptr Pointer to block of memory
 		 */
 		void free(ptr_type ptr) noexcept final;
+
+		using allocator::free;
+
+		/**
+		 * Allocates several blocks of memory of the same size.
+		 * Small blocks are taken off the free list of calling thread at once.
+		 *
+		 * @param[in]  size  Size of every memory block
+		 * @param[in]  count Number of blocks
+		 * @param[out] out   Array of count pointers to be filled with blocks
+		 */
+		void allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false) final;
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Succeeds if new size fits into the size class of the block.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final;
+
+		/**
+		 * Changes size of block of memory, block may be moved.
+		 * Large blocks are resized via realloc.
+		 *
+		 * @param[in] ptr      Pointer to block of memory or nullptr
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return Pointer to resized block of memory.
+		 */
+		ptr_type reallocate(ptr_type ptr, size_type old_size, size_type new_size) noexcept(false) final;
+
+		/**
+		 * Checks if block is served by thread caches rather than malloc
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		static bool cached(const void * ptr) noexcept;
+
+		/**
+		 * Returns size class index for the size, size should not exceed max_size
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		static size_type size_class(size_type size) noexcept;
+
+		/**
+		 * Returns block size of size class
+		 *
+		 * @param[in] index Size class index
+		 */
+		static size_type class_size(size_type index) noexcept;
 	};
 
 } // namespace nostd
 
-#endif
\ No newline at end of file
+#endif
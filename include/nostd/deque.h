@@ -0,0 +1,616 @@
+#ifndef __NOSTD_DEQUE_H__
+#define __NOSTD_DEQUE_H__
+
+#include "default_allocator.h"
+#include "utility.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace nostd {
+
+	/**
+	 * Defines double-ended queue container (analog of std::deque).
+	 * Elements are stored in fixed size blocks, so there is a single allocation per block
+	 * and push/pop at both ends are O(1). Elements never move, references stay valid
+	 * until the element is popped.
+	 * Blocks are indexed by a map of block pointers, that grows when block is added at full end.
+	 * The last released block is kept as spare, so push/pop around block boundary doesn't hit allocator.
+	 * If no allocator is provided, default allocator's new/delete allocation/deallocation routine is used.
+	 * Allocator may be a concrete final allocator type, then block allocation calls are resolved at compile time.
+	 */
+	template <typename T, typename Allocator = allocator>
+	class deque {
+	public:
+
+		using size_type = allocator::size_type;
+
+		static const size_type block_target_size = 1024U; //!< desired size of block in bytes
+		static const size_type block_size = (block_target_size / sizeof(T) < 8U) ? 8U : block_target_size / sizeof(T); //!< number of elements in block
+
+		/**
+		 * Defines iterator class.
+		 */
+		class iterator {
+			friend class deque;
+
+			iterator(deque * owner, size_type index) noexcept
+			: deque_(owner)
+			, index_(index)
+			{
+			}
+		public:
+			iterator(const iterator& other) noexcept
+			: deque_(other.deque_)
+			, index_(other.index_)
+			{
+			}
+			iterator& operator =(const iterator& other) noexcept
+			{
+				deque_ = other.deque_;
+				index_ = other.index_;
+				return *this;
+			}
+			bool operator ==(const iterator& other) const noexcept
+			{
+				return index_ == other.index_ && deque_ == other.deque_;
+			}
+			bool operator !=(const iterator& other) const noexcept
+			{
+				return index_ != other.index_ || deque_ != other.deque_;
+			}
+			iterator& operator ++() noexcept // prefix increment
+			{
+				++index_;
+				return *this;
+			}
+			iterator operator ++(int) noexcept // postfix increment
+			{
+				iterator it(*this);
+				++index_;
+				return it;
+			}
+			iterator& operator --() noexcept // prefix decrement
+			{
+				--index_;
+				return *this;
+			}
+			iterator operator --(int) noexcept // postfix decrement
+			{
+				iterator it(*this);
+				--index_;
+				return it;
+			}
+			iterator& operator +=(std::ptrdiff_t offset) noexcept
+			{
+				index_ = static_cast<size_type>(static_cast<std::ptrdiff_t>(index_) + offset);
+				return *this;
+			}
+			iterator operator +(std::ptrdiff_t offset) const noexcept
+			{
+				return iterator(deque_, static_cast<size_type>(static_cast<std::ptrdiff_t>(index_) + offset));
+			}
+			iterator operator -(std::ptrdiff_t offset) const noexcept
+			{
+				return iterator(deque_, static_cast<size_type>(static_cast<std::ptrdiff_t>(index_) - offset));
+			}
+			std::ptrdiff_t operator -(const iterator& other) const noexcept
+			{
+				return static_cast<std::ptrdiff_t>(index_) - static_cast<std::ptrdiff_t>(other.index_);
+			}
+			T& operator *() const noexcept
+			{
+				return (*deque_)[index_];
+			}
+			T* operator ->() const noexcept
+			{
+				return &(*deque_)[index_];
+			}
+		private:
+			deque * deque_;
+			size_type index_;
+		};
+
+		/**
+		 * Default constructor.
+		 */
+		deque() noexcept
+		: map_(nullptr)
+		, spare_(nullptr)
+		, allocator_(default_allocator::get_instance())
+		, map_size_(0U)
+		, first_block_(0U)
+		, blocks_(0U)
+		, head_(0U)
+		, size_(0U)
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate blocks.
+		 */
+		deque(Allocator * alloc) noexcept
+		: map_(nullptr)
+		, spare_(nullptr)
+		, allocator_(alloc)
+		, map_size_(0U)
+		, first_block_(0U)
+		, blocks_(0U)
+		, head_(0U)
+		, size_(0U)
+		{
+		}
+
+		/**
+		 * Copy constructor.
+		 *
+		 * @param[in] other The other deque.
+		 */
+		deque(const deque& other) noexcept(false)
+		: map_(nullptr)
+		, spare_(nullptr)
+		, allocator_(other.allocator_)
+		, map_size_(0U)
+		, first_block_(0U)
+		, blocks_(0U)
+		, head_(0U)
+		, size_(0U)
+		{
+			_set_by_copy(other);
+		}
+
+		/**
+		 * Move constructor.
+		 *
+		 * @param[in] other The other deque.
+		 */
+		deque(deque && other) noexcept
+		: map_(nullptr)
+		, spare_(nullptr)
+		, allocator_(other.allocator_)
+		, map_size_(0U)
+		, first_block_(0U)
+		, blocks_(0U)
+		, head_(0U)
+		, size_(0U)
+		{
+			_set_by_move(utility::move(other));
+		}
+
+		/**
+		 * Destructor.
+		 */
+		~deque()
+		{
+			_clean();
+		}
+
+		/**
+		 * Copy assignment.
+		 *
+		 * @param[in] other The other deque.
+		 */
+		deque& operator =(const deque& other) noexcept(false)
+		{
+			if (this != &other)
+				_set_by_copy(other);
+			return *this;
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other deque.
+		 */
+		deque& operator =(deque && other) noexcept
+		{
+			if (this != &other)
+				_set_by_move(utility::move(other));
+			return *this;
+		}
+
+		/**
+		 * Returns iterator to the first element.
+		 *
+		 * @return Returns iterator to the first element.
+		 */
+		iterator begin() noexcept
+		{
+			return iterator(this, 0U);
+		}
+
+		/**
+		 * Returns iterator to the end.
+		 *
+		 * @return Returns iterator to the end.
+		 */
+		iterator end() noexcept
+		{
+			return iterator(this, size_);
+		}
+
+		/**
+		 * Returns element at index without bounds check.
+		 *
+		 * @param[in] index The index of element.
+		 *
+		 * @return Returns reference to the element.
+		 */
+		T& operator [](size_type index) const noexcept
+		{
+			const size_type position = head_ + index;
+			return map_[first_block_ + position / block_size][position % block_size];
+		}
+
+		/**
+		 * Returns element at index.
+		 *
+		 * @param[in] index The index of element.
+		 *
+		 * @return Returns reference to the element.
+		 */
+		T& at(size_type index) const noexcept(false)
+		{
+			if (index >= size_)
+				throw std::range_error("index out of range");
+			return (*this)[index];
+		}
+
+		/**
+		 * Gets the first element.
+		 *
+		 * @return Returns reference to the first element.
+		 */
+		T& front() const noexcept(false)
+		{
+			if (size_ == 0U)
+				throw std::range_error("Calling front() on an empty container.");
+			return (*this)[0U];
+		}
+
+		/**
+		 * Gets the last element.
+		 *
+		 * @return Returns reference to the last element.
+		 */
+		T& back() const noexcept(false)
+		{
+			if (size_ == 0U)
+				throw std::range_error("Calling back() on an empty container.");
+			return (*this)[size_ - 1U];
+		}
+
+		/**
+		 * Checks if deque is empty.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Returns number of deque elements.
+		 *
+		 * @return Returns deque size.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * Returns allocator used for blocks.
+		 *
+		 * @return Returns the allocator.
+		 */
+		Allocator * get_allocator() const noexcept
+		{
+			return allocator_;
+		}
+
+		/**
+		 * Clears deque. Blocks are released, except the spare one.
+		 */
+		void clear() noexcept
+		{
+			while (size_ != 0U)
+				pop_back();
+		}
+
+		/**
+		 * Constructs element in place at the end of the deque.
+		 *
+		 * @param[in] args The arguments to construct element from.
+		 *
+		 * @return Returns reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_back(Args&&... args) noexcept(false)
+		{
+			if (head_ + size_ == blocks_ * block_size)
+				_add_block_back();
+			T * element = &(*this)[size_];
+			new (element) T(utility::forward<Args>(args)...);
+			++size_;
+			return *element;
+		}
+
+		/**
+		 * Constructs element in place at the beginning of the deque.
+		 *
+		 * @param[in] args The arguments to construct element from.
+		 *
+		 * @return Returns reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_front(Args&&... args) noexcept(false)
+		{
+			if (blocks_ == 0U)
+			{
+				// Elements are pushed to the front of the block
+				_add_block_back();
+				head_ = block_size;
+			}
+			else if (head_ == 0U)
+				_add_block_front();
+			T * element = &map_[first_block_ + (head_ - 1U) / block_size][(head_ - 1U) % block_size];
+			new (element) T(utility::forward<Args>(args)...);
+			--head_;
+			++size_;
+			return *element;
+		}
+
+		/**
+		 * Pushes data to the end of the deque.
+		 * Version that copies data.
+		 *
+		 * @param[in] data The data.
+		 */
+		void push_back(const T& data) noexcept(false)
+		{
+			emplace_back(data);
+		}
+
+		/**
+		 * Pushes data to the end of the deque.
+		 * Version that moves data.
+		 *
+		 * @param[in] data The data.
+		 */
+		void push_back(T&& data) noexcept(false)
+		{
+			emplace_back(utility::move(data));
+		}
+
+		/**
+		 * Pushes data to the beginning of the deque.
+		 * Version that copies data.
+		 *
+		 * @param[in] data The data.
+		 */
+		void push_front(const T& data) noexcept(false)
+		{
+			emplace_front(data);
+		}
+
+		/**
+		 * Pushes data to the beginning of the deque.
+		 * Version that moves data.
+		 *
+		 * @param[in] data The data.
+		 */
+		void push_front(T&& data) noexcept(false)
+		{
+			emplace_front(utility::move(data));
+		}
+
+		/**
+		 * Removes element from the end of the deque.
+		 */
+		void pop_back() noexcept
+		{
+			if (size_ == 0U)
+				return;
+			(*this)[size_ - 1U].~T();
+			--size_;
+			if (size_ == 0U)
+				_release_blocks();
+			else if (head_ + size_ <= (blocks_ - 1U) * block_size)
+			{
+				// The last block became empty
+				--blocks_;
+				_release_block(map_[first_block_ + blocks_]);
+			}
+		}
+
+		/**
+		 * Removes element from the beginning of the deque.
+		 */
+		void pop_front() noexcept
+		{
+			if (size_ == 0U)
+				return;
+			(*this)[0U].~T();
+			++head_;
+			--size_;
+			if (size_ == 0U)
+				_release_blocks();
+			else if (head_ >= block_size)
+			{
+				// The first block became empty
+				_release_block(map_[first_block_]);
+				++first_block_;
+				--blocks_;
+				head_ -= block_size;
+			}
+		}
+
+		/**
+		 * Swaps deque with other one.
+		 *
+		 * @param[in] other The other deque.
+		 */
+		void swap(deque & other) noexcept
+		{
+			utility::swap(map_, other.map_);
+			utility::swap(spare_, other.spare_);
+			utility::swap(allocator_, other.allocator_);
+			utility::swap(map_size_, other.map_size_);
+			utility::swap(first_block_, other.first_block_);
+			utility::swap(blocks_, other.blocks_);
+			utility::swap(head_, other.head_);
+			utility::swap(size_, other.size_);
+		}
+
+	private:
+
+		T * _allocate_block() noexcept(false)
+		{
+			T * block = reinterpret_cast<T*>(allocator_->allocate(sizeof(T) * block_size));
+			if (block == nullptr)
+				throw std::bad_alloc();
+			return block;
+		}
+		void _free_block(T * block) noexcept
+		{
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(block), sizeof(T) * block_size);
+		}
+		T * _take_block() noexcept(false)
+		{
+			if (spare_ == nullptr)
+				return _allocate_block();
+			T * block = spare_;
+			spare_ = nullptr;
+			return block;
+		}
+		void _release_block(T * block) noexcept
+		{
+			if (spare_ == nullptr)
+				spare_ = block;
+			else
+				_free_block(block);
+		}
+		void _release_blocks() noexcept
+		{
+			// Deque is empty, so blocks may be centered in the map again
+			for (size_type i = 0U; i < blocks_; ++i)
+				_release_block(map_[first_block_ + i]);
+			blocks_ = 0U;
+			head_ = 0U;
+			first_block_ = map_size_ / 2U;
+		}
+		void _add_block_back() noexcept(false)
+		{
+			if (first_block_ + blocks_ == map_size_)
+				_reserve_map();
+			map_[first_block_ + blocks_] = _take_block();
+			++blocks_;
+		}
+		void _add_block_front() noexcept(false)
+		{
+			if (first_block_ == 0U)
+				_reserve_map();
+			map_[first_block_ - 1U] = _take_block();
+			--first_block_;
+			++blocks_;
+			head_ += block_size;
+		}
+		void _reserve_map() noexcept(false)
+		{
+			// Blocks are centered, so both ends get free slots
+			if (map_size_ < 2U * (blocks_ + 1U))
+			{
+				size_type new_size = 2U * map_size_;
+				if (new_size < 8U)
+					new_size = 8U;
+				T ** new_map = reinterpret_cast<T**>(allocator_->allocate(sizeof(T*) * new_size));
+				if (new_map == nullptr)
+					throw std::bad_alloc();
+				const size_type new_first = (new_size - blocks_) / 2U;
+				if (blocks_ != 0U)
+					std::memcpy(new_map + new_first, map_ + first_block_, sizeof(T*) * blocks_);
+				if (map_ != nullptr)
+					allocator_->free(reinterpret_cast<allocator::ptr_type>(map_), sizeof(T*) * map_size_);
+				map_ = new_map;
+				map_size_ = new_size;
+				first_block_ = new_first;
+			}
+			else
+			{
+				const size_type new_first = (map_size_ - blocks_) / 2U;
+				std::memmove(map_ + new_first, map_ + first_block_, sizeof(T*) * blocks_);
+				first_block_ = new_first;
+			}
+		}
+		void _clean() noexcept
+		{
+			clear();
+			if (spare_ != nullptr)
+			{
+				_free_block(spare_);
+				spare_ = nullptr;
+			}
+			if (map_ != nullptr)
+			{
+				allocator_->free(reinterpret_cast<allocator::ptr_type>(map_), sizeof(T*) * map_size_);
+				map_ = nullptr;
+			}
+			map_size_ = 0U;
+			first_block_ = 0U;
+		}
+		void _set_by_copy(const deque& other) noexcept(false)
+		{
+			// Clean old data, blocks are allocated with other's allocator
+			_clean();
+			allocator_ = other.allocator_;
+			for (size_type i = 0U; i < other.size_; ++i)
+				emplace_back(other[i]);
+		}
+		void _set_by_move(deque && other) noexcept
+		{
+			// Clean old data
+			_clean();
+			// Take other's blocks
+			map_ = other.map_;
+			spare_ = other.spare_;
+			allocator_ = other.allocator_;
+			map_size_ = other.map_size_;
+			first_block_ = other.first_block_;
+			blocks_ = other.blocks_;
+			head_ = other.head_;
+			size_ = other.size_;
+			// Other stays empty and keeps the allocator
+			other.map_ = nullptr;
+			other.spare_ = nullptr;
+			other.map_size_ = 0U;
+			other.first_block_ = 0U;
+			other.blocks_ = 0U;
+			other.head_ = 0U;
+			other.size_ = 0U;
+		}
+
+		T ** map_;				//!< pointers to blocks
+		T * spare_;				//!< released block kept for reuse
+		Allocator * allocator_;
+		size_type map_size_;	//!< number of slots in map
+		size_type first_block_;	//!< map slot of the first block
+		size_type blocks_;		//!< number of blocks in use
+		size_type head_;		//!< offset of the first element in the first block
+		size_type size_;
+	};
+
+	template <typename T, typename Allocator>
+	const typename deque<T, Allocator>::size_type deque<T, Allocator>::block_target_size;
+
+	template <typename T, typename Allocator>
+	const typename deque<T, Allocator>::size_type deque<T, Allocator>::block_size;
+
+} // namespace nostd
+
+#endif
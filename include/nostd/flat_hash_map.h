@@ -0,0 +1,71 @@
+#ifndef __NOSTD_FLAT_HASH_MAP_H__
+#define __NOSTD_FLAT_HASH_MAP_H__
+
+#include "functional.h"
+#include "hash.h"
+#include "hash_table.h"
+
+namespace nostd {
+
+	/**
+	 * Defines unordered map container. Implemented as open addressing hash table.
+	 * Elements are stored in a single array, so insertion may move them.
+	 * Iterators are invalidated by rehash.
+	 * If no allocator is provided, default allocator is used.
+	 * @see hash_table
+	 */
+	template <typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>>
+	class flat_hash_map
+	: public hash_table<utility::pair<Key, T>, Key, key_of_pair<Key, utility::pair<Key, T>>, Hash, KeyEqual>
+	{
+		using base_type = hash_table<utility::pair<Key, T>, Key, key_of_pair<Key, utility::pair<Key, T>>, Hash, KeyEqual>;
+
+	public:
+
+		using pair_type = utility::pair<Key, T>;
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		/**
+		 * Default constructor.
+		 */
+		flat_hash_map() noexcept
+		: base_type()
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate table.
+		 */
+		flat_hash_map(allocator * alloc) noexcept
+		: base_type(alloc)
+		{
+		}
+
+		/**
+		 * Value access by key.
+		 * Value is default constructed if key is missing.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns reference to found value.
+		 */
+		T& operator [](const Key& key) noexcept(false)
+		{
+			const std::size_t hash = this->hash_(key);
+			size_type index = this->_find(key, hash);
+			if (index == this->capacity_)
+			{
+				index = this->_prepare_insert(hash);
+				new (this->slots_ + index) pair_type(key, T());
+				this->_commit_insert(index, hash);
+			}
+			return this->slots_[index].second;
+		}
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __NOSTD_FLAT_HASH_SET_H__
+#define __NOSTD_FLAT_HASH_SET_H__
+
+#include "functional.h"
+#include "hash.h"
+#include "hash_table.h"
+
+namespace nostd {
+
+	/**
+	 * Defines unordered set container. Implemented as open addressing hash table.
+	 * Elements are stored in a single array, so insertion may move them.
+	 * Iterators are invalidated by rehash, elements should not be modified through them.
+	 * If no allocator is provided, default allocator is used.
+	 * @see hash_table
+	 */
+	template <typename Key, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>>
+	class flat_hash_set
+	: public hash_table<Key, Key, key_of_identity<Key>, Hash, KeyEqual>
+	{
+		using base_type = hash_table<Key, Key, key_of_identity<Key>, Hash, KeyEqual>;
+
+	public:
+
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		/**
+		 * Default constructor.
+		 */
+		flat_hash_set() noexcept
+		: base_type()
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate table.
+		 */
+		flat_hash_set(allocator * alloc) noexcept
+		: base_type(alloc)
+		{
+		}
+	};
+
+} // namespace nostd
+
+#endif
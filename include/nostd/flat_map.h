@@ -0,0 +1,77 @@
+#ifndef __NOSTD_FLAT_MAP_H__
+#define __NOSTD_FLAT_MAP_H__
+
+#include "flat_tree.h"
+#include "functional.h"
+
+namespace nostd {
+
+	/**
+	 * Defines ordered map container. Implemented as sorted vector of pairs.
+	 * Has the interface of map without per element allocation, best suited for data that is mostly read.
+	 * Insertion and erasure shift elements, all iterators are invalidated by them.
+	 * If no allocator is provided, default allocator is used.
+	 * @see flat_tree
+	 * @see map
+	 */
+	template <typename Key, typename T, typename Compare = less<Key>>
+	class flat_map
+	: public flat_tree<utility::pair<Key, T>, Key, key_of_pair<Key, utility::pair<Key, T>>, Compare>
+	{
+		using base_type = flat_tree<utility::pair<Key, T>, Key, key_of_pair<Key, utility::pair<Key, T>>, Compare>;
+
+	public:
+
+		using pair_type = utility::pair<Key, T>;
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		/**
+		 * Default constructor.
+		 */
+		flat_map() noexcept
+		: base_type()
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate array.
+		 */
+		flat_map(allocator * alloc) noexcept
+		: base_type(alloc)
+		{
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 *
+		 * @param[in] compare The comparator of keys.
+		 * @param[in] alloc   The allocator to be used to allocate array.
+		 */
+		flat_map(const Compare& compare, allocator * alloc) noexcept
+		: base_type(compare, alloc)
+		{
+		}
+
+		/**
+		 * Value access by key.
+		 * Value is default constructed if key is missing.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns reference to found value.
+		 */
+		T& operator [](const Key& key) noexcept(false)
+		{
+			const size_type index = this->_lower_bound_index(key);
+			if (this->_equal_at(index, key))
+				return this->data_[index].second;
+			return this->data_.emplace(this->data_.begin() + index, key, T())->second;
+		}
+	};
+
+} // namespace nostd
+
+#endif
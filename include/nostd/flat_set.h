@@ -0,0 +1,61 @@
+#ifndef __NOSTD_FLAT_SET_H__
+#define __NOSTD_FLAT_SET_H__
+
+#include "flat_tree.h"
+#include "functional.h"
+
+namespace nostd {
+
+	/**
+	 * Defines ordered set container. Implemented as sorted vector.
+	 * Has the interface of set without per element allocation, best suited for data that is mostly read.
+	 * Insertion and erasure shift elements, all iterators are invalidated by them.
+	 * Elements should not be modified through iterators.
+	 * If no allocator is provided, default allocator is used.
+	 * @see flat_tree
+	 * @see set
+	 */
+	template <typename T, typename Compare = less<T>>
+	class flat_set
+	: public flat_tree<T, T, key_of_identity<T>, Compare>
+	{
+		using base_type = flat_tree<T, T, key_of_identity<T>, Compare>;
+
+	public:
+
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		/**
+		 * Default constructor.
+		 */
+		flat_set() noexcept
+		: base_type()
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate array.
+		 */
+		flat_set(allocator * alloc) noexcept
+		: base_type(alloc)
+		{
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 *
+		 * @param[in] compare The comparator of values.
+		 * @param[in] alloc   The allocator to be used to allocate array.
+		 */
+		flat_set(const Compare& compare, allocator * alloc) noexcept
+		: base_type(compare, alloc)
+		{
+		}
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,511 @@
+#ifndef __NOSTD_FLAT_TREE_H__
+#define __NOSTD_FLAT_TREE_H__
+
+#include "algorithm.h"
+#include "default_allocator.h"
+#include "functional.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace nostd {
+
+	/**
+	 * Defines sorted array of unique keys, the core of flat_map and flat_set.
+	 * Elements are kept in a single vector ordered by Compare and looked up with binary search.
+	 * Search has no data dependent branches, so it doesn't suffer from branch misprediction.
+	 * Single insertion and erasure shift following elements, so batch insertion should be preferred:
+	 * it appends elements, sorts them and merges with existing ones in linear time.
+	 * Iterators are invalidated by insertion and erasure.
+	 */
+	template <typename Value, typename Key, typename KeyOf, typename Compare>
+	class flat_tree {
+	public:
+
+		using size_type = allocator::size_type;
+		using value_type = Value;
+		using container_type = vector<Value>;
+		using iterator = typename container_type::iterator;
+
+	public:
+
+		/**
+		 * Default constructor.
+		 */
+		flat_tree() noexcept
+		: flat_tree(Compare(), default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate array.
+		 */
+		explicit flat_tree(allocator * alloc) noexcept
+		: flat_tree(Compare(), alloc)
+		{
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 *
+		 * @param[in] compare The comparator of keys.
+		 * @param[in] alloc   The allocator to be used to allocate array.
+		 */
+		flat_tree(const Compare& compare, allocator * alloc) noexcept
+		: data_(alloc)
+		, compare_(compare)
+		{
+		}
+
+		/**
+		 * Checks if container is empty.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return data_.empty();
+		}
+
+		/**
+		 * Returns number of elements.
+		 *
+		 * @return Returns container size.
+		 */
+		size_type size() const noexcept
+		{
+			return data_.size();
+		}
+
+		/**
+		 * Returns number of elements that fit the array without reallocation.
+		 *
+		 * @return Returns container capacity.
+		 */
+		size_type capacity() const noexcept
+		{
+			return data_.capacity();
+		}
+
+		/**
+		 * Gets pointer to sorted elements.
+		 *
+		 * @return Returns pointer to the first element.
+		 */
+		const Value* data() const noexcept
+		{
+			return data_.data();
+		}
+
+		/**
+		 * Returns iterator to the first element.
+		 *
+		 * @return Returns iterator to the first element.
+		 */
+		iterator begin() noexcept
+		{
+			return data_.begin();
+		}
+
+		/**
+		 * Returns iterator to the end.
+		 *
+		 * @return Returns iterator to the end.
+		 */
+		iterator end() noexcept
+		{
+			return data_.end();
+		}
+
+		/**
+		 * Removes all elements, memory is kept for reuse.
+		 */
+		void clear() noexcept
+		{
+			data_.clear();
+		}
+
+		/**
+		 * Reserves space for number of elements.
+		 *
+		 * @param[in] count  The number of elements.
+		 */
+		void reserve(size_type count) noexcept(false)
+		{
+			data_.reserve(count);
+		}
+
+		/**
+		 * Inserts value if there is no element with equivalent key.
+		 *
+		 * @param[in] value  The value.
+		 *
+		 * @return Returns pair of iterator to the element with the key and true if value has been inserted.
+		 */
+		utility::pair<iterator, bool> insert(const Value& value) noexcept(false)
+		{
+			const size_type index = _lower_bound_index(KeyOf::get(value));
+			if (_equal_at(index, KeyOf::get(value)))
+				return utility::pair<iterator, bool>(data_.begin() + index, false);
+			return utility::pair<iterator, bool>(data_.insert(data_.begin() + index, value), true);
+		}
+
+		/**
+		 * Inserts value if there is no element with equivalent key.
+		 *
+		 * @param[in] value  The value.
+		 *
+		 * @return Returns pair of iterator to the element with the key and true if value has been inserted.
+		 */
+		utility::pair<iterator, bool> insert(Value && value) noexcept(false)
+		{
+			const size_type index = _lower_bound_index(KeyOf::get(value));
+			if (_equal_at(index, KeyOf::get(value)))
+				return utility::pair<iterator, bool>(data_.begin() + index, false);
+			return utility::pair<iterator, bool>(data_.insert(data_.begin() + index, utility::move(value)), true);
+		}
+
+		/**
+		 * Inserts range of values, values with keys which are already present are skipped.
+		 * Values are appended, sorted and merged with existing ones,
+		 * which takes O(n + k log k) for k new values instead of O(n k) for one by one insertion.
+		 * It's unspecified which of equivalent values in the range is inserted.
+		 *
+		 * @param[in] first  The first value.
+		 * @param[in] last   The value after the last one.
+		 */
+		template <typename InputIt>
+		void insert(InputIt first, InputIt last) noexcept(false)
+		{
+			const size_type old_size = data_.size();
+			try
+			{
+				for (; first != last; ++first)
+					data_.emplace_back(*first);
+			}
+			catch (...)
+			{
+				// Drop the unsorted tail, so the array stays sorted
+				data_.erase(data_.begin() + old_size, data_.end());
+				throw;
+			}
+			const size_type new_size = data_.size();
+			if (new_size == old_size)
+				return;
+			_sort(data_.data() + old_size, new_size - old_size);
+			if (old_size == 0U)
+				_unique();
+			else
+				_merge(old_size);
+		}
+
+		/**
+		 * Finds element with key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns iterator to found element or end.
+		 */
+		iterator find(const Key& key) noexcept
+		{
+			return _find(key);
+		}
+
+		/**
+		 * Finds element with key equivalent to a value of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 *
+		 * @return Returns iterator to found element or end.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K& key) noexcept
+		{
+			return _find(key);
+		}
+
+		/**
+		 * Checks if there is element with key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns true if found and false otherwise.
+		 */
+		bool contains(const Key& key) const noexcept
+		{
+			return _equal_at(_lower_bound_index(key), key);
+		}
+
+		/**
+		 * Returns iterator to the first element not less than key.
+		 *
+		 * @param[in] key  The key.
+		 */
+		iterator lower_bound(const Key& key) noexcept
+		{
+			return data_.begin() + _lower_bound_index(key);
+		}
+
+		/**
+		 * Returns iterator to the first element not less than key of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K& key) noexcept
+		{
+			return data_.begin() + _lower_bound_index(key);
+		}
+
+		/**
+		 * Returns iterator to the first element greater than key.
+		 *
+		 * @param[in] key  The key.
+		 */
+		iterator upper_bound(const Key& key) noexcept
+		{
+			return data_.begin() + _upper_bound_index(key);
+		}
+
+		/**
+		 * Returns iterator to the first element greater than key of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K& key) noexcept
+		{
+			return data_.begin() + _upper_bound_index(key);
+		}
+
+		/**
+		 * Returns range of elements equivalent to key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns pair of lower and upper bounds.
+		 */
+		utility::pair<iterator, iterator> equal_range(const Key& key) noexcept
+		{
+			return _equal_range(key);
+		}
+
+		/**
+		 * Returns range of elements equivalent to key of other type.
+		 * Available with transparent comparator only.
+		 *
+		 * @param[in] key  The key-like value.
+		 *
+		 * @return Returns pair of lower and upper bounds.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		utility::pair<iterator, iterator> equal_range(const K& key) noexcept
+		{
+			return _equal_range(key);
+		}
+
+		/**
+		 * Erases element at iterator.
+		 *
+		 * @param[in] it  The iterator to element.
+		 *
+		 * @return Returns iterator to the element after erased one.
+		 */
+		iterator erase(iterator it) noexcept
+		{
+			return data_.erase(it);
+		}
+
+		/**
+		 * Erases elements in range [first, last).
+		 *
+		 * @param[in] first  The first element to erase.
+		 * @param[in] last   The element after the last one to erase.
+		 *
+		 * @return Returns iterator to the element after erased ones.
+		 */
+		iterator erase(iterator first, iterator last) noexcept
+		{
+			return data_.erase(first, last);
+		}
+
+		/**
+		 * Erases element with key.
+		 *
+		 * @param[in] key  The key.
+		 *
+		 * @return Returns number of erased elements.
+		 */
+		size_type erase(const Key& key) noexcept
+		{
+			const size_type index = _lower_bound_index(key);
+			if (!_equal_at(index, key))
+				return 0U;
+			data_.erase(data_.begin() + index);
+			return 1U;
+		}
+
+		/**
+		 * Swaps content with the other container.
+		 *
+		 * @param[in] other  The other container.
+		 */
+		void swap(flat_tree& other) noexcept
+		{
+			data_.swap(other.data_);
+			utility::swap(compare_, other.compare_);
+		}
+
+	protected:
+
+		/**
+		 * Returns index of the first element not less than key.
+		 * Range is halved unconditionally, so loop compiles to conditional moves.
+		 */
+		template <typename K>
+		size_type _lower_bound_index(const K& key) const noexcept
+		{
+			const Value * values = data_.data();
+			size_type length = data_.size();
+			if (length == 0U)
+				return 0U;
+			const Value * first = values;
+			while (length > 1U)
+			{
+				const size_type half = length / 2U;
+				first = compare_(KeyOf::get(first[half]), key) ? first + half : first;
+				length -= half;
+			}
+			return static_cast<size_type>(first - values) + (compare_(KeyOf::get(*first), key) ? 1U : 0U);
+		}
+
+		/**
+		 * Returns index of the first element greater than key.
+		 */
+		template <typename K>
+		size_type _upper_bound_index(const K& key) const noexcept
+		{
+			const Value * values = data_.data();
+			size_type length = data_.size();
+			if (length == 0U)
+				return 0U;
+			const Value * first = values;
+			while (length > 1U)
+			{
+				const size_type half = length / 2U;
+				first = compare_(key, KeyOf::get(first[half])) ? first : first + half;
+				length -= half;
+			}
+			return static_cast<size_type>(first - values) + (compare_(key, KeyOf::get(*first)) ? 0U : 1U);
+		}
+
+		/**
+		 * Checks if element at index from _lower_bound_index is equivalent to key.
+		 */
+		template <typename K>
+		bool _equal_at(size_type index, const K& key) const noexcept
+		{
+			return index < data_.size() && !compare_(key, KeyOf::get(data_.data()[index]));
+		}
+		template <typename K>
+		iterator _find(const K& key) noexcept
+		{
+			const size_type index = _lower_bound_index(key);
+			return _equal_at(index, key) ? data_.begin() + index : data_.end();
+		}
+		template <typename K>
+		utility::pair<iterator, iterator> _equal_range(const K& key) noexcept
+		{
+			const size_type index = _lower_bound_index(key);
+			return utility::pair<iterator, iterator>(data_.begin() + index,
+				data_.begin() + index + (_equal_at(index, key) ? 1U : 0U));
+		}
+		bool _less(const Value& lhs, const Value& rhs) const noexcept
+		{
+			return compare_(KeyOf::get(lhs), KeyOf::get(rhs));
+		}
+
+		/**
+		 * Sorts values with introsort, which needs no extra memory.
+		 */
+		void _sort(Value * values, size_type count) noexcept
+		{
+			nostd::sort(values, values + count, [this](const Value& lhs, const Value& rhs) {
+				return _less(lhs, rhs);
+			});
+		}
+
+		/**
+		 * Removes equivalent neighbours of sorted array in place.
+		 */
+		void _unique() noexcept
+		{
+			Value * values = data_.data();
+			size_type last = 0U;
+			for (size_type i = 1U; i < data_.size(); ++i)
+			{
+				if (_less(values[last], values[i]))
+				{
+					++last;
+					if (last != i)
+						values[last] = utility::move(values[i]);
+				}
+			}
+			data_.erase(data_.begin() + (last + 1U), data_.end());
+		}
+
+		/**
+		 * Merges sorted tail starting at index with unique sorted head.
+		 * Elements of head win over equivalent ones of tail.
+		 */
+		void _merge(size_type middle) noexcept(false)
+		{
+			Value * values = data_.data();
+			const size_type count = data_.size();
+			container_type merged(data_.get_allocator());
+			try
+			{
+				merged.reserve(count);
+			}
+			catch (...)
+			{
+				// Drop the tail, so the array stays sorted
+				data_.erase(data_.begin() + middle, data_.end());
+				throw;
+			}
+			size_type i = 0U;
+			size_type j = middle;
+			while (i < middle && j < count)
+			{
+				if (_less(values[j], values[i]))
+				{
+					if (merged.empty() || _less(merged.data()[merged.size() - 1U], values[j]))
+						merged.emplace_back(utility::move(values[j]));
+					++j;
+				}
+				else if (_less(values[i], values[j]))
+					merged.emplace_back(utility::move(values[i++]));
+				else
+					++j; // the same key is in head
+			}
+			for (; i < middle; ++i)
+				merged.emplace_back(utility::move(values[i]));
+			for (; j < count; ++j)
+			{
+				if (merged.empty() || _less(merged.data()[merged.size() - 1U], values[j]))
+					merged.emplace_back(utility::move(values[j]));
+			}
+			data_.swap(merged);
+		}
+
+		container_type data_;
+		Compare compare_;
+	};
+
+} // namespace nostd
+
+#endif
@@ -2,8 +2,10 @@
 #define __NOSTD_FORWARD_LIST_H__
 
 #include "default_allocator.h"
+#include "node_batch.h"
 #include "utility.h"
 
+#include <new>
 #include <stdexcept>
 
 namespace nostd {
@@ -13,8 +15,9 @@ namespace nostd {
 	 * Move semantics should be defined for used type.
 	 * If no allocator is provided, default allocator's new/delete allocation/deallocation routine is used.
 	 * Note: copy operations require additional allocations.
+	 * Allocator may be a concrete allocator type (like pool_allocator), so node allocation calls are resolved at compile time.
 	 */
-	template <typename T>
+	template <typename T, typename Allocator = allocator>
 	class forward_list {
 
 		/**
@@ -44,7 +47,7 @@ namespace nostd {
 		 * 
 		 * @param[in] alloc The allocator to be used to allocate nodes.
 		 */
-		forward_list(allocator * alloc) noexcept
+		forward_list(Allocator * alloc) noexcept
 		: head_(nullptr)
 		, allocator_(alloc)
 		, size_(0U)
@@ -57,6 +60,9 @@ namespace nostd {
 		 * @param[in] other The other list.
 		 */
 		forward_list(const forward_list& other) noexcept(false)
+		: head_(nullptr)
+		, allocator_(nullptr)
+		, size_(0U)
 		{
 			_set_by_copy(other);
 		}
@@ -71,7 +77,7 @@ namespace nostd {
 		, allocator_(nullptr)
 		, size_(0U)
 		{
-			_set_by_move(utility::forward<forward_list>(other));
+			_set_by_move(utility::move(other));
 		}
 
 		/**
@@ -100,7 +106,7 @@ namespace nostd {
 		 */
 		forward_list& operator =(forward_list && other) noexcept
 		{
-			_set_by_move(utility::forward<forward_list>(other));
+			_set_by_move(utility::move(other));
 			return *this;
 		}
 
@@ -148,32 +154,60 @@ namespace nostd {
 
 		/**
 		 * Clears list.
-		 * Data move constructor is used for data destruction.
 		 */
 		void clear() noexcept
 		{
-			while (size_ != 0U)
+			// Nodes are returned to allocator in batches
+			node_release_batch<Allocator> release(allocator_, sizeof(node_t));
+			node_t * node = head_;
+			while (node != nullptr)
 			{
-				T data(utility::move(front()));
-				pop_front();
+				node_t * next = node->next;
+				node->data.~T();
+				release.add(reinterpret_cast<allocator::ptr_type>(node));
+				node = next;
 			}
+			head_ = nullptr;
+			size_ = 0U;
 		}
 
 		/**
-		 * Pushes data to the beginning of the list.
-		 * Version that copies data.
+		 * Constructs element in place at the beginning of the list.
 		 * 
-		 * @param[in] data The data.
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns reference to the new element.
 		 */
-		void push_front(const T& data) noexcept(false)
+		template <typename... Args>
+		T& emplace_front(Args&&... args) noexcept(false)
 		{
 			node_t * node = _allocate_node();
 			if (node == nullptr)
 				throw std::bad_alloc();
-			node->data = data;
+			try
+			{
+				new (&node->data) T(utility::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				_free_node(node);
+				throw;
+			}
 			node->next = head_;
 			head_ = node;
 			++size_;
+			return node->data;
+		}
+
+		/**
+		 * Pushes data to the beginning of the list.
+		 * Version that copies data.
+		 * 
+		 * @param[in] data The data.
+		 */
+		void push_front(const T& data) noexcept(false)
+		{
+			emplace_front(data);
 		}
 
 		/**
@@ -184,13 +218,7 @@ namespace nostd {
 		 */
 		void push_front(T&& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = utility::move(data);
-			node->next = head_;
-			head_ = node;
-			++size_;
+			emplace_front(utility::move(data));
 		}
 
 		/**
@@ -203,6 +231,7 @@ namespace nostd {
 			{
 				head_ = node->next;
 				--size_;
+				node->data.~T();
 				_free_node(node);
 			}
 		}
@@ -227,7 +256,7 @@ namespace nostd {
 		}
 		void _free_node(node_t * node) noexcept
 		{
-			allocator_->free(reinterpret_cast<allocator::ptr_type>(node));
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(node), sizeof(node_t));
 		}
 		void _clean() noexcept
 		{
@@ -240,30 +269,27 @@ namespace nostd {
 			allocator_ = other.allocator_;
 			size_ = 0U;
 
-			size_type other_size = other.size();
-			if (other_size > 0U)
+			if (other.size_ == 0U)
+				return;
+			// Copy other list nodes in order, storage is allocated in batches
+			node_allocation_batch<Allocator> batch(allocator_, sizeof(node_t), other.size_);
+			node_t ** link = &head_;
+			for (node_t * other_node = other.head_; other_node != nullptr; other_node = other_node->next)
 			{
-				// Allocate storage for nodes
-				node_t ** nodes = new node_t*[other_size];
-				if (nodes == nullptr)
-					throw std::bad_alloc();
-
-				// Copy other list nodes
-				int i = 0;
-				node_t * other_node = other.head_;
-				while (other_node != nullptr)
+				node_t * node = reinterpret_cast<node_t*>(batch.next());
+				try
 				{
-					nodes[i++] = other_node;
-					other_node = other_node->next;
+					new (&node->data) T(other_node->data);
 				}
-				// Push data in reverse order to keep the same order
-				for (i = other_size - 1; i >= 0; --i)
+				catch (...)
 				{
-					push_front(nodes[i]->data);
+					_free_node(node);
+					throw;
 				}
-
-				// Finally
-				delete[] nodes;
+				node->next = nullptr;
+				*link = node;
+				link = &node->next;
+				++size_;
 			}
 		}
 		void _set_by_move(forward_list && other) noexcept
@@ -280,7 +306,7 @@ namespace nostd {
 		}
 
 		node_t * head_;
-		allocator * allocator_;
+		Allocator * allocator_;
 		size_type size_;
 	};
 
@@ -0,0 +1,81 @@
+#ifndef __NOSTD_FUNCTIONAL_H__
+#define __NOSTD_FUNCTIONAL_H__
+
+namespace nostd {
+
+	/**
+	 * Function object for equality comparison (analog of std::equal_to).
+	 */
+	template <typename T = void>
+	struct equal_to {
+		bool operator ()(const T& lhs, const T& rhs) const
+		{
+			return lhs == rhs;
+		}
+	};
+
+	/**
+	 * Transparent equality comparison, arguments may have different types.
+	 */
+	template <>
+	struct equal_to<void> {
+		typedef void is_transparent;
+
+		template <typename A, typename B>
+		bool operator ()(const A& lhs, const B& rhs) const
+		{
+			return lhs == rhs;
+		}
+	};
+
+	/**
+	 * Function object for less comparison (analog of std::less).
+	 */
+	template <typename T = void>
+	struct less {
+		bool operator ()(const T& lhs, const T& rhs) const
+		{
+			return lhs < rhs;
+		}
+	};
+
+	/**
+	 * Transparent less comparison, enables lookup by keys of other types
+	 * without constructing temporary keys.
+	 */
+	template <>
+	struct less<void> {
+		typedef void is_transparent;
+
+		template <typename A, typename B>
+		bool operator ()(const A& lhs, const B& rhs) const
+		{
+			return lhs < rhs;
+		}
+	};
+
+	/**
+	 * Extracts key of map value.
+	 */
+	template <typename Key, typename Value>
+	struct key_of_pair {
+		static const Key& get(const Value& value) noexcept
+		{
+			return value.first;
+		}
+	};
+
+	/**
+	 * Extracts key of set value, that is the value itself.
+	 */
+	template <typename Key>
+	struct key_of_identity {
+		static const Key& get(const Key& value) noexcept
+		{
+			return value;
+		}
+	};
+
+} // namespace nostd
+
+#endif
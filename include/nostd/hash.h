@@ -0,0 +1,84 @@
+#ifndef __NOSTD_HASH_H__
+#define __NOSTD_HASH_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Mixes bits of value, so every input bit affects every output bit.
+	 * Finalizer of MurmurHash3 is used.
+	 *
+	 * @param[in] value The value to mix.
+	 */
+	inline std::size_t hash_mix(std::uint64_t value) noexcept
+	{
+		value ^= value >> 33;
+		value *= 0xff51afd7ed558ccdULL;
+		value ^= value >> 33;
+		value *= 0xc4ceb9fe1a85ec53ULL;
+		value ^= value >> 33;
+		return static_cast<std::size_t>(value);
+	}
+
+	/**
+	 * Computes hash of byte sequence (FNV-1a followed by mixing).
+	 *
+	 * @param[in] data The bytes.
+	 * @param[in] size Number of bytes.
+	 */
+	inline std::size_t hash_bytes(const void * data, std::size_t size) noexcept
+	{
+		const unsigned char * bytes = reinterpret_cast<const unsigned char*>(data);
+		std::uint64_t value = 0xcbf29ce484222325ULL;
+		for (std::size_t i = 0U; i < size; ++i)
+		{
+			value ^= bytes[i];
+			value *= 0x100000001b3ULL;
+		}
+		return hash_mix(value);
+	}
+
+	/**
+	 * Function object computing hash of value (analog of std::hash).
+	 * Defined for integral, enumeration, floating point and pointer types,
+	 * other types may be supported by specialization.
+	 */
+	template <typename T, typename Enable = void>
+	struct hash;
+
+	template <typename T>
+	struct hash<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type> {
+		std::size_t operator ()(T value) const noexcept
+		{
+			return hash_mix(static_cast<std::uint64_t>(value));
+		}
+	};
+
+	template <typename T>
+	struct hash<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+		std::size_t operator ()(T value) const noexcept
+		{
+			// Equal values stay equal in double, which has no padding bytes
+			double number = static_cast<double>(value);
+			// Zero and negative zero are equal
+			if (number == 0.0)
+				return hash_mix(0U);
+			return hash_bytes(&number, sizeof(number));
+		}
+	};
+
+	template <typename T>
+	struct hash<T*> {
+		std::size_t operator ()(T * value) const noexcept
+		{
+			return hash_mix(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value)));
+		}
+	};
+
+} // namespace nostd
+
+#endif
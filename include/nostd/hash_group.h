@@ -0,0 +1,242 @@
+#ifndef __NOSTD_HASH_GROUP_H__
+#define __NOSTD_HASH_GROUP_H__
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+/**
+ * Backend of hash table group probing is selected at compile time:
+ * SSE2 on x86, NEON on little endian ARM and SWAR on other platforms.
+ * Defining NOSTD_PORTABLE_HASH_GROUP forces SWAR backend.
+ * Backend affects table layout, so all translation units should use the same one.
+ */
+#if !defined(NOSTD_PORTABLE_HASH_GROUP) && \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define NOSTD_HASH_GROUP_SSE2 1
+# include <emmintrin.h>
+#elif !defined(NOSTD_PORTABLE_HASH_GROUP) && \
+	((defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)) || defined(_M_ARM64))
+# define NOSTD_HASH_GROUP_NEON 1
+# include <arm_neon.h>
+#else
+# define NOSTD_HASH_GROUP_SWAR 1
+#endif
+
+namespace nostd {
+
+	/**
+	 * Control byte of hash table slot.
+	 * Full slot stores 7 lower bits of hash, special states have the highest bit set.
+	 */
+	typedef signed char ctrl_t;
+
+	enum : ctrl_t {
+		ctrl_empty = -128,  //!< slot has never been used
+		ctrl_deleted = -2,  //!< slot has been erased, probing continues past it
+		ctrl_sentinel = -1  //!< end of control bytes, stops iteration
+	};
+
+	/**
+	 * Returns index of the lowest set bit, value should not be zero
+	 */
+	inline unsigned count_trailing_zeros(std::uint64_t value) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_ctzll(value));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return static_cast<unsigned>(index);
+#else
+		unsigned index = 0U;
+		while ((value & 1U) == 0U)
+		{
+			value >>= 1;
+			++index;
+		}
+		return index;
+#endif
+	}
+
+	/**
+	 * Returns index of the highest set bit, value should not be zero
+	 */
+	inline unsigned highest_bit_set(std::uint64_t value) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63U - static_cast<unsigned>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return static_cast<unsigned>(index);
+#else
+		unsigned index = 0U;
+		while (value >>= 1)
+			++index;
+		return index;
+#endif
+	}
+
+	/**
+	 * Set of slots within a group, every slot occupies (1 << Shift) bits.
+	 * Iterated from the lowest slot to the highest one.
+	 */
+	template <unsigned Width, unsigned Shift>
+	class group_mask {
+	public:
+		explicit group_mask(std::uint64_t bits) noexcept
+		: bits_(bits)
+		{
+		}
+		explicit operator bool() const noexcept
+		{
+			return bits_ != 0U;
+		}
+		unsigned lowest() const noexcept
+		{
+			return count_trailing_zeros(bits_) >> Shift;
+		}
+		unsigned highest() const noexcept
+		{
+			return highest_bit_set(bits_) >> Shift;
+		}
+		unsigned trailing_zeros() const noexcept
+		{
+			return bits_ != 0U ? lowest() : Width;
+		}
+		unsigned leading_zeros() const noexcept
+		{
+			return bits_ != 0U ? Width - 1U - highest() : Width;
+		}
+		void clear_lowest() noexcept
+		{
+			bits_ &= bits_ - 1U;
+		}
+	private:
+		std::uint64_t bits_;
+	};
+
+	/**
+	 * Group of 8 control bytes tested at once with 64-bit arithmetic.
+	 * Mask has the highest bit of every matching byte set.
+	 * Match may report a false positive right after a real match, keys are compared anyway.
+	 */
+	struct group_swar {
+
+		static const unsigned width = 8U;
+		using mask_type = group_mask<width, 3U>;
+
+		explicit group_swar(const ctrl_t * ctrl) noexcept
+		{
+			std::memcpy(&ctrl_, ctrl, sizeof(ctrl_));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			ctrl_ = __builtin_bswap64(ctrl_);
+#endif
+		}
+		mask_type match(ctrl_t hash) const noexcept
+		{
+			const std::uint64_t x = ctrl_ ^ (lsbs * static_cast<unsigned char>(hash));
+			return mask_type((x - lsbs) & ~x & msbs);
+		}
+		mask_type match_empty() const noexcept
+		{
+			// Only empty byte has the highest bit set and the second lowest one clear
+			return mask_type(ctrl_ & (~ctrl_ << 6) & msbs);
+		}
+		mask_type match_empty_or_deleted() const noexcept
+		{
+			// Sentinel is the only special byte with the lowest bit set
+			return mask_type(ctrl_ & (~ctrl_ << 7) & msbs);
+		}
+
+		static const std::uint64_t lsbs = 0x0101010101010101ULL;
+		static const std::uint64_t msbs = 0x8080808080808080ULL;
+
+		std::uint64_t ctrl_;
+	};
+
+#if defined(NOSTD_HASH_GROUP_SSE2)
+	/**
+	 * Group of 16 control bytes tested with SSE2 instructions.
+	 */
+	struct group_sse2 {
+
+		static const unsigned width = 16U;
+		using mask_type = group_mask<width, 0U>;
+
+		explicit group_sse2(const ctrl_t * ctrl) noexcept
+		: ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+		{
+		}
+		mask_type match(ctrl_t hash) const noexcept
+		{
+			return _to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(hash), ctrl_));
+		}
+		mask_type match_empty() const noexcept
+		{
+			return match(ctrl_empty);
+		}
+		mask_type match_empty_or_deleted() const noexcept
+		{
+			// Signed comparison, special bytes below sentinel
+			return _to_mask(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl_));
+		}
+
+		static mask_type _to_mask(__m128i bytes) noexcept
+		{
+			return mask_type(static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(bytes))));
+		}
+
+		__m128i ctrl_;
+	};
+
+	using hash_group = group_sse2;
+
+#elif defined(NOSTD_HASH_GROUP_NEON)
+	/**
+	 * Group of 8 control bytes tested with NEON instructions.
+	 * NEON has no byte mask extraction, so mask has SWAR layout.
+	 */
+	struct group_neon {
+
+		static const unsigned width = 8U;
+		using mask_type = group_mask<width, 3U>;
+
+		explicit group_neon(const ctrl_t * ctrl) noexcept
+		: ctrl_(vld1_s8(reinterpret_cast<const int8_t*>(ctrl)))
+		{
+		}
+		mask_type match(ctrl_t hash) const noexcept
+		{
+			return _to_mask(vceq_s8(vdup_n_s8(hash), ctrl_));
+		}
+		mask_type match_empty() const noexcept
+		{
+			return match(ctrl_empty);
+		}
+		mask_type match_empty_or_deleted() const noexcept
+		{
+			return _to_mask(vcgt_s8(vdup_n_s8(ctrl_sentinel), ctrl_));
+		}
+
+		static mask_type _to_mask(uint8x8_t bytes) noexcept
+		{
+			return mask_type(vget_lane_u64(vreinterpret_u64_u8(bytes), 0) & 0x8080808080808080ULL);
+		}
+
+		int8x8_t ctrl_;
+	};
+
+	using hash_group = group_neon;
+
+#else
+	using hash_group = group_swar;
+#endif
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,628 @@
+#ifndef __NOSTD_HASH_TABLE_H__
+#define __NOSTD_HASH_TABLE_H__
+
+#include "default_allocator.h"
+#include "functional.h"
+#include "hash_group.h"
+#include "utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace nostd {
+
+	/**
+	 * Defines open addressing hash table, the core of flat_hash_map and flat_hash_set.
+	 * Swiss table layout is used: every slot has a control byte holding 7 bits of its hash,
+	 * lookup compares a whole group of control bytes with the hash and only then the keys.
+	 * Control bytes and slots share one allocation, empty table doesn't allocate.
+	 * Capacity is always 2^n - 1 and load factor doesn't exceed 7/8.
+	 */
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+	class hash_table {
+	public:
+
+		using size_type = allocator::size_type;
+		using value_type = Value;
+		using group_type = hash_group;
+
+		/**
+		 * Defines iterator class.
+		 */
+		class iterator {
+			friend class hash_table;
+
+			iterator(ctrl_t * ctrl, Value * slot) noexcept
+			: ctrl_(ctrl)
+			, slot_(slot)
+			{
+			}
+			void _skip_free() noexcept
+			{
+				// Sentinel stops the loop
+				while (*ctrl_ < ctrl_sentinel)
+				{
+					++ctrl_;
+					++slot_;
+				}
+			}
+		public:
+			iterator(const iterator& other) noexcept
+			: ctrl_(other.ctrl_)
+			, slot_(other.slot_)
+			{
+			}
+			iterator& operator =(const iterator& other) noexcept
+			{
+				ctrl_ = other.ctrl_;
+				slot_ = other.slot_;
+				return *this;
+			}
+			bool operator ==(const iterator& other) const noexcept
+			{
+				return ctrl_ == other.ctrl_;
+			}
+			bool operator !=(const iterator& other) const noexcept
+			{
+				return ctrl_ != other.ctrl_;
+			}
+			iterator& operator ++() noexcept // prefix increment
+			{
+				++ctrl_;
+				++slot_;
+				_skip_free();
+				return *this;
+			}
+			iterator operator ++(int) noexcept // postfix increment
+			{
+				iterator it(*this);
+				++(*this);
+				return it;
+			}
+			Value& operator *() const noexcept
+			{
+				return *slot_;
+			}
+			Value* operator ->() const noexcept
+			{
+				return slot_;
+			}
+		private:
+			ctrl_t * ctrl_;
+			Value * slot_;
+		};
+
+	public:
+
+		/**
+		 * Default constructor.
+		 */
+		hash_table() noexcept
+		: hash_table(default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used to allocate table.
+		 */
+		explicit hash_table(allocator * alloc) noexcept
+		: ctrl_(_empty_group())
+		, slots_(nullptr)
+		, allocator_(alloc)
+		, capacity_(0U)
+		, size_(0U)
+		, growth_left_(0U)
+		, hash_()
+		, equal_()
+		{
+		}
+
+		/**
+		 * Copy constructor.
+		 * Both tables share the allocator.
+		 *
+		 * @param[in] other The other table.
+		 */
+		hash_table(const hash_table& other) noexcept(false)
+		: hash_table(other.allocator_)
+		{
+			_copy_from(other);
+		}
+
+		/**
+		 * Move constructor.
+		 *
+		 * @param[in] other The other table.
+		 */
+		hash_table(hash_table && other) noexcept
+		: hash_table(other.allocator_)
+		{
+			swap(other);
+		}
+
+		/**
+		 * Destructor.
+		 */
+		~hash_table()
+		{
+			_clean();
+		}
+
+		/**
+		 * Copy assignment.
+		 *
+		 * @param[in] other The other table.
+		 */
+		hash_table& operator =(const hash_table& other) noexcept(false)
+		{
+			if (this != &other)
+			{
+				clear();
+				_copy_from(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other table.
+		 */
+		hash_table& operator =(hash_table && other) noexcept
+		{
+			if (this != &other)
+			{
+				_clean();
+				swap(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Checks if table is empty.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Returns number of elements.
+		 *
+		 * @return Returns table size.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * Returns number of slots.
+		 *
+		 * @return Returns table capacity.
+		 */
+		size_type capacity() const noexcept
+		{
+			return capacity_;
+		}
+
+		/**
+		 * Returns iterator to the first element.
+		 *
+		 * @return Returns iterator to the first element.
+		 */
+		iterator begin() noexcept
+		{
+			iterator it(ctrl_, slots_);
+			it._skip_free();
+			return it;
+		}
+
+		/**
+		 * Returns iterator to the end.
+		 *
+		 * @return Returns iterator to the end.
+		 */
+		iterator end() noexcept
+		{
+			return iterator(ctrl_ + capacity_, slots_ + capacity_);
+		}
+
+		/**
+		 * Removes all elements, memory is kept for reuse.
+		 */
+		void clear() noexcept
+		{
+			if (capacity_ == 0U)
+				return;
+			_destroy_slots();
+			_reset_ctrl();
+			size_ = 0U;
+			growth_left_ = _capacity_to_growth(capacity_);
+		}
+
+		/**
+		 * Reserves space for number of elements, so they are inserted without rehash.
+		 *
+		 * @param[in] count  The number of elements.
+		 */
+		void reserve(size_type count) noexcept(false)
+		{
+			if (count > size_ + growth_left_)
+				_resize(_normalize_capacity(_growth_to_capacity(count)));
+		}
+
+		/**
+		 * Inserts element in the table.
+		 * Version that copies data.
+		 *
+		 * @param[in] value The value.
+		 *
+		 * @return Returns a pair consisting of an iterator to the inserted element
+		 *         (or to the element that prevented the insertion) and
+		 *         a bool value set to true if the insertion took place.
+		 */
+		utility::pair<iterator, bool> insert(const Value& value) noexcept(false)
+		{
+			const Key& key = KeyOf::get(value);
+			const std::size_t hash = hash_(key);
+			size_type index = _find(key, hash);
+			if (index != capacity_)
+				return utility::pair<iterator, bool>(_iterator_at(index), false);
+			index = _prepare_insert(hash);
+			new (slots_ + index) Value(value);
+			_commit_insert(index, hash);
+			return utility::pair<iterator, bool>(_iterator_at(index), true);
+		}
+
+		/**
+		 * Inserts element in the table.
+		 * Version that moves data.
+		 *
+		 * @param[in] value The value.
+		 *
+		 * @return Returns a pair consisting of an iterator to the inserted element
+		 *         (or to the element that prevented the insertion) and
+		 *         a bool value set to true if the insertion took place.
+		 */
+		utility::pair<iterator, bool> insert(Value && value) noexcept(false)
+		{
+			const Key& key = KeyOf::get(value);
+			const std::size_t hash = hash_(key);
+			size_type index = _find(key, hash);
+			if (index != capacity_)
+				return utility::pair<iterator, bool>(_iterator_at(index), false);
+			index = _prepare_insert(hash);
+			new (slots_ + index) Value(utility::move(value));
+			_commit_insert(index, hash);
+			return utility::pair<iterator, bool>(_iterator_at(index), true);
+		}
+
+		/**
+		 * Finds element in the table.
+		 *
+		 * @param[in] key The key.
+		 *
+		 * @return Returns an iterator to the found element or end iterator.
+		 */
+		iterator find(const Key& key) noexcept
+		{
+			return _iterator_at(_find(key, hash_(key)));
+		}
+
+		/**
+		 * Checks if table contains element with key.
+		 *
+		 * @param[in] key The key.
+		 *
+		 * @return Returns true if element is found and false otherwise.
+		 */
+		bool contains(const Key& key) const noexcept
+		{
+			return _find(key, hash_(key)) != capacity_;
+		}
+
+		/**
+		 * Removes element from the table.
+		 *
+		 * @param[in] pos The iterator to the element to remove.
+		 */
+		void erase(iterator pos) noexcept
+		{
+			pos.slot_->~Value();
+			_erase_ctrl(static_cast<size_type>(pos.ctrl_ - ctrl_));
+		}
+
+		/**
+		 * Removes element with key from the table.
+		 *
+		 * @param[in] key The key to match removable element.
+		 *
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const Key& key) noexcept
+		{
+			size_type index = _find(key, hash_(key));
+			if (index == capacity_)
+				return 0U;
+			slots_[index].~Value();
+			_erase_ctrl(index);
+			return 1U;
+		}
+
+		/**
+		 * Swaps table with other one.
+		 *
+		 * @param[in] other The other table.
+		 */
+		void swap(hash_table& other) noexcept
+		{
+			utility::swap(ctrl_, other.ctrl_);
+			utility::swap(slots_, other.slots_);
+			utility::swap(allocator_, other.allocator_);
+			utility::swap(capacity_, other.capacity_);
+			utility::swap(size_, other.size_);
+			utility::swap(growth_left_, other.growth_left_);
+		}
+
+	protected:
+
+		/**
+		 * Sequence of groups visited by lookup, triangular steps visit every group once.
+		 */
+		class probe_seq {
+		public:
+			probe_seq(std::size_t hash, size_type mask) noexcept
+			: mask_(mask)
+			, offset_(static_cast<size_type>(hash) & mask)
+			, index_(0U)
+			{
+			}
+			size_type offset() const noexcept
+			{
+				return offset_;
+			}
+			size_type offset(unsigned i) const noexcept
+			{
+				return (offset_ + i) & mask_;
+			}
+			void next() noexcept
+			{
+				index_ += group_type::width;
+				offset_ = (offset_ + index_) & mask_;
+			}
+		private:
+			size_type mask_;
+			size_type offset_;
+			size_type index_;
+		};
+
+		static std::size_t _h1(std::size_t hash) noexcept
+		{
+			return hash >> 7;
+		}
+		static ctrl_t _h2(std::size_t hash) noexcept
+		{
+			return static_cast<ctrl_t>(hash & 0x7FU);
+		}
+		static ctrl_t * _empty_group() noexcept
+		{
+			static_assert(group_type::width <= 16U, "Empty group is too small");
+			// Sentinel makes empty table iteration stop, empty bytes stop lookup
+			alignas(16) static const ctrl_t group[16] = {
+				ctrl_sentinel, ctrl_empty, ctrl_empty, ctrl_empty,
+				ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+				ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+				ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+			};
+			return const_cast<ctrl_t*>(group);
+		}
+		static size_type _capacity_to_growth(size_type capacity) noexcept
+		{
+			// Group of 8 can't scan 7 full slots without an empty one
+			if (group_type::width == 8U && capacity == 7U)
+				return 6U;
+			return capacity - capacity / 8U;
+		}
+		static size_type _growth_to_capacity(size_type growth) noexcept
+		{
+			if (group_type::width == 8U && growth == 7U)
+				return 8U;
+			return growth + (growth - 1U) / 7U;
+		}
+		static size_type _normalize_capacity(size_type capacity) noexcept
+		{
+			size_type result = 1U;
+			while (result < capacity)
+				result = result * 2U + 1U;
+			return result;
+		}
+		static size_type _slots_offset(size_type capacity) noexcept
+		{
+			// Sentinel and cloned bytes follow control bytes
+			size_type size = capacity + group_type::width;
+			return (size + (alignof(Value) - 1U)) & ~static_cast<size_type>(alignof(Value) - 1U);
+		}
+		static size_type _allocation_size(size_type capacity) noexcept
+		{
+			return _slots_offset(capacity) + capacity * static_cast<size_type>(sizeof(Value));
+		}
+		static bool _is_full(ctrl_t ctrl) noexcept
+		{
+			return ctrl >= 0;
+		}
+
+		iterator _iterator_at(size_type index) noexcept
+		{
+			return iterator(ctrl_ + index, slots_ + index);
+		}
+		/**
+		 * Returns index of element or capacity if not found
+		 */
+		size_type _find(const Key& key, std::size_t hash) const noexcept
+		{
+			probe_seq seq(_h1(hash), capacity_);
+			const ctrl_t h2 = _h2(hash);
+			for (;;)
+			{
+				group_type group(ctrl_ + seq.offset());
+				for (auto mask = group.match(h2); mask; mask.clear_lowest())
+				{
+					size_type index = seq.offset(mask.lowest());
+					if (equal_(key, KeyOf::get(slots_[index])))
+						return index;
+				}
+				if (group.match_empty())
+					return capacity_;
+				seq.next();
+			}
+		}
+		size_type _find_first_non_full(std::size_t hash) const noexcept
+		{
+			probe_seq seq(_h1(hash), capacity_);
+			for (;;)
+			{
+				group_type group(ctrl_ + seq.offset());
+				auto mask = group.match_empty_or_deleted();
+				if (mask)
+					return seq.offset(mask.lowest());
+				seq.next();
+			}
+		}
+		/**
+		 * Returns index of slot for the new element, value should be constructed there
+		 * and then insertion is finished with _commit_insert.
+		 */
+		size_type _prepare_insert(std::size_t hash) noexcept(false)
+		{
+			if (growth_left_ == 0U)
+				_rehash_and_grow();
+			return _find_first_non_full(hash);
+		}
+		void _commit_insert(size_type index, std::size_t hash) noexcept
+		{
+			if (ctrl_[index] == ctrl_empty)
+				--growth_left_;
+			_set_ctrl(index, _h2(hash));
+			++size_;
+		}
+		void _set_ctrl(size_type index, ctrl_t value) noexcept
+		{
+			// The first width - 1 bytes are cloned after the sentinel
+			const size_type cloned = group_type::width - 1U;
+			ctrl_[index] = value;
+			ctrl_[((index - cloned) & capacity_) + (cloned & capacity_)] = value;
+		}
+		void _erase_ctrl(size_type index) noexcept
+		{
+			--size_;
+			// Slot may become empty if no probe sequence has ever passed it as a full group
+			const size_type before = (index - group_type::width) & capacity_;
+			auto empty_after = group_type(ctrl_ + index).match_empty();
+			auto empty_before = group_type(ctrl_ + before).match_empty();
+			bool was_never_full = empty_before && empty_after &&
+				empty_after.trailing_zeros() + empty_before.leading_zeros() < group_type::width;
+			_set_ctrl(index, was_never_full ? static_cast<ctrl_t>(ctrl_empty) : static_cast<ctrl_t>(ctrl_deleted));
+			if (was_never_full)
+				++growth_left_;
+		}
+		void _rehash_and_grow() noexcept(false)
+		{
+			if (capacity_ == 0U)
+				_resize(1U);
+			else if (capacity_ > group_type::width &&
+				static_cast<std::uint64_t>(size_) * 32U <= static_cast<std::uint64_t>(capacity_) * 25U)
+				_resize(capacity_); // mostly deleted slots, drop them
+			else
+				_resize(capacity_ * 2U + 1U);
+		}
+		void _resize(size_type new_capacity) noexcept(false)
+		{
+			ctrl_t * old_ctrl = ctrl_;
+			Value * old_slots = slots_;
+			const size_type old_capacity = capacity_;
+
+			byte_type_ptr memory = reinterpret_cast<byte_type_ptr>(allocator_->allocate(_allocation_size(new_capacity)));
+			if (memory == nullptr)
+				throw std::bad_alloc();
+			ctrl_ = reinterpret_cast<ctrl_t*>(memory);
+			slots_ = reinterpret_cast<Value*>(memory + _slots_offset(new_capacity));
+			capacity_ = new_capacity;
+			_reset_ctrl();
+			growth_left_ = _capacity_to_growth(new_capacity) - size_;
+
+			for (size_type i = 0U; i < old_capacity; ++i)
+			{
+				if (_is_full(old_ctrl[i]))
+				{
+					const std::size_t hash = hash_(KeyOf::get(old_slots[i]));
+					size_type index = _find_first_non_full(hash);
+					_set_ctrl(index, _h2(hash));
+					new (slots_ + index) Value(utility::move(old_slots[i]));
+					old_slots[i].~Value();
+				}
+			}
+			if (old_capacity != 0U)
+				allocator_->free(reinterpret_cast<allocator::ptr_type>(old_ctrl), _allocation_size(old_capacity));
+		}
+		void _reset_ctrl() noexcept
+		{
+			std::memset(ctrl_, static_cast<unsigned char>(ctrl_empty), capacity_ + group_type::width);
+			ctrl_[capacity_] = ctrl_sentinel;
+		}
+		void _destroy_slots() noexcept
+		{
+			for (size_type i = 0U; i < capacity_; ++i)
+				if (_is_full(ctrl_[i]))
+					slots_[i].~Value();
+		}
+		void _clean() noexcept
+		{
+			if (capacity_ != 0U)
+			{
+				_destroy_slots();
+				allocator_->free(reinterpret_cast<allocator::ptr_type>(ctrl_), _allocation_size(capacity_));
+			}
+			ctrl_ = _empty_group();
+			slots_ = nullptr;
+			capacity_ = 0U;
+			size_ = 0U;
+			growth_left_ = 0U;
+		}
+		void _copy_from(const hash_table& other) noexcept(false)
+		{
+			reserve(other.size_);
+			// Keys are unique, so they are placed without lookup
+			for (size_type i = 0U; i < other.capacity_; ++i)
+			{
+				if (_is_full(other.ctrl_[i]))
+				{
+					const std::size_t hash = hash_(KeyOf::get(other.slots_[i]));
+					size_type index = _prepare_insert(hash);
+					new (slots_ + index) Value(other.slots_[i]);
+					_commit_insert(index, hash);
+				}
+			}
+		}
+
+		using byte_type_ptr = allocator::byte_type *;
+
+		ctrl_t * ctrl_;
+		Value * slots_;
+		allocator * allocator_;
+		size_type capacity_;
+		size_type size_;
+		size_type growth_left_; //!< number of empty slots that may be filled before rehash
+		Hash hash_;
+		KeyEqual equal_;
+	};
+
+} // namespace nostd
+
+#endif
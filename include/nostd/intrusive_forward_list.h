@@ -0,0 +1,297 @@
+#ifndef __NOSTD_INTRUSIVE_FORWARD_LIST_H__
+#define __NOSTD_INTRUSIVE_FORWARD_LIST_H__
+
+#include "allocator.h"
+#include "intrusive_hook.h"
+#include "utility.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace nostd {
+
+	/**
+	 * Defines intrusive singly linked list. Link is stored in forward_list_hook member of element,
+	 * so insertion and erasure don't allocate and element is reached without indirection.
+	 * List doesn't own elements: they should outlive their membership and stay at the same address.
+	 * Elements are unlinked on clear and destruction.
+	 * The last element links back to embedded sentinel, so linked hook is never null.
+	 * @see forward_list_hook
+	 * @see forward_list
+	 */
+	template <typename T, forward_list_hook T::*Hook>
+	class intrusive_forward_list {
+
+		using traits = intrusive_detail::hook_traits<T, forward_list_hook, Hook>;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Defines iterator class.
+		 */
+		class iterator {
+			friend class intrusive_forward_list;
+
+			explicit iterator(forward_list_hook * node) noexcept
+			: node_(node)
+			{
+			}
+		public:
+			iterator() noexcept
+			: node_(nullptr)
+			{
+			}
+			bool operator ==(const iterator& other) const noexcept
+			{
+				return node_ == other.node_;
+			}
+			bool operator !=(const iterator& other) const noexcept
+			{
+				return node_ != other.node_;
+			}
+			iterator& operator ++() noexcept // prefix increment
+			{
+				node_ = node_->next;
+				return *this;
+			}
+			iterator operator ++(int) noexcept // postfix increment
+			{
+				iterator it(*this);
+				node_ = node_->next;
+				return it;
+			}
+			T& operator *() const noexcept
+			{
+				return *traits::to_value(node_);
+			}
+			T* operator ->() const noexcept
+			{
+				return traits::to_value(node_);
+			}
+		private:
+			forward_list_hook * node_;
+		};
+
+		/**
+		 * Default constructor.
+		 */
+		intrusive_forward_list() noexcept
+		: size_(0U)
+		{
+			head_.next = &head_;
+		}
+
+		/**
+		 * Move constructor, elements are taken from other list.
+		 *
+		 * @param[in] other The other list.
+		 */
+		intrusive_forward_list(intrusive_forward_list && other) noexcept
+		: size_(0U)
+		{
+			head_.next = &head_;
+			_take(other);
+		}
+
+		/**
+		 * Destructor, elements are unlinked.
+		 */
+		~intrusive_forward_list()
+		{
+			clear();
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other list.
+		 */
+		intrusive_forward_list& operator =(intrusive_forward_list && other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				_take(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Checks if list is empty.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * Returns the first element.
+		 */
+		T& front() const noexcept(false)
+		{
+			if (empty())
+				throw std::range_error("Calling front() on an empty container.");
+			return *traits::to_value(head_.next);
+		}
+
+		/**
+		 * Returns iterator before the first element, it's used with insert_after and erase_after.
+		 */
+		iterator before_begin() noexcept
+		{
+			return iterator(&head_);
+		}
+
+		iterator begin() noexcept
+		{
+			return iterator(head_.next);
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(&head_);
+		}
+
+		/**
+		 * Returns iterator to element that is in this list.
+		 *
+		 * @param[in] value The element.
+		 */
+		iterator iterator_to(T& value) noexcept
+		{
+			return iterator(traits::to_hook(value));
+		}
+
+		/**
+		 * Links element at the beginning.
+		 *
+		 * @param[in] value The unlinked element.
+		 */
+		void push_front(T& value) noexcept
+		{
+			_link_after(&head_, traits::to_hook(value));
+		}
+
+		/**
+		 * Unlinks the first element.
+		 */
+		void pop_front() noexcept(false)
+		{
+			if (empty())
+				throw std::range_error("Calling pop_front() on an empty container.");
+			_unlink_after(&head_);
+		}
+
+		/**
+		 * Links element after position.
+		 *
+		 * @param[in] pos   The position, may be before_begin.
+		 * @param[in] value The unlinked element.
+		 *
+		 * @return Returns iterator to the element.
+		 */
+		iterator insert_after(iterator pos, T& value) noexcept
+		{
+			forward_list_hook * node = traits::to_hook(value);
+			_link_after(pos.node_, node);
+			return iterator(node);
+		}
+
+		/**
+		 * Unlinks element following position.
+		 *
+		 * @param[in] pos The position, may be before_begin.
+		 *
+		 * @return Returns iterator following the erased element.
+		 */
+		iterator erase_after(iterator pos) noexcept
+		{
+			_unlink_after(pos.node_);
+			return iterator(pos.node_->next);
+		}
+
+		/**
+		 * Unlinks all elements.
+		 */
+		void clear() noexcept
+		{
+			forward_list_hook * node = head_.next;
+			while (node != &head_)
+			{
+				forward_list_hook * next = node->next;
+				node->next = nullptr;
+				node = next;
+			}
+			head_.next = &head_;
+			size_ = 0U;
+		}
+
+		/**
+		 * Swaps elements of two lists.
+		 *
+		 * @param[in] other The other list.
+		 */
+		void swap(intrusive_forward_list& other) noexcept
+		{
+			intrusive_forward_list temp(utility::move(other));
+			other._take(*this);
+			_take(temp);
+		}
+
+	private:
+
+		/**
+		 * Disallow copy, element may be in a single list only
+		 */
+		intrusive_forward_list(const intrusive_forward_list&) = delete;
+		intrusive_forward_list& operator =(const intrusive_forward_list&) = delete;
+
+		void _link_after(forward_list_hook * prev, forward_list_hook * node) noexcept
+		{
+			assert(!node->linked() && "Element is already in a list");
+			node->next = prev->next;
+			prev->next = node;
+			++size_;
+		}
+		void _unlink_after(forward_list_hook * prev) noexcept
+		{
+			forward_list_hook * node = prev->next;
+			prev->next = node->next;
+			node->next = nullptr;
+			--size_;
+		}
+		/**
+		 * Takes elements of other list, this list should be empty.
+		 * The last element is relinked to this sentinel, so the chain is walked once.
+		 */
+		void _take(intrusive_forward_list& other) noexcept
+		{
+			if (other.empty())
+				return;
+			forward_list_hook * last = other.head_.next;
+			while (last->next != &other.head_)
+				last = last->next;
+			head_.next = other.head_.next;
+			last->next = &head_;
+			size_ = other.size_;
+			other.head_.next = &other.head_;
+			other.size_ = 0U;
+		}
+
+		forward_list_hook head_; //!< sentinel, its next is the first element
+		size_type size_;
+	};
+
+} // namespace nostd
+
+#endif
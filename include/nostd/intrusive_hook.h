@@ -0,0 +1,153 @@
+#ifndef __NOSTD_INTRUSIVE_HOOK_H__
+#define __NOSTD_INTRUSIVE_HOOK_H__
+
+#include "rb_tree.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Hook of intrusive doubly linked list, embedded into element.
+	 * Copy of hook is unlinked, so elements stay copyable.
+	 * @see intrusive_list
+	 */
+	struct list_hook {
+		list_hook * prev;
+		list_hook * next;
+
+		list_hook() noexcept
+		: prev(nullptr)
+		, next(nullptr)
+		{
+		}
+		list_hook(const list_hook&) noexcept
+		: prev(nullptr)
+		, next(nullptr)
+		{
+		}
+		list_hook& operator =(const list_hook&) noexcept
+		{
+			return *this;
+		}
+
+		/**
+		 * Checks if element is in a list.
+		 */
+		bool linked() const noexcept
+		{
+			return next != nullptr;
+		}
+	};
+
+	/**
+	 * Hook of intrusive singly linked list, embedded into element.
+	 * Copy of hook is unlinked, so elements stay copyable.
+	 * @see intrusive_forward_list
+	 */
+	struct forward_list_hook {
+		forward_list_hook * next;
+
+		forward_list_hook() noexcept
+		: next(nullptr)
+		{
+		}
+		forward_list_hook(const forward_list_hook&) noexcept
+		: next(nullptr)
+		{
+		}
+		forward_list_hook& operator =(const forward_list_hook&) noexcept
+		{
+			return *this;
+		}
+
+		/**
+		 * Checks if element is in a list.
+		 */
+		bool linked() const noexcept
+		{
+			return next != nullptr;
+		}
+	};
+
+	/**
+	 * Hook of intrusive red-black tree, embedded into element.
+	 * Links of unlinked hook are null, linked hook points to nil instead.
+	 * Copy of hook is unlinked, so elements stay copyable.
+	 * @see intrusive_set
+	 */
+	struct set_hook : public rb_node_base {
+		set_hook() noexcept
+		{
+			reset();
+		}
+		set_hook(const set_hook&) noexcept
+		: rb_node_base()
+		{
+			reset();
+		}
+		set_hook& operator =(const set_hook&) noexcept
+		{
+			return *this;
+		}
+
+		/**
+		 * Checks if element is in a tree.
+		 */
+		bool linked() const noexcept
+		{
+			return left != nullptr;
+		}
+
+		/**
+		 * Marks hook unlinked, used by containers.
+		 */
+		void reset() noexcept
+		{
+			parent_color = 0U;
+			left = nullptr;
+			right = nullptr;
+		}
+	};
+
+	/**
+	 * Helpers of intrusive containers, not for direct use.
+	 */
+	namespace intrusive_detail {
+
+		/**
+		 * Converts between element and its hook member.
+		 */
+		template <typename T, typename Hook, Hook T::*Member>
+		struct hook_traits {
+			/**
+			 * Returns offset of hook inside element.
+			 * Member pointers have no portable offsetof, so offset is taken on uninitialized storage.
+			 * Compilers fold it to a constant.
+			 */
+			static std::ptrdiff_t offset() noexcept
+			{
+				typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+				T * object = reinterpret_cast<T*>(&storage);
+				return reinterpret_cast<char*>(&(object->*Member)) - reinterpret_cast<char*>(object);
+			}
+			static Hook * to_hook(T& value) noexcept
+			{
+				return &(value.*Member);
+			}
+			static T * to_value(Hook * hook) noexcept
+			{
+				return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset());
+			}
+			static const T * to_value(const Hook * hook) noexcept
+			{
+				return reinterpret_cast<const T*>(reinterpret_cast<const char*>(hook) - offset());
+			}
+		};
+
+	} // namespace intrusive_detail
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,367 @@
+#ifndef __NOSTD_INTRUSIVE_LIST_H__
+#define __NOSTD_INTRUSIVE_LIST_H__
+
+#include "allocator.h"
+#include "intrusive_hook.h"
+#include "utility.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace nostd {
+
+	/**
+	 * Defines intrusive doubly linked list. Links are stored in list_hook member of element,
+	 * so insertion and erasure don't allocate and element is reached without indirection.
+	 * List doesn't own elements: they should outlive their membership and stay at the same address.
+	 * Element may be erased knowing only its address. Elements are unlinked on clear and destruction.
+	 * List is circular around embedded sentinel, so no operation checks for null.
+	 * @see list_hook
+	 * @see list
+	 */
+	template <typename T, list_hook T::*Hook>
+	class intrusive_list {
+
+		using traits = intrusive_detail::hook_traits<T, list_hook, Hook>;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Defines iterator class.
+		 */
+		class iterator {
+			friend class intrusive_list;
+
+			explicit iterator(list_hook * node) noexcept
+			: node_(node)
+			{
+			}
+		public:
+			iterator() noexcept
+			: node_(nullptr)
+			{
+			}
+			bool operator ==(const iterator& other) const noexcept
+			{
+				return node_ == other.node_;
+			}
+			bool operator !=(const iterator& other) const noexcept
+			{
+				return node_ != other.node_;
+			}
+			iterator& operator ++() noexcept // prefix increment
+			{
+				node_ = node_->next;
+				return *this;
+			}
+			iterator operator ++(int) noexcept // postfix increment
+			{
+				iterator it(*this);
+				node_ = node_->next;
+				return it;
+			}
+			iterator& operator --() noexcept // prefix decrement
+			{
+				node_ = node_->prev;
+				return *this;
+			}
+			iterator operator --(int) noexcept // postfix decrement
+			{
+				iterator it(*this);
+				node_ = node_->prev;
+				return it;
+			}
+			T& operator *() const noexcept
+			{
+				return *traits::to_value(node_);
+			}
+			T* operator ->() const noexcept
+			{
+				return traits::to_value(node_);
+			}
+		private:
+			list_hook * node_;
+		};
+
+		/**
+		 * Default constructor.
+		 */
+		intrusive_list() noexcept
+		: size_(0U)
+		{
+			_reset();
+		}
+
+		/**
+		 * Move constructor, elements are taken from other list.
+		 *
+		 * @param[in] other The other list.
+		 */
+		intrusive_list(intrusive_list && other) noexcept
+		: size_(0U)
+		{
+			_reset();
+			splice(end(), other);
+		}
+
+		/**
+		 * Destructor, elements are unlinked.
+		 */
+		~intrusive_list()
+		{
+			clear();
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other list.
+		 */
+		intrusive_list& operator =(intrusive_list && other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				splice(end(), other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Checks if list is empty.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * Returns the first element.
+		 */
+		T& front() const noexcept(false)
+		{
+			if (empty())
+				throw std::range_error("Calling front() on an empty container.");
+			return *traits::to_value(head_.next);
+		}
+
+		/**
+		 * Returns the last element.
+		 */
+		T& back() const noexcept(false)
+		{
+			if (empty())
+				throw std::range_error("Calling back() on an empty container.");
+			return *traits::to_value(head_.prev);
+		}
+
+		iterator begin() noexcept
+		{
+			return iterator(head_.next);
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(&head_);
+		}
+
+		/**
+		 * Returns iterator to element that is in this list.
+		 *
+		 * @param[in] value The element.
+		 */
+		iterator iterator_to(T& value) noexcept
+		{
+			return iterator(traits::to_hook(value));
+		}
+
+		/**
+		 * Links element at the beginning.
+		 *
+		 * @param[in] value The unlinked element.
+		 */
+		void push_front(T& value) noexcept
+		{
+			_link_before(head_.next, traits::to_hook(value));
+		}
+
+		/**
+		 * Links element at the end.
+		 *
+		 * @param[in] value The unlinked element.
+		 */
+		void push_back(T& value) noexcept
+		{
+			_link_before(&head_, traits::to_hook(value));
+		}
+
+		/**
+		 * Unlinks the first element.
+		 */
+		void pop_front() noexcept(false)
+		{
+			if (empty())
+				throw std::range_error("Calling pop_front() on an empty container.");
+			_unlink(head_.next);
+		}
+
+		/**
+		 * Unlinks the last element.
+		 */
+		void pop_back() noexcept(false)
+		{
+			if (empty())
+				throw std::range_error("Calling pop_back() on an empty container.");
+			_unlink(head_.prev);
+		}
+
+		/**
+		 * Links element before position.
+		 *
+		 * @param[in] pos   The position.
+		 * @param[in] value The unlinked element.
+		 *
+		 * @return Returns iterator to the element.
+		 */
+		iterator insert(iterator pos, T& value) noexcept
+		{
+			list_hook * node = traits::to_hook(value);
+			_link_before(pos.node_, node);
+			return iterator(node);
+		}
+
+		/**
+		 * Unlinks element at position.
+		 *
+		 * @param[in] pos The position.
+		 *
+		 * @return Returns iterator following the erased element.
+		 */
+		iterator erase(iterator pos) noexcept
+		{
+			list_hook * next = pos.node_->next;
+			_unlink(pos.node_);
+			return iterator(next);
+		}
+
+		/**
+		 * Unlinks element, that is in this list.
+		 *
+		 * @param[in] value The element.
+		 */
+		void erase(T& value) noexcept
+		{
+			_unlink(traits::to_hook(value));
+		}
+
+		/**
+		 * Unlinks all elements.
+		 */
+		void clear() noexcept
+		{
+			list_hook * node = head_.next;
+			while (node != &head_)
+			{
+				list_hook * next = node->next;
+				node->prev = node->next = nullptr;
+				node = next;
+			}
+			_reset();
+			size_ = 0U;
+		}
+
+		/**
+		 * Moves all elements of other list before position.
+		 *
+		 * @param[in] pos   The position.
+		 * @param[in] other The other list.
+		 */
+		void splice(iterator pos, intrusive_list& other) noexcept
+		{
+			if (&other == this || other.empty())
+				return;
+			list_hook * first = other.head_.next;
+			list_hook * last = other.head_.prev;
+			list_hook * next = pos.node_;
+			first->prev = next->prev;
+			next->prev->next = first;
+			last->next = next;
+			next->prev = last;
+			size_ += other.size_;
+			other._reset();
+			other.size_ = 0U;
+		}
+
+		/**
+		 * Moves element of other list before position.
+		 *
+		 * @param[in] pos   The position.
+		 * @param[in] other The other list.
+		 * @param[in] it    The element of other list.
+		 */
+		void splice(iterator pos, intrusive_list& other, iterator it) noexcept
+		{
+			if (pos == it || pos.node_ == it.node_->next)
+				return;
+			other._unlink(it.node_);
+			_link_before(pos.node_, it.node_);
+		}
+
+		/**
+		 * Swaps elements of two lists.
+		 *
+		 * @param[in] other The other list.
+		 */
+		void swap(intrusive_list& other) noexcept
+		{
+			intrusive_list temp(utility::move(other));
+			other.splice(other.end(), *this);
+			splice(end(), temp);
+		}
+
+	private:
+
+		/**
+		 * Disallow copy, element may be in a single list only
+		 */
+		intrusive_list(const intrusive_list&) = delete;
+		intrusive_list& operator =(const intrusive_list&) = delete;
+
+		void _reset() noexcept
+		{
+			head_.prev = head_.next = &head_;
+		}
+		void _link_before(list_hook * next, list_hook * node) noexcept
+		{
+			assert(!node->linked() && "Element is already in a list");
+			node->next = next;
+			node->prev = next->prev;
+			next->prev->next = node;
+			next->prev = node;
+			++size_;
+		}
+		void _unlink(list_hook * node) noexcept
+		{
+			node->prev->next = node->next;
+			node->next->prev = node->prev;
+			node->prev = node->next = nullptr;
+			--size_;
+		}
+
+		list_hook head_; //!< sentinel, its next is the first element and prev is the last one
+		size_type size_;
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,468 @@
+#ifndef __NOSTD_INTRUSIVE_SET_H__
+#define __NOSTD_INTRUSIVE_SET_H__
+
+#include "allocator.h"
+#include "functional.h"
+#include "intrusive_hook.h"
+#include "rb_tree.h"
+#include "utility.h"
+
+#include <cassert>
+
+namespace nostd {
+
+	/**
+	 * Defines intrusive ordered set. Implemented as red-black tree shared with map and set,
+	 * tree links are stored in set_hook member of element, so insertion and erasure don't allocate.
+	 * Set doesn't own elements: they should outlive their membership, stay at the same address
+	 * and keep their order while linked. Elements are unlinked on clear and destruction.
+	 * Elements are ordered by Compare, transparent Compare (like less<>) enables lookup by keys of other types.
+	 * Equivalent elements are allowed by insert_equal.
+	 * @see set_hook
+	 * @see set
+	 */
+	template <typename T, set_hook T::*Hook, typename Compare = less<T>>
+	class intrusive_set {
+
+		using traits = intrusive_detail::hook_traits<T, set_hook, Hook>;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Defines iterator class.
+		 */
+		class iterator {
+			friend class intrusive_set;
+
+			iterator(const rb_tree_header * header, rb_node_base * node) noexcept
+			: header_(header)
+			, node_(node)
+			{
+			}
+		public:
+			iterator() noexcept
+			: header_(nullptr)
+			, node_(nullptr)
+			{
+			}
+			bool operator ==(const iterator& other) const noexcept
+			{
+				return node_ == other.node_;
+			}
+			bool operator !=(const iterator& other) const noexcept
+			{
+				return node_ != other.node_;
+			}
+			iterator& operator ++() noexcept // prefix increment
+			{
+				node_ = rb_tree_successor(node_, header_);
+				return *this;
+			}
+			iterator operator ++(int) noexcept // postfix increment
+			{
+				iterator it(*this);
+				node_ = rb_tree_successor(node_, header_);
+				return it;
+			}
+			iterator& operator --() noexcept // prefix decrement
+			{
+				// End is nil, it steps to the last element
+				if (node_ == rb_tree_nil())
+					node_ = header_->rightmost;
+				else
+					node_ = rb_tree_predecessor(node_, header_);
+				return *this;
+			}
+			iterator operator --(int) noexcept // postfix decrement
+			{
+				iterator it(*this);
+				--(*this);
+				return it;
+			}
+			T& operator *() const noexcept
+			{
+				return *_value(node_);
+			}
+			T* operator ->() const noexcept
+			{
+				return _value(node_);
+			}
+		private:
+			const rb_tree_header * header_;
+			rb_node_base * node_;
+		};
+
+		/**
+		 * Default constructor.
+		 */
+		intrusive_set() noexcept
+		: size_(0U)
+		, compare_()
+		{
+			rb_tree_reset(&header_);
+		}
+
+		/**
+		 * Constructor with comparator.
+		 *
+		 * @param[in] compare The comparator of elements.
+		 */
+		explicit intrusive_set(const Compare& compare) noexcept
+		: size_(0U)
+		, compare_(compare)
+		{
+			rb_tree_reset(&header_);
+		}
+
+		/**
+		 * Move constructor, elements are taken from other set.
+		 *
+		 * @param[in] other The other set.
+		 */
+		intrusive_set(intrusive_set && other) noexcept
+		: size_(other.size_)
+		, compare_(other.compare_)
+		{
+			rb_tree_reset(&header_);
+			rb_tree_move(&header_, &other.header_);
+			other.size_ = 0U;
+		}
+
+		/**
+		 * Destructor, elements are unlinked.
+		 */
+		~intrusive_set()
+		{
+			clear();
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other set.
+		 */
+		intrusive_set& operator =(intrusive_set && other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				rb_tree_move(&header_, &other.header_);
+				compare_ = other.compare_;
+				size_ = other.size_;
+				other.size_ = 0U;
+			}
+			return *this;
+		}
+
+		/**
+		 * Checks if set is empty.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		iterator begin() noexcept
+		{
+			return iterator(&header_, header_.leftmost);
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(&header_, rb_tree_nil());
+		}
+
+		/**
+		 * Returns iterator to element that is in this set.
+		 *
+		 * @param[in] value The element.
+		 */
+		iterator iterator_to(T& value) noexcept
+		{
+			return iterator(&header_, traits::to_hook(value));
+		}
+
+		/**
+		 * Links element if there is no equivalent one.
+		 *
+		 * @param[in] value The unlinked element.
+		 *
+		 * @return Returns iterator to the element or to the equivalent one and true if element was linked.
+		 */
+		utility::pair<iterator, bool> insert(T& value) noexcept
+		{
+			set_hook * node = traits::to_hook(value);
+			assert(!node->linked() && "Element is already in a set");
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * y = &header_;
+			rb_node_base * x = header_.left;
+			rb_node_base * candidate = nil; /* the last node not greater than value */
+			bool left = true; /* the root is the left child of header */
+			while (x != nil) {
+				y = x;
+				left = compare_(value, *_value(x));
+				if (left) {
+					x = x->left;
+				} else {
+					candidate = x;
+					x = x->right;
+				}
+			}
+			if (candidate != nil && !compare_(*_value(candidate), value))
+				return utility::pair<iterator, bool>(iterator(&header_, candidate), false);
+			rb_tree_insert(node, y, left, &header_);
+			++size_;
+			return utility::pair<iterator, bool>(iterator(&header_, node), true);
+		}
+
+		/**
+		 * Links element after equivalent ones.
+		 *
+		 * @param[in] value The unlinked element.
+		 *
+		 * @return Returns iterator to the element.
+		 */
+		iterator insert_equal(T& value) noexcept
+		{
+			set_hook * node = traits::to_hook(value);
+			assert(!node->linked() && "Element is already in a set");
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * y = &header_;
+			rb_node_base * x = header_.left;
+			bool left = true;
+			while (x != nil) {
+				y = x;
+				left = compare_(value, *_value(x));
+				x = left ? x->left : x->right;
+			}
+			rb_tree_insert(node, y, left, &header_);
+			++size_;
+			return iterator(&header_, node);
+		}
+
+		/**
+		 * Unlinks element at position.
+		 *
+		 * @param[in] pos The position.
+		 *
+		 * @return Returns iterator following the erased element.
+		 */
+		iterator erase(iterator pos) noexcept
+		{
+			rb_node_base * next = rb_tree_successor(pos.node_, &header_);
+			_unlink(pos.node_);
+			return iterator(&header_, next);
+		}
+
+		/**
+		 * Unlinks element, that is in this set.
+		 *
+		 * @param[in] value The element.
+		 */
+		void erase(T& value) noexcept
+		{
+			_unlink(traits::to_hook(value));
+		}
+
+		/**
+		 * Unlinks all elements.
+		 */
+		void clear() noexcept
+		{
+			_unlink_tree(header_.left);
+			rb_tree_reset(&header_);
+			size_ = 0U;
+		}
+
+		/**
+		 * Swaps elements of two sets.
+		 *
+		 * @param[in] other The other set.
+		 */
+		void swap(intrusive_set& other) noexcept
+		{
+			rb_tree_swap(&header_, &other.header_);
+			utility::swap(size_, other.size_);
+			utility::swap(compare_, other.compare_);
+		}
+
+		/**
+		 * Finds element equivalent to key.
+		 *
+		 * @param[in] key The key.
+		 *
+		 * @return Returns iterator to the element or end if there is no such element.
+		 */
+		iterator find(const T& key) noexcept
+		{
+			return iterator(&header_, _search(key));
+		}
+
+		/**
+		 * Finds element equivalent to key of other type, Compare should be transparent.
+		 * @see find(const T&)
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K& key) noexcept
+		{
+			return iterator(&header_, _search(key));
+		}
+
+		/**
+		 * Checks if set contains element equivalent to key.
+		 *
+		 * @param[in] key The key.
+		 */
+		bool contains(const T& key) const noexcept
+		{
+			return _search(key) != rb_tree_nil();
+		}
+
+		/**
+		 * Checks if set contains element equivalent to key of other type, Compare should be transparent.
+		 * @see contains(const T&)
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		bool contains(const K& key) const noexcept
+		{
+			return _search(key) != rb_tree_nil();
+		}
+
+		/**
+		 * Returns iterator to the first element not less than key.
+		 *
+		 * @param[in] key The key.
+		 */
+		iterator lower_bound(const T& key) noexcept
+		{
+			return iterator(&header_, _lower_bound(key));
+		}
+
+		/**
+		 * Returns iterator to the first element not less than key of other type, Compare should be transparent.
+		 * @see lower_bound(const T&)
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K& key) noexcept
+		{
+			return iterator(&header_, _lower_bound(key));
+		}
+
+		/**
+		 * Returns iterator to the first element greater than key.
+		 *
+		 * @param[in] key The key.
+		 */
+		iterator upper_bound(const T& key) noexcept
+		{
+			return iterator(&header_, _upper_bound(key));
+		}
+
+		/**
+		 * Returns iterator to the first element greater than key of other type, Compare should be transparent.
+		 * @see upper_bound(const T&)
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K& key) noexcept
+		{
+			return iterator(&header_, _upper_bound(key));
+		}
+
+	private:
+
+		/**
+		 * Disallow copy, element may be in a single set only
+		 */
+		intrusive_set(const intrusive_set&) = delete;
+		intrusive_set& operator =(const intrusive_set&) = delete;
+
+		static T * _value(rb_node_base * x) noexcept
+		{
+			return traits::to_value(static_cast<set_hook*>(x));
+		}
+		static const T * _value(const rb_node_base * x) noexcept
+		{
+			return traits::to_value(static_cast<const set_hook*>(x));
+		}
+
+		template <typename K>
+		rb_node_base * _search(const K& key) const noexcept
+		{
+			// The lowest node not less than key, one comparison per level
+			rb_node_base * candidate = _lower_bound(key);
+			if (candidate != rb_tree_nil() && compare_(key, *_value(candidate)))
+				return rb_tree_nil();
+			return candidate;
+		}
+
+		template <typename K>
+		rb_node_base * _lower_bound(const K& key) const noexcept
+		{
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * x = header_.left;
+			rb_node_base * result = nil;
+			while (x != nil) {
+				if (!compare_(*_value(x), key)) {
+					result = x;
+					x = x->left;
+				} else {
+					x = x->right;
+				}
+			}
+			return result;
+		}
+
+		template <typename K>
+		rb_node_base * _upper_bound(const K& key) const noexcept
+		{
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * x = header_.left;
+			rb_node_base * result = nil;
+			while (x != nil) {
+				if (compare_(key, *_value(x))) {
+					result = x;
+					x = x->left;
+				} else {
+					x = x->right;
+				}
+			}
+			return result;
+		}
+
+		void _unlink(rb_node_base * x) noexcept
+		{
+			rb_tree_erase(x, &header_);
+			static_cast<set_hook*>(x)->reset();
+			--size_;
+		}
+
+		static void _unlink_tree(rb_node_base * x) noexcept
+		{
+			// Depth of red-black tree is logarithmic, so recursion is bounded
+			rb_node_base * nil = rb_tree_nil();
+			while (x != nil) {
+				_unlink_tree(x->right);
+				rb_node_base * left = x->left;
+				static_cast<set_hook*>(x)->reset();
+				x = left;
+			}
+		}
+
+		rb_tree_header header_; // parent of the root
+		size_type size_;
+		Compare compare_;
+	};
+
+} // namespace nostd
+
+#endif
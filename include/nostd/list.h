@@ -2,8 +2,11 @@
 #define __NOSTD_LIST_H__
 
 #include "default_allocator.h"
+#include "node_batch.h"
+#include "node_handle.h"
 #include "utility.h"
 
+#include <new>
 #include <stdexcept>
 
 namespace nostd {
@@ -12,8 +15,9 @@ namespace nostd {
 	 * Defines list container. Implemented as double linked list.
 	 * Move semantics should be defined for used type.
 	 * If no allocator is provided, default new/delete allocation/deallocation routine is used.
+	 * Allocator may be a concrete allocator type (like pool_allocator), so node allocation calls are resolved at compile time.
 	 */
-	template <typename T>
+	template <typename T, typename Allocator = allocator>
 	class list {
 
 		/**
@@ -128,6 +132,7 @@ namespace nostd {
 	public:
 
 		using size_type = allocator::size_type;
+		using node_type = node_handle<list, node_t, T, Allocator>; //!< owner of extracted node
 
 		/**
 		 * Default constructor.
@@ -145,7 +150,7 @@ namespace nostd {
 		 * 
 		 * @param[in] alloc The allocator to be used to allocate nodes.
 		 */
-		list(allocator * alloc) noexcept
+		list(Allocator * alloc) noexcept
 		: head_(nullptr)
 		, tail_(nullptr)
 		, allocator_(alloc)
@@ -178,7 +183,7 @@ namespace nostd {
 		, allocator_(nullptr)
 		, size_(0U)
 		{
-			_set_by_move(utility::forward(other));
+			_set_by_move(utility::move(other));
 		}
 
 		/**
@@ -207,7 +212,7 @@ namespace nostd {
 		 */
 		list& operator =(list && other) noexcept
 		{
-			_set_by_move(utility::forward(other));
+			_set_by_move(utility::move(other));
 			return *this;
 		}
 
@@ -287,15 +292,52 @@ namespace nostd {
 
 		/**
 		 * Clears list.
-		 * Data move constructor is used for data destruction.
 		 */
 		void clear() noexcept
 		{
-			while (size_ != 0U)
+			// Nodes are returned to allocator in batches
+			node_release_batch<Allocator> release(allocator_, sizeof(node_t));
+			node_t * node = head_;
+			while (node != nullptr)
 			{
-				T data(utility::move(front()));
-				pop_front();
+				node_t * next = node->next;
+				node->data.~T();
+				release.add(reinterpret_cast<allocator::ptr_type>(node));
+				node = next;
 			}
+			head_ = nullptr;
+			tail_ = nullptr;
+			size_ = 0U;
+		}
+
+		/**
+		 * Constructs element in place at the beginning of the list.
+		 * 
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_front(Args&&... args) noexcept(false)
+		{
+			node_t * node = _create_node(utility::forward<Args>(args)...);
+			_link_before(head_, node);
+			return node->data;
+		}
+
+		/**
+		 * Constructs element in place at the end of the list.
+		 * 
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_back(Args&&... args) noexcept(false)
+		{
+			node_t * node = _create_node(utility::forward<Args>(args)...);
+			_link_before(nullptr, node);
+			return node->data;
 		}
 
 		/**
@@ -306,18 +348,7 @@ namespace nostd {
 		 */
 		void push_front(const T& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = data;
-			node->prev = nullptr;
-			node->next = head_;
-			if (node->next)
-				node->next->prev = node;
-			head_ = node;
-			if (tail_ == nullptr)
-				tail_ = node;
-			++size_;
+			emplace_front(data);
 		}
 
 		/**
@@ -328,18 +359,7 @@ namespace nostd {
 		 */
 		void push_front(T&& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = utility::move(data);
-			node->prev = nullptr;
-			node->next = head_;
-			if (node->next)
-				node->next->prev = node;
-			head_ = node;
-			if (tail_ == nullptr)
-				tail_ = node;
-			++size_;
+			emplace_front(utility::move(data));
 		}
 
 		/**
@@ -350,18 +370,7 @@ namespace nostd {
 		 */
 		void push_back(const T& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = data;
-			node->prev = tail_;
-			node->next = nullptr;
-			if (node->prev)
-				node->prev->next = node;
-			if (head_ == nullptr)
-				head_ = node;
-			tail_ = node;
-			++size_;
+			emplace_back(data);
 		}
 
 		/**
@@ -372,18 +381,7 @@ namespace nostd {
 		 */
 		void push_back(T&& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = utility::move(data);
-			node->prev = tail_;
-			node->next = nullptr;
-			if (node->prev)
-				node->prev->next = node;
-			if (head_ == nullptr)
-				head_ = node;
-			tail_ = node;
-			++size_;
+			emplace_back(utility::move(data));
 		}
 
 		/**
@@ -400,7 +398,7 @@ namespace nostd {
 				if (tail_ == node)
 					tail_ = nullptr;
 				--size_;
-				_free_node(node);
+				_destroy_node(node);
 			}
 		}
 
@@ -418,7 +416,7 @@ namespace nostd {
 				if (head_ == node)
 					head_ = nullptr;
 				--size_;
-				_free_node(node);
+				_destroy_node(node);
 			}
 		}
 
@@ -435,6 +433,22 @@ namespace nostd {
 			utility::swap(allocator_, other.allocator_);
 		}
 
+		/**
+		 * Constructs element in place before the selected position.
+		 * 
+		 * @param[in] pos  The position to insert before.
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns iterator to the new element.
+		 */
+		template <typename... Args>
+		iterator emplace(iterator pos, Args&&... args) noexcept(false)
+		{
+			node_t * node = _create_node(utility::forward<Args>(args)...);
+			_link_before(pos.node_, node);
+			return iterator(node);
+		}
+
 		/**
 		 * Inserts element before the selected position.
 		 * 
@@ -443,24 +457,19 @@ namespace nostd {
 		 */
 		void insert(iterator pos, const T& data) noexcept(false)
 		{
-			if (pos.node_ == nullptr)
-			{
-				push_back(data);
-				return;
-			}
+			emplace(pos, data);
+		}
 
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = data;
-			node->prev = pos.node_->prev;
-			node->next = pos.node_;
-			if (pos.node_->prev != nullptr)
-				pos.node_->prev->next = node;
-			pos.node_->prev = node;
-			if (pos.node_ == head_)
-				head_ = node;
-			++size_;
+		/**
+		 * Inserts element before the selected position.
+		 * Version that moves data.
+		 * 
+		 * @param[in] pos  The position to insert before.
+		 * @param[in] data The data to insert.
+		 */
+		void insert(iterator pos, T&& data) noexcept(false)
+		{
+			emplace(pos, utility::move(data));
 		}
 
 		/**
@@ -477,16 +486,8 @@ namespace nostd {
 				return iterator(nullptr);
 
 			iterator next_iterator(node->next);
-			if (node->prev)
-				node->prev->next = node->next;
-			if (node->next)
-				node->next->prev = node->prev;
-			if (head_ == node)
-				head_ = node->next;
-			if (tail_ == node)
-				tail_ = node->prev;
-			_free_node(node);
-			--size_;
+			_unlink(node);
+			_destroy_node(node);
 			return next_iterator;
 		}
 
@@ -545,15 +546,210 @@ namespace nostd {
 			return iterator(nullptr);
 		}
 
+		/**
+		 * Unlinks element from the list and returns it as node handle.
+		 * The node isn't freed, so it may be inserted into another list.
+		 * 
+		 * @param[in] pos  The position of element.
+		 * 
+		 * @return Returns handle owning the node or empty handle for the end.
+		 */
+		node_type extract(iterator pos) noexcept
+		{
+			node_t * node = pos.node_;
+			if (node == nullptr)
+				return node_type();
+			_unlink(node);
+			return node_type(node, allocator_);
+		}
+
+		/**
+		 * Inserts node owned by handle before the selected position.
+		 * Node is linked as is if it has been allocated with the allocator of this list,
+		 * otherwise its value is moved to a new node.
+		 * 
+		 * @param[in] pos  The position to insert before.
+		 * @param[in] node The node handle, it's empty after insertion.
+		 * 
+		 * @return Returns iterator to inserted element or the end if handle is empty.
+		 */
+		iterator insert(iterator pos, node_type && node) noexcept(false)
+		{
+			if (node.empty())
+				return end();
+			node_t * x;
+			if (node.allocator_ == allocator_)
+				x = node._release();
+			else
+			{
+				x = _create_node(utility::move(node.node_->data));
+				node._clean();
+			}
+			_link_before(pos.node_, x);
+			return iterator(x);
+		}
+
+		/**
+		 * Moves all elements of other list before the selected position.
+		 * Nodes are relinked in constant time if lists share the allocator.
+		 * 
+		 * @param[in] pos   The position to insert before.
+		 * @param[in] other The list to take elements from.
+		 */
+		void splice(iterator pos, list& other) noexcept(false)
+		{
+			if (&other == this || other.head_ == nullptr)
+				return;
+			if (other.allocator_ != allocator_)
+			{
+				splice(pos, other, other.begin(), other.end());
+				return;
+			}
+			// Size of other list is known, so the whole chain is taken without walking it
+			node_t * head = other.head_;
+			node_t * tail = other.tail_;
+			const size_type count = other.size_;
+			other.head_ = nullptr;
+			other.tail_ = nullptr;
+			other.size_ = 0U;
+			_link_chain_before(pos.node_, head, tail, count);
+		}
+
+		/**
+		 * Moves single element of other list before the selected position.
+		 * Other list may be this list.
+		 * 
+		 * @param[in] pos   The position to insert before.
+		 * @param[in] other The list to take element from.
+		 * @param[in] it    The element to move.
+		 */
+		void splice(iterator pos, list& other, iterator it) noexcept(false)
+		{
+			if (it.node_ == nullptr || pos.node_ == it.node_ || pos.node_ == it.node_->next)
+				return;
+			splice(pos, other, it, iterator(it.node_->next));
+		}
+
+		/**
+		 * Moves range [first, last) of other list before the selected position.
+		 * Other list may be this list, then position should be out of the range.
+		 * Nodes are relinked if lists share the allocator, only the range is walked to count it.
+		 * 
+		 * @param[in] pos   The position to insert before.
+		 * @param[in] other The list to take elements from.
+		 * @param[in] first The first element to move.
+		 * @param[in] last  The element after the last one to move.
+		 */
+		void splice(iterator pos, list& other, iterator first, iterator last) noexcept(false)
+		{
+			if (first.node_ == last.node_)
+				return;
+			if (other.allocator_ != allocator_)
+			{
+				// Nodes can't change allocator, so values are moved to new nodes
+				node_t * node = first.node_;
+				while (node != last.node_)
+				{
+					node_t * next = node->next;
+					_link_before(pos.node_, _create_node(utility::move(node->data)));
+					other._unlink(node);
+					other._destroy_node(node);
+					node = next;
+				}
+				return;
+			}
+			node_t * head = first.node_;
+			node_t * tail = (last.node_ != nullptr) ? last.node_->prev : other.tail_;
+			size_type count = 1U;
+			for (node_t * node = head; node != tail; node = node->next)
+				++count;
+			// Cut the chain out of other list
+			if (head->prev != nullptr)
+				head->prev->next = last.node_;
+			else
+				other.head_ = last.node_;
+			if (last.node_ != nullptr)
+				last.node_->prev = head->prev;
+			else
+				other.tail_ = head->prev;
+			other.size_ -= count;
+			_link_chain_before(pos.node_, head, tail, count);
+		}
+
 	private:
 
+		void _link_chain_before(node_t * pos, node_t * head, node_t * tail, size_type count) noexcept
+		{
+			node_t * prev = (pos != nullptr) ? pos->prev : tail_;
+			head->prev = prev;
+			tail->next = pos;
+			if (prev != nullptr)
+				prev->next = head;
+			else
+				head_ = head;
+			if (pos != nullptr)
+				pos->prev = tail;
+			else
+				tail_ = tail;
+			size_ += count;
+		}
+
 		node_t * _allocate_node() noexcept(false)
 		{
 			return reinterpret_cast<node_t*>(allocator_->allocate(sizeof(node_t)));
 		}
 		void _free_node(node_t * node) noexcept
 		{
-			allocator_->free(reinterpret_cast<allocator::ptr_type>(node));
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(node), sizeof(node_t));
+		}
+		template <typename... Args>
+		node_t * _create_node(Args&&... args) noexcept(false)
+		{
+			node_t * node = _allocate_node();
+			if (node == nullptr)
+				throw std::bad_alloc();
+			try
+			{
+				new (&node->data) T(utility::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				_free_node(node);
+				throw;
+			}
+			return node;
+		}
+		void _destroy_node(node_t * node) noexcept
+		{
+			node->data.~T();
+			_free_node(node);
+		}
+		void _link_before(node_t * pos, node_t * node) noexcept
+		{
+			// Null position is the end
+			node->next = pos;
+			node->prev = (pos != nullptr) ? pos->prev : tail_;
+			if (node->prev != nullptr)
+				node->prev->next = node;
+			else
+				head_ = node;
+			if (pos != nullptr)
+				pos->prev = node;
+			else
+				tail_ = node;
+			++size_;
+		}
+		void _unlink(node_t * node) noexcept
+		{
+			if (node->prev != nullptr)
+				node->prev->next = node->next;
+			else
+				head_ = node->next;
+			if (node->next != nullptr)
+				node->next->prev = node->prev;
+			else
+				tail_ = node->prev;
+			--size_;
 		}
 		void _clean() noexcept
 		{
@@ -567,12 +763,23 @@ namespace nostd {
 			allocator_ = other.allocator_;
 			size_ = 0U;
 
-			// Copy other list nodes
-			node_t * other_node = other.head_;
-			while (other_node != nullptr)
+			if (other.size_ == 0U)
+				return;
+			// Copy other list nodes, storage is allocated in batches
+			node_allocation_batch<Allocator> batch(allocator_, sizeof(node_t), other.size_);
+			for (node_t * other_node = other.head_; other_node != nullptr; other_node = other_node->next)
 			{
-				push_back(other_node->data);
-				other_node = other_node->next;
+				node_t * node = reinterpret_cast<node_t*>(batch.next());
+				try
+				{
+					new (&node->data) T(other_node->data);
+				}
+				catch (...)
+				{
+					_free_node(node);
+					throw;
+				}
+				_link_before(nullptr, node);
 			}
 		}
 		void _set_by_move(list && other) noexcept
@@ -592,7 +799,7 @@ namespace nostd {
 
 		node_t * head_;
 		node_t * tail_;
-		allocator * allocator_;
+		Allocator * allocator_;
 		size_type size_;
 	};
 
@@ -0,0 +1,166 @@
+#ifndef __NOSTD_MONOTONIC_ARENA_H__
+#define __NOSTD_MONOTONIC_ARENA_H__
+
+#include "allocator.h"
+
+namespace nostd {
+
+	/**
+	 * Monotonic arena allocator.
+	 * Allocates memory blocks by bumping a pointer through a growing list of chunks.
+	 * Releasing a single block is a no-op, all memory is dropped at once via reset or release.
+	 * Useful for short-lived containers that are destroyed together.
+	 */
+	class monotonic_arena final
+	: public allocator
+	{
+
+		/**
+		 * Structure that is placed at the beginning of every chunk
+		 */
+		struct chunk_t {
+			chunk_t * next;
+			size_type size; // total size of chunk including this header
+		};
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] chunk_size Size of the first chunk, next chunks grow geometrically
+		 */
+		monotonic_arena(size_type chunk_size) noexcept;
+
+		/**
+		 * Constructor with upstream allocator
+		 *
+		 * @param[in] chunk_size Size of the first chunk, next chunks grow geometrically
+		 * @param[in] upstream   The allocator to be used to allocate chunks
+		 */
+		monotonic_arena(size_type chunk_size, allocator * upstream) noexcept;
+
+		/**
+		 * Constructor with initial buffer.
+		 * The buffer is used before any chunk is allocated and is never freed by arena.
+		 *
+		 * @param[in] buffer      Caller-supplied buffer
+		 * @param[in] buffer_size Size of the buffer
+		 */
+		monotonic_arena(void * buffer, size_type buffer_size) noexcept;
+
+		/**
+		 * Constructor with initial buffer and upstream allocator.
+		 * The buffer is used before any chunk is allocated and is never freed by arena.
+		 *
+		 * @param[in] buffer      Caller-supplied buffer
+		 * @param[in] buffer_size Size of the buffer
+		 * @param[in] upstream    The allocator to be used to allocate chunks
+		 */
+		monotonic_arena(void * buffer, size_type buffer_size, allocator * upstream) noexcept;
+
+		/**
+		 * Copy constructor.
+		 * Creates an empty arena with the same settings, initial buffer is not shared.
+		 *
+		 * @param[in] other Other allocator.
+		 */
+		monotonic_arena(const monotonic_arena& other) noexcept;
+
+		/**
+		 * Move constructor
+		 *
+		 * @param[in] other Other allocator.
+		 */
+		monotonic_arena(monotonic_arena&& other) noexcept;
+
+		/**
+		 * Destructor
+		 */
+		~monotonic_arena();
+
+		/**
+		 * Allocates block of memory
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		ptr_type allocate(size_type size) noexcept(false) final;
+
+		/**
+		 * Does nothing, memory is released via reset or release
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void free(ptr_type ptr) noexcept final;
+
+		/**
+		 * Releases block of memory.
+		 * Memory is reused only if the block was the last allocated one.
+		 *
+		 * @param[in] ptr  Pointer to block of memory
+		 * @param[in] size Size that was passed to allocate
+		 */
+		void free(ptr_type ptr, size_type size) noexcept final;
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Succeeds if the block is the last allocated one and the chunk has enough space.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final;
+
+		/**
+		 * Makes all allocated memory available again.
+		 * Chunks are kept for reuse. Complexity is O(chunks).
+		 */
+		void reset() noexcept;
+
+		/**
+		 * Returns all chunks to upstream allocator.
+		 * Complexity is O(chunks).
+		 */
+		void release() noexcept;
+
+		/**
+		 * Returns number of allocated chunks
+		 */
+		size_type num_chunks() const noexcept;
+
+		/**
+		 * Alignment of every block returned by allocate
+		 */
+		static const size_type alignment;
+
+	private:
+
+		/**
+		 * Disallow default constructor
+		 */
+		monotonic_arena() = delete;
+
+		monotonic_arena(void * buffer, size_type buffer_size, size_type chunk_size, allocator * upstream) noexcept;
+
+		void _rewind() noexcept;
+		void _next_chunk(size_type size) noexcept(false);
+		chunk_t * _allocate_chunk(size_type size) noexcept(false);
+		static size_type _header_size() noexcept;
+
+		allocator * upstream_;
+		byte_type * initial_buffer_;
+		size_type initial_size_;
+		size_type initial_chunk_size_;
+		size_type next_chunk_size_;
+		chunk_t * head_;    //!< first owned chunk
+		chunk_t * current_; //!< chunk being used or nullptr when using initial buffer
+		byte_type * ptr_;   //!< current position
+		byte_type * end_;   //!< end of current region
+	};
+
+} // namespace nostd
+
+#endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#ifndef __NOSTD_MPMC_QUEUE_H__
+#define __NOSTD_MPMC_QUEUE_H__
+
+#include "default_allocator.h"
+#include "utility.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Bounded lock-free multi-producer multi-consumer queue on ring buffer.
+	 * Every slot has a sequence number, that tells whether slot is ready for push or pop
+	 * on the current lap (D. Vyukov's algorithm). So producers and consumers synchronize
+	 * through the slot only and contend on a single position counter each.
+	 * Positions are kept on separate cache lines to avoid false sharing.
+	 * Capacity is rounded up to power of two. Storage is allocated once in constructor.
+	 * Move constructor and move assignment of element type should not throw.
+	 */
+	template <typename T>
+	class mpmc_queue {
+
+		/**
+		 * Defines ring buffer slot.
+		 */
+		struct slot_t {
+			std::atomic<std::size_t> sequence;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param[in] capacity The minimal number of elements queue holds.
+		 */
+		explicit mpmc_queue(size_type capacity) noexcept(false)
+		: mpmc_queue(capacity, default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] capacity The minimal number of elements queue holds.
+		 * @param[in] alloc    The allocator to be used to allocate slots.
+		 */
+		mpmc_queue(size_type capacity, allocator * alloc) noexcept(false)
+		: buffer_(nullptr)
+		, allocator_(alloc)
+		, mask_(_round_capacity(capacity) - 1U)
+		, enqueue_pos_(0U)
+		, dequeue_pos_(0U)
+		{
+			buffer_ = reinterpret_cast<slot_t*>(allocator_->allocate(sizeof(slot_t) * (mask_ + 1U)));
+			if (buffer_ == nullptr)
+				throw std::bad_alloc();
+			for (std::size_t i = 0U; i <= mask_; ++i)
+				new (&buffer_[i].sequence) std::atomic<std::size_t>(i);
+		}
+
+		/**
+		 * Destructor.
+		 * Remaining elements are destroyed, no thread should use queue at that moment.
+		 */
+		~mpmc_queue()
+		{
+			std::size_t position = dequeue_pos_.load(std::memory_order_relaxed);
+			const std::size_t end = enqueue_pos_.load(std::memory_order_relaxed);
+			for (; position != end; ++position)
+				_value(buffer_[position & mask_]).~T();
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(buffer_), sizeof(slot_t) * (mask_ + 1U));
+		}
+
+		/**
+		 * Constructs element in place at the tail of the queue if there is free slot.
+		 *
+		 * @param[in] args The arguments to construct element from.
+		 *
+		 * @return Returns true if element has been pushed and false if queue is full.
+		 */
+		template <typename... Args>
+		bool try_emplace(Args&&... args) noexcept(false)
+		{
+			return _emplace(std::integral_constant<bool, std::is_nothrow_constructible<T, Args&&...>::value>(),
+				utility::forward<Args>(args)...);
+		}
+
+		/**
+		 * Pushes data to the tail of the queue if there is free slot.
+		 * Version that copies data.
+		 *
+		 * @param[in] data The data.
+		 *
+		 * @return Returns true if element has been pushed and false if queue is full.
+		 */
+		bool try_push(const T& data) noexcept(false)
+		{
+			return try_emplace(data);
+		}
+
+		/**
+		 * Pushes data to the tail of the queue if there is free slot.
+		 * Version that moves data.
+		 *
+		 * @param[in] data The data.
+		 *
+		 * @return Returns true if element has been pushed and false if queue is full.
+		 */
+		bool try_push(T&& data) noexcept(false)
+		{
+			return try_emplace(utility::move(data));
+		}
+
+		/**
+		 * Pops element from the head of the queue if there is any.
+		 * Element is moved to data.
+		 *
+		 * @param[out] data The data to move element to.
+		 *
+		 * @return Returns true if element has been popped and false if queue is empty.
+		 */
+		bool try_pop(T& data) noexcept
+		{
+			slot_t * slot;
+			std::size_t position = dequeue_pos_.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				slot = &buffer_[position & mask_];
+				const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1U);
+				if (difference == 0)
+				{
+					// Slot is filled on this lap, try to claim it
+					if (dequeue_pos_.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false; // slot isn't filled yet
+				else
+					position = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+			T& value = _value(*slot);
+			data = utility::move(value);
+			value.~T();
+			// Slot becomes free for the next lap
+			slot->sequence.store(position + mask_ + 1U, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * Returns approximate number of elements, it may be outdated when used concurrently.
+		 *
+		 * @return Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			const std::size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+			const std::size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+			return (tail > head) ? static_cast<size_type>(tail - head) : 0U;
+		}
+
+		/**
+		 * Checks if queue is empty, result may be outdated when used concurrently.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return size() == 0U;
+		}
+
+		/**
+		 * Returns maximum number of elements.
+		 *
+		 * @return Returns queue capacity.
+		 */
+		size_type capacity() const noexcept
+		{
+			return static_cast<size_type>(mask_ + 1U);
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		mpmc_queue(const mpmc_queue&) = delete;
+		mpmc_queue& operator =(const mpmc_queue&) = delete;
+
+		template <typename... Args>
+		bool _emplace(std::true_type, Args&&... args) noexcept
+		{
+			// Construction can't fail, so element is constructed right in the slot
+			std::size_t position;
+			slot_t * slot = _claim(position);
+			if (slot == nullptr)
+				return false;
+			new (slot->storage) T(utility::forward<Args>(args)...);
+			slot->sequence.store(position + 1U, std::memory_order_release);
+			return true;
+		}
+		template <typename... Args>
+		bool _emplace(std::false_type, Args&&... args) noexcept(false)
+		{
+			// Claimed slot can't be given back, so throwing construction is done beforehand
+			T value(utility::forward<Args>(args)...);
+			std::size_t position;
+			slot_t * slot = _claim(position);
+			if (slot == nullptr)
+				return false;
+			new (slot->storage) T(utility::move(value));
+			slot->sequence.store(position + 1U, std::memory_order_release);
+			return true;
+		}
+		slot_t * _claim(std::size_t& position) noexcept
+		{
+			position = enqueue_pos_.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				slot_t * slot = &buffer_[position & mask_];
+				const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+				if (difference == 0)
+				{
+					// Slot is free on this lap, try to claim it
+					if (enqueue_pos_.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+						return slot;
+				}
+				else if (difference < 0)
+					return nullptr; // slot still holds element of the previous lap
+				else
+					position = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+		static T& _value(slot_t& slot) noexcept
+		{
+			return *reinterpret_cast<T*>(slot.storage);
+		}
+		static std::size_t _round_capacity(size_type capacity) noexcept
+		{
+			// Single slot queue can't tell full from empty, so at least two slots are used
+			std::size_t size = 2U;
+			while (size < capacity)
+				size <<= 1U;
+			return size;
+		}
+
+		slot_t * buffer_;
+		allocator * allocator_;
+		const std::size_t mask_;
+		unsigned char padding0_[64];									//!< keeps shared data away from positions
+		std::atomic<std::size_t> enqueue_pos_;							//!< position of the next push
+		unsigned char padding1_[64 - sizeof(std::atomic<std::size_t>)];	//!< keeps enqueue position on its own cache line
+		std::atomic<std::size_t> dequeue_pos_;							//!< position of the next pop
+		unsigned char padding2_[64 - sizeof(std::atomic<std::size_t>)];	//!< keeps dequeue position on its own cache line
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef __NOSTD_NODE_BATCH_H__
+#define __NOSTD_NODE_BATCH_H__
+
+#include "allocator.h"
+
+namespace nostd {
+
+	/**
+	 * Hands out blocks of the same size, that are taken from allocator in batches.
+	 * Used by node containers to copy and build many nodes with few allocator calls.
+	 * Blocks left unused are returned to allocator on destruction.
+	 * Allocator is the static type of allocator used by container.
+	 */
+	template <typename Allocator = allocator>
+	class node_allocation_batch {
+	public:
+
+		using size_type = allocator::size_type;
+		using ptr_type = allocator::ptr_type;
+
+		static const size_type capacity = 32U; //!< maximum number of blocks requested at once
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] alloc The allocator
+		 * @param[in] size  Size of every block
+		 * @param[in] count Expected number of blocks, zero if unknown
+		 */
+		node_allocation_batch(Allocator * alloc, size_type size, size_type count) noexcept
+		: allocator_(alloc)
+		, size_(size)
+		, remaining_(count)
+		, index_(0U)
+		, count_(0U)
+		{
+		}
+
+		/**
+		 * Destructor.
+		 * Returns unused blocks.
+		 */
+		~node_allocation_batch()
+		{
+			if (index_ != count_)
+				allocator_->free_batch(size_, count_ - index_, ptrs_ + index_);
+		}
+
+		/**
+		 * Returns the next block
+		 *
+		 * @return Returns pointer to block of memory.
+		 */
+		ptr_type next() noexcept(false)
+		{
+			if (index_ == count_)
+				_refill();
+			return ptrs_[index_++];
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		node_allocation_batch(const node_allocation_batch&) = delete;
+		node_allocation_batch& operator =(const node_allocation_batch&) = delete;
+
+		void _refill() noexcept(false)
+		{
+			const size_type count = (remaining_ != 0U && remaining_ < capacity) ? remaining_ : capacity;
+			index_ = 0U;
+			count_ = 0U;
+			allocator_->allocate_batch(size_, count, ptrs_);
+			count_ = count;
+			remaining_ = (remaining_ > count) ? remaining_ - count : 0U;
+		}
+
+		Allocator * allocator_;
+		size_type size_;
+		size_type remaining_; //!< number of expected blocks not requested yet
+		size_type index_;
+		size_type count_;
+		ptr_type ptrs_[capacity];
+	};
+
+	/**
+	 * Collects released blocks of the same size and returns them to allocator in batches.
+	 * Used by node containers to release many nodes with few allocator calls.
+	 * Allocator is the static type of allocator used by container.
+	 */
+	template <typename Allocator = allocator>
+	class node_release_batch {
+	public:
+
+		using size_type = allocator::size_type;
+		using ptr_type = allocator::ptr_type;
+
+		static const size_type capacity = 32U; //!< maximum number of blocks released at once
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] alloc The allocator
+		 * @param[in] size  Size of every block
+		 */
+		node_release_batch(Allocator * alloc, size_type size) noexcept
+		: allocator_(alloc)
+		, size_(size)
+		, count_(0U)
+		{
+		}
+
+		/**
+		 * Destructor.
+		 * Releases collected blocks.
+		 */
+		~node_release_batch()
+		{
+			flush();
+		}
+
+		/**
+		 * Adds block to be released
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void add(ptr_type ptr) noexcept
+		{
+			ptrs_[count_++] = ptr;
+			if (count_ == capacity)
+				flush();
+		}
+
+		/**
+		 * Releases collected blocks
+		 */
+		void flush() noexcept
+		{
+			if (count_ != 0U)
+				allocator_->free_batch(size_, count_, ptrs_);
+			count_ = 0U;
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		node_release_batch(const node_release_batch&) = delete;
+		node_release_batch& operator =(const node_release_batch&) = delete;
+
+		Allocator * allocator_;
+		size_type size_;
+		size_type count_;
+		ptr_type ptrs_[capacity];
+	};
+
+} // namespace nostd
+
+#endif
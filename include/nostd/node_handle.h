@@ -0,0 +1,154 @@
+#ifndef __NOSTD_NODE_HANDLE_H__
+#define __NOSTD_NODE_HANDLE_H__
+
+#include "allocator.h"
+
+namespace nostd {
+
+	/**
+	 * Owns node extracted from node based container (analog of std::node_handle).
+	 * Node keeps its value and may be inserted into another container of the same type
+	 * without allocation and without moving the value.
+	 * Node is destroyed with its allocator if handle still owns it.
+	 * Only Owner container creates handles and takes nodes from them.
+	 * Allocator is the static type of allocator of Owner.
+	 */
+	template <typename Owner, typename Node, typename Value, typename Allocator = allocator>
+	class node_handle {
+		friend Owner;
+
+	public:
+
+		/**
+		 * Default constructor, creates empty handle.
+		 */
+		node_handle() noexcept
+		: node_(nullptr)
+		, allocator_(nullptr)
+		{
+		}
+
+		/**
+		 * Move constructor.
+		 *
+		 * @param[in] other The other handle.
+		 */
+		node_handle(node_handle && other) noexcept
+		: node_(other.node_)
+		, allocator_(other.allocator_)
+		{
+			other.node_ = nullptr;
+		}
+
+		/**
+		 * Destructor.
+		 */
+		~node_handle()
+		{
+			_clean();
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other handle.
+		 */
+		node_handle& operator =(node_handle && other) noexcept
+		{
+			if (this != &other)
+			{
+				_clean();
+				node_ = other.node_;
+				allocator_ = other.allocator_;
+				other.node_ = nullptr;
+			}
+			return *this;
+		}
+
+		/**
+		 * Checks if handle owns no node.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return node_ == nullptr;
+		}
+
+		/**
+		 * Checks if handle owns node.
+		 */
+		explicit operator bool() const noexcept
+		{
+			return node_ != nullptr;
+		}
+
+		/**
+		 * Returns value of node, handle should not be empty.
+		 * Value may be modified before insertion, including the key.
+		 *
+		 * @return Returns reference to value.
+		 */
+		Value& value() const noexcept
+		{
+			return node_->data;
+		}
+
+		/**
+		 * Returns allocator the node has been allocated with.
+		 *
+		 * @return Returns the allocator or nullptr for empty handle.
+		 */
+		Allocator * get_allocator() const noexcept
+		{
+			return node_ != nullptr ? allocator_ : nullptr;
+		}
+
+	private:
+
+		node_handle(Node * node, Allocator * alloc) noexcept
+		: node_(node)
+		, allocator_(alloc)
+		{
+		}
+
+		/**
+		 * Disallow copy, node has a single owner
+		 */
+		node_handle(const node_handle&) = delete;
+		node_handle& operator =(const node_handle&) = delete;
+
+		Node * _release() noexcept
+		{
+			Node * node = node_;
+			node_ = nullptr;
+			return node;
+		}
+		void _clean() noexcept
+		{
+			if (node_ != nullptr)
+			{
+				node_->data.~Value();
+				allocator_->free(reinterpret_cast<allocator::ptr_type>(node_), sizeof(Node));
+				node_ = nullptr;
+			}
+		}
+
+		Node * node_;
+		Allocator * allocator_;
+	};
+
+	/**
+	 * Result of node handle insertion.
+	 * If insertion failed, position points to the element that prevented it and node keeps the handle.
+	 */
+	template <typename Iterator, typename NodeHandle>
+	struct node_insert_return {
+		Iterator position;
+		bool inserted;
+		NodeHandle node;
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __NOSTD_PAGE_ALLOCATOR_H__
+#define __NOSTD_PAGE_ALLOCATOR_H__
+
+#include "allocator.h"
+#include "vector.h"
+
+#include <cstddef>
+
+namespace nostd {
+
+	/**
+	 * Defines page size requested from the system.
+	 */
+	enum class page_kind {
+		normal,   //!< regular pages of the system
+		huge_2mb, //!< 2MB huge pages
+		huge_1gb, //!< 1GB huge pages
+	};
+
+	/**
+	 * Page allocator.
+	 * Upstream for pools, arenas and slabs that maps their buffers directly from the system,
+	 * so large buffers may be backed by huge pages and bound to a NUMA node.
+	 * Huge pages are taken from the reserved ones (MAP_HUGETLB, MEM_LARGE_PAGES). If there are none,
+	 * range aligned to 2MB is mapped and advised for transparent huge pages.
+	 * NUMA binding is a hint: if the system refuses it, memory is still returned.
+	 * Sizes are rounded up to the page size, so buffer sizes should be multiples of it.
+	 * Note that pool with alignment greater than max_align_t asks for extra bytes to align its buffers.
+	 * Not thread safe.
+	 */
+	class page_allocator final
+	: public allocator
+	{
+
+		/**
+		 * Range mapped by single allocation
+		 */
+		struct mapping_t {
+			byte_type * begin;
+			std::size_t size;
+			bool huge; //!< backed by reserved huge pages
+		};
+
+	public:
+
+		static const int any_node = -1; //!< memory isn't bound to a NUMA node
+
+		/**
+		 * Constructor.
+		 * Regular pages of any NUMA node are used.
+		 */
+		page_allocator() noexcept;
+
+		/**
+		 * Constructor with page kind and NUMA node
+		 *
+		 * @param[in] kind      The page size
+		 * @param[in] numa_node The NUMA node that memory is bound to, or any_node
+		 */
+		page_allocator(page_kind kind, int numa_node = any_node) noexcept;
+
+		/**
+		 * Destructor, pages that weren't freed are returned to the system
+		 */
+		~page_allocator();
+
+		/**
+		 * Maps pages from the system
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		ptr_type allocate(size_type size) noexcept(false) final;
+
+		/**
+		 * Returns pages to the system
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void free(ptr_type ptr) noexcept final;
+
+		using allocator::free;
+
+		/**
+		 * Returns requested page kind
+		 */
+		page_kind kind() const noexcept;
+
+		/**
+		 * Returns NUMA node that memory is bound to, or any_node
+		 */
+		int numa_node() const noexcept;
+
+		/**
+		 * Returns granularity of allocations, that is size of requested pages
+		 */
+		size_type page_size() const noexcept;
+
+		/**
+		 * Returns total size of mapped pages
+		 */
+		std::size_t mapped_size() const noexcept;
+
+		/**
+		 * Returns size of mapped pages that are reserved huge pages
+		 */
+		std::size_t huge_size() const noexcept;
+
+		/**
+		 * Returns size of regular page of the system
+		 */
+		static size_type system_page_size() noexcept;
+
+	private:
+
+		/**
+		 * Disallow copy
+		 */
+		page_allocator(const page_allocator&) = delete;
+		page_allocator& operator =(const page_allocator&) = delete;
+
+		byte_type * _map(std::size_t size) noexcept(false);
+		void _bind(byte_type * ptr, std::size_t size) noexcept;
+
+		page_kind kind_;
+		int numa_node_;
+		std::size_t mapped_size_;
+		std::size_t huge_size_;
+		vector<mapping_t> mappings_;
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef __NOSTD_PARALLEL_ALGORITHM_H__
+#define __NOSTD_PARALLEL_ALGORITHM_H__
+
+#include "algorithm.h"
+#include "default_allocator.h"
+#include "thread_pool.h"
+#include "utility.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Helpers of parallel algorithms, not for direct use.
+	 */
+	namespace algorithm_detail {
+
+		const allocator::size_type sort_grain = 4096U;		//!< minimal range sorted by single task
+		const allocator::size_type parallel_grain = 1024U;	//!< minimal range processed by single task
+
+		inline allocator::size_type default_grain(const thread_pool& pool, std::ptrdiff_t count, allocator::size_type minimum) noexcept
+		{
+			// A few tasks per thread leave room for stealing
+			const allocator::size_type grain = static_cast<allocator::size_type>(count) / (pool.size() * 8U);
+			return (grain < minimum) ? minimum : grain;
+		}
+
+		/**
+		 * Merges two sorted ranges into uninitialized storage, elements are moved.
+		 */
+		template <typename RandomIt, typename T, typename Compare>
+		void merge_construct(RandomIt a, std::ptrdiff_t count_a, RandomIt b, std::ptrdiff_t count_b, T * out, Compare& compare)
+		{
+			std::ptrdiff_t i = 0;
+			std::ptrdiff_t j = 0;
+			while (i < count_a && j < count_b)
+			{
+				if (compare(*(b + j), *(a + i)))
+					new (out++) T(utility::move(*(b + j++)));
+				else
+					new (out++) T(utility::move(*(a + i++)));
+			}
+			for (; i < count_a; ++i)
+				new (out++) T(utility::move(*(a + i)));
+			for (; j < count_b; ++j)
+				new (out++) T(utility::move(*(b + j)));
+		}
+
+		template <typename RandomIt, typename T, typename Compare>
+		std::ptrdiff_t lower_bound_index(RandomIt first, std::ptrdiff_t count, const T& value, Compare& compare)
+		{
+			std::ptrdiff_t low = 0;
+			while (count > 0)
+			{
+				const std::ptrdiff_t half = count / 2;
+				if (compare(*(first + (low + half)), value))
+				{
+					low += half + 1;
+					count -= half + 1;
+				}
+				else
+					count = half;
+			}
+			return low;
+		}
+
+		/**
+		 * Merges two sorted ranges into uninitialized storage in parallel.
+		 * Middle element of the longer range splits both ranges into independent merges.
+		 */
+		template <typename RandomIt, typename T, typename Compare>
+		void parallel_merge(thread_pool& pool, RandomIt a, std::ptrdiff_t count_a, RandomIt b, std::ptrdiff_t count_b,
+			T * out, Compare& compare, allocator::size_type grain)
+		{
+			if (count_a + count_b <= static_cast<std::ptrdiff_t>(grain))
+			{
+				merge_construct(a, count_a, b, count_b, out, compare);
+				return;
+			}
+			if (count_a < count_b)
+			{
+				utility::swap(a, b);
+				utility::swap(count_a, count_b);
+			}
+			const std::ptrdiff_t middle_a = count_a / 2;
+			const std::ptrdiff_t middle_b = lower_bound_index(b, count_b, *(a + middle_a), compare);
+			T * middle_out = out + (middle_a + middle_b);
+			wait_group group;
+			pool.submit(group, [&pool, a, middle_a, b, middle_b, out, &compare, grain]() {
+				parallel_merge(pool, a, middle_a, b, middle_b, out, compare, grain);
+			});
+			new (middle_out) T(utility::move(*(a + middle_a)));
+			parallel_merge(pool, a + (middle_a + 1), count_a - middle_a - 1, b + middle_b, count_b - middle_b,
+				middle_out + 1, compare, grain);
+			pool.wait(group);
+		}
+
+		template <typename RandomIt, typename T, typename Compare>
+		void parallel_merge_sort(thread_pool& pool, RandomIt first, std::ptrdiff_t count, T * buffer,
+			Compare& compare, allocator::size_type grain)
+		{
+			if (count <= static_cast<std::ptrdiff_t>(grain))
+			{
+				introsort(first, first + count, depth_limit(count), compare);
+				return;
+			}
+			// Halves are sorted in place, buffer halves serve them as scratch
+			const std::ptrdiff_t half = count / 2;
+			wait_group group;
+			pool.submit(group, [&pool, first, half, buffer, &compare, grain]() {
+				parallel_merge_sort(pool, first, half, buffer, compare, grain);
+			});
+			parallel_merge_sort(pool, first + half, count - half, buffer + half, compare, grain);
+			pool.wait(group);
+			parallel_merge(pool, first, half, first + half, count - half, buffer, compare, grain);
+			// Merged elements go back to the range
+			pool.parallel_for(0U, static_cast<allocator::size_type>(count), grain,
+				[first, buffer](allocator::size_type begin, allocator::size_type end) {
+					for (allocator::size_type i = begin; i < end; ++i)
+					{
+						*(first + static_cast<std::ptrdiff_t>(i)) = utility::move(buffer[i]);
+						buffer[i].~T();
+					}
+				});
+		}
+
+	} // namespace algorithm_detail
+
+	/**
+	 * Sorts range with parallel merge sort, order of equivalent elements is not preserved.
+	 * Subranges are sorted by introsort, merges are split between threads too.
+	 * Scratch buffer of range size is taken from allocator.
+	 * Compare and move operations of elements should not throw.
+	 *
+	 * @param[in] pool    The thread pool to run on.
+	 * @param[in] first   The beginning of the range.
+	 * @param[in] last    The end of the range.
+	 * @param[in] compare The less comparator.
+	 * @param[in] alloc   The allocator for scratch buffer.
+	 */
+	template <typename RandomIt, typename Compare>
+	void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last, Compare compare, allocator * alloc) noexcept(false)
+	{
+		typedef algorithm_detail::value_type<RandomIt> value_type;
+		const std::ptrdiff_t count = last - first;
+		const allocator::size_type grain = algorithm_detail::default_grain(pool, count, algorithm_detail::sort_grain);
+		if (count <= static_cast<std::ptrdiff_t>(grain))
+		{
+			nostd::sort(first, last, compare);
+			return;
+		}
+		const allocator::size_type size = static_cast<allocator::size_type>(sizeof(value_type) * count);
+		value_type * buffer = reinterpret_cast<value_type*>(alloc->allocate(size));
+		if (buffer == nullptr)
+			throw std::bad_alloc();
+		algorithm_detail::parallel_merge_sort(pool, first, count, buffer, compare, grain);
+		alloc->free(reinterpret_cast<allocator::ptr_type>(buffer), size);
+	}
+
+	/**
+	 * Sorts range with parallel merge sort, scratch buffer is taken from default allocator.
+	 * @see parallel_sort(thread_pool&, RandomIt, RandomIt, Compare, allocator*)
+	 */
+	template <typename RandomIt, typename Compare>
+	void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last, Compare compare) noexcept(false)
+	{
+		nostd::parallel_sort(pool, first, last, compare, default_allocator::get_instance());
+	}
+
+	/**
+	 * Sorts range with parallel merge sort in ascending order.
+	 * @see parallel_sort(thread_pool&, RandomIt, RandomIt, Compare, allocator*)
+	 */
+	template <typename RandomIt>
+	void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last) noexcept(false)
+	{
+		nostd::parallel_sort(pool, first, last, less<>(), default_allocator::get_instance());
+	}
+
+	/**
+	 * Calls function for every element of range in parallel.
+	 * Function may be called concurrently, so it should be thread-safe.
+	 *
+	 * @param[in] pool     The thread pool to run on.
+	 * @param[in] first    The beginning of the range.
+	 * @param[in] last     The end of the range.
+	 * @param[in] function The function object.
+	 * @param[in] grain    The number of elements processed by single task, zero to choose automatically.
+	 */
+	template <typename RandomIt, typename F>
+	void parallel_for_each(thread_pool& pool, RandomIt first, RandomIt last, F function,
+		allocator::size_type grain = 0U) noexcept(false)
+	{
+		const std::ptrdiff_t count = last - first;
+		if (grain == 0U)
+			grain = algorithm_detail::default_grain(pool, count, algorithm_detail::parallel_grain);
+		pool.parallel_for(0U, static_cast<allocator::size_type>(count), grain,
+			[first, &function](allocator::size_type begin, allocator::size_type end) {
+				RandomIt it = first + static_cast<std::ptrdiff_t>(begin);
+				for (allocator::size_type i = begin; i < end; ++i, ++it)
+					function(*it);
+			});
+	}
+
+	/**
+	 * Writes results of operation on every element of range to destination in parallel.
+	 *
+	 * @param[in] pool      The thread pool to run on.
+	 * @param[in] first     The beginning of the range.
+	 * @param[in] last      The end of the range.
+	 * @param[in] d_first   The beginning of destination, it may be equal to first.
+	 * @param[in] operation The unary operation, it should be thread-safe.
+	 * @param[in] grain     The number of elements processed by single task, zero to choose automatically.
+	 *
+	 * @return Returns iterator past the last written element.
+	 */
+	template <typename RandomIt, typename OutputIt, typename F>
+	OutputIt parallel_transform(thread_pool& pool, RandomIt first, RandomIt last, OutputIt d_first, F operation,
+		allocator::size_type grain = 0U) noexcept(false)
+	{
+		const std::ptrdiff_t count = last - first;
+		if (grain == 0U)
+			grain = algorithm_detail::default_grain(pool, count, algorithm_detail::parallel_grain);
+		pool.parallel_for(0U, static_cast<allocator::size_type>(count), grain,
+			[first, d_first, &operation](allocator::size_type begin, allocator::size_type end) {
+				RandomIt it = first + static_cast<std::ptrdiff_t>(begin);
+				OutputIt out = d_first + static_cast<std::ptrdiff_t>(begin);
+				for (allocator::size_type i = begin; i < end; ++i, ++it, ++out)
+					*out = operation(*it);
+			});
+		return d_first + count;
+	}
+
+	/**
+	 * Folds range with binary operation in parallel.
+	 * Every task folds its chunk, then partial results are folded in chunk order,
+	 * so operation should be associative, but it may be not commutative.
+	 * Partial result of chunk starts with copy of its first element, so unlike reduce
+	 * T should be constructible from element of the range.
+	 * Storage for partial results is taken from allocator.
+	 *
+	 * @param[in] pool      The thread pool to run on.
+	 * @param[in] first     The beginning of the range.
+	 * @param[in] last      The end of the range.
+	 * @param[in] init      The initial value.
+	 * @param[in] operation The associative binary operation, it should be thread-safe.
+	 * @param[in] alloc     The allocator for partial results.
+	 * @param[in] grain     The number of elements processed by single task, zero to choose automatically.
+	 *
+	 * @return Returns the result of folding.
+	 */
+	template <typename RandomIt, typename T, typename F>
+	T parallel_reduce(thread_pool& pool, RandomIt first, RandomIt last, T init, F operation,
+		allocator * alloc, allocator::size_type grain = 0U) noexcept(false)
+	{
+		static_assert(std::is_constructible<T, decltype(*first)>::value,
+			"parallel_reduce requires T to be constructible from element of the range");
+		const std::ptrdiff_t count = last - first;
+		if (grain == 0U)
+			grain = algorithm_detail::default_grain(pool, count, algorithm_detail::parallel_grain);
+		if (count <= static_cast<std::ptrdiff_t>(grain))
+			return nostd::reduce(first, last, utility::move(init), operation);
+		const allocator::size_type chunks = (static_cast<allocator::size_type>(count) + grain - 1U) / grain;
+		// Flags of built partial results follow them, so they are destroyed if not all chunks run
+		const allocator::size_type size = static_cast<allocator::size_type>((sizeof(T) + sizeof(bool)) * chunks);
+		T * partial = reinterpret_cast<T*>(alloc->allocate(size));
+		if (partial == nullptr)
+			throw std::bad_alloc();
+		bool * built = reinterpret_cast<bool*>(partial + chunks);
+		for (allocator::size_type k = 0U; k < chunks; ++k)
+			built[k] = false;
+		try
+		{
+			pool.parallel_for(0U, chunks, 1U,
+				[first, count, grain, partial, built, &operation](allocator::size_type begin, allocator::size_type end) {
+					for (allocator::size_type k = begin; k < end; ++k)
+					{
+						const std::ptrdiff_t chunk_first = static_cast<std::ptrdiff_t>(k) * grain;
+						std::ptrdiff_t chunk_last = chunk_first + grain;
+						if (chunk_last > count)
+							chunk_last = count;
+						RandomIt it = first + chunk_first;
+						T value(*it);
+						for (++it; it != first + chunk_last; ++it)
+							value = operation(utility::move(value), *it);
+						new (&partial[k]) T(utility::move(value));
+						built[k] = true;
+					}
+				});
+		}
+		catch (...)
+		{
+			// Parallel for has finished submitted chunks before rethrowing
+			for (allocator::size_type k = 0U; k < chunks; ++k)
+				if (built[k])
+					partial[k].~T();
+			alloc->free(reinterpret_cast<allocator::ptr_type>(partial), size);
+			throw;
+		}
+		for (allocator::size_type k = 0U; k < chunks; ++k)
+		{
+			init = operation(utility::move(init), utility::move(partial[k]));
+			partial[k].~T();
+		}
+		alloc->free(reinterpret_cast<allocator::ptr_type>(partial), size);
+		return init;
+	}
+
+	/**
+	 * Folds range with binary operation in parallel, partial results are allocated with default allocator.
+	 * @see parallel_reduce(thread_pool&, RandomIt, RandomIt, T, F, allocator*, allocator::size_type)
+	 */
+	template <typename RandomIt, typename T, typename F>
+	T parallel_reduce(thread_pool& pool, RandomIt first, RandomIt last, T init, F operation) noexcept(false)
+	{
+		return nostd::parallel_reduce(pool, first, last, utility::move(init), operation, default_allocator::get_instance());
+	}
+
+} // namespace nostd
+
+#endif
@@ -5,11 +5,27 @@
 #include "stack_linked_list.h"
 #include "vector.h"
 
+#include <cassert>
+
 namespace nostd {
 
+	/**
+	 * Defines when pool returns buffers that have no allocated chunks to upstream.
+	 * Value initialized policy holds buffers until destruction.
+	 */
+	struct pool_release_policy {
+		allocator::size_type keep_buffers;   //!< number of empty buffers kept for reuse
+		allocator::size_type free_threshold; //!< number of free chunks that starts release, zero disables it
+	};
+
 	/**
 	 * Pool allocator.
 	 * Allocates memory blocks with constant size.
+	 * Free list link is stored inside the free chunk itself, so used chunk has no overhead.
+	 * Allocate and free are defined inline, so containers that take pool_allocator as
+	 * template parameter compile them down to a free list pop and push.
+	 * Empty buffers are returned to upstream by release_empty or automatically by release policy,
+	 * so pool over page_allocator gives memory back to the system.
 	 */
 	class pool_allocator final
 	: public allocator
@@ -26,6 +42,23 @@ namespace nostd {
 		 */
 		pool_allocator(size_type num_chunks) noexcept;
 
+		/**
+		 * Constructor with alignment
+		 *
+		 * @param[in] num_chunks Number of chunks per single buffer
+		 * @param[in] alignment  Alignment of every chunk, should be a power of two
+		 */
+		pool_allocator(size_type num_chunks, size_type alignment) noexcept;
+
+		/**
+		 * Constructor with alignment and upstream allocator
+		 *
+		 * @param[in] num_chunks Number of chunks per single buffer
+		 * @param[in] alignment  Alignment of every chunk, should be a power of two
+		 * @param[in] upstream   The allocator to be used to allocate buffers
+		 */
+		pool_allocator(size_type num_chunks, size_type alignment, allocator * upstream) noexcept;
+
 		/**
 		 * Copy constructor
 		 *
@@ -60,11 +93,106 @@ namespace nostd {
 		 */
 		void free(ptr_type ptr) noexcept final;
 
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr  Pointer to block of memory
+		 * @param[in] size Size that was passed to allocate
+		 */
+		void free(ptr_type ptr, size_type size) noexcept final;
+
+		/**
+		 * Allocates several blocks of memory in one pass.
+		 * Whole run of chunks is taken off the free list at once.
+		 *
+		 * @param[in]  size  Size of every memory block
+		 * @param[in]  count Number of blocks
+		 * @param[out] out   Array of count pointers to be filled with blocks
+		 */
+		void allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false) final;
+
+		/**
+		 * Releases several blocks of memory in one pass.
+		 * Blocks are linked into a chain and put to the free list at once.
+		 *
+		 * @param[in] size  Size that was passed to allocate
+		 * @param[in] count Number of blocks
+		 * @param[in] ptrs  Array of count pointers to blocks
+		 */
+		void free_batch(size_type size, size_type count, ptr_type * ptrs) noexcept final;
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Succeeds if new size fits into the chunk.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final;
+
+		/**
+		 * Returns buffers that have no allocated chunks to upstream.
+		 * Number of empty buffers set by release policy is kept.
+		 * Costs a pass over free chunks with binary search of their buffers.
+		 *
+		 * @return Returns number of released buffers.
+		 */
+		size_type release_empty() noexcept(false);
+
+		/**
+		 * Sets release policy.
+		 * When number of free chunks reaches the threshold, empty buffers are released.
+		 * While pool stays fragmented, next attempt waits until number of free chunks doubles.
+		 *
+		 * @param[in] policy The release policy.
+		 */
+		void set_release_policy(const pool_release_policy& policy) noexcept;
+
+		/**
+		 * Returns release policy
+		 */
+		const pool_release_policy& release_policy() const noexcept;
+
+		/**
+		 * Returns number of buffers taken from upstream
+		 */
+		size_type num_buffers() const noexcept;
+
+		/**
+		 * Returns number of free chunks in all buffers
+		 */
+		size_type num_free() const noexcept;
+
 		/**
 		 * Returns number of chunks
 		 */
 		size_type num_chunks() const noexcept;
 
+		/**
+		 * Returns chunk alignment
+		 */
+		size_type alignment() const noexcept;
+
+		/**
+		 * Returns size of single chunk or zero if nothing has been allocated yet
+		 */
+		size_type chunk_size() const noexcept;
+
+#ifdef NOSTD_MEMORY_DEBUG
+		/**
+		 * Returns total size of buffers taken from upstream
+		 */
+		size_type total_size() const noexcept;
+
+		/**
+		 * Returns total size of allocated chunks
+		 */
+		size_type used_size() const noexcept;
+#endif
+
 	private:
 
 		/**
@@ -72,18 +200,69 @@ namespace nostd {
 		 */
 		pool_allocator() = delete;
 
+		/**
+		 * Buffer entry used by release_empty
+		 */
+		struct buffer_t {
+			byte_type * begin; //!< first chunk
+			size_type index;   //!< index in buffers
+			size_type num_free;
+			bool released;
+		};
+
+		void _grow(size_type size) noexcept(false);
 		byte_type* _allocate_buffer() noexcept(false);
+		byte_type* _buffer_begin(byte_type* buffer) const noexcept;
+		size_type _buffer_size() const noexcept;
+		size_type _chunk_size(size_type size) const noexcept;
+		void _on_free() noexcept;
+		buffer_t * _find_buffer(vector<buffer_t>& order, const node_type * node) const noexcept;
 		
+		allocator * upstream_;
 		size_type num_chunks_;
+		size_type alignment_;
 		size_type chunk_size_;
 #ifdef NOSTD_MEMORY_DEBUG
 		size_type total_size_;
 		size_type used_;
 #endif
+		size_type free_chunks_;
+		size_type release_at_; //!< number of free chunks that starts release
+		pool_release_policy release_policy_;
 		stack_linked_list free_list_;
 		vector<byte_type*> buffers_;
 	};
 
+	inline allocator::ptr_type pool_allocator::allocate(size_type size) noexcept(false)
+	{
+		assert((buffers_.empty() || _chunk_size(size) == chunk_size_) && "Allocated size should be constant");
+		node_type * free_node = free_list_.pop();
+		if (free_node == nullptr)
+		{
+			_grow(size);
+			free_node = free_list_.pop();
+		}
+		--free_chunks_;
+#ifdef NOSTD_MEMORY_DEBUG
+		used_ += chunk_size_;
+#endif
+		return reinterpret_cast<ptr_type>(free_node);
+	}
+	inline void pool_allocator::free(ptr_type ptr) noexcept
+	{
+#ifdef NOSTD_MEMORY_DEBUG
+		used_ -= chunk_size_;
+#endif
+		free_list_.push(reinterpret_cast<node_type*>(ptr));
+		if (++free_chunks_ >= release_at_)
+			_on_free();
+	}
+	inline void pool_allocator::free(ptr_type ptr, size_type size) noexcept
+	{
+		(void)size;
+		free(ptr);
+	}
+
 } // namespace nostd
 
 #endif
\ No newline at end of file
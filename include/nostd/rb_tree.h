@@ -0,0 +1,402 @@
+#ifndef __NOSTD_RB_TREE_H__
+#define __NOSTD_RB_TREE_H__
+
+#include <cstdint>
+
+namespace nostd {
+
+	/**
+	 * Links of red-black tree node, shared by map and set.
+	 * Color is stored in the lowest bit of parent pointer, nodes are at least pointer aligned.
+	 * Missing children point to the shared nil node, which is black, self-linked and is never modified.
+	 * Tree is hung on the left link of header node, that is the parent of tree root.
+	 * Header is black, its right link is nil, so it stops upward walks like a sentinel.
+	 */
+	struct rb_node_base {
+		std::uintptr_t parent_color;
+		rb_node_base * left;
+		rb_node_base * right;
+
+		rb_node_base * parent() const noexcept
+		{
+			return reinterpret_cast<rb_node_base*>(parent_color & ~static_cast<std::uintptr_t>(1U));
+		}
+		void set_parent(rb_node_base * node) noexcept
+		{
+			parent_color = reinterpret_cast<std::uintptr_t>(node) | (parent_color & 1U);
+		}
+		bool red() const noexcept
+		{
+			return (parent_color & 1U) != 0U;
+		}
+		void set_red(bool red) noexcept
+		{
+			parent_color = (parent_color & ~static_cast<std::uintptr_t>(1U)) | static_cast<std::uintptr_t>(red);
+		}
+	};
+
+	/**
+	 * Header of red-black tree, the parent of tree root.
+	 * Keeps the leftmost and the rightmost nodes, so begin and insertion at either end don't walk the tree.
+	 * Both are nil for empty tree.
+	 */
+	struct rb_tree_header : public rb_node_base {
+		rb_node_base * leftmost;
+		rb_node_base * rightmost;
+	};
+
+	/**
+	 * Holds nil node, so it has a single definition in header only library.
+	 */
+	template <typename Dummy = void>
+	struct rb_nil_holder {
+		static rb_node_base nil;
+	};
+
+	template <typename Dummy>
+	rb_node_base rb_nil_holder<Dummy>::nil = {0U, &rb_nil_holder<Dummy>::nil, &rb_nil_holder<Dummy>::nil};
+
+	/**
+	 * Returns nil node.
+	 */
+	inline rb_node_base * rb_tree_nil() noexcept
+	{
+		return &rb_nil_holder<>::nil;
+	}
+
+	/**
+	 * Makes header of empty tree.
+	 *
+	 * @param[in] header The header node.
+	 */
+	inline void rb_tree_reset(rb_tree_header * header) noexcept
+	{
+		header->parent_color = 0U;
+		header->left = rb_tree_nil();
+		header->right = rb_tree_nil();
+		header->leftmost = rb_tree_nil();
+		header->rightmost = rb_tree_nil();
+	}
+
+	/**
+	 * Moves tree from one header to another, source header becomes empty.
+	 * Destination header should be empty.
+	 *
+	 * @param[in] header The destination header.
+	 * @param[in] source The source header.
+	 */
+	inline void rb_tree_move(rb_tree_header * header, rb_tree_header * source) noexcept
+	{
+		header->left = source->left;
+		header->leftmost = source->leftmost;
+		header->rightmost = source->rightmost;
+		if (header->left != rb_tree_nil())
+			header->left->set_parent(header);
+		source->left = rb_tree_nil();
+		source->leftmost = rb_tree_nil();
+		source->rightmost = rb_tree_nil();
+	}
+
+	/**
+	 * Swaps trees of two headers.
+	 */
+	inline void rb_tree_swap(rb_tree_header * header, rb_tree_header * other) noexcept
+	{
+		rb_node_base * root = header->left;
+		header->left = other->left;
+		other->left = root;
+		rb_node_base * leftmost = header->leftmost;
+		header->leftmost = other->leftmost;
+		other->leftmost = leftmost;
+		rb_node_base * rightmost = header->rightmost;
+		header->rightmost = other->rightmost;
+		other->rightmost = rightmost;
+		if (header->left != rb_tree_nil())
+			header->left->set_parent(header);
+		if (other->left != rb_tree_nil())
+			other->left->set_parent(other);
+	}
+
+	/**
+	 * Returns the leftmost node of subtree, subtree should not be empty.
+	 */
+	inline rb_node_base * rb_tree_minimum(rb_node_base * x) noexcept
+	{
+		rb_node_base * nil = rb_tree_nil();
+		while (x->left != nil)
+			x = x->left;
+		return x;
+	}
+
+	/**
+	 * Returns the rightmost node of subtree, subtree should not be empty.
+	 */
+	inline rb_node_base * rb_tree_maximum(rb_node_base * x) noexcept
+	{
+		rb_node_base * nil = rb_tree_nil();
+		while (x->right != nil)
+			x = x->right;
+		return x;
+	}
+
+	/**
+	 * Sets the leftmost and the rightmost nodes after tree was built without rb_tree_insert.
+	 *
+	 * @param[in] header The header node.
+	 */
+	inline void rb_tree_update_bounds(rb_tree_header * header) noexcept
+	{
+		if (header->left == rb_tree_nil()) {
+			header->leftmost = header->rightmost = rb_tree_nil();
+		} else {
+			header->leftmost = rb_tree_minimum(header->left);
+			header->rightmost = rb_tree_maximum(header->left);
+		}
+	}
+
+	/**
+	 * Returns the next node in order or nil after the last one.
+	 */
+	inline rb_node_base * rb_tree_successor(rb_node_base * x, const rb_node_base * header) noexcept
+	{
+		rb_node_base * y = x->right;
+		if (y != rb_tree_nil())
+			return rb_tree_minimum(y);
+		y = x->parent();
+		while (x == y->right) { /* header's right link is nil, so loop stops there */
+			x = y;
+			y = y->parent();
+		}
+		if (y == header)
+			return rb_tree_nil();
+		return y;
+	}
+
+	/**
+	 * Returns the previous node in order or nil before the first one.
+	 */
+	inline rb_node_base * rb_tree_predecessor(rb_node_base * x, const rb_node_base * header) noexcept
+	{
+		rb_node_base * y = x->left;
+		if (y != rb_tree_nil())
+			return rb_tree_maximum(y);
+		y = x->parent();
+		while (y != header && x == y->left) {
+			x = y;
+			y = y->parent();
+		}
+		if (y == header)
+			return rb_tree_nil();
+		return y;
+	}
+
+	inline void rb_tree_left_rotate(rb_node_base * x) noexcept
+	{
+		rb_node_base * y = x->right;
+		x->right = y->left;
+		if (y->left != rb_tree_nil())
+			y->left->set_parent(x);
+		rb_node_base * parent = x->parent();
+		y->set_parent(parent);
+		/* header takes care of the root case */
+		if (x == parent->left)
+			parent->left = y;
+		else
+			parent->right = y;
+		y->left = x;
+		x->set_parent(y);
+	}
+
+	inline void rb_tree_right_rotate(rb_node_base * y) noexcept
+	{
+		rb_node_base * x = y->left;
+		y->left = x->right;
+		if (x->right != rb_tree_nil())
+			x->right->set_parent(y);
+		rb_node_base * parent = y->parent();
+		x->set_parent(parent);
+		if (y == parent->left)
+			parent->left = x;
+		else
+			parent->right = x;
+		x->right = y;
+		y->set_parent(x);
+	}
+
+	/**
+	 * Links node as a child of parent and restores red-black properties.
+	 * Position should keep tree ordered.
+	 *
+	 * @param[in] x      The new node.
+	 * @param[in] parent The parent node, header for empty tree.
+	 * @param[in] left   True to link as the left child of parent.
+	 * @param[in] header The header node.
+	 */
+	inline void rb_tree_insert(rb_node_base * x, rb_node_base * parent, bool left, rb_tree_header * header) noexcept
+	{
+		x->parent_color = reinterpret_cast<std::uintptr_t>(parent);
+		x->left = x->right = rb_tree_nil();
+		if (left)
+			parent->left = x;
+		else
+			parent->right = x;
+		if (parent == header) {
+			header->leftmost = header->rightmost = x;
+		} else if (left) {
+			if (parent == header->leftmost)
+				header->leftmost = x;
+		} else if (parent == header->rightmost) {
+			header->rightmost = x;
+		}
+		x->set_red(true);
+		while (x->parent()->red()) { /* header is black, so no check for root is needed */
+			rb_node_base * p = x->parent();
+			rb_node_base * g = p->parent();
+			if (p == g->left) {
+				rb_node_base * y = g->right;
+				if (y->red()) {
+					p->set_red(false);
+					y->set_red(false);
+					g->set_red(true);
+					x = g;
+				} else {
+					if (x == p->right) {
+						x = p;
+						rb_tree_left_rotate(x);
+						p = x->parent();
+					}
+					p->set_red(false);
+					g->set_red(true);
+					rb_tree_right_rotate(g);
+				}
+			} else { /* case for p == g->right */
+				rb_node_base * y = g->left;
+				if (y->red()) {
+					p->set_red(false);
+					y->set_red(false);
+					g->set_red(true);
+					x = g;
+				} else {
+					if (x == p->left) {
+						x = p;
+						rb_tree_right_rotate(x);
+						p = x->parent();
+					}
+					p->set_red(false);
+					g->set_red(true);
+					rb_tree_left_rotate(g);
+				}
+			}
+		}
+		header->left->set_red(false);
+	}
+
+	/**
+	 * Performs rotations and changes colors to restore red-black properties after a node is unlinked.
+	 * Parent of x is passed separately, because x may be nil.
+	 */
+	inline void rb_tree_erase_fix_up(rb_node_base * x, rb_node_base * parent, rb_node_base * header) noexcept
+	{
+		while (x != header->left && !x->red()) {
+			if (x == parent->left) {
+				rb_node_base * w = parent->right;
+				if (w->red()) {
+					w->set_red(false);
+					parent->set_red(true);
+					rb_tree_left_rotate(parent);
+					w = parent->right;
+				}
+				if (!w->right->red() && !w->left->red()) {
+					w->set_red(true);
+					x = parent;
+					parent = x->parent();
+				} else {
+					if (!w->right->red()) {
+						w->left->set_red(false);
+						w->set_red(true);
+						rb_tree_right_rotate(w);
+						w = parent->right;
+					}
+					w->set_red(parent->red());
+					parent->set_red(false);
+					w->right->set_red(false);
+					rb_tree_left_rotate(parent);
+					x = header->left; /* this is to exit while loop */
+				}
+			} else { /* the code below has left and right switched from above */
+				rb_node_base * w = parent->left;
+				if (w->red()) {
+					w->set_red(false);
+					parent->set_red(true);
+					rb_tree_right_rotate(parent);
+					w = parent->left;
+				}
+				if (!w->right->red() && !w->left->red()) {
+					w->set_red(true);
+					x = parent;
+					parent = x->parent();
+				} else {
+					if (!w->left->red()) {
+						w->right->set_red(false);
+						w->set_red(true);
+						rb_tree_left_rotate(w);
+						w = parent->left;
+					}
+					w->set_red(parent->red());
+					parent->set_red(false);
+					w->left->set_red(false);
+					rb_tree_right_rotate(parent);
+					x = header->left; /* this is to exit while loop */
+				}
+			}
+		}
+		if (x != rb_tree_nil())
+			x->set_red(false);
+	}
+
+	/**
+	 * Unlinks node from tree and restores red-black properties.
+	 * Other nodes are relinked rather than moved, so iterators to them stay valid.
+	 *
+	 * @param[in] z      The node to unlink.
+	 * @param[in] header The header node.
+	 */
+	inline void rb_tree_erase(rb_node_base * z, rb_tree_header * header) noexcept
+	{
+		rb_node_base * nil = rb_tree_nil();
+		if (z == header->leftmost)
+			header->leftmost = rb_tree_successor(z, header);
+		if (z == header->rightmost)
+			header->rightmost = rb_tree_predecessor(z, header);
+		/* y is the node to splice out and x is its child */
+		rb_node_base * y = (z->left == nil || z->right == nil) ? z : rb_tree_minimum(z->right);
+		rb_node_base * x = (y->left == nil) ? y->right : y->left;
+		rb_node_base * parent = y->parent();
+		if (x != nil)
+			x->set_parent(parent);
+		if (y == parent->left)
+			parent->left = x;
+		else
+			parent->right = x;
+		if (!y->red())
+			rb_tree_erase_fix_up(x, parent, header);
+		if (y != z) {
+			/* y takes place of z */
+			y->parent_color = z->parent_color;
+			y->left = z->left;
+			y->right = z->right;
+			if (y->left != nil)
+				y->left->set_parent(y);
+			if (y->right != nil)
+				y->right->set_parent(y);
+			parent = z->parent();
+			if (z == parent->left)
+				parent->left = y;
+			else
+				parent->right = y;
+		}
+	}
+
+} // namespace nostd
+
+#endif
@@ -2,8 +2,13 @@
 #define __NOSTD_SET_H__
 
 #include "default_allocator.h"
+#include "functional.h"
+#include "node_batch.h"
+#include "node_handle.h"
+#include "rb_tree.h"
 #include "utility.h"
 
+#include <cassert>
 #include <new>
 #include <stdexcept>
 
@@ -11,32 +16,24 @@ namespace nostd {
 
 	/**
 	 * Defines set container. Implemented as red-black tree.
+	 * Values are ordered by Compare, values are equivalent if neither is less than the other.
+	 * Transparent Compare (like less<>) enables lookup by values of other types.
 	 * Move semantics should be defined for used type.
+	 * Sentinels are embedded, so empty set doesn't allocate and move doesn't allocate either.
 	 * If no allocator is provided, default new/delete allocation/deallocation routine is used.
 	 * `pool_allocator` is the best solution for custom allocator.
 	 * @see pool_allocator
+	 * Allocator may be a concrete allocator type (like pool_allocator), so node allocation calls are resolved at compile time.
 	 */
-	template <typename T>
+	template <typename T, typename Compare = less<T>, typename Allocator = allocator>
 	class set {
 
 		/**
 		 * Defines single tree node that holds data.
+		 * Sentinels don't have data, so they are only links.
 		 */
-		struct node_t {
-			node_t * parent;
-			node_t * left;
-			node_t * right;
-			bool red; // if red = false then the node is black
+		struct node_t : public rb_node_base {
 			T data;
-
-			node_t(node_t * node) noexcept
-			: parent(node)
-			, left(node)
-			, right(node)
-			, red(false)
-			, data()
-			{
-			}
 		};
 
 	public:
@@ -47,35 +44,19 @@ namespace nostd {
 		class iterator {
 			friend class set;
 
-			iterator(set const * set, node_t * node) noexcept
+			iterator(set const * set, rb_node_base * node) noexcept
 			: set_(set)
 			, node_(node)
 			{
 			}
-			node_t * _next(node_t * prev) noexcept
+			rb_node_base * _next(rb_node_base * prev) noexcept
 			{
-				node_t * x = prev;
-				node_t * y;
-
-				if (set_->nil_ != (y = x->right)) { /* assignment to y is intentional */
-					while (y->left != set_->nil_) { /* returns the minium of the right subtree of x */
-						y = y->left;
-					}
-					return y;
-				} else {
-					y = x->parent;
-					while (y != set_->nil_ && x == y->right) { /* sentinel used instead of checking for nil */
-						x = y;
-						y = y->parent;
-					}
-					if (y == set_->root_)
-						return set_->nil_;
-					return y;
-				}
+				return rb_tree_successor(prev, &set_->header_);
 			}
-			void _check_node() noexcept(false)
+			void _check_node() const noexcept(false)
 			{
-				if (node_ == nullptr)
+				// End is nil, it has neither value nor next node
+				if (node_ == nullptr || node_ == rb_tree_nil())
 					throw std::runtime_error("invalid iterator operation");
 			}
 		public:
@@ -114,28 +95,31 @@ namespace nostd {
 			T& operator *() noexcept(false)
 			{
 				_check_node();
-				return node_->data;
+				return static_cast<node_t*>(node_)->data;
 			}
 			const T& operator *() const noexcept(false)
 			{
 				_check_node();
-				return node_->data;
+				return static_cast<node_t*>(node_)->data;
 			}
 			T& operator ->() noexcept(false)
 			{
 				_check_node();
-				return node_->data;
+				return static_cast<node_t*>(node_)->data;
 			}
 			const T& operator ->() const noexcept(false)
 			{
 				_check_node();
-				return node_->data;
+				return static_cast<node_t*>(node_)->data;
 			}
 		private:
 			set const * set_;
-			node_t * node_;
+			rb_node_base * node_;
 		};
 
+		using node_type = node_handle<set, node_t, T, Allocator>; //!< owner of extracted node
+		using insert_return_type = node_insert_return<iterator, node_type>;
+
 	public:
 
 		using size_type = allocator::size_type;
@@ -143,14 +127,13 @@ namespace nostd {
 		/**
 		 * Default constructor.
 		 */
-		set() noexcept(false)
-		: nil_(nullptr)
-		, root_(nullptr)
+		set() noexcept
+		: header_()
 		, allocator_(default_allocator::get_instance())
 		, size_(0U)
+		, compare_()
 		{
-			nil_ = _make_nil_node();
-			root_ = _make_root_node();
+			rb_tree_reset(&header_);
 		}
 
 		/**
@@ -158,14 +141,28 @@ namespace nostd {
 		 * 
 		 * @param[in] alloc The allocator to be used to allocate nodes.
 		 */
-		set(allocator * alloc) noexcept(false)
-		: nil_(nullptr)
-		, root_(nullptr)
+		set(Allocator * alloc) noexcept
+		: header_()
 		, allocator_(alloc)
 		, size_(0U)
+		, compare_()
 		{
-			nil_ = _make_nil_node();
-			root_ = _make_root_node();
+			rb_tree_reset(&header_);
+		}
+
+		/**
+		 * Constructor with comparator and allocator.
+		 * 
+		 * @param[in] compare The comparator of values.
+		 * @param[in] alloc   The allocator to be used to allocate nodes.
+		 */
+		set(const Compare& compare, Allocator * alloc) noexcept
+		: header_()
+		, allocator_(alloc)
+		, size_(0U)
+		, compare_(compare)
+		{
+			rb_tree_reset(&header_);
 		}
 
 		/**
@@ -174,11 +171,12 @@ namespace nostd {
 		 * @param[in] other The other set.
 		 */
 		set(const set& other) noexcept(false)
-		: nil_(nullptr)
-		, root_(nullptr)
+		: header_()
 		, allocator_(nullptr)
 		, size_(0U)
+		, compare_(other.compare_)
 		{
+			rb_tree_reset(&header_);
 			_set_by_copy(other);
 		}
 
@@ -188,12 +186,13 @@ namespace nostd {
 		 * @param[in] other The other set.
 		 */
 		set(set && other) noexcept
-		: nil_(nullptr)
-		, root_(nullptr)
+		: header_()
 		, allocator_(nullptr)
 		, size_(0U)
+		, compare_(other.compare_)
 		{
-			_set_by_move(utility::forward(other));
+			rb_tree_reset(&header_);
+			_set_by_move(utility::move(other));
 		}
 
 		/**
@@ -211,7 +210,9 @@ namespace nostd {
 		 */
 		set& operator =(const set& other) noexcept(false)
 		{
-			_set_by_copy(other);
+			if (this != &other)
+				_set_by_copy(other);
+			return *this;
 		}
 
 		/**
@@ -221,7 +222,8 @@ namespace nostd {
 		 */
 		set& operator =(set && other) noexcept
 		{
-			_set_by_move(utility::forward(other));
+			if (this != &other)
+				_set_by_move(utility::move(other));
 			return *this;
 		}
 
@@ -251,8 +253,8 @@ namespace nostd {
 		 */
 		void clear() noexcept
 		{
-			_destroy_helper(root_->left);
-			root_->left = nil_;
+			_destroy_tree(header_.left);
+			rb_tree_reset(&header_);
 			size_ = 0U;
 		}
 
@@ -263,15 +265,7 @@ namespace nostd {
 		 */
 		iterator begin() noexcept
 		{
-			node_t * x = root_->left;
-			if (x != nil_)
-			{
-				while (x->left != nil_)
-					x = x->left;
-				return iterator(this, x);
-			}
-			else
-				return end();
+			return iterator(this, header_.leftmost);
 		}
 
 		/**
@@ -281,7 +275,7 @@ namespace nostd {
 		 */
 		iterator end() noexcept
 		{
-			return iterator(this, nil_);
+			return iterator(this, rb_tree_nil());
 		}
 
 		/**
@@ -299,15 +293,14 @@ namespace nostd {
 		 */
 		utility::pair<iterator, bool> insert(const T& value) noexcept(false)
 		{
-			node_t * existing = _search(value);
-			if (existing != nil_)
+			rb_node_base * existing = _search(value);
+			if (existing != rb_tree_nil())
 				return utility::pair<iterator, bool>(iterator(this, existing), false);
 
 			node_t * x;
 			node_t * new_node;
 
-			x = _allocate_node();
-			x->data = value;
+			x = _create_node(value);
 
 			new_node = _insert(x);
 			return utility::pair<iterator, bool>(iterator(this, new_node), true);
@@ -328,15 +321,14 @@ namespace nostd {
 		 */
 		utility::pair<iterator, bool> insert(T && value) noexcept(false)
 		{
-			node_t * existing = _search(value);
-			if (existing != nil_)
+			rb_node_base * existing = _search(value);
+			if (existing != rb_tree_nil())
 				return utility::pair<iterator, bool>(iterator(this, existing), false);
 
 			node_t * x;
 			node_t * new_node;
 
-			x = _allocate_node();
-			x->data = utility::move(value);
+			x = _create_node(utility::move(value));
 
 			new_node = _insert(x);
 			return utility::pair<iterator, bool>(iterator(this, new_node), true);
@@ -356,8 +348,7 @@ namespace nostd {
 			node_t * x;
 			node_t * new_node;
 
-			x = _allocate_node();
-			x->data = value;
+			x = _create_node(value);
 
 			new_node = _insert(x);
 			return iterator(this, new_node);
@@ -377,13 +368,62 @@ namespace nostd {
 			node_t * x;
 			node_t * new_node;
 
-			x = _allocate_node();
-			x->data = utility::move(value);
+			x = _create_node(utility::move(value));
 
 			new_node = _insert(x);
 			return iterator(this, new_node);
 		}
 
+		/**
+		 * Constructs element in place from arguments.
+		 * Node is released if equivalent element exists.
+		 * 
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns a pair consisting of an iterator to the inserted element 
+		 *         (or to the element that prevented the insertion) and 
+		 *         a bool value set to true if the insertion took place.
+		 */
+		template <typename... Args>
+		utility::pair<iterator, bool> emplace(Args&&... args) noexcept(false)
+		{
+			node_t * x = _create_node(utility::forward<Args>(args)...);
+			rb_node_base * existing = _search(_key(x));
+			if (existing != rb_tree_nil())
+			{
+				_data(x).~T();
+				_free_node(x);
+				return utility::pair<iterator, bool>(iterator(this, existing), false);
+			}
+			return utility::pair<iterator, bool>(iterator(this, _insert(x)), true);
+		}
+
+		/**
+		 * Constructs element in place using position hint.
+		 * @see emplace
+		 * @see insert(iterator, const T&)
+		 * 
+		 * @param[in] hint The iterator to the element near the insertion point.
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns an iterator to the inserted element or to the element that prevented the insertion.
+		 */
+		template <typename... Args>
+		iterator emplace_hint(iterator hint, Args&&... args) noexcept(false)
+		{
+			node_t * x = _create_node(utility::forward<Args>(args)...);
+			rb_node_base * parent;
+			bool left;
+			rb_node_base * existing = _hint_position(hint.node_, _key(x), parent, left);
+			if (existing != nullptr)
+			{
+				_data(x).~T();
+				_free_node(x);
+				return iterator(this, existing);
+			}
+			return iterator(this, _insert_at(x, parent, left));
+		}
+
 		/**
 		 * Finds element in the set.
 		 * 
@@ -393,8 +433,26 @@ namespace nostd {
 		 */
 		iterator find(const T& value) noexcept
 		{
-			node_t * node = _search(value);
-			if (node != nil_)
+			rb_node_base * node = _search(value);
+			if (node != rb_tree_nil())
+				return iterator(this, node);
+			else
+				return end();
+		}
+
+		/**
+		 * Finds element in the set by value of other type.
+		 * Available only if Compare is transparent.
+		 * 
+		 * @param[in] value The value comparable with elements.
+		 * 
+		 * @return Returns an iterator to the found element or end iterator.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K& value) noexcept
+		{
+			rb_node_base * node = _search(value);
+			if (node != rb_tree_nil())
 				return iterator(this, node);
 			else
 				return end();
@@ -407,332 +465,440 @@ namespace nostd {
 		 */
 		void erase(iterator pos) noexcept(false)
 		{
-			if (pos.node_ == nil_)
+			if (pos.node_ == rb_tree_nil())
 				throw std::runtime_error("trying to erase nil node");
 			_delete(pos.node_);
 		}
 
 		/**
-		 * Removes all elements with value from the set.
+		 * Removes element equivalent to value from the set.
 		 * 
-		 * @param[in] value The value to match removable elements.
+		 * @param[in] value The value to match removable element.
 		 * 
 		 * @return Number of elements removed (0 or 1).
 		 */
 		size_type erase(const T& value) noexcept
 		{
-			size_type count = 0U;
-			node_t * node;
-			for (iterator it = begin(); it != end(); ++it)
-			{
-				node = it.node_;
-				if (node->data == value)
-				{
-					_delete(node);
-					++count;
-				}
-			}
-			return count;
+			rb_node_base * node = _search(value);
+			if (node == rb_tree_nil())
+				return 0U;
+			_delete(node);
+			return 1U;
 		}
 
 		/**
-		 * Swaps set with other one.
+		 * Returns iterator to the first element not less than value.
 		 * 
-		 * @param[in] other The other set.
+		 * @param[in] value The value.
+		 * 
+		 * @return Returns an iterator to the found element or end iterator.
 		 */
-		void swap(set & other) noexcept
+		iterator lower_bound(const T& value) noexcept
 		{
-			utility::swap(nil_, other.nil_);
-			utility::swap(root_, other.root_);
-			utility::swap(size_, other.size_);
-			utility::swap(allocator_, other.allocator_);
+			return iterator(this, _lower_bound(value));
 		}
 
-	private: // Helpers
+		/**
+		 * Returns iterator to the first element not less than value of other type.
+		 * Available only if Compare is transparent.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K& value) noexcept
+		{
+			return iterator(this, _lower_bound(value));
+		}
 
-		void _left_rotate(node_t * x) noexcept
+		/**
+		 * Returns iterator to the first element greater than value.
+		 * 
+		 * @param[in] value The value.
+		 * 
+		 * @return Returns an iterator to the found element or end iterator.
+		 */
+		iterator upper_bound(const T& value) noexcept
 		{
-			node_t * y;
+			return iterator(this, _upper_bound(value));
+		}
 
-			y = x->right;
-			x->right = y->left;
+		/**
+		 * Returns iterator to the first element greater than value of other type.
+		 * Available only if Compare is transparent.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K& value) noexcept
+		{
+			return iterator(this, _upper_bound(value));
+		}
 
-			if (y->left != nil_) y->left->parent = x; /* used to use sentinel here */
-			/* and do an unconditional assignment instead of testing for nil */
+		/**
+		 * Returns range of elements equivalent to value, it has at most one element.
+		 * 
+		 * @param[in] value The value.
+		 * 
+		 * @return Returns a pair of lower_bound and upper_bound iterators.
+		 */
+		utility::pair<iterator, iterator> equal_range(const T& value) noexcept
+		{
+			return _equal_range(value);
+		}
 
-			y->parent = x->parent;
+		/**
+		 * Returns range of elements equivalent to value of other type.
+		 * Available only if Compare is transparent.
+		 */
+		template <typename K, typename C = Compare, typename = typename C::is_transparent>
+		utility::pair<iterator, iterator> equal_range(const K& value) noexcept
+		{
+			return _equal_range(value);
+		}
 
-			/* instead of checking if x->parent is the root as in the book, we */
-			/* count on the root sentinel to implicitly take care of this case */
-			if (x == x->parent->left) {
-				x->parent->left = y;
-			} else {
-				x->parent->right = y;
+		/**
+		 * Removes range of elements from the set.
+		 * Every element is unlinked in place, no searches are made.
+		 * 
+		 * @param[in] first The iterator to the first element to remove.
+		 * @param[in] last  The iterator after the last element to remove.
+		 * 
+		 * @return Returns iterator following the last removed element.
+		 */
+		iterator erase(iterator first, iterator last) noexcept
+		{
+			rb_node_base * node = first.node_;
+			while (node != last.node_)
+			{
+				// Deletion relinks nodes, so the successor stays valid
+				rb_node_base * next = rb_tree_successor(node, &header_);
+				_delete(node);
+				node = next;
 			}
-			y->left = x;
-			x->parent = y;
+			return last;
 		}
 
-		void _right_rotate(node_t * y) noexcept
+		/**
+		 * Inserts element in the set using position hint.
+		 * Version that copies data.
+		 * Insertion is amortized O(1) if hint is end or the last element and element goes after it
+		 * (or hint is the first element and element goes before it), so feeding sorted input
+		 * with end or the previous result as a hint is fast.
+		 * Element going right before or after other hint costs O(log n) in the worst case to reach its neighbour,
+		 * any other hint falls back to regular search.
+		 * 
+		 * @param[in] hint  The iterator to the element near the insertion point.
+		 * @param[in] value The value.
+		 * 
+		 * @return Returns an iterator to the inserted element or to the element that prevented the insertion.
+		 */
+		iterator insert(iterator hint, const T& value) noexcept(false)
 		{
-			node_t * x;
-
-			x = y->left;
-			y->left = x->right;
+			rb_node_base * parent;
+			bool left;
+			rb_node_base * existing = _hint_position(hint.node_, value, parent, left);
+			if (existing != nullptr)
+				return iterator(this, existing);
+			node_t * x = _create_node(value);
+			return iterator(this, _insert_at(x, parent, left));
+		}
 
-			if (nil_ != x->right) x->right->parent = y; /*used to use sentinel here */
-			/* and do an unconditional assignment instead of testing for nil */
+		/**
+		 * Inserts element in the set using position hint.
+		 * Version that moves data.
+		 * @see insert(iterator, const T&)
+		 * 
+		 * @param[in] hint  The iterator to the element near the insertion point.
+		 * @param[in] value The value.
+		 * 
+		 * @return Returns an iterator to the inserted element or to the element that prevented the insertion.
+		 */
+		iterator insert(iterator hint, T && value) noexcept(false)
+		{
+			rb_node_base * parent;
+			bool left;
+			rb_node_base * existing = _hint_position(hint.node_, value, parent, left);
+			if (existing != nullptr)
+				return iterator(this, existing);
+			node_t * x = _create_node(utility::move(value));
+			return iterator(this, _insert_at(x, parent, left));
+		}
 
-			/* instead of checking if x->parent is the root as in the book, we */
-			/* count on the root sentinel to implicitly take care of this case */
-			x->parent = y->parent;
-			if (y == y->parent->left) {
-				y->parent->left = x;
-			} else {
-				y->parent->right = x;
-			}
-			x->right = y;
-			y->parent = x;
+		/**
+		 * Builds set from sorted range in linear time.
+		 * Elements should be strictly increasing by Compare.
+		 * 
+		 * @param[in] first The iterator to the first element.
+		 * @param[in] last  The iterator after the last element.
+		 * @param[in] alloc The allocator to be used to allocate nodes.
+		 * 
+		 * @return Returns the new set.
+		 */
+		template <typename InputIt>
+		static set from_sorted(InputIt first, InputIt last, Allocator * alloc = default_allocator::get_instance()) noexcept(false)
+		{
+			set result(alloc);
+			result._build_sorted(first, last);
+			return result;
 		}
 
-		node_t * _search(const T& data) noexcept
+		/**
+		 * Swaps set with other one.
+		 * 
+		 * @param[in] other The other set.
+		 */
+		void swap(set & other) noexcept
 		{
-			node_t * x = root_->left;
-			if (x == nil_)
-				return nil_;
-			while (!(data == x->data)) {
-				if (data < x->data)
-					x = x->left;
-				else
-					x = x->right;
-				if (x == nil_)
-					return nil_;
-			}
-			return x;
+			rb_tree_swap(&header_, &other.header_);
+			utility::swap(size_, other.size_);
+			utility::swap(allocator_, other.allocator_);
+			utility::swap(compare_, other.compare_);
 		}
 
-		void _insert_help(node_t * z) noexcept
+		/**
+		 * Unlinks element from the set and returns it as node handle.
+		 * The node isn't freed, so it may be inserted into another set.
+		 * 
+		 * @param[in] pos The iterator to the element.
+		 * 
+		 * @return Returns handle owning the node.
+		 */
+		node_type extract(iterator pos) noexcept(false)
 		{
-			node_t * x;
-			node_t * y;
+			if (pos.node_ == rb_tree_nil())
+				throw std::runtime_error("trying to extract nil node");
+			return _extract(pos.node_);
+		}
 
-			z->left = z->right = nil_;
-			y = root_;
-			x = root_->left;
-			while (x != nil_) {
-				y = x;
-				if (z->data < x->data) { /* x.data > z.data */
-					x = x->left;
-				} else { /* x.data <= z.data */
-					x = x->right;
-				}
-			}
-			z->parent = y;
-			if ((y == root_) ||
-				(z->data < y->data)) { /* y.data > z.data */
-				y->left = z;
-			} else {
-				y->right = z;
-			}
+		/**
+		 * Unlinks element with value from the set and returns it as node handle.
+		 * 
+		 * @param[in] value The value.
+		 * 
+		 * @return Returns handle owning the node or empty handle if there is no such element.
+		 */
+		node_type extract(const T& value) noexcept
+		{
+			rb_node_base * node = _search(value);
+			if (node == rb_tree_nil())
+				return node_type();
+			return _extract(node);
 		}
 
-		node_t * _insert(node_t * x) noexcept
+		/**
+		 * Inserts node owned by handle.
+		 * Node is linked as is if it has been allocated with the allocator of this set,
+		 * otherwise its value is moved to a new node.
+		 * 
+		 * @param[in] node The node handle.
+		 * 
+		 * @return Returns position of the equivalent element, whether insertion took place
+		 *         and the handle, which is empty unless insertion failed.
+		 */
+		insert_return_type insert(node_type && node) noexcept(false)
 		{
-			node_t * y;
-			node_t * new_node;
+			if (node.empty())
+				return insert_return_type{end(), false, node_type()};
+			rb_node_base * existing = _search(_key(node.node_));
+			if (existing != rb_tree_nil())
+				return insert_return_type{iterator(this, existing), false, utility::move(node)};
+			node_t * x = _adopt(node);
+			return insert_return_type{iterator(this, _insert(x)), true, node_type()};
+		}
 
-			_insert_help(x);
-			new_node = x;
-			x->red = true;
-			while (x->parent->red)
-			{ /* use sentinel instead of checking for root */
-				if (x->parent == x->parent->parent->left)
+		/**
+		 * Moves elements missing in this set from source set.
+		 * Nodes are relinked if both share the allocator, so nothing is allocated or moved.
+		 * 
+		 * @param[in] source The set to take elements from.
+		 */
+		void merge(set & source) noexcept(false)
+		{
+			if (&source == this)
+				return;
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * x = source.header_.leftmost;
+			while (x != nil)
+			{
+				// Unlinking relinks nodes, so the successor stays valid
+				rb_node_base * next = rb_tree_successor(x, &source.header_);
+				if (_search(_key(x)) == nil)
 				{
-					y = x->parent->parent->right;
-					if (y->red)
+					if (source.allocator_ == allocator_)
 					{
-						x->parent->red = false;
-						y->red = false;
-						x->parent->parent->red = true;
-						x = x->parent->parent;
+						rb_tree_erase(x, &source.header_);
+						--source.size_;
+						_insert(static_cast<node_t*>(x));
 					}
 					else
 					{
-						if (x == x->parent->right)
-						{
-							x = x->parent;
-							_left_rotate(x);
-						}
-						x->parent->red = false;
-						x->parent->parent->red = true;
-						_right_rotate(x->parent->parent);
+						_insert(_create_node(utility::move(_data(x))));
+						source._delete(x);
 					}
 				}
-				else
-				{ /* case for x->parent == x->parent->parent->right */
-					y = x->parent->parent->left;
-					if (y->red)
-					{
-						x->parent->red = false;
-						y->red = false;
-						x->parent->parent->red = true;
-						x = x->parent->parent;
-					}
-					else
-					{
-						if (x == x->parent->left)
-						{
-							x = x->parent;
-							_right_rotate(x);
-						}
-						x->parent->red = false;
-						x->parent->parent->red = true;
-						_left_rotate(x->parent->parent);
-					}
+				x = next;
+			}
+		}
+
+	private: // Helpers
+
+		static T& _data(rb_node_base * x) noexcept
+		{
+			return static_cast<node_t*>(x)->data;
+		}
+		static const T& _key(const rb_node_base * x) noexcept
+		{
+			return static_cast<const node_t*>(x)->data;
+		}
+
+		template <typename K>
+		rb_node_base * _search(const K& key) const noexcept
+		{
+			// The lowest node not less than key, one comparison per level
+			rb_node_base * candidate = _lower_bound(key);
+			if (candidate != rb_tree_nil() && compare_(key, _key(candidate)))
+				return rb_tree_nil();
+			return candidate;
+		}
+
+		template <typename K>
+		rb_node_base * _lower_bound(const K& key) const noexcept
+		{
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * x = header_.left;
+			rb_node_base * result = nil;
+			while (x != nil) {
+				if (!compare_(_key(x), key)) {
+					result = x;
+					x = x->left;
+				} else {
+					x = x->right;
 				}
 			}
-			root_->left->red = false;
-			++size_;
-			return new_node;
+			return result;
 		}
 
-		void _destroy_helper(node_t * x) noexcept
+		template <typename K>
+		rb_node_base * _upper_bound(const K& key) const noexcept
 		{
-			if (x != nil_) {
-				_destroy_helper(x->left);
-				_destroy_helper(x->right);
-				// Destroy data
-				x->data.~T(); // or: T data(utility::move(x->data));
-				_free_node(x);
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * x = header_.left;
+			rb_node_base * result = nil;
+			while (x != nil) {
+				if (compare_(key, _key(x))) {
+					result = x;
+					x = x->left;
+				} else {
+					x = x->right;
+				}
 			}
+			return result;
 		}
 
-		/* Performs rotations and changes colors to restore red-black properties after a node is deleted */
-		void _delete_fix_up(node_t * x) noexcept
+		template <typename K>
+		utility::pair<iterator, iterator> _equal_range(const K& key) noexcept
 		{
-			node_t * root = root_->left;
-			node_t * w;
+			rb_node_base * first = _lower_bound(key);
+			rb_node_base * last = first;
+			if (first != rb_tree_nil() && !compare_(key, _key(first)))
+				last = rb_tree_successor(first, &header_);
+			return utility::pair<iterator, iterator>(iterator(this, first), iterator(this, last));
+		}
 
-			while ((!x->red) && (root != x))
-			{
-				if (x == x->parent->left)
-				{
-					w = x->parent->right;
-					if (w->red)
-					{
-						w->red = false;
-						x->parent->red = true;
-						_left_rotate(x->parent);
-						w = x->parent->right;
-					}
-					if ((!w->right->red) && (!w->left->red) )
-					{
-						w->red = true;
-						x = x->parent;
+		/**
+		 * Finds where node with key may be linked next to hint.
+		 * Returns existing equivalent node or nullptr, parent is nullptr if hint didn't help.
+		 */
+		template <typename K>
+		rb_node_base * _hint_position(rb_node_base * hint, const K& key, rb_node_base *& parent, bool& left) noexcept
+		{
+			rb_node_base * nil = rb_tree_nil();
+			parent = nullptr;
+			left = false;
+			if (size_ == 0U)
+				return nullptr;
+			if (hint == nil) {
+				// Hint is end, new key should be the greatest one
+				rb_node_base * last = header_.rightmost;
+				if (compare_(_key(last), key)) {
+					parent = last;
+					return nullptr;
+				}
+			} else if (compare_(key, _key(hint))) {
+				// New key goes before hint, nothing precedes the leftmost node
+				rb_node_base * prev = (hint == header_.leftmost) ? nil : rb_tree_predecessor(hint, &header_);
+				if (prev == nil || compare_(_key(prev), key)) {
+					if (hint->left == nil) {
+						parent = hint;
+						left = true;
 					} else {
-						if (!w->right->red) {
-							w->left->red = false;
-							w->red = true;
-							_right_rotate(w);
-							w = x->parent->right;
-						}
-						w->red = x->parent->red;
-						x->parent->red = false;
-						w->right->red = false;
-						_left_rotate(x->parent);
-						x = root; /* this is to exit while loop */
-					}
-				} else { /* the code below is has left and right switched from above */
-					w = x->parent->left;
-					if (w->red) {
-						w->red = false;
-						x->parent->red = true;
-						_right_rotate(x->parent);
-						w = x->parent->left;
+						parent = prev; /* the rightmost node of the left subtree */
 					}
-					if ( (!w->right->red) && (!w->left->red) ) { 
-						w->red = true;
-						x = x->parent;
+					return nullptr;
+				}
+			} else if (compare_(_key(hint), key)) {
+				// New key goes after hint, nothing follows the rightmost node
+				rb_node_base * next = (hint == header_.rightmost) ? nil : rb_tree_successor(hint, &header_);
+				if (next == nil || compare_(key, _key(next))) {
+					if (hint->right == nil) {
+						parent = hint;
 					} else {
-						if (!w->left->red) {
-							w->right->red = false;
-							w->red = true;
-							_left_rotate(w);
-							w = x->parent->left;
-						}
-						w->red = x->parent->red;
-						x->parent->red = false;
-						w->left->red = false;
-						_right_rotate(x->parent);
-						x = root; /* this is to exit while loop */
+						parent = next; /* the leftmost node of the right subtree */
+						left = true;
 					}
+					return nullptr;
 				}
+			} else {
+				return hint;
 			}
-			x->red = false;
+			// Hint is wrong, fall back to regular search
+			rb_node_base * existing = _search(key);
+			return (existing != nil) ? existing : nullptr;
 		}
 
-		node_t * _tree_successor(node_t * x) noexcept
+		node_t * _insert_at(node_t * x, rb_node_base * parent, bool left) noexcept
 		{
-			node_t * y;
+			if (parent == nullptr)
+				return _insert(x);
+			rb_tree_insert(x, parent, left, &header_);
+			++size_;
+			return x;
+		}
 
-			if (nil_ != (y = x->right)) { /* assignment to y is intentional */
-				while (y->left != nil_) { /* returns the minium of the right subtree of x */
-					y = y->left;
-				}
-				return y;
-			} else {
-				y = x->parent;
-				while (x == y->right) { /* sentinel used instead of checking for nil */
-					x = y;
-					y = y->parent;
-				}
-				if (y == root_)
-					return nil_;
-				return y;
+		node_t * _insert(node_t * z) noexcept
+		{
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * y = &header_;
+			rb_node_base * x = header_.left;
+			bool left = true; /* the root is the left child of header */
+			while (x != nil) {
+				y = x;
+				left = compare_(_key(z), _key(x));
+				x = left ? x->left : x->right;
 			}
+			rb_tree_insert(z, y, left, &header_);
+			++size_;
+			return z;
 		}
 
-		void _delete(node_t * z) noexcept
+		void _destroy_tree(rb_node_base * x) noexcept
 		{
-			node_t * y;
-			node_t * x;
-			node_t * root = root_;
-
-			y = ((z->left == nil_) || (z->right == nil_)) ? z : _tree_successor(z);
-			x = (y->left == nil_) ? y->right : y->left;
-			if (root == (x->parent = y->parent)) { /* assignment of y->p to x->p is intentional */
-				root->left = x;
-			} else {
-				if (y == y->parent->left) {
-					y->parent->left = x;
-				} else {
-					y->parent->right = x;
-				}
+			// Nodes are returned to allocator in batches
+			node_release_batch<Allocator> release(allocator_, sizeof(node_t));
+			_destroy_helper(x, release);
+		}
+		void _destroy_helper(rb_node_base * x, node_release_batch<Allocator>& release) noexcept
+		{
+			if (x != rb_tree_nil()) {
+				_destroy_helper(x->left, release);
+				_destroy_helper(x->right, release);
+				// Destroy data
+				_data(x).~T();
+				release.add(reinterpret_cast<allocator::ptr_type>(static_cast<node_t*>(x)));
 			}
-			if (y != z) { /* y should not be nil in this case */
-
-				/* y is the node to splice out and x is its child */
-				if (!(y->red))
-					_delete_fix_up(x);
+		}
 
-				z->data.~T(); // call destructor
-				y->left = z->left;
-				y->right = z->right;
-				y->parent = z->parent;
-				y->red = z->red;
-				z->left->parent = z->right->parent = y;
-				if (z == z->parent->left) {
-					z->parent->left = y; 
-				} else {
-					z->parent->right = y;
-				}
-				_free_node(z);
-			} else {
-				y->data.~T(); // call destructor
-				if (!(y->red))
-					_delete_fix_up(x);
-				_free_node(y);
-			}
+		void _delete(rb_node_base * z) noexcept
+		{
+			rb_tree_erase(z, &header_);
+			_data(z).~T(); // call destructor
+			_free_node(z);
 			--size_;
 		}
 
@@ -742,77 +908,198 @@ namespace nostd {
 		{
 			return reinterpret_cast<node_t*>(allocator_->allocate(sizeof(node_t)));
 		}
-		void _free_node(node_t * node) noexcept
+		void _free_node(rb_node_base * node) noexcept
 		{
-			allocator_->free(reinterpret_cast<allocator::ptr_type>(node));
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(static_cast<node_t*>(node)), sizeof(node_t));
 		}
-		node_t * _make_nil_node() noexcept(false)
+		template <typename... Args>
+		node_t * _create_node(Args&&... args) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			new (node) node_t(node);
-			return node;
+			node_t * x = _allocate_node();
+			try
+			{
+				new (&x->data) T(utility::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				_free_node(x);
+				throw;
+			}
+			return x;
+		}
+		node_type _extract(rb_node_base * x) noexcept
+		{
+			rb_tree_erase(x, &header_);
+			--size_;
+			return node_type(static_cast<node_t*>(x), allocator_);
 		}
-		node_t * _make_root_node() noexcept(false)
+		node_t * _adopt(node_type& node) noexcept(false)
 		{
-			// NIL node should be initialized first
-			node_t * node = _allocate_node();
-			new (node) node_t(nil_);
-			return node;
+			if (node.allocator_ == allocator_)
+				return node._release();
+			// Node belongs to other allocator, so only the value is taken
+			node_t * x = _create_node(utility::move(node.node_->data));
+			node._clean();
+			return x;
 		}
 		void _clean() noexcept
 		{
-			if (root_ != nullptr)
-			{
-				_destroy_helper(root_->left);
-				_free_node(root_);
-				root_ = nullptr;
-			}
-			if (nil_ != nullptr)
-			{
-				_free_node(nil_);
-				nil_ = nullptr;
-			}
+			_destroy_tree(header_.left);
+			rb_tree_reset(&header_);
+			size_ = 0U;
 		}
 		void _set_by_copy(const set& other) noexcept(false)
 		{
 			// Clean old data
 			_clean();
 
-			// set values
-			nil_ = _make_nil_node();
-			root_ = _make_root_node();
+			// set values, nodes come from other's allocator
 			allocator_ = other.allocator_;
-			size_ = 0U;
+			compare_ = other.compare_;
 
-			// Copy other set nodes
-			node_t * x;
-			for (iterator it = other.begin(); it != other.end(); ++it)
+			// Clone tree structure with colors, so no rebalancing is needed
+			const rb_node_base * source = other.header_.left;
+			if (source == rb_tree_nil())
+				return;
+			try
 			{
-				x = _allocate_node();
-				x->data = it.node_->data;
-				(void)_insert(x);
+				node_allocation_batch<Allocator> batch(allocator_, sizeof(node_t), other.size_);
+				node_t * x = _clone_node(source, &header_, batch);
+				header_.left = x;
+				_clone_children(x, source, batch);
+				rb_tree_update_bounds(&header_);
 			}
+			catch (...)
+			{
+				clear();
+				throw;
+			}
+			size_ = other.size_;
+		}
+		node_t * _clone_node(const rb_node_base * source, rb_node_base * parent, node_allocation_batch<Allocator>& batch) noexcept(false)
+		{
+			node_t * x = reinterpret_cast<node_t*>(batch.next());
+			try
+			{
+				new (&x->data) T(static_cast<const node_t*>(source)->data);
+			}
+			catch (...)
+			{
+				_free_node(x);
+				throw;
+			}
+			x->parent_color = reinterpret_cast<std::uintptr_t>(parent);
+			x->set_red(source->red());
+			x->left = x->right = rb_tree_nil();
+			return x;
+		}
+		void _clone_children(rb_node_base * x, const rb_node_base * source, node_allocation_batch<Allocator>& batch) noexcept(false)
+		{
+			// Children are linked right away, so partial tree can be destroyed
+			rb_node_base * nil = rb_tree_nil();
+			if (source->left != nil)
+			{
+				x->left = _clone_node(source->left, x, batch);
+				_clone_children(x->left, source->left, batch);
+			}
+			if (source->right != nil)
+			{
+				x->right = _clone_node(source->right, x, batch);
+				_clone_children(x->right, source->right, batch);
+			}
+		}
+		template <typename InputIt>
+		void _build_sorted(InputIt first, InputIt last) noexcept(false)
+		{
+			// Chain nodes through right links at first
+			rb_node_base * nil = rb_tree_nil();
+			rb_node_base * head = nil;
+			rb_node_base * tail = nullptr;
+			size_type count = 0U;
+			node_allocation_batch<Allocator> batch(allocator_, sizeof(node_t), 0U);
+			try
+			{
+				for (; first != last; ++first)
+				{
+					node_t * x = reinterpret_cast<node_t*>(batch.next());
+					try
+					{
+						new (&x->data) T(*first);
+					}
+					catch (...)
+					{
+						_free_node(x);
+						throw;
+					}
+					x->right = nil;
+					assert((tail == nullptr || compare_(_key(tail), _key(x))) && "Range should be sorted");
+					if (tail != nullptr)
+						tail->right = x;
+					else
+						head = x;
+					tail = x;
+					++count;
+				}
+			}
+			catch (...)
+			{
+				while (head != nil)
+				{
+					rb_node_base * next = head->right;
+					_data(head).~T();
+					_free_node(head);
+					head = next;
+				}
+				throw;
+			}
+			clear();
+			// Levels above the last one are full, nodes of the incomplete last level are red
+			size_type red_depth = 0U;
+			while ((static_cast<unsigned long long>(2) << red_depth) <= static_cast<unsigned long long>(count) + 1U)
+				++red_depth;
+			rb_node_base * x = _build_balanced(head, count, 0U, red_depth);
+			if (x != nil)
+				x->set_parent(&header_);
+			header_.left = x;
+			rb_tree_update_bounds(&header_);
+			size_ = count;
+		}
+		rb_node_base * _build_balanced(rb_node_base *& list, size_type count, size_type depth, size_type red_depth) noexcept
+		{
+			rb_node_base * nil = rb_tree_nil();
+			if (count == 0U)
+				return nil;
+			const size_type left_count = count / 2U;
+			rb_node_base * left = _build_balanced(list, left_count, depth + 1U, red_depth);
+			rb_node_base * x = list;
+			list = list->right;
+			// Parent is linked by the caller
+			x->parent_color = static_cast<std::uintptr_t>(depth == red_depth);
+			x->left = left;
+			if (left != nil)
+				left->set_parent(x);
+			x->right = _build_balanced(list, count - left_count - 1U, depth + 1U, red_depth);
+			if (x->right != nil)
+				x->right->set_parent(x);
+			return x;
 		}
 		void _set_by_move(set && other) noexcept
 		{
 			// Clean old data
 			_clean();
-			// Copy other fields
-			nil_ = other.nil_;
-			root_ = other.root_;
+			// Take other's tree, only the root is relinked to the header
+			rb_tree_move(&header_, &other.header_);
 			allocator_ = other.allocator_;
+			compare_ = other.compare_;
 			size_ = other.size_;
-			// Nullify other
-			other.nil_ = nullptr;
-			other.root_ = nullptr;
-			other.allocator_ = nullptr;
+			// Other stays empty and keeps the allocator
 			other.size_ = 0U;
 		}
 
-		node_t * nil_;
-		node_t * root_;
-		allocator * allocator_;
+		rb_tree_header header_; // parent of the root, embedded so empty set doesn't allocate
+		Allocator * allocator_;
 		size_type size_;
+		Compare compare_;
 	};
 
 } // namespace nostd
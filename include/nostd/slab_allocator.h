@@ -0,0 +1,188 @@
+#ifndef __NOSTD_SLAB_ALLOCATOR_H__
+#define __NOSTD_SLAB_ALLOCATOR_H__
+
+#include "allocator.h"
+#include "pool_allocator.h"
+#include "stack_linked_list.h"
+#include "vector.h"
+
+namespace nostd {
+
+	/**
+	 * Slab allocator.
+	 * General purpose allocator that routes requests to per-size-class pools.
+	 * Size classes are geometric (8, 16, 24, 32, 48, 64, ... 3072, 4096 bytes),
+	 * larger requests are forwarded to the parent allocator.
+	 *
+	 * Pools take their buffers from pages of `page_size` bytes aligned to `page_size`.
+	 * Every page starts with a header holding its size class, so the owning pool is found
+	 * by masking the pointer and checking the page against the sorted list of segments.
+	 * Blocks are aligned to the largest power of two dividing their class size,
+	 * but not more than max_align_t.
+	 */
+	class slab_allocator final
+	: public allocator
+	{
+
+		/**
+		 * Header placed at the beginning of every page
+		 */
+		struct page_header_t {
+			size_type size_class;
+		};
+
+		/**
+		 * Upstream of a single pool, hands out pages of its size class
+		 */
+		class page_source final
+		: public allocator
+		{
+		public:
+			page_source() noexcept;
+			void init(slab_allocator * slab, size_type size_class) noexcept;
+			ptr_type allocate(size_type size) noexcept(false) final;
+			void free(ptr_type ptr) noexcept final;
+		private:
+			slab_allocator * slab_;
+			size_type size_class_;
+		};
+
+		/**
+		 * Range of pages obtained from parent by single allocation
+		 */
+		struct segment_t {
+			byte_type * begin; //!< first page
+			byte_type * raw;   //!< pointer returned by parent
+		};
+
+	public:
+
+		static const size_type page_size = 1U << 16;        //!< size of page
+		static const size_type page_header_size = 64U;      //!< space reserved for page header
+		static const size_type pages_per_segment = 16U;     //!< number of pages allocated at once
+		static const size_type max_size = 4096U;           //!< largest size served by pools
+		static const size_type num_size_classes = 18U;     //!< number of size classes
+
+		/**
+		 * Constructor.
+		 * Default allocator is used as parent.
+		 */
+		slab_allocator() noexcept;
+
+		/**
+		 * Constructor with parent allocator
+		 *
+		 * @param[in] parent The allocator to be used for segments and large blocks
+		 */
+		slab_allocator(allocator * parent) noexcept;
+
+		/**
+		 * Destructor
+		 */
+		~slab_allocator();
+
+		/**
+		 * Allocates block of memory
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		ptr_type allocate(size_type size) noexcept(false) final;
+
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void free(ptr_type ptr) noexcept final;
+
+		/**
+		 * Releases block of memory that was allocated previously.
+		 * Size class is taken from size, so no page lookup is needed.
+		 *
+		 * @param[in] ptr  Pointer to block of memory
+		 * @param[in] size Size that was passed to allocate
+		 */
+		void free(ptr_type ptr, size_type size) noexcept final;
+
+		/**
+		 * Allocates several blocks of memory of the same size.
+		 * Pool of the size class hands out a whole run of chunks, large blocks are delegated to the parent.
+		 *
+		 * @param[in]  size  Size of every memory block
+		 * @param[in]  count Number of blocks
+		 * @param[out] out   Array of count pointers to be filled with blocks
+		 */
+		void allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false) final;
+
+		/**
+		 * Releases several blocks of memory of the same size.
+		 *
+		 * @param[in] size  Size that was passed to allocate
+		 * @param[in] count Number of blocks
+		 * @param[in] ptrs  Array of count pointers to blocks
+		 */
+		void free_batch(size_type size, size_type count, ptr_type * ptrs) noexcept final;
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Succeeds if both sizes belong to the same size class,
+		 * large blocks are delegated to the parent.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final;
+
+		/**
+		 * Changes size of block of memory, block may be moved.
+		 * Large blocks are reallocated by the parent.
+		 *
+		 * @param[in] ptr      Pointer to block of memory or nullptr
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return Pointer to resized block of memory.
+		 */
+		ptr_type reallocate(ptr_type ptr, size_type old_size, size_type new_size) noexcept(false) final;
+
+		/**
+		 * Returns size class index for the size, size should not exceed max_size
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		static size_type size_class(size_type size) noexcept;
+
+		/**
+		 * Returns block size of size class
+		 *
+		 * @param[in] index Size class index
+		 */
+		static size_type class_size(size_type index) noexcept;
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		slab_allocator(const slab_allocator&) = delete;
+		slab_allocator& operator =(const slab_allocator&) = delete;
+
+		pool_allocator * _pool(size_type index) noexcept(false);
+		byte_type * _allocate_page(size_type index) noexcept(false);
+		void _free_page(byte_type * page) noexcept;
+		void _allocate_segment() noexcept(false);
+		bool _owns_page(const byte_type * page) const noexcept;
+
+		allocator * parent_;
+		pool_allocator * pools_[num_size_classes];
+		page_source page_sources_[num_size_classes];
+		stack_linked_list free_pages_;
+		vector<segment_t> segments_; //!< sorted by address
+	};
+
+} // namespace nostd
+
+#endif
\ No newline at end of file
@@ -0,0 +1,322 @@
+#ifndef __NOSTD_SMALL_VECTOR_H__
+#define __NOSTD_SMALL_VECTOR_H__
+
+#include "vector.h"
+
+namespace nostd {
+
+	/**
+	 * Allocator with a single inline block of Size bytes.
+	 * Block is handed out while it's unused and fits the request,
+	 * other requests are forwarded to the upstream allocator.
+	 */
+	template <allocator::size_type Size, allocator::size_type Alignment>
+	class inline_allocator final
+	: public allocator
+	{
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] upstream The allocator to be used when inline block doesn't fit
+		 */
+		explicit inline_allocator(allocator * upstream) noexcept
+		: upstream_(upstream)
+		, used_(false)
+		{
+		}
+
+		/**
+		 * Allocates block of memory
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		ptr_type allocate(size_type size) noexcept(false) final
+		{
+			if (!used_ && size <= Size)
+			{
+				used_ = true;
+				return reinterpret_cast<ptr_type>(buffer_);
+			}
+			return upstream_->allocate(size);
+		}
+
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void free(ptr_type ptr) noexcept final
+		{
+			if (owns(ptr))
+				used_ = false;
+			else
+				upstream_->free(ptr);
+		}
+
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr  Pointer to block of memory
+		 * @param[in] size Size that was passed to allocate
+		 */
+		void free(ptr_type ptr, size_type size) noexcept final
+		{
+			if (owns(ptr))
+				used_ = false;
+			else
+				upstream_->free(ptr, size);
+		}
+
+		/**
+		 * Tries to change size of block of memory in place.
+		 * Inline block may grow up to Size bytes.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final
+		{
+			if (owns(ptr))
+				return new_size <= Size;
+			return upstream_->try_expand(ptr, old_size, new_size);
+		}
+
+		/**
+		 * Changes size of block of memory, block may be moved.
+		 * Blocks that are already out of line are reallocated by the upstream.
+		 *
+		 * @param[in] ptr      Pointer to block of memory or nullptr
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return Pointer to resized block of memory.
+		 */
+		ptr_type reallocate(ptr_type ptr, size_type old_size, size_type new_size) noexcept(false) final
+		{
+			if (ptr != nullptr && !owns(ptr) && new_size > Size)
+				return upstream_->reallocate(ptr, old_size, new_size);
+			return allocator::reallocate(ptr, old_size, new_size);
+		}
+
+		/**
+		 * Checks if pointer is the inline block
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		bool owns(const void * ptr) const noexcept
+		{
+			return ptr == reinterpret_cast<const void*>(buffer_);
+		}
+
+		/**
+		 * Returns upstream allocator
+		 */
+		allocator * upstream() const noexcept
+		{
+			return upstream_;
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move, inline block can't change owner
+		 */
+		inline_allocator(const inline_allocator&) = delete;
+		inline_allocator& operator =(const inline_allocator&) = delete;
+
+		alignas(Alignment) byte_type buffer_[Size];
+		allocator * upstream_;
+		bool used_;
+	};
+
+	/**
+	 * Holds inline allocator of small_vector, so it's constructed before the array.
+	 */
+	template <allocator::size_type Size, allocator::size_type Alignment>
+	struct small_vector_storage {
+		explicit small_vector_storage(allocator * upstream) noexcept
+		: inline_allocator_(upstream)
+		{
+		}
+		inline_allocator<Size, Alignment> inline_allocator_;
+	};
+
+	/**
+	 * Defines array container with inline storage for N elements (analog of llvm::SmallVector).
+	 * Has the same interface as vector, the allocator is used only when size exceeds N.
+	 * Elements are stored inline, so move of a small array moves every element.
+	 * @see vector
+	 */
+	template <typename T, allocator::size_type N, typename Growth = default_growth>
+	class small_vector
+	: private small_vector_storage<sizeof(T) * N, alignof(T)>
+	, private vector<T, Growth>
+	{
+		static_assert(N != 0U, "Use vector for arrays without inline storage");
+
+		using storage_type = small_vector_storage<sizeof(T) * N, alignof(T)>;
+		using base_type = vector<T, Growth>;
+
+	public:
+
+		using typename base_type::size_type;
+		using typename base_type::iterator;
+
+		static const allocator::size_type inline_capacity = N; //!< number of elements stored inline
+
+		/**
+		 * Default constructor.
+		 */
+		small_vector() noexcept
+		: small_vector(default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] alloc The allocator to be used when inline storage is exceeded.
+		 */
+		small_vector(allocator * alloc) noexcept
+		: storage_type(alloc)
+		, base_type(&this->inline_allocator_)
+		{
+			base_type::reserve(N);
+		}
+
+		/**
+		 * Copy constructor.
+		 *
+		 * @param[in] other The other array.
+		 */
+		small_vector(const small_vector& other) noexcept(false)
+		: small_vector(other.inline_allocator_.upstream())
+		{
+			_copy_from(other);
+		}
+
+		/**
+		 * Move constructor.
+		 *
+		 * @param[in] other The other array.
+		 */
+		small_vector(small_vector && other) noexcept(false)
+		: small_vector(other.inline_allocator_.upstream())
+		{
+			_move_from(other);
+		}
+
+		/**
+		 * Copy assignment.
+		 *
+		 * @param[in] other The other array.
+		 */
+		small_vector& operator =(const small_vector& other) noexcept(false)
+		{
+			if (this != &other)
+			{
+				base_type::clear();
+				_copy_from(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Move assignment.
+		 *
+		 * @param[in] other The other array.
+		 */
+		small_vector& operator =(small_vector && other) noexcept(false)
+		{
+			if (this != &other)
+			{
+				base_type::clear();
+				_move_from(other);
+			}
+			return *this;
+		}
+
+		using base_type::operator [];
+		using base_type::at;
+		using base_type::empty;
+		using base_type::size;
+		using base_type::capacity;
+		using base_type::data;
+		using base_type::front;
+		using base_type::back;
+		using base_type::begin;
+		using base_type::end;
+		using base_type::clear;
+		using base_type::reserve;
+		using base_type::resize;
+		using base_type::emplace_back;
+		using base_type::push_back;
+		using base_type::pop_back;
+		using base_type::emplace;
+		using base_type::insert;
+		using base_type::erase;
+
+		/**
+		 * Checks if elements are stored inline.
+		 *
+		 * @return Returns true if no allocation has been made and false otherwise.
+		 */
+		bool is_inline() const noexcept
+		{
+			return storage_type::inline_allocator_.owns(base_type::buffer_);
+		}
+
+		/**
+		 * Swaps content with the other container.
+		 *
+		 * @param[in] other  The other container.
+		 */
+		void swap(small_vector& other) noexcept(false)
+		{
+			small_vector temp(utility::move(other));
+			other = utility::move(*this);
+			*this = utility::move(temp);
+		}
+
+	private:
+
+		void _copy_from(const small_vector& other) noexcept(false)
+		{
+			base_type::reserve(other.size());
+			for (size_type i = 0U; i < other.size(); ++i)
+				base_type::push_back(other.data()[i]);
+		}
+		void _move_from(small_vector& other) noexcept(false)
+		{
+			if (!other.is_inline() && other.base_type::buffer_ != nullptr &&
+				other.inline_allocator_.upstream() == storage_type::inline_allocator_.upstream())
+			{
+				// Take out of line buffer, both arrays share the upstream
+				base_type::_clean();
+				base_type::buffer_ = other.base_type::buffer_;
+				base_type::buffer_size_ = other.base_type::buffer_size_;
+				base_type::size_ = other.base_type::size_;
+				other.base_type::buffer_ = nullptr;
+				other.base_type::buffer_size_ = 0U;
+				other.base_type::size_ = 0U;
+				other.base_type::reserve(N);
+				return;
+			}
+			base_type::reserve(other.size());
+			for (size_type i = 0U; i < other.size(); ++i)
+				base_type::emplace_back(utility::move(other.data()[i]));
+			other.clear();
+		}
+	};
+
+	template <typename T, allocator::size_type N, typename Growth>
+	const allocator::size_type small_vector<T, N, Growth>::inline_capacity;
+
+} // namespace nostd
+
+#endif
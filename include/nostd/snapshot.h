@@ -0,0 +1,651 @@
+#ifndef __NOSTD_SNAPSHOT_H__
+#define __NOSTD_SNAPSHOT_H__
+
+#include "allocator.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "functional.h"
+#include "hash.h"
+#include "vector.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Kind of container stored in snapshot.
+	 */
+	enum class snapshot_kind : std::uint16_t {
+		vector = 1,
+		flat_map = 2,
+		hash_map = 3
+	};
+
+	/**
+	 * File format of snapshots, not for direct use.
+	 * File starts with header, sections follow it at offsets aligned to section_alignment.
+	 * Offsets are relative to the beginning of file, so mapped file is usable at any address.
+	 * Sections hold arrays of trivially copyable elements in native byte order.
+	 */
+	namespace snapshot_detail {
+
+		const std::uint32_t magic = 0x504e534eU;		//!< "NSNP"
+		const std::uint32_t byte_order = 0x01020304U;	//!< differs on machines with other byte order
+		const std::uint16_t version = 1U;				//!< incremented on incompatible format changes
+		const std::uint64_t section_alignment = 64U;
+		const std::uint32_t max_sections = 3U;
+
+		struct section_t {
+			std::uint64_t offset;
+			std::uint64_t size;
+			std::uint64_t checksum;
+		};
+
+		struct header_t {
+			std::uint32_t magic;
+			std::uint32_t byte_order;
+			std::uint16_t version;
+			std::uint16_t kind;
+			std::uint32_t num_sections;
+			std::uint32_t key_size;		//!< size of key, zero for vector
+			std::uint32_t value_size;
+			std::uint64_t count;		//!< number of elements
+			std::uint64_t file_size;
+			section_t sections[max_sections];
+		};
+
+		/**
+		 * Defines data of section to be written.
+		 */
+		struct part_t {
+			const void * data;
+			std::uint64_t size;
+		};
+
+		/**
+		 * Computes checksum of bytes. It detects corruption, not intentional modification.
+		 *
+		 * @param[in] data The bytes.
+		 * @param[in] size Number of bytes.
+		 *
+		 * @return Returns the checksum.
+		 */
+		std::uint64_t checksum(const void * data, std::uint64_t size) noexcept;
+
+		/**
+		 * Writes header and sections to file, offsets, sizes and checksums of sections are filled.
+		 *
+		 * @param[in] path   The file path.
+		 * @param[in] header The header with kind, sizes and number of sections set.
+		 * @param[in] parts  Data of sections.
+		 */
+		void write_file(const char * path, header_t& header, const part_t * parts) noexcept(false);
+
+		/**
+		 * Fills header fields common for all kinds.
+		 */
+		inline header_t make_header(snapshot_kind kind, std::uint32_t num_sections,
+			std::uint32_t key_size, std::uint32_t value_size, std::uint64_t count) noexcept
+		{
+			header_t header = header_t();
+			header.magic = magic;
+			header.byte_order = byte_order;
+			header.version = version;
+			header.kind = static_cast<std::uint16_t>(kind);
+			header.num_sections = num_sections;
+			header.key_size = key_size;
+			header.value_size = value_size;
+			header.count = count;
+			return header;
+		}
+
+		/**
+		 * Returns number of slots of index table for count elements, at most half of slots are used.
+		 */
+		inline std::uint64_t index_capacity(std::uint64_t count) noexcept
+		{
+			std::uint64_t capacity = 8U;
+			while (capacity < count * 2U)
+				capacity <<= 1;
+			return capacity;
+		}
+
+		template <typename T>
+		struct checked_type {
+			static_assert(std::is_trivially_copyable<T>::value, "Snapshot element should be trivially copyable");
+			static_assert(alignof(T) <= section_alignment, "Snapshot element alignment is too big");
+		};
+
+	} // namespace snapshot_detail
+
+	/**
+	 * Read-only view of array stored in snapshot.
+	 * View is valid while snapshot exists.
+	 */
+	template <typename T>
+	class vector_view {
+		friend class snapshot;
+
+	public:
+
+		using size_type = allocator::size_type;
+		using iterator = const T*;
+
+		/**
+		 * Default constructor, creates empty view.
+		 */
+		vector_view() noexcept
+		: data_(nullptr)
+		, size_(0U)
+		{
+		}
+
+		/**
+		 * Returns pointer to the first element.
+		 */
+		const T* data() const noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * Checks if view is empty.
+		 */
+		bool empty() const noexcept
+		{
+			return size_ == 0U;
+		}
+
+		/**
+		 * Element access without bounds check.
+		 *
+		 * @param[in] index The index of element.
+		 *
+		 * @return Returns reference to element.
+		 */
+		const T& operator [](size_type index) const noexcept
+		{
+			return data_[index];
+		}
+
+		/**
+		 * Element access with bounds check.
+		 *
+		 * @param[in] index The index of element.
+		 *
+		 * @return Returns reference to element.
+		 */
+		const T& at(size_type index) const noexcept(false)
+		{
+			if (index >= size_)
+				throw std::range_error("index out of range");
+			return data_[index];
+		}
+
+		iterator begin() const noexcept
+		{
+			return data_;
+		}
+
+		iterator end() const noexcept
+		{
+			return data_ + size_;
+		}
+
+	private:
+
+		vector_view(const T * data, size_type size) noexcept
+		: data_(data)
+		, size_(size)
+		{
+		}
+
+		const T * data_;
+		size_type size_;
+	};
+
+	/**
+	 * Read-only view of ordered map stored in snapshot.
+	 * Keys and values are stored in separate sorted arrays, lookup is a binary search over keys.
+	 * Compare should order keys the same way as the saved map did.
+	 */
+	template <typename Key, typename T, typename Compare = less<Key>>
+	class flat_map_view {
+		friend class snapshot;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Default constructor, creates empty view.
+		 */
+		flat_map_view() noexcept
+		: keys_()
+		, values_()
+		, compare_()
+		{
+		}
+
+		/**
+		 * Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			return keys_.size();
+		}
+
+		/**
+		 * Checks if view is empty.
+		 */
+		bool empty() const noexcept
+		{
+			return keys_.empty();
+		}
+
+		/**
+		 * Returns sorted keys.
+		 */
+		const vector_view<Key>& keys() const noexcept
+		{
+			return keys_;
+		}
+
+		/**
+		 * Returns values in order of keys.
+		 */
+		const vector_view<T>& values() const noexcept
+		{
+			return values_;
+		}
+
+		/**
+		 * Finds value by key.
+		 *
+		 * @param[in] key The key.
+		 *
+		 * @return Returns pointer to value or nullptr if key is missing.
+		 */
+		const T* find(const Key& key) const noexcept
+		{
+			size_type first = 0U;
+			size_type count = keys_.size();
+			while (count != 0U)
+			{
+				const size_type step = count / 2U;
+				if (compare_(keys_[first + step], key))
+				{
+					first += step + 1U;
+					count -= step + 1U;
+				}
+				else
+					count = step;
+			}
+			if (first < keys_.size() && !compare_(key, keys_[first]))
+				return values_.data() + first;
+			return nullptr;
+		}
+
+		/**
+		 * Checks if map contains key.
+		 *
+		 * @param[in] key The key.
+		 */
+		bool contains(const Key& key) const noexcept
+		{
+			return find(key) != nullptr;
+		}
+
+	private:
+
+		flat_map_view(const vector_view<Key>& keys, const vector_view<T>& values) noexcept
+		: keys_(keys)
+		, values_(values)
+		, compare_()
+		{
+		}
+
+		vector_view<Key> keys_;
+		vector_view<T> values_;
+		Compare compare_;
+	};
+
+	/**
+	 * Read-only view of hash map stored in snapshot.
+	 * Keys and values are stored in separate arrays, index table of open addressing
+	 * with linear probing holds element index plus one, zero marks free slot.
+	 * Hash should give the same values as the one used to save map.
+	 */
+	template <typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>>
+	class hash_map_view {
+		friend class snapshot;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Default constructor, creates empty view.
+		 */
+		hash_map_view() noexcept
+		: keys_()
+		, values_()
+		, index_()
+		, hash_()
+		, equal_()
+		{
+		}
+
+		/**
+		 * Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			return keys_.size();
+		}
+
+		/**
+		 * Checks if view is empty.
+		 */
+		bool empty() const noexcept
+		{
+			return keys_.empty();
+		}
+
+		/**
+		 * Returns keys in unspecified order.
+		 */
+		const vector_view<Key>& keys() const noexcept
+		{
+			return keys_;
+		}
+
+		/**
+		 * Returns values in order of keys.
+		 */
+		const vector_view<T>& values() const noexcept
+		{
+			return values_;
+		}
+
+		/**
+		 * Finds value by key.
+		 *
+		 * @param[in] key The key.
+		 *
+		 * @return Returns pointer to value or nullptr if key is missing.
+		 */
+		const T* find(const Key& key) const noexcept
+		{
+			if (index_.empty())
+				return nullptr;
+			const size_type mask = index_.size() - 1U;
+			size_type slot = static_cast<size_type>(hash_(key)) & mask;
+			// Entries are validated on open, probing is bounded by table size anyway
+			for (size_type i = 0U; i < index_.size(); ++i, slot = (slot + 1U) & mask)
+			{
+				const std::uint32_t entry = index_[slot];
+				if (entry == 0U)
+					return nullptr;
+				if (equal_(keys_[entry - 1U], key))
+					return values_.data() + (entry - 1U);
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Checks if map contains key.
+		 *
+		 * @param[in] key The key.
+		 */
+		bool contains(const Key& key) const noexcept
+		{
+			return find(key) != nullptr;
+		}
+
+	private:
+
+		hash_map_view(const vector_view<Key>& keys, const vector_view<T>& values,
+			const vector_view<std::uint32_t>& index) noexcept
+		: keys_(keys)
+		, values_(values)
+		, index_(index)
+		, hash_()
+		, equal_()
+		{
+		}
+
+		vector_view<Key> keys_;
+		vector_view<T> values_;
+		vector_view<std::uint32_t> index_;
+		Hash hash_;
+		KeyEqual equal_;
+	};
+
+	/**
+	 * Read-only snapshot of container mapped from file.
+	 * Data is used in place without deserialization, pages are loaded by the system on first access.
+	 * Header is validated on open: magic, byte order, version, sizes and section bounds.
+	 * Checksums of sections are verified on request, since that reads the whole file.
+	 * Without verification corrupted data gives wrong results, but structure of file is always validated,
+	 * so lookups never read out of mapping.
+	 * Hash map snapshots are the exception to loading on demand: entries of index section are
+	 * validated on open, so the whole index section is faulted in.
+	 * Views returned by the snapshot are valid while it exists.
+	 * @see save_snapshot
+	 */
+	class snapshot {
+	public:
+
+		using size_type = allocator::size_type;
+		using byte_type = allocator::byte_type;
+
+		/**
+		 * Opens and maps snapshot file.
+		 *
+		 * @param[in] path   The file path.
+		 * @param[in] verify Verify checksums of sections, that reads the whole file.
+		 */
+		explicit snapshot(const char * path, bool verify = false) noexcept(false);
+
+		/**
+		 * Destructor, unmaps file.
+		 */
+		~snapshot();
+
+		/**
+		 * Returns kind of stored container.
+		 */
+		snapshot_kind kind() const noexcept;
+
+		/**
+		 * Returns number of stored elements.
+		 */
+		size_type size() const noexcept;
+
+		/**
+		 * Verifies checksums of all sections.
+		 *
+		 * @return Returns true if all checksums match and false otherwise.
+		 */
+		bool verify() const noexcept;
+
+		/**
+		 * Returns view of stored array.
+		 * Throws runtime_error if snapshot holds other kind or element size differs.
+		 *
+		 * @return Returns the view.
+		 */
+		template <typename T>
+		vector_view<T> as_vector() const noexcept(false)
+		{
+			(void)sizeof(snapshot_detail::checked_type<T>);
+			_check(snapshot_kind::vector, 0U, sizeof(T));
+			return vector_view<T>(_section<T>(0U), size());
+		}
+
+		/**
+		 * Returns view of stored ordered map.
+		 * Throws runtime_error if snapshot holds other kind or key or value size differs.
+		 *
+		 * @return Returns the view.
+		 */
+		template <typename Key, typename T, typename Compare = less<Key>>
+		flat_map_view<Key, T, Compare> as_flat_map() const noexcept(false)
+		{
+			(void)sizeof(snapshot_detail::checked_type<Key>);
+			(void)sizeof(snapshot_detail::checked_type<T>);
+			_check(snapshot_kind::flat_map, sizeof(Key), sizeof(T));
+			return flat_map_view<Key, T, Compare>(
+				vector_view<Key>(_section<Key>(0U), size()),
+				vector_view<T>(_section<T>(1U), size()));
+		}
+
+		/**
+		 * Returns view of stored hash map.
+		 * Throws runtime_error if snapshot holds other kind or key or value size differs.
+		 *
+		 * @return Returns the view.
+		 */
+		template <typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>>
+		hash_map_view<Key, T, Hash, KeyEqual> as_hash_map() const noexcept(false)
+		{
+			(void)sizeof(snapshot_detail::checked_type<Key>);
+			(void)sizeof(snapshot_detail::checked_type<T>);
+			_check(snapshot_kind::hash_map, sizeof(Key), sizeof(T));
+			return hash_map_view<Key, T, Hash, KeyEqual>(
+				vector_view<Key>(_section<Key>(0U), size()),
+				vector_view<T>(_section<T>(1U), size()),
+				vector_view<std::uint32_t>(_section<std::uint32_t>(2U), _index_size()));
+		}
+
+	private:
+
+		/**
+		 * Disallow default constructor, copy and move
+		 */
+		snapshot() = delete;
+		snapshot(const snapshot&) = delete;
+		snapshot& operator =(const snapshot&) = delete;
+
+		template <typename T>
+		const T* _section(std::uint32_t index) const noexcept
+		{
+			return reinterpret_cast<const T*>(data_ + _header()->sections[index].offset);
+		}
+
+		const snapshot_detail::header_t * _header() const noexcept;
+		size_type _index_size() const noexcept;
+		void _validate() const noexcept(false);
+		void _check(snapshot_kind kind, std::uint32_t key_size, std::uint32_t value_size) const noexcept(false);
+		void _unmap() noexcept;
+
+		const byte_type * data_;
+		std::uint64_t size_;
+	};
+
+	/**
+	 * Saves array to snapshot file.
+	 *
+	 * @param[in] path  The file path.
+	 * @param[in] array The array of trivially copyable elements.
+	 */
+	template <typename T, typename Growth, typename Allocator>
+	void save_snapshot(const char * path, const vector<T, Growth, Allocator>& array) noexcept(false)
+	{
+		(void)sizeof(snapshot_detail::checked_type<T>);
+		snapshot_detail::header_t header = snapshot_detail::make_header(snapshot_kind::vector, 1U, 0U, sizeof(T), array.size());
+		const snapshot_detail::part_t parts[] = {
+			{array.data(), static_cast<std::uint64_t>(array.size()) * sizeof(T)}
+		};
+		snapshot_detail::write_file(path, header, parts);
+	}
+
+	/**
+	 * Saves ordered map to snapshot file.
+	 * @see flat_map_view
+	 *
+	 * @param[in] path The file path.
+	 * @param[in] map  The map with trivially copyable keys and values.
+	 */
+	template <typename Key, typename T, typename Compare>
+	void save_snapshot(const char * path, const flat_map<Key, T, Compare>& map) noexcept(false)
+	{
+		(void)sizeof(snapshot_detail::checked_type<Key>);
+		(void)sizeof(snapshot_detail::checked_type<T>);
+		const allocator::size_type count = map.size();
+		vector<Key> keys;
+		vector<T> values;
+		keys.reserve(count);
+		values.reserve(count);
+		// Pairs aren't trivially copyable, so keys and values are split into arrays
+		const utility::pair<Key, T> * pairs = map.data();
+		for (allocator::size_type i = 0U; i < count; ++i)
+		{
+			keys.push_back(pairs[i].first);
+			values.push_back(pairs[i].second);
+		}
+		snapshot_detail::header_t header = snapshot_detail::make_header(snapshot_kind::flat_map, 2U, sizeof(Key), sizeof(T), count);
+		const snapshot_detail::part_t parts[] = {
+			{keys.data(), static_cast<std::uint64_t>(count) * sizeof(Key)},
+			{values.data(), static_cast<std::uint64_t>(count) * sizeof(T)}
+		};
+		snapshot_detail::write_file(path, header, parts);
+	}
+
+	/**
+	 * Saves hash map to snapshot file.
+	 * @see hash_map_view
+	 *
+	 * @param[in] path The file path.
+	 * @param[in] map  The map with trivially copyable keys and values.
+	 */
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void save_snapshot(const char * path, const flat_hash_map<Key, T, Hash, KeyEqual>& map) noexcept(false)
+	{
+		(void)sizeof(snapshot_detail::checked_type<Key>);
+		(void)sizeof(snapshot_detail::checked_type<T>);
+		using map_type = flat_hash_map<Key, T, Hash, KeyEqual>;
+		const allocator::size_type count = map.size();
+		const allocator::size_type capacity = static_cast<allocator::size_type>(snapshot_detail::index_capacity(count));
+		const allocator::size_type mask = capacity - 1U;
+		vector<Key> keys;
+		vector<T> values;
+		vector<std::uint32_t> index;
+		keys.reserve(count);
+		values.reserve(count);
+		index.resize(capacity);
+		Hash hasher;
+		// Table has no const iteration, iteration doesn't modify it
+		map_type& table = const_cast<map_type&>(map);
+		for (typename map_type::iterator it = table.begin(); it != table.end(); ++it)
+		{
+			allocator::size_type slot = static_cast<allocator::size_type>(hasher(it->first)) & mask;
+			while (index[slot] != 0U)
+				slot = (slot + 1U) & mask;
+			keys.push_back(it->first);
+			values.push_back(it->second);
+			index[slot] = keys.size();
+		}
+		snapshot_detail::header_t header = snapshot_detail::make_header(snapshot_kind::hash_map, 3U, sizeof(Key), sizeof(T), count);
+		const snapshot_detail::part_t parts[] = {
+			{keys.data(), static_cast<std::uint64_t>(count) * sizeof(Key)},
+			{values.data(), static_cast<std::uint64_t>(count) * sizeof(T)},
+			{index.data(), static_cast<std::uint64_t>(capacity) * sizeof(std::uint32_t)}
+		};
+		snapshot_detail::write_file(path, header, parts);
+	}
+
+} // namespace nostd
+
+#endif
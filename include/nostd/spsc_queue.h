@@ -0,0 +1,229 @@
+#ifndef __NOSTD_SPSC_QUEUE_H__
+#define __NOSTD_SPSC_QUEUE_H__
+
+#include "default_allocator.h"
+#include "utility.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace nostd {
+
+	/**
+	 * Bounded lock-free single-producer single-consumer queue on ring buffer.
+	 * Only one thread may push and only one thread may pop at a time.
+	 * Each side owns its position and caches the last seen position of the other side,
+	 * so shared cache lines are touched only when the cached position says queue is full or empty.
+	 * Capacity is rounded up to power of two. Storage is allocated once in constructor.
+	 * @see mpmc_queue
+	 */
+	template <typename T>
+	class spsc_queue {
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param[in] capacity The minimal number of elements queue holds.
+		 */
+		explicit spsc_queue(size_type capacity) noexcept(false)
+		: spsc_queue(capacity, default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] capacity The minimal number of elements queue holds.
+		 * @param[in] alloc    The allocator to be used to allocate elements storage.
+		 */
+		spsc_queue(size_type capacity, allocator * alloc) noexcept(false)
+		: buffer_(nullptr)
+		, allocator_(alloc)
+		, mask_(_round_capacity(capacity) - 1U)
+		, tail_(0U)
+		, head_cache_(0U)
+		, head_(0U)
+		, tail_cache_(0U)
+		{
+			buffer_ = reinterpret_cast<T*>(allocator_->allocate(sizeof(T) * (mask_ + 1U)));
+			if (buffer_ == nullptr)
+				throw std::bad_alloc();
+		}
+
+		/**
+		 * Destructor.
+		 * Remaining elements are destroyed, no thread should use queue at that moment.
+		 */
+		~spsc_queue()
+		{
+			std::size_t position = head_.load(std::memory_order_relaxed);
+			const std::size_t end = tail_.load(std::memory_order_relaxed);
+			for (; position != end; ++position)
+				buffer_[position & mask_].~T();
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(buffer_), sizeof(T) * (mask_ + 1U));
+		}
+
+		/**
+		 * Constructs element in place at the tail of the queue if there is free slot.
+		 * Should be called by producer thread only.
+		 *
+		 * @param[in] args The arguments to construct element from.
+		 *
+		 * @return Returns true if element has been pushed and false if queue is full.
+		 */
+		template <typename... Args>
+		bool try_emplace(Args&&... args) noexcept(false)
+		{
+			const std::size_t tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_cache_ > mask_)
+			{
+				head_cache_ = head_.load(std::memory_order_acquire);
+				if (tail - head_cache_ > mask_)
+					return false;
+			}
+			// Position is published after construction, so failed construction leaves queue intact
+			new (&buffer_[tail & mask_]) T(utility::forward<Args>(args)...);
+			tail_.store(tail + 1U, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * Pushes data to the tail of the queue if there is free slot.
+		 * Version that copies data.
+		 *
+		 * @param[in] data The data.
+		 *
+		 * @return Returns true if element has been pushed and false if queue is full.
+		 */
+		bool try_push(const T& data) noexcept(false)
+		{
+			return try_emplace(data);
+		}
+
+		/**
+		 * Pushes data to the tail of the queue if there is free slot.
+		 * Version that moves data.
+		 *
+		 * @param[in] data The data.
+		 *
+		 * @return Returns true if element has been pushed and false if queue is full.
+		 */
+		bool try_push(T&& data) noexcept(false)
+		{
+			return try_emplace(utility::move(data));
+		}
+
+		/**
+		 * Returns the head element without popping it.
+		 * Should be called by consumer thread only.
+		 *
+		 * @return Returns pointer to the head element or nullptr if queue is empty.
+		 */
+		T * front() noexcept
+		{
+			const std::size_t head = head_.load(std::memory_order_relaxed);
+			if (head == tail_cache_)
+			{
+				tail_cache_ = tail_.load(std::memory_order_acquire);
+				if (head == tail_cache_)
+					return nullptr;
+			}
+			return &buffer_[head & mask_];
+		}
+
+		/**
+		 * Removes the head element, queue should not be empty.
+		 * Should be called by consumer thread only after front returned element.
+		 */
+		void pop() noexcept
+		{
+			const std::size_t head = head_.load(std::memory_order_relaxed);
+			buffer_[head & mask_].~T();
+			head_.store(head + 1U, std::memory_order_release);
+		}
+
+		/**
+		 * Pops element from the head of the queue if there is any.
+		 * Should be called by consumer thread only.
+		 *
+		 * @param[out] data The data to move element to.
+		 *
+		 * @return Returns true if element has been popped and false if queue is empty.
+		 */
+		bool try_pop(T& data) noexcept(false)
+		{
+			T * element = front();
+			if (element == nullptr)
+				return false;
+			data = utility::move(*element);
+			pop();
+			return true;
+		}
+
+		/**
+		 * Returns approximate number of elements, it may be outdated when used concurrently.
+		 *
+		 * @return Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			const std::size_t head = head_.load(std::memory_order_acquire);
+			const std::size_t tail = tail_.load(std::memory_order_acquire);
+			return (tail > head) ? static_cast<size_type>(tail - head) : 0U;
+		}
+
+		/**
+		 * Checks if queue is empty, result may be outdated when used concurrently.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return size() == 0U;
+		}
+
+		/**
+		 * Returns maximum number of elements.
+		 *
+		 * @return Returns queue capacity.
+		 */
+		size_type capacity() const noexcept
+		{
+			return static_cast<size_type>(mask_ + 1U);
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator =(const spsc_queue&) = delete;
+
+		static std::size_t _round_capacity(size_type capacity) noexcept
+		{
+			std::size_t size = 1U;
+			while (size < capacity)
+				size <<= 1U;
+			return size;
+		}
+
+		T * buffer_;
+		allocator * allocator_;
+		const std::size_t mask_;
+		unsigned char padding0_[64];									//!< keeps shared data away from positions
+		std::atomic<std::size_t> tail_;									//!< position of the next push, written by producer
+		std::size_t head_cache_;										//!< last seen head, used by producer
+		unsigned char padding1_[64 - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)]; //!< keeps producer data on its own cache line
+		std::atomic<std::size_t> head_;									//!< position of the next pop, written by consumer
+		std::size_t tail_cache_;										//!< last seen tail, used by consumer
+		unsigned char padding2_[64 - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)]; //!< keeps consumer data on its own cache line
+	};
+
+} // namespace nostd
+
+#endif
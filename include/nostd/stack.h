@@ -1,7 +1,7 @@
 #ifndef __NOSTD_STACK_H__
 #define __NOSTD_STACK_H__
 
-#include "default_allocator.h"
+#include "deque.h"
 #include "utility.h"
 
 #include <stdexcept>
@@ -9,22 +9,14 @@
 namespace nostd {
 
 	/**
-	 * Defines stack container. Implemented as single linked list.
-	 * Move semantics should be defined for used type.
+	 * Defines stack container. Implemented on top of deque,
+	 * so elements are stored in blocks and there is a single allocation per block.
 	 * If no allocator is provided, default allocator's new/delete allocation/deallocation routine is used.
-	 * Note: copy operations require additional allocations.
+	 * @see deque
+	 * Allocator is passed to the underlying deque.
 	 */
-	template <typename T>
+	template <typename T, typename Allocator = allocator>
 	class stack {
-
-		/**
-		 * Defines single list node that holds data.
-		 */
-		struct node_t {
-			node_t * next;
-			T data;
-		};
-
 	public:
 
 		using size_type = allocator::size_type;
@@ -33,9 +25,7 @@ namespace nostd {
 		 * Default constructor.
 		 */
 		stack() noexcept
-		: head_(nullptr)
-		, allocator_(default_allocator::get_instance())
-		, size_(0U)
+		: data_()
 		{
 		}
 
@@ -44,10 +34,8 @@ namespace nostd {
 		 * 
 		 * @param[in] alloc The allocator to be used to allocate nodes.
 		 */
-		stack(allocator * alloc) noexcept
-		: head_(nullptr)
-		, allocator_(alloc)
-		, size_(0U)
+		stack(Allocator * alloc) noexcept
+		: data_(alloc)
 		{
 		}
 
@@ -57,11 +45,8 @@ namespace nostd {
 		 * @param[in] other The other stack.
 		 */
 		stack(const stack& other) noexcept(false)
-		: head_(nullptr)
-		, allocator_(nullptr)
-		, size_(0U)
+		: data_(other.data_)
 		{
-			_set_by_copy(other);
 		}
 
 		/**
@@ -70,19 +55,8 @@ namespace nostd {
 		 * @param[in] other The other stack.
 		 */
 		stack(stack && other) noexcept
-		: head_(nullptr)
-		, allocator_(nullptr)
-		, size_(0U)
+		: data_(utility::move(other.data_))
 		{
-			_set_by_move(utility::forward(other));
-		}
-
-		/**
-		 * Destructor.
-		 */
-		~stack()
-		{
-			_clean();
 		}
 
 		/**
@@ -92,7 +66,7 @@ namespace nostd {
 		 */
 		stack& operator =(const stack& other) noexcept(false)
 		{
-			_set_by_copy(other);
+			data_ = other.data_;
 			return *this;
 		}
 
@@ -103,7 +77,7 @@ namespace nostd {
 		 */
 		stack& operator =(stack && other) noexcept
 		{
-			_set_by_move(utility::forward(other));
+			data_ = utility::move(other.data_);
 			return *this;
 		}
 
@@ -114,9 +88,9 @@ namespace nostd {
 		 */
 		T& top() const noexcept(false)
 		{
-			if (head_ == nullptr)
+			if (data_.empty())
 				throw std::range_error("Calling top() on an empty container.");
-			return head_->data;
+			return data_.back();
 		}
 
 		/**
@@ -126,7 +100,7 @@ namespace nostd {
 		 */
 		bool empty() const noexcept
 		{
-			return size_ == 0U;
+			return data_.empty();
 		}
 
 		/**
@@ -136,20 +110,28 @@ namespace nostd {
 		 */
 		size_type size() const noexcept
 		{
-			return size_;
+			return data_.size();
 		}
 
 		/**
 		 * Clears stack.
-		 * Data move constructor is used for data destruction.
 		 */
 		void clear() noexcept
 		{
-			while (size_ != 0U)
-			{
-				T data(utility::move(top()));
-				pop();
-			}
+			data_.clear();
+		}
+
+		/**
+		 * Constructs element in place on the top of the stack.
+		 * 
+		 * @param[in] args The arguments to construct element from.
+		 * 
+		 * @return Returns reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace(Args&&... args) noexcept(false)
+		{
+			return data_.emplace_back(utility::forward<Args>(args)...);
 		}
 
 		/**
@@ -160,13 +142,7 @@ namespace nostd {
 		 */
 		void push(const T& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = data;
-			node->next = head_;
-			head_ = node;
-			++size_;
+			emplace(data);
 		}
 
 		/**
@@ -177,13 +153,7 @@ namespace nostd {
 		 */
 		void push(T&& data) noexcept(false)
 		{
-			node_t * node = _allocate_node();
-			if (node == nullptr)
-				throw std::bad_alloc();
-			node->data = utility::move(data);
-			node->next = head_;
-			head_ = node;
-			++size_;
+			emplace(utility::move(data));
 		}
 
 		/**
@@ -191,13 +161,7 @@ namespace nostd {
 		 */
 		void pop() noexcept
 		{
-			node_t * node = head_;
-			if (node)
-			{
-				head_ = node->next;
-				--size_;
-				_free_node(node);
-			}
+			data_.pop_back();
 		}
 
 		/**
@@ -207,74 +171,12 @@ namespace nostd {
 		 */
 		void swap(stack & other) noexcept
 		{
-			utility::swap(head_, other.head_);
-			utility::swap(allocator_, other.allocator_);
-			utility::swap(size_, other.size_);
+			data_.swap(other.data_);
 		}
 
 	private:
 
-		node_t * _allocate_node() noexcept(false)
-		{
-			return reinterpret_cast<node_t*>(allocator_->allocate(sizeof(node_t)));
-		}
-		void _free_node(node_t * node) noexcept
-		{
-			allocator_->free(reinterpret_cast<allocator::ptr_type>(node));
-		}
-		void _clean() noexcept
-		{
-			clear();
-		}
-		void _set_by_copy(const stack& other) noexcept(false)
-		{
-			_clean();
-			head_ = nullptr;
-			allocator_ = other.allocator_;
-			size_ = 0U;
-
-			size_type other_size = other.size();
-			if (other_size > 0U)
-			{
-				// Allocate storage for nodes
-				node_t ** nodes = new node_t*[other_size];
-				if (nodes == nullptr)
-					throw std::bad_alloc();
-
-				// Copy other stack nodes
-				int i = 0;
-				node_t * other_node = other.head_;
-				while (other_node != nullptr)
-				{
-					nodes[i++] = other_node;
-					other_node = other_node->next;
-				}
-				// Push data in reverse order to keep the same order
-				for (i = other_size - 1; i >= 0; --i)
-				{
-					push_front(nodes[i]->data);
-				}
-
-				// Finally
-				delete[] nodes;
-			}
-		}
-		void _set_by_move(stack && other) noexcept
-		{
-			_clean();
-			// Copy other fields
-			head_ = other.head_;
-			allocator_ = other.allocator_;
-			size_ = other.size_;
-			// Nullify other
-			other.head_ = nullptr;
-			other.allocator_ = nullptr;
-			other.size_ = 0U;
-		}
-
-		node_t * head_;
-		allocator * allocator_;
-		size_type size_;
+		deque<T, Allocator> data_;
 	};
 
 } // namespace nostd
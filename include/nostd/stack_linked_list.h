@@ -35,6 +35,14 @@ namespace nostd {
 			other.head_ = nullptr;
 		}
 
+		/**
+		 * Checks if list is empty
+		 */
+		bool empty() const noexcept
+		{
+			return head_ == nullptr;
+		}
+
 		/**
 		 * Pushes new node to top of the list
 		 *
@@ -59,6 +67,50 @@ namespace nostd {
 			return top;
 		}
 
+		/**
+		 * Pushes chain of linked nodes to top of the list
+		 *
+		 * @param[in] first The first node of chain
+		 * @param[in] last  The last node of chain
+		 */
+		void push_chain(node_t * first, node_t * last) noexcept
+		{
+			last->next = head_;
+			head_ = first;
+		}
+
+		/**
+		 * Pops several top nodes from the list at once
+		 *
+		 * @param[in] count Maximum number of nodes
+		 *
+		 * @return Chain of popped nodes terminated by null, or null if list is empty
+		 */
+		node_t * pop_chain(unsigned int count) noexcept
+		{
+			node_t * first = head_;
+			if (first == nullptr || count == 0U)
+				return nullptr;
+			node_t * last = first;
+			while (--count != 0U && last->next != nullptr)
+				last = last->next;
+			head_ = last->next;
+			last->next = nullptr;
+			return first;
+		}
+
+		/**
+		 * Pops all nodes from the list
+		 *
+		 * @return Chain of all nodes terminated by null, or null if list is empty
+		 */
+		node_t * pop_all() noexcept
+		{
+			node_t * first = head_;
+			head_ = nullptr;
+			return first;
+		}
+
 	private:
 
 		/**
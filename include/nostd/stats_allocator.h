@@ -0,0 +1,171 @@
+#ifndef __NOSTD_STATS_ALLOCATOR_H__
+#define __NOSTD_STATS_ALLOCATOR_H__
+
+#include "allocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace nostd {
+
+	/**
+	 * Snapshot of allocation statistics.
+	 * Histograms use power of two classes: class i counts values in [2^i, 2^(i+1)), zero goes to the first class.
+	 */
+	struct allocator_stats {
+		static const allocator::size_type size_classes = 32U;
+		static const allocator::size_type latency_classes = 32U;
+
+		std::uint64_t live_bytes;						//!< bytes allocated and not freed yet
+		std::uint64_t peak_bytes;						//!< maximum of live bytes
+		std::uint64_t allocated_bytes;					//!< bytes allocated over the whole time
+		std::uint64_t allocations;						//!< number of successful allocations
+		std::uint64_t frees;							//!< number of releases
+		std::uint64_t failures;							//!< number of failed allocations
+		std::uint64_t size_histogram[size_classes];		//!< allocations by requested size
+		std::uint64_t latency_samples;					//!< number of timed allocations
+		std::uint64_t latency_total;					//!< total time of timed allocations in nanoseconds
+		std::uint64_t latency_histogram[latency_classes]; //!< timed allocations by time in nanoseconds
+
+		/**
+		 * Returns number of blocks allocated and not freed yet.
+		 */
+		std::uint64_t live_blocks() const noexcept
+		{
+			return allocations - frees;
+		}
+	};
+
+	/**
+	 * Allocator that collects statistics of allocations made through it and forwards them to upstream.
+	 * Every thread gets its own counter block on first use and only the owner writes it, so counters
+	 * are updated by relaxed load and store without read-modify-write and threads don't share cache lines.
+	 * Blocks are summed on read, including histograms. Blocks of exited threads are kept until
+	 * the allocator is destroyed, so their counts aren't lost.
+	 * Live bytes are folded into shared counter in batches. Peak is exact for single thread,
+	 * concurrent use may overestimate it by up to number of threads times fold threshold.
+	 * Allocation time is measured for every n-th allocation of a thread, since clock reads are costly.
+	 * Block size is stored in a header before the block, so free without size is counted correctly.
+	 * Blocks are aligned to std::max_align_t regardless of upstream alignment.
+	 * Allocator is as thread-safe as its upstream.
+	 */
+	class stats_allocator final
+	: public allocator
+	{
+
+		static const std::int64_t fold_threshold = 64 * 1024; //!< live bytes delta that is folded into shared counter
+
+		/**
+		 * Defines counters of single thread.
+		 * The first cache line holds counters updated on every call.
+		 */
+		struct thread_block_t {
+			std::atomic<std::uint64_t> allocations;
+			std::atomic<std::uint64_t> frees;
+			std::atomic<std::uint64_t> failures;
+			std::atomic<std::uint64_t> allocated_bytes;
+			std::atomic<std::int64_t> pending_bytes; //!< live bytes delta not folded yet
+			std::atomic<std::int64_t> pending_peak;	 //!< maximum of pending bytes since the last fold
+			size_type untimed;						 //!< allocations left before the next timed one, used by owner only
+			std::atomic<std::uint64_t> size_histogram[allocator_stats::size_classes];
+			std::atomic<std::uint64_t> latency_samples;
+			std::atomic<std::uint64_t> latency_total;
+			std::atomic<std::uint64_t> latency_histogram[allocator_stats::latency_classes];
+			thread_block_t * next;	//!< next block of allocator, written before block is published
+			std::uint64_t owner;	//!< token of owner thread
+			byte_type padding[64];	//!< keeps the next heap block off the last cache line
+
+			explicit thread_block_t(std::uint64_t owner) noexcept;
+		};
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * @param[in] upstream       The allocator to forward requests to
+		 * @param[in] latency_sample Every latency_sample-th allocation is timed, zero disables timing
+		 */
+		explicit stats_allocator(allocator * upstream, size_type latency_sample = 64U) noexcept;
+
+		/**
+		 * Destructor, releases counter blocks of threads
+		 */
+		~stats_allocator();
+
+		/**
+		 * Allocates block of memory
+		 *
+		 * @param[in] size Size of memory block
+		 */
+		ptr_type allocate(size_type size) noexcept(false) final;
+
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr Pointer to block of memory
+		 */
+		void free(ptr_type ptr) noexcept final;
+
+		/**
+		 * Releases block of memory that was allocated previously
+		 *
+		 * @param[in] ptr  Pointer to block of memory
+		 * @param[in] size Size that was passed to allocate
+		 */
+		void free(ptr_type ptr, size_type size) noexcept final;
+
+		/**
+		 * Tries to change size of block of memory in place, request is forwarded to upstream.
+		 *
+		 * @param[in] ptr      Pointer to block of memory
+		 * @param[in] old_size Current size of memory block
+		 * @param[in] new_size Requested size of memory block
+		 *
+		 * @return True if block now has new size and false otherwise.
+		 */
+		bool try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept final;
+
+		/**
+		 * Returns aggregated statistics.
+		 * Counters are read one by one, so snapshot taken during concurrent use may be slightly inconsistent.
+		 *
+		 * @return Returns statistics snapshot.
+		 */
+		allocator_stats stats() const noexcept;
+
+		/**
+		 * Returns upstream allocator
+		 */
+		allocator * upstream() const noexcept;
+
+	private:
+
+		/**
+		 * Disallow default constructor, copy and move
+		 */
+		stats_allocator() = delete;
+		stats_allocator(const stats_allocator&) = delete;
+		stats_allocator& operator =(const stats_allocator&) = delete;
+
+		thread_block_t& _block(std::unique_lock<std::mutex>& lock) noexcept;
+		thread_block_t& _register(std::unique_lock<std::mutex>& lock) noexcept;
+		void _add_live(thread_block_t& block, std::int64_t delta) noexcept;
+		void _release(ptr_type ptr) noexcept;
+		static void _collect(const thread_block_t& block, allocator_stats& result, std::int64_t& live, std::int64_t& peak_bound) noexcept;
+
+		allocator * upstream_;
+		size_type latency_sample_;
+		std::uint64_t id_;						//!< unique identifier, never reused unlike the address
+		std::atomic<thread_block_t*> blocks_;	//!< blocks of threads, pushed once per thread
+		byte_type padding_[64];					//!< keeps shared counters away from the fields read on every call
+		std::atomic<std::int64_t> live_bytes_;	//!< folded live bytes
+		std::atomic<std::int64_t> peak_bytes_;
+		std::mutex fallback_mutex_;				//!< guards fallback block
+		thread_block_t fallback_;				//!< shared by threads that failed to allocate own block
+	};
+
+} // namespace nostd
+
+#endif
@@ -33,6 +33,8 @@ namespace nostd {
 		 */
 		void free(ptr_type ptr) noexcept final;
 
+		using allocator::free;
+
 		/**
 		 * Returns current number of allocated blocks.
 		 */
@@ -0,0 +1,287 @@
+#ifndef __NOSTD_THREAD_POOL_H__
+#define __NOSTD_THREAD_POOL_H__
+
+#include "concurrent_pool_allocator.h"
+#include "deque.h"
+#include "utility.h"
+#include "vector.h"
+#include "work_stealing_deque.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Counter of unfinished tasks, that threads may wait for (analog of Go's sync.WaitGroup).
+	 * @see thread_pool::wait
+	 */
+	class wait_group {
+		friend class thread_pool;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param[in] count The initial number of tasks.
+		 */
+		explicit wait_group(size_type count = 0U) noexcept;
+
+		/**
+		 * Adds tasks to wait for.
+		 *
+		 * @param[in] count The number of tasks.
+		 */
+		void add(size_type count = 1U) noexcept;
+
+		/**
+		 * Marks one task as finished, wakes waiting threads after the last one.
+		 */
+		void done() noexcept;
+
+		/**
+		 * Blocks until all tasks are finished.
+		 * Prefer thread_pool::wait on pool's threads, since it runs pending tasks meanwhile.
+		 */
+		void wait() noexcept;
+
+		/**
+		 * Checks if all tasks are finished.
+		 *
+		 * @return Returns true if there are no unfinished tasks and false otherwise.
+		 */
+		bool finished() const noexcept;
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		wait_group(const wait_group&) = delete;
+		wait_group& operator =(const wait_group&) = delete;
+
+		std::atomic<size_type> count_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+	};
+
+	/**
+	 * Fixed pool of worker threads with work stealing.
+	 * Every worker owns a work-stealing deque: tasks submitted by worker go to its own deque,
+	 * it takes the latest ones first, while idle workers steal the oldest ones from others.
+	 * Tasks submitted from other threads go to a shared queue.
+	 * Tasks are allocated from concurrent pool allocator, that keeps per-thread chunk caches,
+	 * so submit doesn't touch the heap and task may be released by the thread that ran it.
+	 * Larger tasks fall back to default allocator.
+	 * Tasks should not throw, pending tasks are finished on destruction.
+	 */
+	class thread_pool {
+
+		/**
+		 * Defines type erased task.
+		 */
+		struct task_t {
+			void (*invoke)(task_t * task);	//!< calls function and destroys task
+			void (*destroy)(task_t * task);	//!< destroys task that was never run
+			wait_group * group;
+			bool pooled; //!< allocated from task allocator
+		};
+
+		/**
+		 * Defines task that holds function object.
+		 */
+		template <typename F>
+		struct task_impl : public task_t {
+			F function;
+
+			template <typename G>
+			explicit task_impl(G&& g)
+			: function(utility::forward<G>(g))
+			{
+				invoke = &task_impl::_invoke;
+				destroy = &task_impl::_destroy;
+			}
+			static void _invoke(task_t * task)
+			{
+				task_impl * self = static_cast<task_impl*>(task);
+				self->function();
+				self->~task_impl();
+			}
+			static void _destroy(task_t * task)
+			{
+				static_cast<task_impl*>(task)->~task_impl();
+			}
+		};
+
+		struct worker_t;
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		static const size_type task_size = 128U; //!< size of task allocated from the pool
+
+		/**
+		 * Constructor.
+		 *
+		 * @param[in] num_threads The number of worker threads, zero means hardware concurrency.
+		 */
+		explicit thread_pool(size_type num_threads = 0U) noexcept(false);
+
+		/**
+		 * Constructor with allocator of task queues.
+		 *
+		 * @param[in] num_threads The number of worker threads, zero means hardware concurrency.
+		 * @param[in] alloc       The allocator to be used to allocate queue buffers.
+		 */
+		thread_pool(size_type num_threads, allocator * alloc) noexcept(false);
+
+		/**
+		 * Destructor.
+		 * Waits until all submitted tasks are finished and joins worker threads.
+		 */
+		~thread_pool();
+
+		/**
+		 * Returns number of worker threads.
+		 *
+		 * @return Returns number of threads.
+		 */
+		size_type size() const noexcept;
+
+		/**
+		 * Submits task for execution.
+		 *
+		 * @param[in] function The function object to be called without arguments.
+		 */
+		template <typename F>
+		void submit(F&& function) noexcept(false)
+		{
+			_push(_create_task(nullptr, utility::forward<F>(function)));
+		}
+
+		/**
+		 * Submits task for execution, group is notified when task is finished.
+		 *
+		 * @param[in] group    The wait group, task is added to it.
+		 * @param[in] function The function object to be called without arguments.
+		 */
+		template <typename F>
+		void submit(wait_group& group, F&& function) noexcept(false)
+		{
+			task_t * task = _create_task(&group, utility::forward<F>(function));
+			group.add();
+			_push(task);
+		}
+
+		/**
+		 * Waits until all tasks of group are finished.
+		 * Calling thread runs pending tasks meanwhile, so waiting inside task doesn't block worker.
+		 *
+		 * @param[in] group The wait group.
+		 */
+		void wait(wait_group& group) noexcept;
+
+		/**
+		 * Calls body for subranges of [first, last) in parallel and waits for completion.
+		 * Range is split in halves, so idle workers steal large parts first.
+		 * Body is called as body(begin, end) with subranges not longer than grain.
+		 * If submit fails, already submitted subranges are finished before exception is rethrown.
+		 *
+		 * @param[in] first The beginning of the range.
+		 * @param[in] last  The end of the range.
+		 * @param[in] grain The maximal length of subrange for single call.
+		 * @param[in] body  The function object.
+		 */
+		template <typename F>
+		void parallel_for(size_type first, size_type last, size_type grain, F&& body) noexcept(false)
+		{
+			if (grain == 0U)
+				grain = 1U;
+			wait_group group;
+			try
+			{
+				_split(group, first, last, grain, body);
+			}
+			catch (...)
+			{
+				// Submitted tasks refer to group and body, so they are finished before unwinding
+				wait(group);
+				throw;
+			}
+			wait(group);
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator =(const thread_pool&) = delete;
+
+		template <typename F>
+		task_t * _create_task(wait_group * group, F&& function) noexcept(false)
+		{
+			typedef task_impl<typename std::decay<F>::type> task_type;
+			bool pooled;
+			void * memory = _allocate_task(sizeof(task_type), pooled);
+			task_type * task;
+			try
+			{
+				task = new (memory) task_type(utility::forward<F>(function));
+			}
+			catch (...)
+			{
+				_free_task(memory, pooled);
+				throw;
+			}
+			task->group = group;
+			task->pooled = pooled;
+			return task;
+		}
+		template <typename F>
+		void _split(wait_group& group, size_type first, size_type last, size_type grain, F& body) noexcept(false)
+		{
+			// Right halves are submitted, the left one is processed by this thread
+			while (last - first > grain)
+			{
+				const size_type middle = first + (last - first) / 2U;
+				submit(group, [this, &group, middle, last, grain, &body]() {
+					_split(group, middle, last, grain, body);
+				});
+				last = middle;
+			}
+			if (first < last)
+				body(first, last);
+		}
+
+		void * _allocate_task(size_type size, bool& pooled) noexcept(false);
+		void _free_task(void * memory, bool pooled) noexcept;
+		void _push(task_t * task) noexcept(false);
+		void _execute(task_t * task) noexcept;
+		task_t * _find_task(size_type index) noexcept;
+		size_type _current_index() const noexcept;
+		void _worker_loop(size_type index) noexcept;
+
+		vector<worker_t*> workers_;
+		concurrent_pool_allocator task_allocator_;
+		deque<task_t*> injected_;				//!< tasks submitted by other threads
+		std::atomic<size_type> injected_size_;
+		std::atomic<size_type> queued_;			//!< number of tasks waiting for execution
+		std::atomic<size_type> sleeping_;		//!< number of workers waiting for tasks
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		bool stop_;
+	};
+
+} // namespace nostd
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef __NOSTD_TYPE_TRAITS_H__
+#define __NOSTD_TYPE_TRAITS_H__
+
+#include "utility.h"
+
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Checks whether objects of type may be moved to another address by copying their bytes,
+	 * with the source left without destructor call.
+	 * Trivially copyable types are relocatable, other types may opt in by specialization.
+	 */
+	template <typename T>
+	struct is_trivially_relocatable
+	: std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+	{
+	};
+
+	/**
+	 * Pair is relocatable when both members are.
+	 */
+	template <typename A, typename B>
+	struct is_trivially_relocatable<utility::pair<A, B>>
+	: std::integral_constant<bool, is_trivially_relocatable<A>::value && is_trivially_relocatable<B>::value>
+	{
+	};
+
+} // namespace nostd
+
+#endif
\ No newline at end of file
@@ -5,35 +5,53 @@ namespace nostd {
 namespace utility {
 
 	template <typename T>
-	T&& move(T&& t)
-	{
-		return static_cast<T&&>(t);
-	}
+	struct remove_reference { typedef T type; };
+	template <typename T>
+	struct remove_reference<T&> { typedef T type; };
+	template <typename T>
+	struct remove_reference<T&&> { typedef T type; };
+
 	template <typename T>
-	T&& move(T& t)
+	typename remove_reference<T>::type&& move(T&& t) noexcept
 	{
-		return static_cast<T&&>(t);
+		return static_cast<typename remove_reference<T>::type&&>(t);
 	}
 
+	/**
+	 * Forwards argument with its value category, template argument should be given explicitly.
+	 */
 	template <typename T>
-	T&& forward(T&& t)
+	T&& forward(typename remove_reference<T>::type& t) noexcept
 	{
 		return static_cast<T&&>(t);
 	}
 	template <typename T>
-	T&& forward(T& t)
+	T&& forward(typename remove_reference<T>::type&& t) noexcept
 	{
 		return static_cast<T&&>(t);
 	}
 
+	/**
+	 * Returns reference to value in unevaluated context, so it should not be defined.
+	 */
+	template <typename T>
+	T&& declval() noexcept;
+
 	template <typename T>
 	void swap(T& lhs, T& rhs)
 	{
-		T t = lhs;
-		lhs = rhs;
-		rhs = t;
+		T t = utility::move(lhs);
+		lhs = utility::move(rhs);
+		rhs = utility::move(t);
 	}
 
+	/**
+	 * Tag for pair construction, where the first argument constructs the first member
+	 * and the rest arguments construct the second member.
+	 */
+	struct emplace_second_t {};
+	constexpr emplace_second_t emplace_second = emplace_second_t();
+
 	template <typename A, typename B>
 	struct pair
 	{
@@ -42,8 +60,12 @@ namespace utility {
 
 		pair() : first(), second() {}
 		pair(const A& a, const B& b) : first(a), second(b) {}
+		template <typename U, typename V>
+		pair(U&& a, V&& b) : first(utility::forward<U>(a)), second(utility::forward<V>(b)) {}
+		template <typename U, typename... Args>
+		pair(emplace_second_t, U&& a, Args&&... args) : first(utility::forward<U>(a)), second(utility::forward<Args>(args)...) {}
 		pair(const pair& other) : first(other.first), second(other.second) {}
-		pair(pair&& other) : first(move(other.first)), second(move(other.second)) {}
+		pair(pair&& other) : first(utility::move(other.first)), second(utility::move(other.second)) {}
 		pair& operator =(const pair& other)
 		{
 			first = other.first;
@@ -52,8 +74,8 @@ namespace utility {
 		}
 		void operator =(pair&& other)
 		{
-			first = move(other.first);
-			second = move(other.second);
+			first = utility::move(other.first);
+			second = utility::move(other.second);
 		}
 		bool operator ==(const pair& other) const
 		{
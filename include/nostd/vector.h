@@ -2,20 +2,67 @@
 #define __NOSTD_VECTOR_H__
 
 #include "default_allocator.h"
+#include "type_traits.h"
 #include "utility.h"
 
+#include <cstddef>
+#include <cstring>
 #include <new>
 #include <stdexcept>
+#include <type_traits>
 
 namespace nostd {
 
+	/**
+	 * Geometric growth policy of array capacity.
+	 * Capacity is multiplied by Numerator / Denominator, but not less than required size is returned.
+	 */
+	template <unsigned int Numerator, unsigned int Denominator>
+	struct growth_factor {
+
+		static_assert(Numerator > Denominator && Denominator != 0U, "Growth factor should be greater than one");
+
+		/**
+		 * Computes new capacity.
+		 * 
+		 * @param[in] capacity  The current capacity.
+		 * @param[in] required  The minimal size to hold.
+		 * 
+		 * @return Returns new capacity.
+		 */
+		static allocator::size_type next_capacity(allocator::size_type capacity, allocator::size_type required) noexcept
+		{
+			const unsigned long long max_capacity = static_cast<allocator::size_type>(-1);
+			unsigned long long grown = static_cast<unsigned long long>(capacity) * Numerator / Denominator;
+			if (grown > max_capacity)
+				grown = max_capacity;
+			return (grown < required) ? required : static_cast<allocator::size_type>(grown);
+		}
+	};
+
+	/**
+	 * Default growth policy, 1.5x lets allocator reuse blocks freed by previous growth steps.
+	 */
+	using default_growth = growth_factor<3U, 2U>;
+
+	template <typename T, allocator::size_type N, typename Growth>
+	class small_vector;
+
 	/**
 	 * Defines array container (analog of std::vector).
 	 * Move semantics should be defined for used type.
 	 * If no allocator is provided, default new/delete allocation/deallocation routine is used.
+	 * Trivially relocatable types are moved on growth with a single reallocate call,
+	 * trivially copyable types are copied with memcpy.
+	 * Capacity grows by the Growth policy, which provides static next_capacity(capacity, required).
+	 * @see is_trivially_relocatable
+	 * @see growth_factor
+	 * Allocator may be a concrete final allocator type, then its calls are resolved at compile time.
 	 */
-	template <typename T>
+	template <typename T, typename Growth = default_growth, typename Allocator = allocator>
 	class vector {
+		template <typename, allocator::size_type, typename>
+		friend class small_vector;
 	public:
 
 		using size_type = allocator::size_type;
@@ -44,11 +91,11 @@ namespace nostd {
 				ptr_ = other.ptr_;
 				return *this;
 			}
-			bool operator ==(const iterator& other) noexcept
+			bool operator ==(const iterator& other) const noexcept
 			{
 				return ptr_ == other.ptr_;
 			}
-			bool operator !=(const iterator& other) noexcept
+			bool operator !=(const iterator& other) const noexcept
 			{
 				return ptr_ != other.ptr_;
 			}
@@ -74,6 +121,23 @@ namespace nostd {
 				--ptr_;
 				return it;
 			}
+			iterator& operator +=(std::ptrdiff_t offset) noexcept
+			{
+				ptr_ += offset;
+				return *this;
+			}
+			iterator operator +(std::ptrdiff_t offset) const noexcept
+			{
+				return iterator(ptr_ + offset);
+			}
+			iterator operator -(std::ptrdiff_t offset) const noexcept
+			{
+				return iterator(ptr_ - offset);
+			}
+			std::ptrdiff_t operator -(const iterator& other) const noexcept
+			{
+				return ptr_ - other.ptr_;
+			}
 			T& operator *() noexcept(false)
 			{
 				return *ptr_;
@@ -112,7 +176,7 @@ namespace nostd {
 		 * 
 		 * @param[in] alloc The allocator to be used to allocate nodes.
 		 */
-		vector(allocator * alloc) noexcept
+		vector(Allocator * alloc) noexcept
 		: buffer_(nullptr)
 		, allocator_(alloc)
 		, buffer_size_(0U)
@@ -145,7 +209,7 @@ namespace nostd {
 		, buffer_size_(0U)
 		, size_(0U)
 		{
-			_set_by_move(utility::forward<vector>(other));
+			_set_by_move(utility::move(other));
 		}
 
 		/**
@@ -163,7 +227,8 @@ namespace nostd {
 		 */
 		vector& operator =(const vector& other) noexcept(false)
 		{
-			_set_by_copy(other);
+			if (this != &other)
+				_set_by_copy(other);
 			return *this;
 		}
 
@@ -174,7 +239,8 @@ namespace nostd {
 		 */
 		vector& operator =(vector && other) noexcept
 		{
-			_set_by_move(utility::forward<vector>(other));
+			if (this != &other)
+				_set_by_move(utility::move(other));
 			return *this;
 		}
 
@@ -278,6 +344,16 @@ namespace nostd {
 			return buffer_[size_ - 1];
 		}
 
+		/**
+		 * Gets allocator of the array.
+		 * 
+		 * @return Returns the allocator.
+		 */
+		Allocator * get_allocator() const noexcept
+		{
+			return allocator_;
+		}
+
 		/**
 		 * Returns iterator to the first element.
 		 * 
@@ -303,13 +379,14 @@ namespace nostd {
 		 */
 		void clear() noexcept
 		{
-			for (size_type i = 0U; i < size_; ++i)
-				(buffer_ + i)->~T();
+			_destroy(buffer_, buffer_ + size_, destructible_tag());
 			size_ = 0U;
 		}
 
 		/**
 		 * Reserves buffer for number of elements.
+		 * Buffer is expanded in place if allocator allows that.
+		 * Reserving zero elements for an empty array releases the buffer.
 		 * 
 		 * @param[in] size  The size to reserve.
 		 */
@@ -317,32 +394,17 @@ namespace nostd {
 		{
 			if (size == 0U)
 			{
-				if (buffer_ != nullptr)
+				if (buffer_ != nullptr && size_ == 0U)
 				{
-					_free_buffer(buffer_);
+					_free_buffer(buffer_, buffer_size_);
 					buffer_ = nullptr;
+					buffer_size_ = 0U;
 				}
 			}
 			else if (buffer_size_ < size)
 			{
-				// Allocate a new buffer
-				T * new_buffer = _allocate_buffer(size);
-				if (new_buffer == nullptr)
-					throw std::bad_alloc();
-				if (buffer_ != nullptr)
-				{
-					// Call move constructor on old elements
-					for (size_type i = 0U; i < size_; ++i)
-					{
-						new (new_buffer + i) T(utility::move(buffer_[i]));
-					}
-					// Free old buffer
-					_free_buffer(buffer_);	
-				}
-				// Replace buffers
-				buffer_ = new_buffer;
+				_grow_buffer(size, relocatable_tag());
 			}
-			buffer_size_ = size;
 		}
 
 		/**
@@ -353,23 +415,46 @@ namespace nostd {
 		void resize(size_type new_size) noexcept(false)
 		{
 			size_type old_size = size_;
-			size_ = new_size;
 			if (new_size <= old_size)
 			{
 				// Destruct old elements
-				for (size_type i = new_size; i < old_size; ++i)
-					(buffer_ + i)->~T();
+				_destroy(buffer_ + new_size, buffer_ + old_size, destructible_tag());
 			}
 			else
 			{
 				// New size is greater than old one
-				reserve(new_size + (new_size >> 2));
+				if (buffer_size_ < new_size)
+					reserve(Growth::next_capacity(buffer_size_, new_size));
 				// Copy default T into new elements.
 				for (size_type i = old_size; i < new_size; ++i)
 				{
 					new (buffer_ + i) T();
 				}
 			}
+			size_ = new_size;
+		}
+
+		/**
+		 * Constructs element in place at the end of the array.
+		 * Arguments may refer to elements of the array.
+		 * 
+		 * @param[in] args The arguments passed to constructor.
+		 * 
+		 * @return Returns reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_back(Args&&... args) noexcept(false)
+		{
+			if (size_ == buffer_size_)
+			{
+				// Arguments may be invalidated by growth, so construct the value beforehand
+				T value(utility::forward<Args>(args)...);
+				reserve(Growth::next_capacity(buffer_size_, size_ + 1U));
+				new (buffer_ + size_) T(utility::move(value));
+			}
+			else
+				new (buffer_ + size_) T(utility::forward<Args>(args)...);
+			return buffer_[size_++];
 		}
 
 		/**
@@ -380,8 +465,7 @@ namespace nostd {
 		 */
 		void push_back(const T& value) noexcept(false)
 		{
-			resize(size_ + 1);
-			buffer_[size_ - 1] = value;
+			emplace_back(value);
 		}
 
 		/**
@@ -392,21 +476,106 @@ namespace nostd {
 		 */
 		void push_back(T && value) noexcept(false)
 		{
-			resize(size_ + 1);
-			buffer_[size_ - 1] = utility::move(value);
+			emplace_back(utility::move(value));
 		}
 
 		/**
-		 * Removes element from the end of the array.
+		 * Constructs element in place before position, following elements are shifted.
+		 * Arguments may refer to elements of the array.
 		 * 
-		 * @return True on success and false otherwise.
+		 * @param[in] pos  The position to insert before.
+		 * @param[in] args The arguments passed to constructor.
+		 * 
+		 * @return Returns iterator to the new element.
+		 */
+		template <typename... Args>
+		iterator emplace(iterator pos, Args&&... args) noexcept(false)
+		{
+			const size_type index = static_cast<size_type>(pos.ptr_ - buffer_);
+			if (index == size_)
+			{
+				emplace_back(utility::forward<Args>(args)...);
+				return iterator(buffer_ + index);
+			}
+			// Arguments may be invalidated by shift or growth
+			T value(utility::forward<Args>(args)...);
+			if (size_ == buffer_size_)
+				reserve(Growth::next_capacity(buffer_size_, size_ + 1U));
+			_open_gap(index, relocatable_tag());
+			new (buffer_ + index) T(utility::move(value));
+			++size_;
+			return iterator(buffer_ + index);
+		}
+
+		/**
+		 * Inserts data before position.
+		 * Version that copies data.
+		 * 
+		 * @param[in] pos   The position to insert before.
+		 * @param[in] value The data.
+		 * 
+		 * @return Returns iterator to the new element.
+		 */
+		iterator insert(iterator pos, const T& value) noexcept(false)
+		{
+			return emplace(pos, value);
+		}
+
+		/**
+		 * Inserts data before position.
+		 * Version that moves data.
+		 * 
+		 * @param[in] pos   The position to insert before.
+		 * @param[in] value The data.
+		 * 
+		 * @return Returns iterator to the new element.
+		 */
+		iterator insert(iterator pos, T && value) noexcept(false)
+		{
+			return emplace(pos, utility::move(value));
+		}
+
+		/**
+		 * Erases element at position, following elements are shifted.
+		 * 
+		 * @param[in] pos  The position of element.
+		 * 
+		 * @return Returns iterator to the element after erased one.
+		 */
+		iterator erase(iterator pos) noexcept
+		{
+			return erase(pos, pos + 1);
+		}
+
+		/**
+		 * Erases elements in range [first, last), following elements are shifted.
+		 * 
+		 * @param[in] first  The first element to erase.
+		 * @param[in] last   The element after the last one to erase.
+		 * 
+		 * @return Returns iterator to the element after erased ones.
+		 */
+		iterator erase(iterator first, iterator last) noexcept
+		{
+			const size_type index = static_cast<size_type>(first.ptr_ - buffer_);
+			const size_type count = static_cast<size_type>(last.ptr_ - first.ptr_);
+			if (count != 0U)
+			{
+				_close_gap(index, count, relocatable_tag());
+				size_ -= count;
+			}
+			return iterator(buffer_ + index);
+		}
+
+		/**
+		 * Removes element from the end of the array.
 		 */
 		void pop_back() noexcept(false)
 		{
-			if (size_ != 0U)
-				resize(size_ - 1);
-			else
+			if (size_ == 0U)
 				throw std::range_error("pop_back on empty container");
+			--size_;
+			_destroy(buffer_ + size_, buffer_ + size_ + 1U, destructible_tag());
 		}
 
 		/**
@@ -424,20 +593,107 @@ namespace nostd {
 
 	private:
 
+		using relocatable_tag = std::integral_constant<bool, is_trivially_relocatable<T>::value>;
+		using copyable_tag = std::integral_constant<bool, std::is_trivially_copyable<T>::value>;
+		using destructible_tag = std::integral_constant<bool, std::is_trivially_destructible<T>::value>;
+
 		T * _allocate_buffer(size_type size) noexcept(false)
 		{
 			return reinterpret_cast<T*>(allocator_->allocate(sizeof(T) * size));
 		}
-		void _free_buffer(T * buffer) noexcept
+		void _free_buffer(T * buffer, size_type size) noexcept
 		{
-			allocator_->free(reinterpret_cast<allocator::ptr_type>(buffer));
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(buffer), sizeof(T) * size);
+		}
+		void _grow_buffer(size_type size, std::true_type) noexcept(false)
+		{
+			// Elements are relocated bitwise, allocator may expand buffer in place or use realloc
+			T * new_buffer = reinterpret_cast<T*>(allocator_->reallocate(
+				reinterpret_cast<allocator::ptr_type>(buffer_), sizeof(T) * buffer_size_, sizeof(T) * size));
+			if (new_buffer == nullptr)
+				throw std::bad_alloc();
+			buffer_ = new_buffer;
+			buffer_size_ = size;
+		}
+		void _grow_buffer(size_type size, std::false_type) noexcept(false)
+		{
+			if (buffer_ != nullptr &&
+				allocator_->try_expand(buffer_, sizeof(T) * buffer_size_, sizeof(T) * size))
+			{
+				buffer_size_ = size;
+				return;
+			}
+			// Allocate a new buffer
+			T * new_buffer = _allocate_buffer(size);
+			if (new_buffer == nullptr)
+				throw std::bad_alloc();
+			if (buffer_ != nullptr)
+			{
+				// Call move constructor on old elements
+				for (size_type i = 0U; i < size_; ++i)
+				{
+					new (new_buffer + i) T(utility::move(buffer_[i]));
+					(buffer_ + i)->~T();
+				}
+				// Free old buffer
+				_free_buffer(buffer_, buffer_size_);
+			}
+			// Replace buffers
+			buffer_ = new_buffer;
+			buffer_size_ = size;
+		}
+		static void _destroy(T * first, T * last, std::true_type) noexcept
+		{
+			(void)first;
+			(void)last;
+		}
+		static void _destroy(T * first, T * last, std::false_type) noexcept
+		{
+			for (; first != last; ++first)
+				first->~T();
+		}
+		void _open_gap(size_type index, std::true_type) noexcept
+		{
+			std::memmove(static_cast<void*>(buffer_ + index + 1U), static_cast<void*>(buffer_ + index), sizeof(T) * (size_ - index));
+		}
+		void _open_gap(size_type index, std::false_type) noexcept
+		{
+			// Slot at index is left without an object
+			new (buffer_ + size_) T(utility::move(buffer_[size_ - 1U]));
+			for (size_type i = size_ - 1U; i > index; --i)
+				buffer_[i] = utility::move(buffer_[i - 1U]);
+			(buffer_ + index)->~T();
+		}
+		void _close_gap(size_type index, size_type count, std::true_type) noexcept
+		{
+			_destroy(buffer_ + index, buffer_ + index + count, destructible_tag());
+			std::memmove(static_cast<void*>(buffer_ + index), static_cast<void*>(buffer_ + index + count),
+				sizeof(T) * (size_ - index - count));
+		}
+		void _close_gap(size_type index, size_type count, std::false_type) noexcept
+		{
+			for (size_type i = index; i + count < size_; ++i)
+				buffer_[i] = utility::move(buffer_[i + count]);
+			_destroy(buffer_ + size_ - count, buffer_ + size_, destructible_tag());
+		}
+		void _copy_elements(const T * source, size_type count, std::true_type) noexcept
+		{
+			if (count != 0U)
+				std::memcpy(buffer_, source, sizeof(T) * count);
+		}
+		void _copy_elements(const T * source, size_type count, std::false_type) noexcept(false)
+		{
+			for (size_type i = 0U; i < count; ++i)
+			{
+				new (buffer_ + i) T(source[i]);
+			}
 		}
 		void _clean() noexcept
 		{
 			clear();
 			if (buffer_ != nullptr)
 			{
-				_free_buffer(buffer_);
+				_free_buffer(buffer_, buffer_size_);
 				buffer_ = nullptr;
 			}
 			buffer_size_ = 0U;
@@ -455,12 +711,9 @@ namespace nostd {
 			}
 			else
 				buffer_ = nullptr;
-			size_ = other.size_;
 			// Copy data
-			for (size_type i = 0U; i < size_; ++i)
-			{
-				new (buffer_ + i) T(other.buffer_[i]);
-			}
+			_copy_elements(other.buffer_, other.size_, copyable_tag());
+			size_ = other.size_;
 		}
 		void _set_by_move(vector && other) noexcept
 		{
@@ -470,15 +723,14 @@ namespace nostd {
 			allocator_ = other.allocator_;
 			buffer_size_ = other.buffer_size_;
 			size_ = other.size_;
-			// Nullify other
+			// Nullify other, it keeps the allocator to stay usable
 			other.buffer_ = nullptr;
-			other.allocator_ = nullptr;
 			other.buffer_size_ = 0U;
 			other.size_ = 0U;
 		}
 
 		T * buffer_;
-		allocator * allocator_;
+		Allocator * allocator_;
 		size_type buffer_size_;
 		size_type size_;
 	};
@@ -0,0 +1,225 @@
+#ifndef __NOSTD_WORK_STEALING_DEQUE_H__
+#define __NOSTD_WORK_STEALING_DEQUE_H__
+
+#include "default_allocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace nostd {
+
+	/**
+	 * Lock-free work-stealing deque (Chase-Lev, with memory orders by Le et al.).
+	 * Owner thread pushes and pops at the bottom, other threads steal from the top.
+	 * Element type should be trivially copyable, usually it's a pointer to task.
+	 * Buffer grows on push, old buffers are kept until destruction, because thieves may still read them.
+	 */
+	template <typename T>
+	class work_stealing_deque {
+
+		static_assert(std::is_trivially_copyable<T>::value, "Element should be trivially copyable");
+
+		/**
+		 * Defines circular buffer, elements follow the header.
+		 */
+		struct buffer_t {
+			std::int64_t mask;
+			buffer_t * previous; //!< retired buffer
+			std::atomic<T> * elements() noexcept
+			{
+				return reinterpret_cast<std::atomic<T>*>(this + 1);
+			}
+			T get(std::int64_t index) noexcept
+			{
+				return elements()[index & mask].load(std::memory_order_relaxed);
+			}
+			void put(std::int64_t index, T value) noexcept
+			{
+				elements()[index & mask].store(value, std::memory_order_relaxed);
+			}
+		};
+
+	public:
+
+		using size_type = allocator::size_type;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param[in] capacity The initial capacity, rounded up to power of two.
+		 */
+		explicit work_stealing_deque(size_type capacity = 64U) noexcept(false)
+		: work_stealing_deque(capacity, default_allocator::get_instance())
+		{
+		}
+
+		/**
+		 * Constructor with allocator.
+		 *
+		 * @param[in] capacity The initial capacity, rounded up to power of two.
+		 * @param[in] alloc    The allocator to be used to allocate buffers.
+		 */
+		work_stealing_deque(size_type capacity, allocator * alloc) noexcept(false)
+		: allocator_(alloc)
+		, top_(0)
+		, bottom_(0)
+		{
+			std::int64_t size = 2;
+			while (size < static_cast<std::int64_t>(capacity))
+				size <<= 1;
+			buffer_.store(_create_buffer(size, nullptr), std::memory_order_relaxed);
+		}
+
+		/**
+		 * Destructor.
+		 * No thread should use deque at that moment.
+		 */
+		~work_stealing_deque()
+		{
+			buffer_t * buffer = buffer_.load(std::memory_order_relaxed);
+			while (buffer != nullptr)
+			{
+				buffer_t * previous = buffer->previous;
+				_free_buffer(buffer);
+				buffer = previous;
+			}
+		}
+
+		/**
+		 * Pushes element to the bottom. Should be called by owner thread only.
+		 *
+		 * @param[in] value The value.
+		 */
+		void push(T value) noexcept(false)
+		{
+			const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+			const std::int64_t top = top_.load(std::memory_order_acquire);
+			buffer_t * buffer = buffer_.load(std::memory_order_relaxed);
+			if (bottom - top > buffer->mask)
+				buffer = _grow(buffer, top, bottom);
+			buffer->put(bottom, value);
+			// Release store instead of fence, the same ordering is visible to race detectors
+			bottom_.store(bottom + 1, std::memory_order_release);
+		}
+
+		/**
+		 * Pops element from the bottom. Should be called by owner thread only.
+		 *
+		 * @param[out] value The popped value.
+		 *
+		 * @return Returns true if element has been popped and false if deque is empty.
+		 */
+		bool pop(T& value) noexcept
+		{
+			const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+			buffer_t * buffer = buffer_.load(std::memory_order_relaxed);
+			bottom_.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top = top_.load(std::memory_order_relaxed);
+			if (top > bottom)
+			{
+				// Deque is empty
+				bottom_.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+			value = buffer->get(bottom);
+			if (top == bottom)
+			{
+				// The last element, race with thieves for it
+				const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom_.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+
+		/**
+		 * Steals element from the top. May be called by any thread.
+		 * Fails if deque is empty or other thread took the element first.
+		 *
+		 * @param[out] value The stolen value.
+		 *
+		 * @return Returns true if element has been stolen and false otherwise.
+		 */
+		bool steal(T& value) noexcept
+		{
+			std::int64_t top = top_.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+			if (top >= bottom)
+				return false;
+			buffer_t * buffer = buffer_.load(std::memory_order_acquire);
+			value = buffer->get(top);
+			return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Returns approximate number of elements, it may be outdated when used concurrently.
+		 *
+		 * @return Returns number of elements.
+		 */
+		size_type size() const noexcept
+		{
+			const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+			const std::int64_t top = top_.load(std::memory_order_relaxed);
+			return (bottom > top) ? static_cast<size_type>(bottom - top) : 0U;
+		}
+
+		/**
+		 * Checks if deque is empty, result may be outdated when used concurrently.
+		 *
+		 * @return Returns true if empty and false otherwise.
+		 */
+		bool empty() const noexcept
+		{
+			return size() == 0U;
+		}
+
+	private:
+
+		/**
+		 * Disallow copy and move
+		 */
+		work_stealing_deque(const work_stealing_deque&) = delete;
+		work_stealing_deque& operator =(const work_stealing_deque&) = delete;
+
+		buffer_t * _create_buffer(std::int64_t size, buffer_t * previous) noexcept(false)
+		{
+			buffer_t * buffer = reinterpret_cast<buffer_t*>(allocator_->allocate(
+				static_cast<size_type>(sizeof(buffer_t) + sizeof(std::atomic<T>) * size)));
+			if (buffer == nullptr)
+				throw std::bad_alloc();
+			buffer->mask = size - 1;
+			buffer->previous = previous;
+			for (std::int64_t i = 0; i < size; ++i)
+				new (&buffer->elements()[i]) std::atomic<T>();
+			return buffer;
+		}
+		void _free_buffer(buffer_t * buffer) noexcept
+		{
+			allocator_->free(reinterpret_cast<allocator::ptr_type>(buffer),
+				static_cast<size_type>(sizeof(buffer_t) + sizeof(std::atomic<T>) * (buffer->mask + 1)));
+		}
+		buffer_t * _grow(buffer_t * buffer, std::int64_t top, std::int64_t bottom) noexcept(false)
+		{
+			buffer_t * grown = _create_buffer(2 * (buffer->mask + 1), buffer);
+			for (std::int64_t i = top; i < bottom; ++i)
+				grown->put(i, buffer->get(i));
+			buffer_.store(grown, std::memory_order_release);
+			return grown;
+		}
+
+		allocator * allocator_;
+		std::atomic<buffer_t*> buffer_;
+		unsigned char padding0_[64];									//!< keeps shared data away from positions
+		std::atomic<std::int64_t> top_;									//!< position of the next steal
+		unsigned char padding1_[64 - sizeof(std::atomic<std::int64_t>)];	//!< keeps top on its own cache line
+		std::atomic<std::int64_t> bottom_;								//!< position of the next push
+		unsigned char padding2_[64 - sizeof(std::atomic<std::int64_t>)];	//!< keeps bottom on its own cache line
+	};
+
+} // namespace nostd
+
+#endif
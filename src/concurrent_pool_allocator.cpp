@@ -0,0 +1,342 @@
+#include <nostd/concurrent_pool_allocator.h>
+
+#include <cassert>
+#include <new>
+#include <stdexcept>
+
+namespace nostd {
+
+	namespace {
+
+#if UINTPTR_MAX > 0xFFFFFFFFu
+		// User space addresses fit into 48 bits on supported 64-bit platforms
+		const unsigned kPointerBits = 48U;
+#else
+		const unsigned kPointerBits = 32U;
+#endif
+		const std::uint64_t kPointerMask = (static_cast<std::uint64_t>(1) << kPointerBits) - 1U;
+
+		std::atomic<std::uint64_t> g_next_id(1U);
+
+		std::mutex& registry_mutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+	} // namespace
+
+	/**
+	 * Thread-local table of caches, one slot per recently used allocator.
+	 * Table is trivial, so it remains accessible during thread termination,
+	 * the guard object returns cached magazines to their owners.
+	 */
+	struct concurrent_pool_allocator::cache_table_t {
+
+		static const size_type kNumSlots = 8U;
+
+		struct guard_t {
+			~guard_t();
+		};
+
+		cache_t slots[kNumSlots];
+		size_type victim;
+		bool guarded;
+		bool dead;
+
+		static cache_table_t& instance() noexcept
+		{
+			static thread_local cache_table_t table;
+			return table;
+		}
+		static void install_guard() noexcept
+		{
+			static thread_local guard_t guard;
+			(void)guard;
+		}
+		static concurrent_pool_allocator *& registry_head() noexcept
+		{
+			static concurrent_pool_allocator * head = nullptr;
+			return head;
+		}
+		static bool is_alive(concurrent_pool_allocator * owner, std::uint64_t id) noexcept
+		{
+			for (concurrent_pool_allocator * x = registry_head(); x != nullptr; x = x->registry_next_)
+				if (x == owner && x->id_ == id)
+					return true;
+			return false;
+		}
+		static void flush(cache_t& slot) noexcept
+		{
+			if (slot.owner != nullptr)
+			{
+				std::lock_guard<std::mutex> lock(registry_mutex());
+				if (is_alive(slot.owner, slot.owner_id))
+				{
+					if (slot.loaded_count != 0U)
+						slot.owner->_push_magazine(slot.loaded, slot.loaded_count);
+					if (slot.previous_count != 0U)
+						slot.owner->_push_magazine(slot.previous, slot.previous_count);
+				}
+			}
+			slot.owner = nullptr;
+			slot.owner_id = 0U;
+			slot.loaded = nullptr;
+			slot.previous = nullptr;
+			slot.loaded_count = 0U;
+			slot.previous_count = 0U;
+		}
+	};
+
+	concurrent_pool_allocator::cache_table_t::guard_t::~guard_t()
+	{
+		cache_table_t& table = cache_table_t::instance();
+		for (size_type i = 0U; i < kNumSlots; ++i)
+			flush(table.slots[i]);
+		table.dead = true;
+	}
+
+	concurrent_pool_allocator::concurrent_pool_allocator(size_type num_chunks) noexcept
+	: concurrent_pool_allocator(num_chunks, 32U)
+	{
+	}
+	concurrent_pool_allocator::concurrent_pool_allocator(size_type num_chunks, size_type magazine_size) noexcept
+	: depot_(0U)
+	, num_chunks_(num_chunks != 0U ? num_chunks : 1U)
+	, magazine_size_(magazine_size != 0U ? magazine_size : 1U)
+	, chunk_size_(0U)
+	, id_(g_next_id.fetch_add(1U, std::memory_order_relaxed))
+	, registry_prev_(nullptr)
+	, registry_next_(nullptr)
+	, grow_mutex_()
+	, buffers_()
+	{
+		_register();
+	}
+	concurrent_pool_allocator::~concurrent_pool_allocator()
+	{
+		_unregister();
+		// Drop own thread cache, it points into buffers being freed
+		cache_table_t& table = cache_table_t::instance();
+		for (size_type i = 0U; i < cache_table_t::kNumSlots; ++i)
+			if (table.slots[i].owner == this && table.slots[i].owner_id == id_)
+				cache_table_t::flush(table.slots[i]);
+		for (auto buffer : buffers_)
+			delete[] buffer;
+	}
+	allocator::ptr_type concurrent_pool_allocator::allocate(size_type size) noexcept(false)
+	{
+		assert((chunk_size_.load(std::memory_order_relaxed) == 0U || size <= chunk_size_.load(std::memory_order_relaxed)) && "Allocated size should be constant");
+		node_t * node;
+		cache_t * cache = _cache();
+		if (cache == nullptr)
+		{
+			// Thread is terminating, work with depot directly
+			node = _pop_magazine();
+			if (node == nullptr)
+				node = _grow(size);
+			if (node->count > 1U)
+				_push_magazine(node->next, node->count - 1U);
+			return reinterpret_cast<ptr_type>(node);
+		}
+		if (cache->loaded_count == 0U)
+		{
+			if (cache->previous_count != 0U)
+			{
+				utility::swap(cache->loaded, cache->previous);
+				utility::swap(cache->loaded_count, cache->previous_count);
+			}
+			else
+			{
+				node = _pop_magazine();
+				if (node == nullptr)
+					node = _grow(size);
+				cache->loaded = node;
+				cache->loaded_count = node->count;
+			}
+		}
+		node = cache->loaded;
+		cache->loaded = node->next;
+		--cache->loaded_count;
+		return reinterpret_cast<ptr_type>(node);
+	}
+	void concurrent_pool_allocator::free(ptr_type ptr) noexcept
+	{
+		node_t * node = new (ptr) node_t;
+		cache_t * cache = _cache();
+		if (cache == nullptr)
+		{
+			// Thread is terminating, work with depot directly
+			node->next = nullptr;
+			_push_magazine(node, 1U);
+			return;
+		}
+		if (cache->loaded_count == magazine_size_)
+		{
+			// Previous magazine is either empty or full
+			if (cache->previous_count != 0U)
+				_push_magazine(cache->previous, cache->previous_count);
+			cache->previous = cache->loaded;
+			cache->previous_count = cache->loaded_count;
+			cache->loaded = nullptr;
+			cache->loaded_count = 0U;
+		}
+		node->next = cache->loaded;
+		cache->loaded = node;
+		++cache->loaded_count;
+	}
+	bool concurrent_pool_allocator::try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+	{
+		(void)ptr;
+		(void)old_size;
+		return new_size <= chunk_size_.load(std::memory_order_relaxed);
+	}
+	allocator::size_type concurrent_pool_allocator::num_chunks() const noexcept
+	{
+		return num_chunks_;
+	}
+	allocator::size_type concurrent_pool_allocator::magazine_size() const noexcept
+	{
+		return magazine_size_;
+	}
+	concurrent_pool_allocator::cache_t * concurrent_pool_allocator::_cache() noexcept
+	{
+		cache_table_t& table = cache_table_t::instance();
+		if (table.dead)
+			return nullptr;
+		size_type i;
+		for (i = 0U; i < cache_table_t::kNumSlots; ++i)
+		{
+			cache_t& slot = table.slots[i];
+			if (slot.owner == this && slot.owner_id == id_)
+				return &slot;
+		}
+		// Slot for this allocator is missing
+		if (!table.guarded)
+		{
+			cache_table_t::install_guard();
+			table.guarded = true;
+		}
+		for (i = 0U; i < cache_table_t::kNumSlots; ++i)
+			if (table.slots[i].owner == nullptr)
+				break;
+		if (i == cache_table_t::kNumSlots)
+		{
+			i = table.victim;
+			table.victim = (table.victim + 1U) % cache_table_t::kNumSlots;
+			cache_table_t::flush(table.slots[i]);
+		}
+		cache_t& slot = table.slots[i];
+		slot.owner = this;
+		slot.owner_id = id_;
+		return &slot;
+	}
+	concurrent_pool_allocator::node_t * concurrent_pool_allocator::_pop_magazine() noexcept
+	{
+		std::uint64_t head = depot_.load(std::memory_order_acquire);
+		for (;;)
+		{
+			node_t * node = _unpack(head);
+			if (node == nullptr)
+				return nullptr;
+			// Node may be popped by other thread meanwhile, the tag protects from using stale link
+			node_t * next = node->next_magazine.load(std::memory_order_relaxed);
+			if (depot_.compare_exchange_weak(head, _pack(next, _next_tag(head)),
+				std::memory_order_acquire, std::memory_order_acquire))
+				return node;
+		}
+	}
+	void concurrent_pool_allocator::_push_magazine(node_t * magazine, size_type count) noexcept
+	{
+		magazine->count = count;
+		std::uint64_t head = depot_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			magazine->next_magazine.store(_unpack(head), std::memory_order_relaxed);
+			if (depot_.compare_exchange_weak(head, _pack(magazine, _next_tag(head)),
+				std::memory_order_release, std::memory_order_relaxed))
+				return;
+		}
+	}
+	concurrent_pool_allocator::node_t * concurrent_pool_allocator::_grow(size_type size) noexcept(false)
+	{
+		std::lock_guard<std::mutex> lock(grow_mutex_);
+
+		// Other thread may have refilled depot while we were waiting
+		node_t * magazine = _pop_magazine();
+		if (magazine != nullptr)
+			return magazine;
+
+		size_type chunk_size = chunk_size_.load(std::memory_order_relaxed);
+		if (chunk_size == 0U)
+		{
+			// First time buffer allocation
+			chunk_size = (size < sizeof(node_t)) ? static_cast<size_type>(sizeof(node_t)) : size;
+			chunk_size = (chunk_size + (alignof(node_t) - 1U)) & ~static_cast<size_type>(alignof(node_t) - 1U);
+			chunk_size_.store(chunk_size, std::memory_order_relaxed);
+		}
+
+		byte_type* buffer = new byte_type[num_chunks_ * chunk_size];
+		if (buffer == nullptr)
+			throw std::bad_alloc();
+		buffers_.push_back(buffer);
+
+		// Split buffer into magazines
+		for (size_type first = 0U; first < num_chunks_; first += magazine_size_)
+		{
+			size_type last = first + magazine_size_;
+			if (last > num_chunks_)
+				last = num_chunks_;
+			node_t * head = nullptr;
+			for (size_type i = last; i != first; --i)
+			{
+				node_t * node = new (buffer + (i - 1U) * chunk_size) node_t;
+				node->next = head;
+				head = node;
+			}
+			head->count = last - first;
+			if (magazine == nullptr)
+				magazine = head;
+			else
+				_push_magazine(head, head->count);
+		}
+		return magazine;
+	}
+	void concurrent_pool_allocator::_register() noexcept
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex());
+		concurrent_pool_allocator *& head = cache_table_t::registry_head();
+		registry_next_ = head;
+		if (head != nullptr)
+			head->registry_prev_ = this;
+		head = this;
+	}
+	void concurrent_pool_allocator::_unregister() noexcept
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex());
+		concurrent_pool_allocator *& head = cache_table_t::registry_head();
+		if (registry_prev_ != nullptr)
+			registry_prev_->registry_next_ = registry_next_;
+		else
+			head = registry_next_;
+		if (registry_next_ != nullptr)
+			registry_next_->registry_prev_ = registry_prev_;
+		registry_prev_ = nullptr;
+		registry_next_ = nullptr;
+	}
+	std::uint64_t concurrent_pool_allocator::_pack(node_t * node, std::uint64_t tag) noexcept
+	{
+		std::uint64_t address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(node));
+		assert((address & ~kPointerMask) == 0U && "Pointer doesn't fit into tagged value");
+		return address | (tag << kPointerBits);
+	}
+	concurrent_pool_allocator::node_t * concurrent_pool_allocator::_unpack(std::uint64_t value) noexcept
+	{
+		return reinterpret_cast<node_t*>(static_cast<std::uintptr_t>(value & kPointerMask));
+	}
+	std::uint64_t concurrent_pool_allocator::_next_tag(std::uint64_t value) noexcept
+	{
+		return (value >> kPointerBits) + 1U;
+	}
+
+} // namespace nostd
\ No newline at end of file
@@ -1,19 +1,385 @@
 #include <nostd/default_allocator.h>
+#include <nostd/stack_linked_list.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
 
 namespace nostd {
 
+	namespace {
+
+		using size_type = allocator::size_type;
+		using byte_type = allocator::byte_type;
+		using node_type = stack_linked_list::node_t;
+
+		const std::size_t kRegionSize = sizeof(void*) >= 8U ? (std::size_t(1) << 35) : (std::size_t(1) << 28);
+		const std::size_t kMinRegionSize = std::size_t(1) << 24;
+
+		unsigned highest_bit(size_type value) noexcept
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return 31U - static_cast<unsigned>(__builtin_clz(value));
+#elif defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse(&index, value);
+			return static_cast<unsigned>(index);
+#else
+			unsigned index = 0U;
+			while (value >>= 1)
+				++index;
+			return index;
+#endif
+		}
+
+		/**
+		 * Cache of single thread
+		 */
+		struct heap_t {
+			stack_linked_list free_lists[default_allocator::num_size_classes]; //!< used by owner only
+			heap_t * next_abandoned;
+			byte_type padding[64]; //!< keeps remote stack off the cache lines of owner
+			std::atomic<node_type*> remote_free; //!< blocks freed by other threads
+
+			heap_t() noexcept
+			: next_abandoned(nullptr)
+			, remote_free(nullptr)
+			{
+			}
+		};
+
+		/**
+		 * Header placed at the beginning of every page.
+		 * It's written once before blocks of page are handed out.
+		 */
+		struct page_header_t {
+			heap_t * owner;
+			size_type size_class;
+		};
+
+		/**
+		 * Address range that pages are cut from.
+		 * Pages are never returned, so range is never released.
+		 */
+		class region_t {
+		public:
+			region_t() noexcept
+			: begin_(0U)
+			, end_(0U)
+			, next_(0U)
+			{
+				// Extra page is reserved to align the beginning
+				for (std::size_t size = kRegionSize; size >= kMinRegionSize; size /= 2U)
+				{
+					void * ptr = _reserve(size + default_allocator::page_size);
+					if (ptr == nullptr)
+						continue;
+					std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+					begin_ = (address + (default_allocator::page_size - 1U)) & ~static_cast<std::uintptr_t>(default_allocator::page_size - 1U);
+					end_ = begin_ + size;
+					break;
+				}
+			}
+			bool contains(const void * ptr) const noexcept
+			{
+				std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+				return address >= begin_ && address < end_;
+			}
+			byte_type * allocate_page() noexcept
+			{
+				const std::size_t size = end_ - begin_;
+				if (next_.load(std::memory_order_relaxed) >= size)
+					return nullptr;
+				std::size_t offset = next_.fetch_add(default_allocator::page_size, std::memory_order_relaxed);
+				if (offset >= size)
+					return nullptr;
+				byte_type * page = reinterpret_cast<byte_type*>(begin_ + offset);
+#if defined(_WIN32)
+				if (::VirtualAlloc(page, default_allocator::page_size, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+					return nullptr;
+#endif
+				return page;
+			}
+		private:
+			static void * _reserve(std::size_t size) noexcept
+			{
+#if defined(_WIN32)
+				return ::VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+				int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+# ifdef MAP_NORESERVE
+				flags |= MAP_NORESERVE;
+# endif
+				// Physical pages are taken on first access
+				void * ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+				return ptr != MAP_FAILED ? ptr : nullptr;
+#endif
+			}
+
+			std::uintptr_t begin_;
+			std::uintptr_t end_;
+			std::atomic<std::size_t> next_; //!< offset of the next free page
+		};
+
+		region_t& region() noexcept
+		{
+			static region_t instance;
+			return instance;
+		}
+
+		page_header_t * page_of(const void * ptr) noexcept
+		{
+			std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+			return reinterpret_cast<page_header_t*>(address & ~static_cast<std::uintptr_t>(default_allocator::page_size - 1U));
+		}
+
+		/**
+		 * Heaps of exited threads, they are never destroyed since their blocks may be alive
+		 */
+		std::mutex& abandoned_mutex() noexcept
+		{
+			static std::mutex * mutex = new std::mutex();
+			return *mutex;
+		}
+		heap_t * abandoned_heaps = nullptr;
+
+		thread_local heap_t * current = nullptr;
+		thread_local bool exited = false;
+
+		/**
+		 * Abandons heap of thread on its exit
+		 */
+		struct heap_guard {
+			heap_t * heap;
+
+			~heap_guard()
+			{
+				// Allocations of later thread local destructors go to malloc
+				current = nullptr;
+				exited = true;
+				std::lock_guard<std::mutex> lock(abandoned_mutex());
+				heap->next_abandoned = abandoned_heaps;
+				abandoned_heaps = heap;
+			}
+		};
+
+		heap_t * acquire_heap() noexcept
+		{
+			if (exited)
+				return nullptr;
+			heap_t * heap = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(abandoned_mutex());
+				heap = abandoned_heaps;
+				if (heap != nullptr)
+					abandoned_heaps = heap->next_abandoned;
+			}
+			if (heap == nullptr)
+				heap = new (std::nothrow) heap_t();
+			if (heap == nullptr)
+				return nullptr;
+			static thread_local heap_guard guard = {nullptr};
+			guard.heap = heap;
+			current = heap;
+			return heap;
+		}
+
+		heap_t * current_heap() noexcept
+		{
+			heap_t * heap = current;
+			return heap != nullptr ? heap : acquire_heap();
+		}
+
+		void push_remote(heap_t * owner, node_type * node) noexcept
+		{
+			node_type * head = owner->remote_free.load(std::memory_order_relaxed);
+			do {
+				node->next = head;
+			} while (!owner->remote_free.compare_exchange_weak(head, node,
+				std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		void drain_remote(heap_t * heap) noexcept
+		{
+			if (heap->remote_free.load(std::memory_order_relaxed) == nullptr)
+				return;
+			node_type * node = heap->remote_free.exchange(nullptr, std::memory_order_acquire);
+			while (node != nullptr)
+			{
+				node_type * next = node->next;
+				heap->free_lists[page_of(node)->size_class].push(node);
+				node = next;
+			}
+		}
+
+		/**
+		 * Refills free list of size class by remote blocks or new page
+		 *
+		 * @return Returns false if the range is exhausted.
+		 */
+		bool refill(heap_t * heap, size_type index) noexcept
+		{
+			drain_remote(heap);
+			if (!heap->free_lists[index].empty())
+				return true;
+			byte_type * page = region().allocate_page();
+			if (page == nullptr)
+				return false;
+			page_header_t * header = reinterpret_cast<page_header_t*>(page);
+			header->owner = heap;
+			header->size_class = index;
+			// Lower addresses go first
+			const size_type size = default_allocator::class_size(index);
+			const size_type count = (default_allocator::page_size - default_allocator::page_header_size) / size;
+			byte_type * first = page + default_allocator::page_header_size;
+			for (size_type i = count; i != 0U; --i)
+				heap->free_lists[index].push(reinterpret_cast<node_type*>(first + (i - 1U) * size));
+			return true;
+		}
+
+	} // namespace
+
+	const allocator::size_type default_allocator::page_size;
+	const allocator::size_type default_allocator::page_header_size;
+	const allocator::size_type default_allocator::max_size;
+	const allocator::size_type default_allocator::num_size_classes;
+
 	default_allocator * default_allocator::get_instance()
 	{
-		static thread_local default_allocator instance;
-		return &instance;
+		static default_allocator * const instance = new default_allocator();
+		return instance;
 	}
 	allocator::ptr_type default_allocator::allocate(size_type size) noexcept(false)
 	{
-		return reinterpret_cast<ptr_type>(new byte_type[size]);
+		static_assert(sizeof(page_header_t) <= page_header_size, "Page header doesn't fit");
+		static_assert(page_header_size % alignof(std::max_align_t) == 0U, "Blocks should be aligned like malloc");
+		if (size <= max_size)
+		{
+			heap_t * heap = current_heap();
+			if (heap != nullptr)
+			{
+				const size_type index = size_class(size);
+				node_type * node = heap->free_lists[index].pop();
+				if (node == nullptr && refill(heap, index))
+					node = heap->free_lists[index].pop();
+				if (node != nullptr)
+					return reinterpret_cast<ptr_type>(node);
+			}
+		}
+		ptr_type ptr = std::malloc(size != 0U ? size : 1U);
+		if (ptr == nullptr)
+			throw std::bad_alloc();
+		return ptr;
 	}
 	void default_allocator::free(ptr_type ptr) noexcept
 	{
-		delete[] reinterpret_cast<byte_type*>(ptr);
+		if (!cached(ptr))
+		{
+			std::free(ptr);
+			return;
+		}
+		page_header_t * page = page_of(ptr);
+		node_type * node = reinterpret_cast<node_type*>(ptr);
+		if (page->owner == current)
+			page->owner->free_lists[page->size_class].push(node);
+		else
+			push_remote(page->owner, node);
+	}
+	void default_allocator::allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false)
+	{
+		heap_t * heap = size <= max_size ? current_heap() : nullptr;
+		if (heap == nullptr)
+		{
+			allocator::allocate_batch(size, count, out);
+			return;
+		}
+		const size_type index = size_class(size);
+		size_type i = 0;
+		while (i < count)
+		{
+			node_type * node = heap->free_lists[index].pop_chain(count - i);
+			if (node == nullptr)
+			{
+				if (refill(heap, index))
+					continue;
+				// The range is exhausted, the rest goes to malloc
+				try
+				{
+					allocator::allocate_batch(size, count - i, out + i);
+				}
+				catch (...)
+				{
+					free_batch(size, i, out);
+					throw;
+				}
+				return;
+			}
+			for (; node != nullptr; node = node->next)
+				out[i++] = reinterpret_cast<ptr_type>(node);
+		}
+	}
+	bool default_allocator::try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+	{
+		(void)old_size;
+		return cached(ptr) && new_size <= class_size(page_of(ptr)->size_class);
+	}
+	allocator::ptr_type default_allocator::reallocate(ptr_type ptr, size_type old_size, size_type new_size) noexcept(false)
+	{
+		if (ptr == nullptr)
+			return allocate(new_size);
+		if (!cached(ptr))
+		{
+			ptr_type new_ptr = std::realloc(ptr, new_size != 0U ? new_size : 1U);
+			if (new_ptr == nullptr)
+				throw std::bad_alloc();
+			return new_ptr;
+		}
+		if (try_expand(ptr, old_size, new_size))
+			return ptr;
+		ptr_type new_ptr = allocate(new_size);
+		std::memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+		free(ptr);
+		return new_ptr;
+	}
+	bool default_allocator::cached(const void * ptr) noexcept
+	{
+		return region().contains(ptr);
+	}
+	allocator::size_type default_allocator::size_class(size_type size) noexcept
+	{
+		assert(size <= max_size && "Size should be served by caches");
+		// Steps of 16 bytes up to 128, then four classes per power of two
+		if (size <= 128U)
+			return size != 0U ? (size - 1U) >> 4 : 0U;
+		const unsigned bit = highest_bit(size - 1U);
+		return 8U + (bit - 7U) * 4U + (((size - 1U) >> (bit - 2U)) - 4U);
+	}
+	allocator::size_type default_allocator::class_size(size_type index) noexcept
+	{
+		assert(index < num_size_classes && "Size class index is out of range");
+		if (index < 8U)
+			return (index + 1U) << 4;
+		const unsigned step = index - 8U;
+		const unsigned bit = 7U + step / 4U;
+		return (5U + step % 4U) << (bit - 2U);
 	}
 
-} // namespace nostd
\ No newline at end of file
+} // namespace nostd
@@ -0,0 +1,195 @@
+#include <nostd/monotonic_arena.h>
+#include <nostd/default_allocator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace nostd {
+
+	namespace {
+
+		const allocator::size_type kMaxChunkSize = 1U << 24;
+
+		allocator::byte_type * align_up(allocator::byte_type * ptr, allocator::size_type alignment) noexcept
+		{
+			std::uintptr_t value = reinterpret_cast<std::uintptr_t>(ptr);
+			value = (value + (alignment - 1)) & ~static_cast<std::uintptr_t>(alignment - 1);
+			return reinterpret_cast<allocator::byte_type*>(value);
+		}
+
+	} // namespace
+
+	const allocator::size_type monotonic_arena::alignment = alignof(std::max_align_t);
+
+	monotonic_arena::monotonic_arena(size_type chunk_size) noexcept
+	: monotonic_arena(nullptr, 0U, chunk_size, default_allocator::get_instance())
+	{
+	}
+	monotonic_arena::monotonic_arena(size_type chunk_size, allocator * upstream) noexcept
+	: monotonic_arena(nullptr, 0U, chunk_size, upstream)
+	{
+	}
+	monotonic_arena::monotonic_arena(void * buffer, size_type buffer_size) noexcept
+	: monotonic_arena(buffer, buffer_size, buffer_size, default_allocator::get_instance())
+	{
+	}
+	monotonic_arena::monotonic_arena(void * buffer, size_type buffer_size, allocator * upstream) noexcept
+	: monotonic_arena(buffer, buffer_size, buffer_size, upstream)
+	{
+	}
+	monotonic_arena::monotonic_arena(const monotonic_arena& other) noexcept
+	: monotonic_arena(nullptr, 0U, other.initial_chunk_size_, other.upstream_)
+	{
+	}
+	monotonic_arena::monotonic_arena(monotonic_arena&& other) noexcept
+	: upstream_(other.upstream_)
+	, initial_buffer_(other.initial_buffer_)
+	, initial_size_(other.initial_size_)
+	, initial_chunk_size_(other.initial_chunk_size_)
+	, next_chunk_size_(other.next_chunk_size_)
+	, head_(other.head_)
+	, current_(other.current_)
+	, ptr_(other.ptr_)
+	, end_(other.end_)
+	{
+		other.initial_buffer_ = nullptr;
+		other.initial_size_ = 0U;
+		other.next_chunk_size_ = other.initial_chunk_size_;
+		other.head_ = nullptr;
+		other._rewind();
+	}
+	monotonic_arena::monotonic_arena(void * buffer, size_type buffer_size, size_type chunk_size, allocator * upstream) noexcept
+	: upstream_(upstream)
+	, initial_buffer_(reinterpret_cast<byte_type*>(buffer))
+	, initial_size_(buffer != nullptr ? buffer_size : 0U)
+	, initial_chunk_size_(chunk_size)
+	, next_chunk_size_(chunk_size)
+	, head_(nullptr)
+	, current_(nullptr)
+	, ptr_(nullptr)
+	, end_(nullptr)
+	{
+		_rewind();
+	}
+	monotonic_arena::~monotonic_arena()
+	{
+		release();
+	}
+	allocator::ptr_type monotonic_arena::allocate(size_type size) noexcept(false)
+	{
+		if (size == 0U)
+			size = 1U;
+		byte_type * address = align_up(ptr_, alignment);
+		if (ptr_ == nullptr || address > end_ || static_cast<size_type>(end_ - address) < size)
+		{
+			// Current region is exhausted
+			_next_chunk(size);
+			address = align_up(ptr_, alignment);
+		}
+		ptr_ = address + size;
+		return reinterpret_cast<ptr_type>(address);
+	}
+	void monotonic_arena::free(ptr_type ptr) noexcept
+	{
+		(void)ptr;
+	}
+	void monotonic_arena::free(ptr_type ptr, size_type size) noexcept
+	{
+		byte_type * address = reinterpret_cast<byte_type*>(ptr);
+		if (size == 0U)
+			size = 1U;
+		// Only the last block can be given back
+		if (address != nullptr && address + size == ptr_)
+			ptr_ = address;
+	}
+	bool monotonic_arena::try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+	{
+		byte_type * address = reinterpret_cast<byte_type*>(ptr);
+		if (old_size == 0U)
+			old_size = 1U;
+		if (new_size == 0U)
+			new_size = 1U;
+		if (address == nullptr || address + old_size != ptr_)
+			return false;
+		if (new_size > static_cast<size_type>(end_ - address))
+			return false;
+		ptr_ = address + new_size;
+		return true;
+	}
+	void monotonic_arena::reset() noexcept
+	{
+		_rewind();
+	}
+	void monotonic_arena::release() noexcept
+	{
+		chunk_t * chunk = head_;
+		while (chunk != nullptr)
+		{
+			chunk_t * next = chunk->next;
+			upstream_->free(reinterpret_cast<ptr_type>(chunk));
+			chunk = next;
+		}
+		head_ = nullptr;
+		next_chunk_size_ = initial_chunk_size_;
+		_rewind();
+	}
+	allocator::size_type monotonic_arena::num_chunks() const noexcept
+	{
+		size_type count = 0U;
+		for (chunk_t * chunk = head_; chunk != nullptr; chunk = chunk->next)
+			++count;
+		return count;
+	}
+	void monotonic_arena::_rewind() noexcept
+	{
+		current_ = nullptr;
+		ptr_ = initial_buffer_;
+		end_ = (initial_buffer_ != nullptr) ? initial_buffer_ + initial_size_ : nullptr;
+	}
+	void monotonic_arena::_next_chunk(size_type size) noexcept(false)
+	{
+		const size_type overhead = _header_size() + alignment;
+		if (size > static_cast<size_type>(-1) - overhead)
+			throw std::bad_alloc();
+		const size_type needed = size + overhead;
+
+		// Try to reuse the chunk retained by previous reset
+		chunk_t * chunk = (current_ != nullptr) ? current_->next : head_;
+		if (chunk == nullptr || chunk->size < needed)
+		{
+			size_type chunk_size = (next_chunk_size_ < needed) ? needed : next_chunk_size_;
+			chunk = _allocate_chunk(chunk_size);
+			// Link the new chunk right after the current one
+			if (current_ != nullptr)
+			{
+				chunk->next = current_->next;
+				current_->next = chunk;
+			}
+			else
+			{
+				chunk->next = head_;
+				head_ = chunk;
+			}
+			if (next_chunk_size_ < kMaxChunkSize)
+				next_chunk_size_ <<= 1;
+		}
+		current_ = chunk;
+		ptr_ = reinterpret_cast<byte_type*>(chunk) + _header_size();
+		end_ = reinterpret_cast<byte_type*>(chunk) + chunk->size;
+	}
+	monotonic_arena::chunk_t * monotonic_arena::_allocate_chunk(size_type size) noexcept(false)
+	{
+		chunk_t * chunk = reinterpret_cast<chunk_t*>(upstream_->allocate(size));
+		if (chunk == nullptr)
+			throw std::bad_alloc();
+		chunk->next = nullptr;
+		chunk->size = size;
+		return chunk;
+	}
+	allocator::size_type monotonic_arena::_header_size() noexcept
+	{
+		return (static_cast<size_type>(sizeof(chunk_t)) + (alignment - 1)) & ~(alignment - 1);
+	}
+
+} // namespace nostd
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include <nostd/page_allocator.h>
+
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+# ifndef MAP_HUGE_SHIFT
+#  define MAP_HUGE_SHIFT 26
+# endif
+#endif
+
+namespace nostd {
+
+	namespace {
+
+		const std::size_t kHugePage = 1U << 21;
+		const std::size_t kGiantPage = 1U << 30;
+
+		std::size_t huge_page_size(page_kind kind) noexcept
+		{
+			switch (kind)
+			{
+			case page_kind::huge_2mb:
+				return kHugePage;
+			case page_kind::huge_1gb:
+				return kGiantPage;
+			default:
+				return 0U;
+			}
+		}
+
+		std::size_t round_up(std::size_t size, std::size_t alignment) noexcept(false)
+		{
+			std::size_t rounded = (size + (alignment - 1U)) & ~(alignment - 1U);
+			if (rounded < size)
+				throw std::bad_alloc();
+			return rounded;
+		}
+
+	} // namespace
+
+	const int page_allocator::any_node;
+
+	page_allocator::page_allocator() noexcept
+	: page_allocator(page_kind::normal)
+	{
+	}
+	page_allocator::page_allocator(page_kind kind, int numa_node) noexcept
+	: kind_(kind)
+	, numa_node_(numa_node)
+	, mapped_size_(0U)
+	, huge_size_(0U)
+	, mappings_()
+	{
+	}
+	page_allocator::~page_allocator()
+	{
+		while (!mappings_.empty())
+			free(mappings_.back().begin);
+	}
+	allocator::ptr_type page_allocator::allocate(size_type size) noexcept(false)
+	{
+		mappings_.reserve(mappings_.size() + 1U); // so record never fails after mapping
+		byte_type * ptr = _map(size != 0U ? size : 1U);
+		return reinterpret_cast<ptr_type>(ptr);
+	}
+	void page_allocator::free(ptr_type ptr) noexcept
+	{
+		if (ptr == nullptr)
+			return;
+		// Buffers are usually freed in reverse order
+		for (size_type i = mappings_.size(); i != 0U; --i)
+		{
+			mapping_t& mapping = mappings_[i - 1U];
+			if (mapping.begin != reinterpret_cast<byte_type*>(ptr))
+				continue;
+#if defined(_WIN32)
+			::VirtualFree(mapping.begin, 0, MEM_RELEASE);
+#else
+			::munmap(mapping.begin, mapping.size);
+#endif
+			mapped_size_ -= mapping.size;
+			if (mapping.huge)
+				huge_size_ -= mapping.size;
+			mapping = mappings_.back();
+			mappings_.pop_back();
+			return;
+		}
+	}
+	page_kind page_allocator::kind() const noexcept
+	{
+		return kind_;
+	}
+	int page_allocator::numa_node() const noexcept
+	{
+		return numa_node_;
+	}
+	allocator::size_type page_allocator::page_size() const noexcept
+	{
+#if defined(_WIN32)
+		if (kind_ != page_kind::normal && ::GetLargePageMinimum() != 0U)
+			return static_cast<size_type>(::GetLargePageMinimum());
+		return system_page_size();
+#else
+		return kind_ != page_kind::normal ? static_cast<size_type>(huge_page_size(kind_)) : system_page_size();
+#endif
+	}
+	std::size_t page_allocator::mapped_size() const noexcept
+	{
+		return mapped_size_;
+	}
+	std::size_t page_allocator::huge_size() const noexcept
+	{
+		return huge_size_;
+	}
+	allocator::size_type page_allocator::system_page_size() noexcept
+	{
+#if defined(_WIN32)
+		SYSTEM_INFO info;
+		::GetSystemInfo(&info);
+		return static_cast<size_type>(info.dwPageSize);
+#else
+		return static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+#endif
+	}
+#if defined(_WIN32)
+	allocator::byte_type * page_allocator::_map(std::size_t size) noexcept(false)
+	{
+		const DWORD flags = MEM_RESERVE | MEM_COMMIT;
+		const DWORD node = numa_node_ != any_node ? static_cast<DWORD>(numa_node_) : NUMA_NO_PREFERRED_NODE;
+		void * ptr = nullptr;
+		bool huge = false;
+		std::size_t length = 0U;
+		// Large pages need SeLockMemoryPrivilege, without it regular pages are used
+		const std::size_t large_page = ::GetLargePageMinimum();
+		if (kind_ != page_kind::normal && large_page != 0U)
+		{
+			length = round_up(size, large_page);
+			ptr = ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, length, flags | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+			huge = ptr != nullptr;
+		}
+		if (ptr == nullptr)
+		{
+			length = round_up(size, system_page_size());
+			ptr = ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, length, flags, PAGE_READWRITE, node);
+		}
+		if (ptr == nullptr)
+			throw std::bad_alloc();
+		byte_type * begin = reinterpret_cast<byte_type*>(ptr);
+		mappings_.push_back(mapping_t{begin, length, huge});
+		mapped_size_ += length;
+		if (huge)
+			huge_size_ += length;
+		return begin;
+	}
+	void page_allocator::_bind(byte_type * ptr, std::size_t size) noexcept
+	{
+		// Node is chosen by VirtualAllocExNuma
+		(void)ptr;
+		(void)size;
+	}
+#else
+	allocator::byte_type * page_allocator::_map(std::size_t size) noexcept(false)
+	{
+		const int protection = PROT_READ | PROT_WRITE;
+		const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+		byte_type * begin = nullptr;
+		bool huge = false;
+		std::size_t length = round_up(size, system_page_size());
+		if (kind_ != page_kind::normal)
+		{
+			const std::size_t page = huge_page_size(kind_);
+			length = round_up(size, page);
+#ifdef MAP_HUGETLB
+			const int page_flag = (kind_ == page_kind::huge_1gb ? 30 : 21) << MAP_HUGE_SHIFT;
+			void * ptr = ::mmap(nullptr, length, protection, flags | MAP_HUGETLB | page_flag, -1, 0);
+			if (ptr != MAP_FAILED)
+			{
+				begin = reinterpret_cast<byte_type*>(ptr);
+				huge = true;
+			}
+#endif
+			if (begin == nullptr)
+			{
+				// No reserved huge pages, transparent ones need range aligned to 2MB
+				void * ptr = ::mmap(nullptr, length + kHugePage, protection, flags, -1, 0);
+				if (ptr == MAP_FAILED)
+					throw std::bad_alloc();
+				byte_type * raw = reinterpret_cast<byte_type*>(ptr);
+				std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw);
+				address = (address + (kHugePage - 1U)) & ~static_cast<std::uintptr_t>(kHugePage - 1U);
+				begin = reinterpret_cast<byte_type*>(address);
+				if (begin != raw)
+					::munmap(raw, static_cast<std::size_t>(begin - raw));
+				::munmap(begin + length, static_cast<std::size_t>(raw + kHugePage - begin));
+#ifdef MADV_HUGEPAGE
+				::madvise(begin, length, MADV_HUGEPAGE);
+#endif
+			}
+		}
+		else
+		{
+			void * ptr = ::mmap(nullptr, length, protection, flags, -1, 0);
+			if (ptr == MAP_FAILED)
+				throw std::bad_alloc();
+			begin = reinterpret_cast<byte_type*>(ptr);
+		}
+		_bind(begin, length);
+		mappings_.push_back(mapping_t{begin, length, huge});
+		mapped_size_ += length;
+		if (huge)
+			huge_size_ += length;
+		return begin;
+	}
+	void page_allocator::_bind(byte_type * ptr, std::size_t size) noexcept
+	{
+#if defined(__linux__) && defined(SYS_mbind)
+		if (numa_node_ < 0 || numa_node_ >= 1024)
+			return;
+		const int kPreferred = 1; // MPOL_PREFERRED, full node falls back to others unlike MPOL_BIND
+		const std::size_t bits = 8U * sizeof(unsigned long);
+		unsigned long mask[1024U / bits] = {};
+		const std::size_t node = static_cast<std::size_t>(numa_node_);
+		mask[node / bits] = 1UL << (node % bits);
+		// Pages aren't touched yet, so they are placed on first access
+		(void)::syscall(SYS_mbind, ptr, size, kPreferred, mask, static_cast<unsigned long>(1024U + 1U), 0U);
+#else
+		(void)ptr;
+		(void)size;
+#endif
+	}
+#endif
+
+} // namespace nostd
@@ -1,43 +1,73 @@
 #include <nostd/pool_allocator.h>
+#include <nostd/algorithm.h>
+#include <nostd/default_allocator.h>
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 
 namespace nostd {
 
 	pool_allocator::pool_allocator(size_type num_chunks) noexcept
-	: num_chunks_(num_chunks)
+	: pool_allocator(num_chunks, alignof(node_type))
+	{
+	}
+	pool_allocator::pool_allocator(size_type num_chunks, size_type alignment) noexcept
+	: pool_allocator(num_chunks, alignment, default_allocator::get_instance())
+	{
+	}
+	pool_allocator::pool_allocator(size_type num_chunks, size_type alignment, allocator * upstream) noexcept
+	: upstream_(upstream)
+	, num_chunks_(num_chunks)
+	, alignment_(alignment < alignof(node_type) ? alignof(node_type) : alignment)
 	, chunk_size_(0)
 #ifdef NOSTD_MEMORY_DEBUG
 	, total_size_(0)
 	, used_(0)
 #endif
+	, free_chunks_(0)
+	, release_at_(static_cast<size_type>(-1))
+	, release_policy_()
 	, free_list_()
 	, buffers_()
 	{
+		assert((alignment_ & (alignment_ - 1)) == 0 && "Alignment should be a power of two");
 	}
 	pool_allocator::pool_allocator(const pool_allocator& other) noexcept
-	: num_chunks_(other.num_chunks_)
+	: upstream_(other.upstream_)
+	, num_chunks_(other.num_chunks_)
+	, alignment_(other.alignment_)
 	, chunk_size_(0)
 #ifdef NOSTD_MEMORY_DEBUG
 	, total_size_(0)
 	, used_(0)
 #endif
+	, free_chunks_(0)
+	, release_at_(static_cast<size_type>(-1))
+	, release_policy_()
 	, free_list_()
 	, buffers_()
 	{
+		set_release_policy(other.release_policy_);
 	}
 	pool_allocator::pool_allocator(pool_allocator&& other) noexcept
-	: num_chunks_(other.num_chunks_)
+	: upstream_(other.upstream_)
+	, num_chunks_(other.num_chunks_)
+	, alignment_(other.alignment_)
 	, chunk_size_(other.chunk_size_)
 #ifdef NOSTD_MEMORY_DEBUG
 	, total_size_(other.total_size_)
 	, used_(other.used_)
 #endif
+	, free_chunks_(other.free_chunks_)
+	, release_at_(other.release_at_)
+	, release_policy_(other.release_policy_)
 	, free_list_(utility::move(other.free_list_))
 	, buffers_(utility::move(other.buffers_))
 	{
 		other.chunk_size_ = 0;
+		other.free_chunks_ = 0;
 #ifdef NOSTD_MEMORY_DEBUG
 		other.total_size_ = 0;
 		other.used_ = 0;
@@ -46,59 +76,257 @@ namespace nostd {
 	pool_allocator::~pool_allocator()
 	{
 		for (auto buffer : buffers_)
-			delete[] buffer;
+			upstream_->free(reinterpret_cast<ptr_type>(buffer), _buffer_size());
 	}
-	allocator::ptr_type pool_allocator::allocate(size_type size) noexcept(false)
+	void pool_allocator::allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false)
 	{
-		assert((buffers_.empty() || sizeof(node_type) + size == chunk_size_) && "Allocated size should be constant");
-		node_type * free_node = free_list_.pop();
-		if (free_node == nullptr)
+		assert((buffers_.empty() || _chunk_size(size) == chunk_size_) && "Allocated size should be constant");
+		size_type i = 0;
+		while (i < count)
 		{
-			if (buffers_.empty())
+			node_type * node = free_list_.pop_chain(count - i);
+			if (node == nullptr)
 			{
-				// First time buffer allocation
-				chunk_size_ = sizeof(node_type) + size;
-			}
+				try
+				{
+					_grow(size);
+				}
+				catch (...)
+				{
 #ifdef NOSTD_MEMORY_DEBUG
-			total_size_ += num_chunks_ * chunk_size_;
+					used_ += i * chunk_size_;
 #endif
-			// The pool allocator is full
-			// Add a new pool
-			byte_type* buffer = _allocate_buffer();
-			// Create a linked-list with all free positions
-			for (size_type i = 0; i < num_chunks_; ++i)
+					free_batch(size, i, out);
+					throw;
+				}
+				continue;
+			}
+			for (; node != nullptr; node = node->next)
 			{
-				byte_type* node_ptr = buffer + i * chunk_size_;
-				free_list_.push(reinterpret_cast<node_type*>(node_ptr));
+				out[i++] = reinterpret_cast<ptr_type>(node);
+				--free_chunks_;
 			}
-			free_node = free_list_.pop();
 		}
 #ifdef NOSTD_MEMORY_DEBUG
-		used_ += chunk_size_;
+		used_ += count * chunk_size_;
 #endif
-		byte_type* address = reinterpret_cast<byte_type*>(free_node) + sizeof(node_type);
-		return reinterpret_cast<ptr_type>(address);
 	}
-	void pool_allocator::free(ptr_type ptr) noexcept
+	void pool_allocator::free_batch(size_type size, size_type count, ptr_type * ptrs) noexcept
 	{
+		(void)size;
+		if (count == 0)
+			return;
 #ifdef NOSTD_MEMORY_DEBUG
-		used_ -= chunk_size_;
+		used_ -= count * chunk_size_;
 #endif
-		byte_type* node_ptr = reinterpret_cast<byte_type*>(ptr) - sizeof(node_type);
-		free_list_.push(reinterpret_cast<node_type*>(node_ptr));
+		node_type * first = reinterpret_cast<node_type*>(ptrs[0]);
+		node_type * last = first;
+		for (size_type i = 1; i < count; ++i)
+		{
+			node_type * node = reinterpret_cast<node_type*>(ptrs[i]);
+			last->next = node;
+			last = node;
+		}
+		free_list_.push_chain(first, last);
+		free_chunks_ += count;
+		if (free_chunks_ >= release_at_)
+			_on_free();
+	}
+	bool pool_allocator::try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+	{
+		(void)ptr;
+		(void)old_size;
+		return new_size <= chunk_size_;
+	}
+	void pool_allocator::_grow(size_type size) noexcept(false)
+	{
+		if (buffers_.empty())
+		{
+			// First time buffer allocation
+			chunk_size_ = _chunk_size(size);
+		}
+		// The pool allocator is full
+		// Add a new pool
+		byte_type* buffer = _allocate_buffer();
+#ifdef NOSTD_MEMORY_DEBUG
+		total_size_ += num_chunks_ * chunk_size_;
+#endif
+		// Create a linked-list with all free positions, lower addresses go first
+		for (size_type i = num_chunks_; i != 0; --i)
+		{
+			byte_type* node_ptr = buffer + (i - 1) * chunk_size_;
+			free_list_.push(reinterpret_cast<node_type*>(node_ptr));
+		}
+		free_chunks_ += num_chunks_;
 	}
 	allocator::byte_type* pool_allocator::_allocate_buffer() noexcept(false)
 	{
-		size_type size_to_allocate = num_chunks_ * chunk_size_;
-		byte_type* buffer = new byte_type[size_to_allocate];
+		byte_type* buffer = reinterpret_cast<byte_type*>(upstream_->allocate(_buffer_size()));
 		if (buffer == nullptr)
 			throw std::bad_alloc();
 		buffers_.push_back(buffer);
-		return buffer;
+		return _buffer_begin(buffer);
+	}
+	allocator::byte_type* pool_allocator::_buffer_begin(byte_type* buffer) const noexcept
+	{
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer);
+		address = (address + (alignment_ - 1)) & ~static_cast<std::uintptr_t>(alignment_ - 1);
+		return reinterpret_cast<byte_type*>(address);
+	}
+	allocator::size_type pool_allocator::_buffer_size() const noexcept
+	{
+		size_type size = num_chunks_ * chunk_size_;
+		// Extra space is needed to align the first chunk
+		if (alignment_ > alignof(std::max_align_t))
+			size += alignment_ - 1;
+		return size;
+	}
+	void pool_allocator::_on_free() noexcept
+	{
+		try
+		{
+			release_empty();
+		}
+		catch (...)
+		{
+			// Buffers are held if there is no memory for bookkeeping
+		}
+		const size_type threshold = release_policy_.free_threshold;
+		if (threshold == 0U)
+			release_at_ = static_cast<size_type>(-1);
+		else if (free_chunks_ < threshold)
+			release_at_ = threshold;
+		else
+			release_at_ = free_chunks_ > static_cast<size_type>(-1) / 2U ? static_cast<size_type>(-1) : free_chunks_ * 2U;
+	}
+	pool_allocator::buffer_t * pool_allocator::_find_buffer(vector<buffer_t>& order, const node_type * node) const noexcept
+	{
+		// The last buffer that begins not after the node
+		const byte_type * ptr = reinterpret_cast<const byte_type*>(node);
+		size_type low = 0;
+		size_type high = order.size();
+		while (high - low > 1U)
+		{
+			size_type middle = low + (high - low) / 2U;
+			if (order[middle].begin <= ptr)
+				low = middle;
+			else
+				high = middle;
+		}
+		return &order[low];
+	}
+	allocator::size_type pool_allocator::_chunk_size(size_type size) const noexcept
+	{
+		// Chunk should be able to hold free list link
+		if (size < sizeof(node_type))
+			size = sizeof(node_type);
+		return (size + (alignment_ - 1)) & ~(alignment_ - 1);
+	}
+	allocator::size_type pool_allocator::release_empty() noexcept(false)
+	{
+		if (buffers_.empty())
+			return 0;
+		// Buffers are sorted by address to find buffer of every free chunk
+		vector<buffer_t> order;
+		order.reserve(buffers_.size());
+		for (size_type i = 0; i < buffers_.size(); ++i)
+			order.push_back(buffer_t{_buffer_begin(buffers_[i]), i, 0U, false});
+		sort(order.begin(), order.end(), [](const buffer_t& a, const buffer_t& b) {
+			return a.begin < b.begin;
+		});
+		node_type * chain = free_list_.pop_all();
+		for (node_type * node = chain; node != nullptr; node = node->next)
+			++_find_buffer(order, node)->num_free;
+		size_type num_kept = 0;
+		size_type num_released = 0;
+		for (buffer_t& buffer : order)
+		{
+			if (buffer.num_free != num_chunks_)
+				continue;
+			if (num_kept < release_policy_.keep_buffers)
+			{
+				++num_kept;
+				continue;
+			}
+			buffer.released = true;
+			++num_released;
+		}
+		// Free list is rebuilt without chunks of released buffers, order of chunks is kept
+		node_type * first = nullptr;
+		node_type * last = nullptr;
+		while (chain != nullptr)
+		{
+			node_type * next = chain->next;
+			if (num_released == 0U || !_find_buffer(order, chain)->released)
+			{
+				if (last == nullptr)
+					first = chain;
+				else
+					last->next = chain;
+				last = chain;
+			}
+			chain = next;
+		}
+		if (last != nullptr)
+			free_list_.push_chain(first, last);
+		if (num_released == 0U)
+			return 0;
+		for (const buffer_t& buffer : order)
+		{
+			if (!buffer.released)
+				continue;
+			upstream_->free(reinterpret_cast<ptr_type>(buffers_[buffer.index]), _buffer_size());
+			buffers_[buffer.index] = nullptr;
+		}
+		size_type count = 0;
+		for (size_type i = 0; i < buffers_.size(); ++i)
+			if (buffers_[i] != nullptr)
+				buffers_[count++] = buffers_[i];
+		buffers_.resize(count);
+		free_chunks_ -= num_released * num_chunks_;
+#ifdef NOSTD_MEMORY_DEBUG
+		total_size_ -= num_released * num_chunks_ * chunk_size_;
+#endif
+		return num_released;
+	}
+	void pool_allocator::set_release_policy(const pool_release_policy& policy) noexcept
+	{
+		release_policy_ = policy;
+		release_at_ = policy.free_threshold != 0U ? policy.free_threshold : static_cast<size_type>(-1);
+	}
+	const pool_release_policy& pool_allocator::release_policy() const noexcept
+	{
+		return release_policy_;
+	}
+	allocator::size_type pool_allocator::num_buffers() const noexcept
+	{
+		return buffers_.size();
+	}
+	allocator::size_type pool_allocator::num_free() const noexcept
+	{
+		return free_chunks_;
 	}
 	allocator::size_type pool_allocator::num_chunks() const noexcept
 	{
 		return num_chunks_;
 	}
+	allocator::size_type pool_allocator::alignment() const noexcept
+	{
+		return alignment_;
+	}
+	allocator::size_type pool_allocator::chunk_size() const noexcept
+	{
+		return chunk_size_;
+	}
+#ifdef NOSTD_MEMORY_DEBUG
+	allocator::size_type pool_allocator::total_size() const noexcept
+	{
+		return total_size_;
+	}
+	allocator::size_type pool_allocator::used_size() const noexcept
+	{
+		return used_;
+	}
+#endif
 
 } // namespace nostd
\ No newline at end of file
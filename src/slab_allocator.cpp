@@ -0,0 +1,255 @@
+#include <nostd/slab_allocator.h>
+#include <nostd/default_allocator.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+namespace nostd {
+
+	namespace {
+
+		unsigned highest_bit(allocator::size_type value) noexcept
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return 31U - static_cast<unsigned>(__builtin_clz(value));
+#elif defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse(&index, value);
+			return static_cast<unsigned>(index);
+#else
+			unsigned index = 0U;
+			while (value >>= 1)
+				++index;
+			return index;
+#endif
+		}
+
+		allocator::size_type class_alignment(allocator::size_type size) noexcept
+		{
+			allocator::size_type alignment = size & (~size + 1U); // lowest set bit
+			if (alignment > alignof(std::max_align_t))
+				alignment = alignof(std::max_align_t);
+			return alignment;
+		}
+
+	} // namespace
+
+	const allocator::size_type slab_allocator::page_size;
+	const allocator::size_type slab_allocator::page_header_size;
+	const allocator::size_type slab_allocator::pages_per_segment;
+	const allocator::size_type slab_allocator::max_size;
+	const allocator::size_type slab_allocator::num_size_classes;
+
+	slab_allocator::page_source::page_source() noexcept
+	: slab_(nullptr)
+	, size_class_(0U)
+	{
+	}
+	void slab_allocator::page_source::init(slab_allocator * slab, size_type size_class) noexcept
+	{
+		slab_ = slab;
+		size_class_ = size_class;
+	}
+	allocator::ptr_type slab_allocator::page_source::allocate(size_type size) noexcept(false)
+	{
+		assert(size <= page_size - page_header_size && "Pool buffer should fit into a page");
+		(void)size;
+		return reinterpret_cast<ptr_type>(slab_->_allocate_page(size_class_) + page_header_size);
+	}
+	void slab_allocator::page_source::free(ptr_type ptr) noexcept
+	{
+		slab_->_free_page(reinterpret_cast<byte_type*>(ptr) - page_header_size);
+	}
+
+	slab_allocator::slab_allocator() noexcept
+	: slab_allocator(default_allocator::get_instance())
+	{
+	}
+	slab_allocator::slab_allocator(allocator * parent) noexcept
+	: parent_(parent)
+	, free_pages_()
+	, segments_(parent)
+	{
+		static_assert(sizeof(page_header_t) <= page_header_size, "Page header doesn't fit");
+		static_assert((page_size & (page_size - 1U)) == 0U, "Page size should be a power of two");
+		for (size_type i = 0U; i < num_size_classes; ++i)
+		{
+			pools_[i] = nullptr;
+			page_sources_[i].init(this, i);
+		}
+	}
+	slab_allocator::~slab_allocator()
+	{
+		// Pools return their pages first
+		for (size_type i = 0U; i < num_size_classes; ++i)
+			delete pools_[i];
+		for (auto& segment : segments_)
+			parent_->free(reinterpret_cast<ptr_type>(segment.raw));
+	}
+	allocator::ptr_type slab_allocator::allocate(size_type size) noexcept(false)
+	{
+		if (size > max_size)
+			return parent_->allocate(size);
+		size_type index = size_class(size);
+		return _pool(index)->allocate(class_size(index));
+	}
+	void slab_allocator::free(ptr_type ptr) noexcept
+	{
+		if (ptr == nullptr)
+			return;
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+		byte_type * page = reinterpret_cast<byte_type*>(address & ~static_cast<std::uintptr_t>(page_size - 1U));
+		if (_owns_page(page))
+		{
+			const page_header_t * header = reinterpret_cast<const page_header_t*>(page);
+			pools_[header->size_class]->free(ptr);
+		}
+		else
+			parent_->free(ptr);
+	}
+	void slab_allocator::free(ptr_type ptr, size_type size) noexcept
+	{
+		if (ptr == nullptr)
+			return;
+		if (size > max_size)
+			parent_->free(ptr, size);
+		else
+			pools_[size_class(size)]->free(ptr);
+	}
+	void slab_allocator::allocate_batch(size_type size, size_type count, ptr_type * out) noexcept(false)
+	{
+		if (size > max_size)
+		{
+			parent_->allocate_batch(size, count, out);
+			return;
+		}
+		size_type index = size_class(size);
+		_pool(index)->allocate_batch(class_size(index), count, out);
+	}
+	void slab_allocator::free_batch(size_type size, size_type count, ptr_type * ptrs) noexcept
+	{
+		if (count == 0U)
+			return;
+		if (size > max_size)
+			parent_->free_batch(size, count, ptrs);
+		else
+		{
+			size_type index = size_class(size);
+			pools_[index]->free_batch(class_size(index), count, ptrs);
+		}
+	}
+	bool slab_allocator::try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+	{
+		if (old_size > max_size && new_size > max_size)
+			return parent_->try_expand(ptr, old_size, new_size);
+		if (old_size > max_size || new_size > max_size)
+			return false;
+		return size_class(old_size) == size_class(new_size);
+	}
+	allocator::ptr_type slab_allocator::reallocate(ptr_type ptr, size_type old_size, size_type new_size) noexcept(false)
+	{
+		if (ptr != nullptr && old_size > max_size && new_size > max_size)
+			return parent_->reallocate(ptr, old_size, new_size);
+		return allocator::reallocate(ptr, old_size, new_size);
+	}
+	allocator::size_type slab_allocator::size_class(size_type size) noexcept
+	{
+		if (size <= 8U)
+			return 0U;
+		if (size <= 16U)
+			return 1U;
+		// Two classes per power of two: 1.5 * 2^b and 2^(b+1)
+		size_type n = size - 1U;
+		unsigned b = highest_bit(n);
+		size_type upper_half = (n >> (b - 1U)) & 1U;
+		return 2U + (b - 4U) * 2U + upper_half;
+	}
+	allocator::size_type slab_allocator::class_size(size_type index) noexcept
+	{
+		if (index < 2U)
+			return 8U << index;
+		unsigned b = 4U + (index - 2U) / 2U;
+		return ((index - 2U) & 1U) ? (1U << (b + 1U)) : (3U << (b - 1U));
+	}
+	pool_allocator * slab_allocator::_pool(size_type index) noexcept(false)
+	{
+		pool_allocator * pool = pools_[index];
+		if (pool == nullptr)
+		{
+			size_type size = class_size(index);
+			size_type num_chunks = (page_size - page_header_size) / size;
+			pool = new pool_allocator(num_chunks, class_alignment(size), &page_sources_[index]);
+			pools_[index] = pool;
+		}
+		return pool;
+	}
+	allocator::byte_type * slab_allocator::_allocate_page(size_type index) noexcept(false)
+	{
+		stack_linked_list::node_t * node = free_pages_.pop();
+		if (node == nullptr)
+		{
+			_allocate_segment();
+			node = free_pages_.pop();
+		}
+		page_header_t * header = reinterpret_cast<page_header_t*>(node);
+		header->size_class = index;
+		return reinterpret_cast<byte_type*>(header);
+	}
+	void slab_allocator::_free_page(byte_type * page) noexcept
+	{
+		free_pages_.push(reinterpret_cast<stack_linked_list::node_t*>(page));
+	}
+	void slab_allocator::_allocate_segment() noexcept(false)
+	{
+		// Extra page is needed to align pages
+		byte_type * raw = reinterpret_cast<byte_type*>(parent_->allocate((pages_per_segment + 1U) * page_size));
+		if (raw == nullptr)
+			throw std::bad_alloc();
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw);
+		address = (address + (page_size - 1U)) & ~static_cast<std::uintptr_t>(page_size - 1U);
+
+		segment_t segment;
+		segment.begin = reinterpret_cast<byte_type*>(address);
+		segment.raw = raw;
+		try
+		{
+			segments_.push_back(segment);
+		}
+		catch (...)
+		{
+			parent_->free(reinterpret_cast<ptr_type>(raw));
+			throw;
+		}
+		// Keep segments sorted by address
+		for (size_type i = segments_.size() - 1U; i != 0U && segments_[i - 1U].begin > segment.begin; --i)
+			utility::swap(segments_[i - 1U], segments_[i]);
+
+		for (size_type i = pages_per_segment; i != 0U; --i)
+			_free_page(segment.begin + (i - 1U) * page_size);
+	}
+	bool slab_allocator::_owns_page(const byte_type * page) const noexcept
+	{
+		// Find the last segment starting not after the page
+		size_type lo = 0U;
+		size_type hi = segments_.size();
+		while (lo < hi)
+		{
+			size_type mid = lo + (hi - lo) / 2U;
+			if (segments_.data()[mid].begin <= page)
+				lo = mid + 1U;
+			else
+				hi = mid;
+		}
+		if (lo == 0U)
+			return false;
+		const segment_t& segment = segments_.data()[lo - 1U];
+		return page < segment.begin + pages_per_segment * page_size;
+	}
+
+} // namespace nostd
\ No newline at end of file
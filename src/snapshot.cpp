@@ -0,0 +1,290 @@
+#include <nostd/snapshot.h>
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#if defined(_WIN32)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace nostd {
+
+	namespace {
+
+		const std::uint64_t kPrime = 0x100000001b3ULL;
+
+		std::uint64_t align_offset(std::uint64_t offset) noexcept
+		{
+			const std::uint64_t alignment = snapshot_detail::section_alignment;
+			return (offset + (alignment - 1U)) & ~(alignment - 1U);
+		}
+
+		std::uint64_t rotate_left(std::uint64_t value, unsigned shift) noexcept
+		{
+			return (value << shift) | (value >> (64U - shift));
+		}
+
+		/**
+		 * Closes file on scope exit.
+		 */
+		struct file_guard {
+			std::FILE * file;
+
+			~file_guard()
+			{
+				if (file != nullptr)
+					std::fclose(file);
+			}
+		};
+
+		void write_bytes(std::FILE * file, const void * data, std::uint64_t size) noexcept(false)
+		{
+			if (size != 0U && std::fwrite(data, 1U, static_cast<std::size_t>(size), file) != size)
+				throw std::runtime_error("failed to write snapshot");
+		}
+
+		void write_padding(std::FILE * file, std::uint64_t offset) noexcept(false)
+		{
+			static const allocator::byte_type zeros[snapshot_detail::section_alignment] = {};
+			write_bytes(file, zeros, align_offset(offset) - offset);
+		}
+
+	} // namespace
+
+	namespace snapshot_detail {
+
+		std::uint64_t checksum(const void * data, std::uint64_t size) noexcept
+		{
+			// Words are folded one at a time, so it's much faster than bytewise hash
+			const allocator::byte_type * bytes = reinterpret_cast<const allocator::byte_type*>(data);
+			std::uint64_t value = 0xcbf29ce484222325ULL ^ size;
+			std::uint64_t i = 0U;
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+			{
+				std::uint64_t word;
+				std::memcpy(&word, bytes + i, sizeof(word));
+				value = rotate_left((value ^ word) * kPrime, 31U);
+			}
+			for (; i < size; ++i)
+				value = (value ^ bytes[i]) * kPrime;
+			return static_cast<std::uint64_t>(hash_mix(value));
+		}
+
+		void write_file(const char * path, header_t& header, const part_t * parts) noexcept(false)
+		{
+			std::uint64_t offset = align_offset(sizeof(header_t));
+			for (std::uint32_t i = 0U; i < header.num_sections; ++i)
+			{
+				header.sections[i].offset = offset;
+				header.sections[i].size = parts[i].size;
+				header.sections[i].checksum = checksum(parts[i].data, parts[i].size);
+				offset = align_offset(offset + parts[i].size);
+			}
+			header.file_size = offset;
+
+			file_guard guard = {std::fopen(path, "wb")};
+			if (guard.file == nullptr)
+				throw std::runtime_error("failed to open snapshot file for writing");
+			write_bytes(guard.file, &header, sizeof(header));
+			write_padding(guard.file, sizeof(header));
+			for (std::uint32_t i = 0U; i < header.num_sections; ++i)
+			{
+				write_bytes(guard.file, parts[i].data, parts[i].size);
+				write_padding(guard.file, parts[i].size);
+			}
+			std::FILE * file = guard.file;
+			guard.file = nullptr;
+			if (std::fclose(file) != 0)
+				throw std::runtime_error("failed to write snapshot");
+		}
+
+	} // namespace snapshot_detail
+
+	snapshot::snapshot(const char * path, bool verify) noexcept(false)
+	: data_(nullptr)
+	, size_(0U)
+	{
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("failed to open snapshot file");
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size))
+		{
+			CloseHandle(file);
+			throw std::runtime_error("failed to get snapshot file size");
+		}
+		size_ = static_cast<std::uint64_t>(file_size.QuadPart);
+		if (size_ >= sizeof(snapshot_detail::header_t))
+		{
+			// View keeps mapping alive, so handles are closed right away
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				data_ = reinterpret_cast<const byte_type*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		int file = ::open(path, O_RDONLY);
+		if (file < 0)
+			throw std::runtime_error("failed to open snapshot file");
+		struct stat info;
+		if (::fstat(file, &info) != 0)
+		{
+			::close(file);
+			throw std::runtime_error("failed to get snapshot file size");
+		}
+		size_ = static_cast<std::uint64_t>(info.st_size);
+		if (size_ >= sizeof(snapshot_detail::header_t))
+		{
+			// Mapping stays valid after the descriptor is closed
+			void * memory = ::mmap(nullptr, static_cast<std::size_t>(size_), PROT_READ, MAP_SHARED, file, 0);
+			if (memory != MAP_FAILED)
+				data_ = reinterpret_cast<const byte_type*>(memory);
+		}
+		::close(file);
+#endif
+		if (size_ < sizeof(snapshot_detail::header_t))
+			throw std::runtime_error("snapshot file is too small");
+		if (data_ == nullptr)
+			throw std::runtime_error("failed to map snapshot file");
+		try
+		{
+			_validate();
+			if (verify && !this->verify())
+				throw std::runtime_error("snapshot checksum mismatch");
+		}
+		catch (...)
+		{
+			_unmap();
+			throw;
+		}
+	}
+	snapshot::~snapshot()
+	{
+		_unmap();
+	}
+	snapshot_kind snapshot::kind() const noexcept
+	{
+		return static_cast<snapshot_kind>(_header()->kind);
+	}
+	snapshot::size_type snapshot::size() const noexcept
+	{
+		return static_cast<size_type>(_header()->count);
+	}
+	bool snapshot::verify() const noexcept
+	{
+		const snapshot_detail::header_t * header = _header();
+		for (std::uint32_t i = 0U; i < header->num_sections; ++i)
+		{
+			const snapshot_detail::section_t& section = header->sections[i];
+			if (snapshot_detail::checksum(data_ + section.offset, section.size) != section.checksum)
+				return false;
+		}
+		return true;
+	}
+	const snapshot_detail::header_t * snapshot::_header() const noexcept
+	{
+		return reinterpret_cast<const snapshot_detail::header_t*>(data_);
+	}
+	snapshot::size_type snapshot::_index_size() const noexcept
+	{
+		return static_cast<size_type>(_header()->sections[2].size / sizeof(std::uint32_t));
+	}
+	void snapshot::_validate() const noexcept(false)
+	{
+		const snapshot_detail::header_t * header = _header();
+		if (header->magic != snapshot_detail::magic)
+			throw std::runtime_error("not a snapshot file");
+		if (header->byte_order != snapshot_detail::byte_order)
+			throw std::runtime_error("snapshot has other byte order");
+		if (header->version != snapshot_detail::version)
+			throw std::runtime_error("unsupported snapshot version");
+		if (header->file_size != size_)
+			throw std::runtime_error("snapshot file is truncated");
+		if (header->count > static_cast<size_type>(-1) - 1U)
+			throw std::runtime_error("snapshot is too large");
+		std::uint32_t num_sections;
+		switch (static_cast<snapshot_kind>(header->kind))
+		{
+		case snapshot_kind::vector:
+			num_sections = 1U;
+			break;
+		case snapshot_kind::flat_map:
+			num_sections = 2U;
+			break;
+		case snapshot_kind::hash_map:
+			num_sections = 3U;
+			break;
+		default:
+			throw std::runtime_error("unknown snapshot kind");
+		}
+		if (header->num_sections != num_sections)
+			throw std::runtime_error("invalid snapshot header");
+		// Count and sizes fit into 32 bits, so products don't overflow
+		const std::uint64_t sizes[] = {header->key_size, header->value_size, sizeof(std::uint32_t)};
+		const std::uint64_t * section_sizes = (num_sections == 1U) ? sizes + 1 : sizes;
+		for (std::uint32_t i = 0U; i < num_sections; ++i)
+		{
+			const snapshot_detail::section_t& section = header->sections[i];
+			if (section.offset % snapshot_detail::section_alignment != 0U ||
+				section.offset < sizeof(snapshot_detail::header_t) ||
+				section.offset > size_ || section.size > size_ - section.offset)
+				throw std::runtime_error("invalid snapshot section");
+			// The last section is index table of hash map, its size is checked separately
+			if (!(num_sections == 3U && i == 2U) && section.size != header->count * section_sizes[i])
+				throw std::runtime_error("invalid snapshot section");
+		}
+		if (num_sections == 3U)
+		{
+			// Index table should have free slots and power of two size, so probing stops
+			const std::uint64_t slots = header->sections[2].size / sizeof(std::uint32_t);
+			if (header->sections[2].size % sizeof(std::uint32_t) != 0U || slots <= header->count ||
+				(slots & (slots - 1U)) != 0U || slots > static_cast<size_type>(-1))
+				throw std::runtime_error("invalid snapshot index");
+			// Every entry should refer to a key, and there should be exactly count of them
+			const std::uint32_t * index = reinterpret_cast<const std::uint32_t*>(data_ + header->sections[2].offset);
+			std::uint64_t used = 0U;
+			for (std::uint64_t i = 0U; i < slots; ++i)
+			{
+				if (index[i] > header->count)
+					throw std::runtime_error("invalid snapshot index");
+				if (index[i] != 0U)
+					++used;
+			}
+			if (used != header->count)
+				throw std::runtime_error("invalid snapshot index");
+		}
+	}
+	void snapshot::_check(snapshot_kind kind, std::uint32_t key_size, std::uint32_t value_size) const noexcept(false)
+	{
+		const snapshot_detail::header_t * header = _header();
+		if (static_cast<snapshot_kind>(header->kind) != kind)
+			throw std::runtime_error("snapshot holds other container kind");
+		if (header->key_size != key_size || header->value_size != value_size)
+			throw std::runtime_error("snapshot element size mismatch");
+	}
+	void snapshot::_unmap() noexcept
+	{
+		if (data_ == nullptr)
+			return;
+#if defined(_WIN32)
+		UnmapViewOfFile(data_);
+#else
+		::munmap(const_cast<byte_type*>(data_), static_cast<std::size_t>(size_));
+#endif
+		data_ = nullptr;
+	}
+
+} // namespace nostd
@@ -0,0 +1,283 @@
+#include <nostd/stats_allocator.h>
+
+#include <chrono>
+#include <cstddef>
+#include <new>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+namespace nostd {
+
+	namespace {
+
+		const allocator::size_type kHeaderSize = alignof(std::max_align_t); //!< keeps block aligned
+
+		const std::size_t kCacheSize = 4U; //!< allocators a thread may alternate between without lookups
+
+		std::atomic<std::uint64_t> g_next_id(0U);
+		std::atomic<std::uint64_t> g_next_token(0U);
+
+		/**
+		 * Block of allocator used by calling thread lately
+		 */
+		struct cache_entry_t {
+			std::uint64_t id; //!< zero for empty entry
+			void * block;
+		};
+
+		thread_local cache_entry_t t_cache[kCacheSize] = {};
+
+		/**
+		 * Returns token of calling thread, tokens are never reused
+		 */
+		std::uint64_t thread_token() noexcept
+		{
+			thread_local std::uint64_t token = g_next_token.fetch_add(1U, std::memory_order_relaxed) + 1U;
+			return token;
+		}
+
+		/**
+		 * Adds value to counter written by single thread at a time
+		 */
+		template<typename T>
+		void add(std::atomic<T>& counter, T value) noexcept
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Returns histogram class of value, that is floor of its binary logarithm
+		 */
+		allocator::size_type class_of(std::uint64_t value, allocator::size_type num_classes) noexcept
+		{
+			if (value == 0U)
+				return 0U;
+#if defined(__GNUC__) || defined(__clang__)
+			allocator::size_type index = 63U - static_cast<allocator::size_type>(__builtin_clzll(value));
+#elif defined(_MSC_VER)
+			unsigned long bit;
+			_BitScanReverse64(&bit, value);
+			allocator::size_type index = static_cast<allocator::size_type>(bit);
+#endif
+			return (index < num_classes) ? index : num_classes - 1U;
+		}
+
+	} // namespace
+
+	stats_allocator::thread_block_t::thread_block_t(std::uint64_t owner) noexcept
+	: allocations(0U)
+	, frees(0U)
+	, failures(0U)
+	, allocated_bytes(0U)
+	, pending_bytes(0)
+	, pending_peak(0)
+	, untimed(0U)
+	, latency_samples(0U)
+	, latency_total(0U)
+	, next(nullptr)
+	, owner(owner)
+	{
+		for (size_type i = 0U; i < allocator_stats::size_classes; ++i)
+			size_histogram[i].store(0U, std::memory_order_relaxed);
+		for (size_type i = 0U; i < allocator_stats::latency_classes; ++i)
+			latency_histogram[i].store(0U, std::memory_order_relaxed);
+	}
+
+	stats_allocator::stats_allocator(allocator * upstream, size_type latency_sample) noexcept
+	: upstream_(upstream)
+	, latency_sample_(latency_sample)
+	, id_(g_next_id.fetch_add(1U, std::memory_order_relaxed) + 1U)
+	, blocks_(nullptr)
+	, live_bytes_(0)
+	, peak_bytes_(0)
+	, fallback_(0U)
+	{
+	}
+	stats_allocator::~stats_allocator()
+	{
+		thread_block_t * block = blocks_.load(std::memory_order_acquire);
+		while (block != nullptr)
+		{
+			thread_block_t * next = block->next;
+			delete block;
+			block = next;
+		}
+	}
+	allocator::ptr_type stats_allocator::allocate(size_type size) noexcept(false)
+	{
+		std::unique_lock<std::mutex> lock;
+		thread_block_t& counters = _block(lock);
+		if (size > static_cast<size_type>(-1) - kHeaderSize)
+		{
+			add<std::uint64_t>(counters.failures, 1U);
+			throw std::bad_alloc();
+		}
+		bool timed = false;
+		if (latency_sample_ != 0U)
+		{
+			timed = counters.untimed == 0U;
+			counters.untimed = timed ? latency_sample_ - 1U : counters.untimed - 1U;
+		}
+		std::chrono::steady_clock::time_point start;
+		if (timed)
+			start = std::chrono::steady_clock::now();
+		byte_type * block;
+		try
+		{
+			block = reinterpret_cast<byte_type*>(upstream_->allocate(size + kHeaderSize));
+		}
+		catch (...)
+		{
+			add<std::uint64_t>(counters.failures, 1U);
+			throw;
+		}
+		if (block == nullptr)
+		{
+			add<std::uint64_t>(counters.failures, 1U);
+			return nullptr;
+		}
+		if (timed)
+		{
+			const std::uint64_t duration = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count());
+			add<std::uint64_t>(counters.latency_samples, 1U);
+			add<std::uint64_t>(counters.latency_total, duration);
+			add<std::uint64_t>(counters.latency_histogram[class_of(duration, allocator_stats::latency_classes)], 1U);
+		}
+		*reinterpret_cast<size_type*>(block) = size;
+		add<std::uint64_t>(counters.allocations, 1U);
+		add<std::uint64_t>(counters.allocated_bytes, size);
+		add<std::uint64_t>(counters.size_histogram[class_of(size, allocator_stats::size_classes)], 1U);
+		_add_live(counters, static_cast<std::int64_t>(size));
+		return reinterpret_cast<ptr_type>(block + kHeaderSize);
+	}
+	void stats_allocator::free(ptr_type ptr) noexcept
+	{
+		_release(ptr);
+	}
+	void stats_allocator::free(ptr_type ptr, size_type size) noexcept
+	{
+		(void)size; // header keeps the size anyway
+		_release(ptr);
+	}
+	bool stats_allocator::try_expand(ptr_type ptr, size_type old_size, size_type new_size) noexcept
+	{
+		if (new_size > static_cast<size_type>(-1) - kHeaderSize)
+			return false;
+		byte_type * block = reinterpret_cast<byte_type*>(ptr) - kHeaderSize;
+		if (!upstream_->try_expand(reinterpret_cast<ptr_type>(block), old_size + kHeaderSize, new_size + kHeaderSize))
+			return false;
+		*reinterpret_cast<size_type*>(block) = new_size;
+		std::unique_lock<std::mutex> lock;
+		thread_block_t& counters = _block(lock);
+		if (new_size > old_size)
+			add<std::uint64_t>(counters.allocated_bytes, new_size - old_size);
+		_add_live(counters, static_cast<std::int64_t>(new_size) - static_cast<std::int64_t>(old_size));
+		return true;
+	}
+	allocator_stats stats_allocator::stats() const noexcept
+	{
+		allocator_stats result = allocator_stats();
+		std::int64_t live = live_bytes_.load(std::memory_order_relaxed);
+		std::int64_t peak_bound = live;
+		_collect(fallback_, result, live, peak_bound);
+		for (const thread_block_t * block = blocks_.load(std::memory_order_acquire); block != nullptr; block = block->next)
+			_collect(*block, result, live, peak_bound);
+		std::int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+		if (peak < peak_bound)
+			peak = peak_bound;
+		if (peak < live)
+			peak = live;
+		result.live_bytes = (live > 0) ? static_cast<std::uint64_t>(live) : 0U;
+		result.peak_bytes = (peak > 0) ? static_cast<std::uint64_t>(peak) : 0U;
+		return result;
+	}
+	allocator * stats_allocator::upstream() const noexcept
+	{
+		return upstream_;
+	}
+	stats_allocator::thread_block_t& stats_allocator::_block(std::unique_lock<std::mutex>& lock) noexcept
+	{
+		const cache_entry_t& entry = t_cache[id_ % kCacheSize];
+		if (entry.id == id_)
+			return *static_cast<thread_block_t*>(entry.block);
+		return _register(lock);
+	}
+	stats_allocator::thread_block_t& stats_allocator::_register(std::unique_lock<std::mutex>& lock) noexcept
+	{
+		cache_entry_t& entry = t_cache[id_ % kCacheSize];
+		const std::uint64_t token = thread_token();
+		// Block may be evicted from cache by other allocator
+		thread_block_t * block = blocks_.load(std::memory_order_acquire);
+		while (block != nullptr && block->owner != token)
+			block = block->next;
+		if (block == nullptr)
+		{
+			block = new (std::nothrow) thread_block_t(token);
+			if (block == nullptr)
+			{
+				// Not cached, so the next call tries again
+				lock = std::unique_lock<std::mutex>(fallback_mutex_);
+				return fallback_;
+			}
+			block->next = blocks_.load(std::memory_order_relaxed);
+			while (!blocks_.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+		entry.id = id_;
+		entry.block = block;
+		return *block;
+	}
+	void stats_allocator::_add_live(thread_block_t& block, std::int64_t delta) noexcept
+	{
+		const std::int64_t pending = block.pending_bytes.load(std::memory_order_relaxed) + delta;
+		block.pending_bytes.store(pending, std::memory_order_relaxed);
+		if (pending > block.pending_peak.load(std::memory_order_relaxed))
+			block.pending_peak.store(pending, std::memory_order_relaxed);
+		if (pending < fold_threshold && pending > -fold_threshold)
+			return;
+		// Fold the delta and its peak into shared counters
+		const std::int64_t pending_peak = block.pending_peak.load(std::memory_order_relaxed);
+		const std::int64_t live = live_bytes_.fetch_add(pending, std::memory_order_relaxed);
+		block.pending_bytes.store(0, std::memory_order_relaxed);
+		block.pending_peak.store(0, std::memory_order_relaxed);
+		const std::int64_t candidate = live + ((pending_peak > pending) ? pending_peak : pending);
+		std::int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+		while (candidate > peak && !peak_bytes_.compare_exchange_weak(peak, candidate, std::memory_order_relaxed))
+		{
+		}
+	}
+	void stats_allocator::_release(ptr_type ptr) noexcept
+	{
+		if (ptr == nullptr)
+			return;
+		byte_type * block = reinterpret_cast<byte_type*>(ptr) - kHeaderSize;
+		const size_type size = *reinterpret_cast<size_type*>(block);
+		{
+			std::unique_lock<std::mutex> lock;
+			thread_block_t& counters = _block(lock);
+			add<std::uint64_t>(counters.frees, 1U);
+			_add_live(counters, -static_cast<std::int64_t>(size));
+		}
+		upstream_->free(reinterpret_cast<ptr_type>(block), size + kHeaderSize);
+	}
+	void stats_allocator::_collect(const thread_block_t& block, allocator_stats& result, std::int64_t& live, std::int64_t& peak_bound) noexcept
+	{
+		result.allocations += block.allocations.load(std::memory_order_relaxed);
+		result.frees += block.frees.load(std::memory_order_relaxed);
+		result.failures += block.failures.load(std::memory_order_relaxed);
+		result.allocated_bytes += block.allocated_bytes.load(std::memory_order_relaxed);
+		live += block.pending_bytes.load(std::memory_order_relaxed);
+		peak_bound += block.pending_peak.load(std::memory_order_relaxed);
+		for (size_type i = 0U; i < allocator_stats::size_classes; ++i)
+			result.size_histogram[i] += block.size_histogram[i].load(std::memory_order_relaxed);
+		result.latency_samples += block.latency_samples.load(std::memory_order_relaxed);
+		result.latency_total += block.latency_total.load(std::memory_order_relaxed);
+		for (size_type i = 0U; i < allocator_stats::latency_classes; ++i)
+			result.latency_histogram[i] += block.latency_histogram[i].load(std::memory_order_relaxed);
+	}
+
+} // namespace nostd
@@ -0,0 +1,245 @@
+#include <nostd/thread_pool.h>
+
+#include <nostd/default_allocator.h>
+
+namespace nostd {
+
+	namespace {
+
+		const unsigned kNumSpins = 64U;
+		const allocator::size_type kTaskChunks = 256U;
+		const allocator::size_type kNoIndex = static_cast<allocator::size_type>(-1);
+
+		/**
+		 * Worker of the current thread, so tasks submitted by worker go to its own deque.
+		 */
+		struct current_worker_t {
+			const thread_pool * pool;
+			allocator::size_type index;
+		};
+		thread_local current_worker_t g_current = {nullptr, 0U};
+
+	} // namespace
+
+	struct thread_pool::worker_t {
+		explicit worker_t(allocator * alloc) noexcept(false)
+		: deque(64U, alloc)
+		{
+		}
+		work_stealing_deque<task_t*> deque;
+		std::thread thread;
+		size_type victim; //!< the next worker to steal from
+	};
+
+	wait_group::wait_group(size_type count) noexcept
+	: count_(count)
+	{
+	}
+	void wait_group::add(size_type count) noexcept
+	{
+		count_.fetch_add(count, std::memory_order_relaxed);
+	}
+	void wait_group::done() noexcept
+	{
+		// Waiter passes the mutex before it returns, so group isn't destroyed while we notify
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (count_.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+			condition_.notify_all();
+	}
+	void wait_group::wait() noexcept
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (count_.load(std::memory_order_acquire) != 0U)
+			condition_.wait(lock);
+	}
+	bool wait_group::finished() const noexcept
+	{
+		return count_.load(std::memory_order_acquire) == 0U;
+	}
+
+	thread_pool::thread_pool(size_type num_threads) noexcept(false)
+	: thread_pool(num_threads, default_allocator::get_instance())
+	{
+	}
+	thread_pool::thread_pool(size_type num_threads, allocator * alloc) noexcept(false)
+	: task_allocator_(kTaskChunks)
+	, injected_(alloc)
+	, injected_size_(0U)
+	, queued_(0U)
+	, sleeping_(0U)
+	, stop_(false)
+	{
+		if (num_threads == 0U)
+			num_threads = static_cast<size_type>(std::thread::hardware_concurrency());
+		if (num_threads == 0U)
+			num_threads = 1U;
+		workers_.reserve(num_threads);
+		for (size_type i = 0U; i < num_threads; ++i)
+		{
+			worker_t * worker = new worker_t(alloc);
+			worker->victim = (i + 1U) % num_threads;
+			workers_.push_back(worker);
+		}
+		// Threads start after all deques exist, since they steal from each other
+		for (size_type i = 0U; i < num_threads; ++i)
+			workers_[i]->thread = std::thread(&thread_pool::_worker_loop, this, i);
+	}
+	thread_pool::~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		condition_.notify_all();
+		for (size_type i = 0U; i < workers_.size(); ++i)
+			workers_[i]->thread.join();
+		for (size_type i = 0U; i < workers_.size(); ++i)
+			delete workers_[i];
+	}
+	thread_pool::size_type thread_pool::size() const noexcept
+	{
+		return workers_.size();
+	}
+	void thread_pool::wait(wait_group& group) noexcept
+	{
+		const size_type index = _current_index();
+		while (!group.finished())
+		{
+			task_t * task = _find_task(index);
+			if (task == nullptr)
+				break; // the rest of tasks is running on other threads
+			_execute(task);
+		}
+		group.wait();
+	}
+	void * thread_pool::_allocate_task(size_type size, bool& pooled) noexcept(false)
+	{
+		pooled = (size <= task_size);
+		if (pooled)
+			return task_allocator_.allocate(task_size);
+		return default_allocator::get_instance()->allocate(size);
+	}
+	void thread_pool::_free_task(void * memory, bool pooled) noexcept
+	{
+		// Task may be freed on other thread than allocated it. Pooled tasks go back to concurrent pool,
+		// that accepts frees from any thread, large ones go to owner's cache of default allocator
+		// via its remote free stack.
+		if (pooled)
+			task_allocator_.free(memory, task_size);
+		else
+			default_allocator::get_instance()->free(memory);
+	}
+	void thread_pool::_push(task_t * task) noexcept(false)
+	{
+		queued_.fetch_add(1U, std::memory_order_seq_cst);
+		const size_type index = _current_index();
+		try
+		{
+			if (index != kNoIndex)
+				workers_[index]->deque.push(task);
+			else
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				injected_.push_back(task);
+				injected_size_.fetch_add(1U, std::memory_order_release);
+			}
+		}
+		catch (...)
+		{
+			queued_.fetch_sub(1U, std::memory_order_relaxed);
+			wait_group * group = task->group;
+			const bool pooled = task->pooled;
+			task->destroy(task);
+			_free_task(task, pooled);
+			if (group != nullptr)
+				group->done();
+			throw;
+		}
+		// Sleeping worker either sees the task counter or gets notified
+		if (sleeping_.load(std::memory_order_seq_cst) != 0U)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			condition_.notify_one();
+		}
+	}
+	void thread_pool::_execute(task_t * task) noexcept
+	{
+		wait_group * group = task->group;
+		const bool pooled = task->pooled;
+		task->invoke(task);
+		_free_task(task, pooled);
+		if (group != nullptr)
+			group->done();
+	}
+	thread_pool::task_t * thread_pool::_find_task(size_type index) noexcept
+	{
+		task_t * task = nullptr;
+		// Own tasks first, the latest one is likely in cache
+		if (index != kNoIndex && workers_[index]->deque.pop(task))
+		{
+			queued_.fetch_sub(1U, std::memory_order_relaxed);
+			return task;
+		}
+		if (injected_size_.load(std::memory_order_acquire) != 0U)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!injected_.empty())
+			{
+				task = injected_.front();
+				injected_.pop_front();
+				injected_size_.fetch_sub(1U, std::memory_order_relaxed);
+				queued_.fetch_sub(1U, std::memory_order_relaxed);
+				return task;
+			}
+		}
+		// Steal the oldest task of other workers
+		const size_type count = workers_.size();
+		size_type victim = (index != kNoIndex) ? workers_[index]->victim : 0U;
+		for (size_type i = 0U; i < count; ++i)
+		{
+			if (victim != index && workers_[victim]->deque.steal(task))
+			{
+				queued_.fetch_sub(1U, std::memory_order_relaxed);
+				if (index != kNoIndex)
+					workers_[index]->victim = victim;
+				return task;
+			}
+			if (++victim == count)
+				victim = 0U;
+		}
+		return nullptr;
+	}
+	thread_pool::size_type thread_pool::_current_index() const noexcept
+	{
+		return (g_current.pool == this) ? g_current.index : kNoIndex;
+	}
+	void thread_pool::_worker_loop(size_type index) noexcept
+	{
+		g_current.pool = this;
+		g_current.index = index;
+		for (;;)
+		{
+			task_t * task = _find_task(index);
+			for (unsigned i = 0U; task == nullptr && i < kNumSpins; ++i)
+			{
+				std::this_thread::yield();
+				task = _find_task(index);
+			}
+			if (task != nullptr)
+			{
+				_execute(task);
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(mutex_);
+			sleeping_.fetch_add(1U, std::memory_order_seq_cst);
+			while (queued_.load(std::memory_order_seq_cst) == 0U && !stop_)
+				condition_.wait(lock);
+			sleeping_.fetch_sub(1U, std::memory_order_relaxed);
+			// Pending tasks are finished before exit
+			if (stop_ && queued_.load(std::memory_order_seq_cst) == 0U)
+				break;
+		}
+		g_current.pool = nullptr;
+	}
+
+} // namespace nostd
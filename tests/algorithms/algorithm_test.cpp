@@ -0,0 +1,105 @@
+#include <nostd/algorithm.h>
+#include <nostd/functional.h>
+#include <nostd/vector.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+class AlgorithmTest : public testing::Test {
+public:
+	typedef nostd::vector<int> Vector;
+
+protected:
+	static bool is_sorted(Vector& values)
+	{
+		for (unsigned int i = 1U; i < values.size(); ++i)
+			if (values[i] < values[i - 1U])
+				return false;
+		return true;
+	}
+	static long long sum(Vector& values)
+	{
+		long long result = 0;
+		for (unsigned int i = 0U; i < values.size(); ++i)
+			result += values[i];
+		return result;
+	}
+};
+
+TEST_F(AlgorithmTest, SortRandom)
+{
+	std::mt19937 engine(17U);
+	for (int count : {0, 1, 2, 3, 16, 17, 100, 10000})
+	{
+		Vector values;
+		for (int i = 0; i < count; ++i)
+			values.push_back(static_cast<int>(engine() % 1000U));
+		const long long expected = sum(values);
+		nostd::sort(values.begin(), values.end());
+		EXPECT_EQ(is_sorted(values), true);
+		EXPECT_EQ(sum(values), expected);
+	}
+}
+
+TEST_F(AlgorithmTest, SortPatterns)
+{
+	const int count = 5000;
+	Vector ascending, descending, equal, organ_pipe;
+	for (int i = 0; i < count; ++i)
+	{
+		ascending.push_back(i);
+		descending.push_back(count - i);
+		equal.push_back(7);
+		organ_pipe.push_back((i < count / 2) ? i : count - i);
+	}
+	Vector * all[] = {&ascending, &descending, &equal, &organ_pipe};
+	for (Vector * values : all)
+	{
+		const long long expected = sum(*values);
+		nostd::sort(values->begin(), values->end());
+		EXPECT_EQ(is_sorted(*values), true);
+		EXPECT_EQ(sum(*values), expected);
+	}
+	EXPECT_EQ(descending[0], 1);
+	EXPECT_EQ(descending[count - 1], count);
+}
+
+TEST_F(AlgorithmTest, SortCompare)
+{
+	nostd::vector<std::string> values;
+	for (int i = 0; i < 300; ++i)
+		values.push_back(std::to_string((i * 37) % 300));
+	// Descending order of length, then ascending of text
+	nostd::sort(values.begin(), values.end(), [](const std::string& lhs, const std::string& rhs) {
+		return (lhs.size() != rhs.size()) ? (lhs.size() > rhs.size()) : (lhs < rhs);
+	});
+	EXPECT_EQ(values[0], "100");
+	EXPECT_EQ(values[199], "299");
+	EXPECT_EQ(values[200], "10");
+	EXPECT_EQ(values[299], "9");
+	// Plain arrays work too
+	int array[] = {5, 3, 9, 1, 7};
+	nostd::sort(array, array + 5, nostd::less<int>());
+	EXPECT_EQ(array[0], 1);
+	EXPECT_EQ(array[4], 9);
+}
+
+TEST_F(AlgorithmTest, ForEachTransformReduce)
+{
+	Vector values;
+	for (int i = 1; i <= 10; ++i)
+		values.push_back(i);
+	int visited = 0;
+	nostd::for_each(values.begin(), values.end(), [&visited](int& value) { ++visited; value *= 2; });
+	EXPECT_EQ(visited, 10);
+	EXPECT_EQ(values[9], 20);
+	Vector squares;
+	squares.resize(values.size());
+	Vector::iterator end = nostd::transform(values.begin(), values.end(), squares.begin(), [](int value) { return value * value; });
+	EXPECT_EQ(end, squares.end());
+	EXPECT_EQ(squares[2], 36);
+	const int total = nostd::reduce(values.begin(), values.end(), 0, [](int lhs, int rhs) { return lhs + rhs; });
+	EXPECT_EQ(total, 110);
+}
@@ -0,0 +1,166 @@
+#include <nostd/parallel_algorithm.h>
+#include <nostd/test_allocator.h>
+#include <nostd/vector.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+	/**
+	 * Allocator that throws on request, used to break task submission.
+	 */
+	class FailingAllocator final : public nostd::allocator {
+	public:
+		FailingAllocator() noexcept
+		: failing(false)
+		{
+		}
+		ptr_type allocate(size_type size) noexcept(false) final
+		{
+			if (failing.load())
+				throw std::bad_alloc();
+			return std::malloc(size);
+		}
+		void free(ptr_type ptr) noexcept final
+		{
+			std::free(ptr);
+		}
+		using nostd::allocator::free;
+
+		std::atomic<bool> failing;
+	};
+
+} // namespace
+
+class ParallelAlgorithmTest : public testing::Test {
+public:
+	typedef nostd::vector<int> Vector;
+	typedef nostd::test_allocator Allocator;
+
+protected:
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		pool = new nostd::thread_pool(4U);
+	}
+	void TearDown() override
+	{
+		delete pool;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	nostd::thread_pool * pool;
+};
+
+TEST_F(ParallelAlgorithmTest, Sort)
+{
+	std::mt19937 engine(29U);
+	for (int count : {0, 1, 1000, 100000})
+	{
+		Vector values, expected;
+		for (int i = 0; i < count; ++i)
+		{
+			const int value = static_cast<int>(engine() % 50000U);
+			values.push_back(value);
+			expected.push_back(value);
+		}
+		nostd::sort(expected.begin(), expected.end());
+		nostd::parallel_sort(*pool, values.begin(), values.end(), nostd::less<int>(), allocator);
+		for (int i = 0; i < count; ++i)
+			ASSERT_EQ(values[i], expected[i]);
+		// Scratch buffer is released
+		EXPECT_EQ(allocator->count(), 0U);
+	}
+}
+
+TEST_F(ParallelAlgorithmTest, SortStrings)
+{
+	const int count = 40000;
+	nostd::vector<std::string> values;
+	for (int i = 0; i < count; ++i)
+		values.push_back(std::string("value number ") + std::to_string((i * 7919) % count));
+	nostd::parallel_sort(*pool, values.begin(), values.end(), [](const std::string& lhs, const std::string& rhs) {
+		return lhs > rhs;
+	}, allocator);
+	for (int i = 1; i < count; ++i)
+		ASSERT_GE(values[i - 1], values[i]);
+	EXPECT_EQ(values[count - 1], "value number 0");
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(ParallelAlgorithmTest, ForEach)
+{
+	const int count = 100000;
+	Vector values;
+	for (int i = 0; i < count; ++i)
+		values.push_back(i);
+	std::atomic<int> visited(0);
+	nostd::parallel_for_each(*pool, values.begin(), values.end(), [&visited](int& value) {
+		value += 1;
+		++visited;
+	}, 100U);
+	EXPECT_EQ(visited.load(), count);
+	for (int i = 0; i < count; ++i)
+		ASSERT_EQ(values[i], i + 1);
+}
+
+TEST_F(ParallelAlgorithmTest, Transform)
+{
+	const int count = 100000;
+	Vector values;
+	for (int i = 0; i < count; ++i)
+		values.push_back(i);
+	nostd::vector<long long> squares;
+	squares.resize(values.size());
+	nostd::vector<long long>::iterator end = nostd::parallel_transform(*pool, values.begin(), values.end(), squares.begin(),
+		[](int value) { return static_cast<long long>(value) * value; });
+	EXPECT_EQ(end, squares.end());
+	for (int i = 0; i < count; ++i)
+		ASSERT_EQ(squares[i], static_cast<long long>(i) * i);
+	// Transformation in place
+	nostd::parallel_transform(*pool, values.begin(), values.end(), values.begin(), [](int value) { return -value; });
+	EXPECT_EQ(values[count - 1], 1 - count);
+}
+
+TEST_F(ParallelAlgorithmTest, Reduce)
+{
+	const int count = 100001;
+	Vector values;
+	for (int i = 0; i < count; ++i)
+		values.push_back(i);
+	const long long total = nostd::parallel_reduce(*pool, values.begin(), values.end(), 0LL,
+		[](long long lhs, long long rhs) { return lhs + rhs; }, allocator, 1000U);
+	EXPECT_EQ(total, static_cast<long long>(count) * (count - 1) / 2);
+	EXPECT_EQ(allocator->count(), 0U);
+	// Chunks are folded in order, so operation may be not commutative
+	nostd::vector<std::string> words;
+	for (int i = 0; i < 5000; ++i)
+		words.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+	const std::string joined = nostd::parallel_reduce(*pool, words.begin(), words.end(), std::string(),
+		[](std::string lhs, const std::string& rhs) { return lhs + rhs; }, allocator, 64U);
+	ASSERT_EQ(joined.size(), 5000U);
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_EQ(joined[i], 'a' + i % 26);
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(ParallelAlgorithmTest, ReduceFailedSubmit)
+{
+	FailingAllocator queue_allocator;
+	nostd::thread_pool failing_pool(2U, &queue_allocator);
+	nostd::vector<std::string> words;
+	for (int i = 0; i < 1000; ++i)
+		words.push_back(std::string(32, 'a'));
+	queue_allocator.failing = true;
+	// Partial results are released when tasks can't be submitted
+	EXPECT_THROW(nostd::parallel_reduce(failing_pool, words.begin(), words.end(), std::string(),
+		[](std::string lhs, const std::string& rhs) { return lhs + rhs; }, allocator, 64U), std::bad_alloc);
+	EXPECT_EQ(allocator->count(), 0U);
+	queue_allocator.failing = false;
+}
@@ -0,0 +1,113 @@
+#include <nostd/concurrent_pool_allocator.h>
+#include <nostd/list.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+class ConcurrentPoolAllocatorTest : public testing::Test {
+public:
+	typedef nostd::concurrent_pool_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using ptr_type = Allocator::ptr_type;
+
+	static const size_type kChunkSize = 32U;
+
+protected:
+	void SetUp() override
+	{
+		allocator = new Allocator(64U, 8U);
+	}
+	void TearDown() override
+	{
+		delete allocator;
+	}
+	Allocator * allocator;
+};
+
+TEST_F(ConcurrentPoolAllocatorTest, Creation)
+{
+	EXPECT_EQ(allocator->num_chunks(), 64U);
+	EXPECT_EQ(allocator->magazine_size(), 8U);
+}
+
+TEST_F(ConcurrentPoolAllocatorTest, Reuse)
+{
+	ptr_type ptr = allocator->allocate(kChunkSize);
+	allocator->free(ptr);
+	EXPECT_EQ(allocator->allocate(kChunkSize), ptr);
+	allocator->free(ptr);
+}
+
+TEST_F(ConcurrentPoolAllocatorTest, Distinct)
+{
+	const size_type count = 200U;
+	ptr_type ptrs[count];
+	for (size_type i = 0; i < count; ++i)
+	{
+		ptrs[i] = allocator->allocate(kChunkSize);
+		std::memset(ptrs[i], static_cast<int>(i), kChunkSize);
+	}
+	for (size_type i = 0; i < count; ++i)
+	{
+		const unsigned char * bytes = reinterpret_cast<const unsigned char*>(ptrs[i]);
+		EXPECT_EQ(bytes[0], static_cast<unsigned char>(i));
+		EXPECT_EQ(bytes[kChunkSize - 1], static_cast<unsigned char>(i));
+	}
+	for (size_type i = 0; i < count; ++i)
+		allocator->free(ptrs[i]);
+}
+
+TEST_F(ConcurrentPoolAllocatorTest, MultipleThreads)
+{
+	const int kNumThreads = 4;
+	const int kNumIterations = 10000;
+	std::atomic<int> failures(0);
+	std::thread threads[kNumThreads];
+	for (int t = 0; t < kNumThreads; ++t)
+	{
+		threads[t] = std::thread([this, t, &failures]() {
+			ptr_type ptrs[16];
+			for (int i = 0; i < kNumIterations; ++i)
+			{
+				for (int j = 0; j < 16; ++j)
+				{
+					ptrs[j] = allocator->allocate(kChunkSize);
+					*reinterpret_cast<int*>(ptrs[j]) = t * 16 + j;
+				}
+				for (int j = 0; j < 16; ++j)
+				{
+					if (*reinterpret_cast<int*>(ptrs[j]) != t * 16 + j)
+						++failures;
+					allocator->free(ptrs[j]);
+				}
+			}
+		});
+	}
+	for (int t = 0; t < kNumThreads; ++t)
+		threads[t].join();
+	EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(ConcurrentPoolAllocatorTest, CrossThreadFree)
+{
+	const size_type count = 1000U;
+	nostd::list<int> * list = new nostd::list<int>(allocator);
+	std::thread producer([list]() {
+		for (size_type i = 0; i < count; ++i)
+			list->push_back(static_cast<int>(i));
+	});
+	producer.join();
+	EXPECT_EQ(list->size(), count);
+	std::thread consumer([list]() {
+		delete list;
+	});
+	consumer.join();
+	// Blocks returned by exited threads are available again
+	ptr_type ptr = allocator->allocate(sizeof(int));
+	EXPECT_NE(ptr, nullptr);
+	allocator->free(ptr);
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <nostd/default_allocator.h>
+#include <nostd/map.h>
+#include <nostd/vector.h>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+
+class DefaultAllocatorTest : public testing::Test {
+public:
+	typedef nostd::default_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using byte_type = Allocator::byte_type;
+protected:
+	Allocator * allocator = Allocator::get_instance();
+};
+
+TEST_F(DefaultAllocatorTest, SizeClasses)
+{
+	size_type previous = 0U;
+	for (size_type index = 0U; index < Allocator::num_size_classes; ++index)
+	{
+		size_type size = Allocator::class_size(index);
+		EXPECT_GT(size, previous);
+		EXPECT_EQ(size % alignof(std::max_align_t), 0U);
+		EXPECT_EQ(Allocator::size_class(size), index);
+		EXPECT_EQ(Allocator::size_class(previous + 1U), index);
+		previous = size;
+	}
+	EXPECT_EQ(previous, Allocator::max_size);
+}
+
+TEST_F(DefaultAllocatorTest, Alignment)
+{
+	for (size_type size = 0U; size <= 5000U; size += 7U)
+	{
+		void * ptr = allocator->allocate(size);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t), 0U);
+		std::memset(ptr, 0x7f, size);
+		EXPECT_EQ(Allocator::cached(ptr), size <= Allocator::max_size);
+		allocator->free(ptr);
+	}
+}
+
+TEST_F(DefaultAllocatorTest, Reuse)
+{
+	// Block freed by the same thread is handed out first
+	void * ptr = allocator->allocate(40U);
+	allocator->free(ptr);
+	EXPECT_EQ(allocator->allocate(48U), ptr);
+	allocator->free(ptr, 48U);
+}
+
+TEST_F(DefaultAllocatorTest, Reallocate)
+{
+	byte_type * ptr = reinterpret_cast<byte_type*>(allocator->reallocate(nullptr, 0U, 20U));
+	for (int i = 0; i < 20; ++i)
+		ptr[i] = static_cast<byte_type>(i);
+	// Size class of 20 bytes is 32 bytes
+	EXPECT_EQ(allocator->try_expand(ptr, 20U, 32U), true);
+	EXPECT_EQ(allocator->try_expand(ptr, 20U, 33U), false);
+	ptr = reinterpret_cast<byte_type*>(allocator->reallocate(ptr, 20U, 1000U));
+	ptr = reinterpret_cast<byte_type*>(allocator->reallocate(ptr, 1000U, 10000U));
+	EXPECT_EQ(Allocator::cached(ptr), false);
+	for (int i = 0; i < 20; ++i)
+		EXPECT_EQ(ptr[i], static_cast<byte_type>(i));
+	allocator->free(ptr);
+}
+
+TEST_F(DefaultAllocatorTest, Batch)
+{
+	void * ptrs[100];
+	allocator->allocate_batch(3000U, 100U, ptrs);
+	std::set<void*> unique(ptrs, ptrs + 100);
+	EXPECT_EQ(unique.size(), 100U);
+	for (void * ptr : ptrs)
+		std::memset(ptr, 1, 3000U);
+	allocator->free_batch(3000U, 100U, ptrs);
+}
+
+TEST_F(DefaultAllocatorTest, RemoteFree)
+{
+	// Blocks freed by other thread return to the owner
+	const int count = 1000;
+	std::set<void*> original;
+	std::size_t reused = 0U;
+	std::thread owner([&]() {
+		nostd::vector<void*> ptrs;
+		ptrs.reserve(count);
+		for (int i = 0; i < count; ++i)
+		{
+			ptrs.push_back(allocator->allocate(3500U));
+			original.insert(ptrs.back());
+		}
+		std::thread other([&]() {
+			for (void * ptr : ptrs)
+				allocator->free(ptr);
+		});
+		other.join();
+		for (int i = 0; i < count; ++i)
+			ptrs[i] = allocator->allocate(3500U);
+		for (void * ptr : ptrs)
+		{
+			reused += original.count(ptr);
+			allocator->free(ptr);
+		}
+	});
+	owner.join();
+	// Only blocks left in the owner's cache are handed out before remote ones
+	EXPECT_GE(reused, static_cast<std::size_t>(count) - 20U);
+}
+
+TEST_F(DefaultAllocatorTest, ThreadExit)
+{
+	// Container outlives the thread that filled it
+	nostd::map<int, int> * map = nullptr;
+	std::thread producer([&]() {
+		map = new nostd::map<int, int>();
+		for (int i = 0; i < 1000; ++i)
+			(*map)[i] = i;
+	});
+	producer.join();
+	EXPECT_EQ(map->size(), 1000U);
+	for (int i = 0; i < 1000; i += 2)
+		map->erase(map->find(i));
+	(*map)[5000] = 1;
+	delete map;
+	// Cache of exited thread is adopted
+	for (int round = 0; round < 4; ++round)
+	{
+		std::thread worker([&]() {
+			nostd::vector<int> array;
+			for (int i = 0; i < 100; ++i)
+				array.push_back(i);
+			EXPECT_EQ(array[99], 99);
+		});
+		worker.join();
+	}
+}
+
+TEST_F(DefaultAllocatorTest, Concurrent)
+{
+	// Blocks are exchanged between threads in ring
+	const int num_threads = 4;
+	const int count = 2000;
+	nostd::vector<void*> slots[num_threads];
+	for (int t = 0; t < num_threads; ++t)
+		slots[t].resize(count);
+	std::thread threads[num_threads];
+	for (int t = 0; t < num_threads; ++t)
+	{
+		threads[t] = std::thread([&slots, t, this]() {
+			for (int i = 0; i < count; ++i)
+			{
+				slots[t][i] = allocator->allocate(static_cast<size_type>(16 + (i % 64) * 8));
+				std::memset(slots[t][i], t, 16U);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+	for (int t = 0; t < num_threads; ++t)
+	{
+		threads[t] = std::thread([&slots, t, this]() {
+			nostd::vector<void*>& foreign = slots[(t + 1) % num_threads];
+			for (int i = 0; i < count; ++i)
+			{
+				EXPECT_EQ(*reinterpret_cast<byte_type*>(foreign[i]), static_cast<byte_type>((t + 1) % num_threads));
+				allocator->free(foreign[i]);
+			}
+			for (int i = 0; i < count; ++i)
+				allocator->free(allocator->allocate(64U));
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+}
@@ -0,0 +1,143 @@
+#include <nostd/monotonic_arena.h>
+#include <nostd/test_allocator.h>
+#include <nostd/list.h>
+#include <nostd/map.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+class MonotonicArenaTest : public testing::Test {
+public:
+	typedef nostd::monotonic_arena Arena;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using byte_type = Allocator::byte_type;
+
+protected:
+	void SetUp() override
+	{
+		upstream = new Allocator();
+		arena = new Arena(256U, upstream);
+	}
+	void TearDown() override
+	{
+		delete arena;
+		delete upstream;
+	}
+	Allocator * upstream;
+	Arena * arena;
+};
+
+TEST_F(MonotonicArenaTest, Creation)
+{
+	EXPECT_EQ(arena->num_chunks(), 0U);
+	EXPECT_EQ(upstream->count(), 0U);
+}
+
+TEST_F(MonotonicArenaTest, Allocate)
+{
+	byte_type * prev = nullptr;
+	for (size_type i = 0; i < 100; ++i)
+	{
+		byte_type * ptr = reinterpret_cast<byte_type*>(arena->allocate(24U));
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % Arena::alignment, 0U);
+		if (prev != nullptr && arena->num_chunks() == 1U)
+		{
+			EXPECT_GE(ptr, prev + 24U);
+		}
+		prev = ptr;
+	}
+	EXPECT_GT(arena->num_chunks(), 1U);
+	EXPECT_EQ(upstream->count(), arena->num_chunks());
+}
+
+TEST_F(MonotonicArenaTest, LargeAllocation)
+{
+	void * ptr = arena->allocate(4096U);
+	EXPECT_NE(ptr, nullptr);
+	EXPECT_EQ(arena->num_chunks(), 1U);
+}
+
+TEST_F(MonotonicArenaTest, Reset)
+{
+	void * first = arena->allocate(16U);
+	for (size_type i = 0; i < 100; ++i)
+		(void)arena->allocate(16U);
+	size_type chunks = arena->num_chunks();
+
+	arena->reset();
+	EXPECT_EQ(arena->num_chunks(), chunks);
+	EXPECT_EQ(arena->allocate(16U), first);
+	for (size_type i = 0; i < 100; ++i)
+		(void)arena->allocate(16U);
+	EXPECT_EQ(arena->num_chunks(), chunks);
+	EXPECT_EQ(upstream->count(), chunks);
+}
+
+TEST_F(MonotonicArenaTest, Release)
+{
+	for (size_type i = 0; i < 100; ++i)
+		(void)arena->allocate(16U);
+	arena->release();
+	EXPECT_EQ(arena->num_chunks(), 0U);
+	EXPECT_EQ(upstream->count(), 0U);
+}
+
+TEST_F(MonotonicArenaTest, InitialBuffer)
+{
+	alignas(16) byte_type buffer[512];
+	Arena buffered(buffer, sizeof(buffer), upstream);
+
+	byte_type * ptr = reinterpret_cast<byte_type*>(buffered.allocate(64U));
+	EXPECT_GE(ptr, buffer);
+	EXPECT_LT(ptr, buffer + sizeof(buffer));
+	EXPECT_EQ(upstream->count(), 0U);
+
+	// Overflow initial buffer
+	(void)buffered.allocate(1024U);
+	EXPECT_EQ(upstream->count(), 1U);
+
+	// Initial buffer is used again after reset
+	buffered.reset();
+	EXPECT_EQ(buffered.allocate(64U), ptr);
+}
+
+TEST_F(MonotonicArenaTest, Containers)
+{
+	{
+		nostd::list<int> list(arena);
+		nostd::map<int, int> map(arena);
+		for (int i = 0; i < 100; ++i)
+		{
+			list.push_back(i);
+			map[i] = i * i;
+		}
+		EXPECT_EQ(list.size(), 100U);
+		EXPECT_EQ(map.size(), 100U);
+		EXPECT_EQ(map[7], 49);
+	}
+	arena->release();
+	EXPECT_EQ(upstream->count(), 0U);
+}
+
+TEST_F(MonotonicArenaTest, SizedFree)
+{
+	void * first = arena->allocate(16U);
+	void * second = arena->allocate(16U);
+	// Only the last block is reused
+	arena->free(first, 16U);
+	arena->free(second, 16U);
+	EXPECT_EQ(arena->allocate(16U), second);
+}
+
+TEST_F(MonotonicArenaTest, TryExpand)
+{
+	void * first = arena->allocate(16U);
+	void * second = arena->allocate(16U);
+	EXPECT_EQ(arena->try_expand(first, 16U, 32U), false);
+	EXPECT_EQ(arena->try_expand(second, 16U, 64U), true);
+	EXPECT_EQ(arena->try_expand(second, 64U, 100000U), false);
+	EXPECT_EQ(arena->reallocate(second, 64U, 128U), second);
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include <nostd/page_allocator.h>
+#include <nostd/pool_allocator.h>
+#include <nostd/slab_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+class PageAllocatorTest : public testing::Test {
+public:
+	typedef nostd::page_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using byte_type = Allocator::byte_type;
+};
+
+TEST_F(PageAllocatorTest, Pages)
+{
+	Allocator allocator;
+	const size_type page = Allocator::system_page_size();
+	EXPECT_EQ(allocator.page_size(), page);
+	byte_type * first = reinterpret_cast<byte_type*>(allocator.allocate(1U));
+	byte_type * second = reinterpret_cast<byte_type*>(allocator.allocate(page + 1U));
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % page, 0U);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % page, 0U);
+	EXPECT_EQ(allocator.mapped_size(), 3U * page);
+	std::memset(second, 0x5a, 2U * page);
+	allocator.free(first);
+	EXPECT_EQ(allocator.mapped_size(), 2U * page);
+	allocator.free(second, page + 1U);
+	EXPECT_EQ(allocator.mapped_size(), 0U);
+}
+
+TEST_F(PageAllocatorTest, HugePages)
+{
+	// Without reserved huge pages memory is still aligned for transparent ones
+	Allocator allocator(nostd::page_kind::huge_2mb);
+	const size_type huge = 1U << 21;
+	EXPECT_EQ(allocator.page_size(), huge);
+	byte_type * ptr = reinterpret_cast<byte_type*>(allocator.allocate(huge + 1U));
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % huge, 0U);
+	EXPECT_EQ(allocator.mapped_size(), 2U * huge);
+	EXPECT_LE(allocator.huge_size(), allocator.mapped_size());
+	ptr[0] = 1U;
+	ptr[2U * huge - 1U] = 2U;
+	allocator.free(ptr);
+	EXPECT_EQ(allocator.mapped_size(), 0U);
+	EXPECT_EQ(allocator.huge_size(), 0U);
+}
+
+TEST_F(PageAllocatorTest, NumaNode)
+{
+	// Node 0 exists on every system
+	Allocator allocator(nostd::page_kind::normal, 0);
+	EXPECT_EQ(allocator.numa_node(), 0);
+	byte_type * ptr = reinterpret_cast<byte_type*>(allocator.allocate(1U << 16));
+	std::memset(ptr, 0, 1U << 16);
+	allocator.free(ptr);
+}
+
+TEST_F(PageAllocatorTest, Upstream)
+{
+	// Pages left allocated are unmapped by destructor
+	Allocator allocator(nostd::page_kind::huge_2mb);
+	{
+		// Buffer fills huge page exactly
+		nostd::pool_allocator pool((1U << 21) / 64U, 16U, &allocator);
+		for (int i = 0; i < 100000; ++i)
+			(void)pool.allocate(64U);
+		EXPECT_EQ(pool.num_buffers(), 4U);
+		EXPECT_EQ(allocator.mapped_size(), 4U << 21);
+	}
+	EXPECT_EQ(allocator.mapped_size(), 0U);
+	{
+		nostd::slab_allocator slab(&allocator);
+		void * ptr = slab.allocate(100U);
+		std::memset(ptr, 1, 100U);
+		slab.free(ptr);
+	}
+	(void)allocator.allocate(1U);
+}
@@ -0,0 +1,177 @@
+#include <nostd/pool_allocator.h>
+#include <nostd/page_allocator.h>
+#include <nostd/list.h>
+#include <nostd/map.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+class PoolAllocatorTest : public testing::Test {
+public:
+	typedef nostd::pool_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using byte_type = Allocator::byte_type;
+};
+
+TEST_F(PoolAllocatorTest, NoChunkOverhead)
+{
+	Allocator allocator(8U);
+	byte_type * first = reinterpret_cast<byte_type*>(allocator.allocate(16U));
+	byte_type * second = reinterpret_cast<byte_type*>(allocator.allocate(16U));
+	EXPECT_EQ(allocator.chunk_size(), 16U);
+	EXPECT_EQ(second - first, 16);
+	allocator.free(second);
+	allocator.free(first);
+}
+
+TEST_F(PoolAllocatorTest, SmallChunk)
+{
+	Allocator allocator(8U);
+	(void)allocator.allocate(1U);
+	EXPECT_EQ(allocator.chunk_size(), sizeof(void*));
+}
+
+TEST_F(PoolAllocatorTest, Reuse)
+{
+	Allocator allocator(8U);
+	void * ptr = allocator.allocate(16U);
+	allocator.free(ptr);
+	EXPECT_EQ(allocator.allocate(16U), ptr);
+}
+
+TEST_F(PoolAllocatorTest, Alignment)
+{
+	const size_type alignments[] = {16U, 32U, 64U, 128U};
+	for (size_type alignment : alignments)
+	{
+		Allocator allocator(4U, alignment);
+		EXPECT_EQ(allocator.alignment(), alignment);
+		for (size_type i = 0; i < 10U; ++i)
+		{
+			void * ptr = allocator.allocate(24U);
+			EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0U);
+		}
+		EXPECT_EQ(allocator.chunk_size(), alignment < 24U ? 32U : alignment);
+	}
+}
+
+TEST_F(PoolAllocatorTest, Map)
+{
+	Allocator allocator(16U);
+	{
+		nostd::map<int, int> map(&allocator);
+		for (int i = 0; i < 100; ++i)
+			map[i] = i;
+		for (int i = 0; i < 100; i += 2)
+			map.erase(map.find(i));
+		EXPECT_EQ(map.size(), 50U);
+		EXPECT_EQ(map[51], 51);
+	}
+}
+TEST_F(PoolAllocatorTest, Batch)
+{
+	// Batch spans several buffers
+	Allocator allocator(8U);
+	void * ptrs[20];
+	allocator.allocate_batch(16U, 20U, ptrs);
+	EXPECT_EQ(allocator.chunk_size(), 16U);
+	for (int i = 0; i < 20; ++i)
+	{
+		std::memset(ptrs[i], i, 16U);
+		for (int j = 0; j < i; ++j)
+			EXPECT_NE(ptrs[i], ptrs[j]);
+	}
+	for (int i = 0; i < 20; ++i)
+		EXPECT_EQ(*reinterpret_cast<byte_type*>(ptrs[i]), static_cast<byte_type>(i));
+	// Released chunks are handed out again in the same order
+	allocator.free_batch(16U, 20U, ptrs);
+	void * again[20];
+	allocator.allocate_batch(16U, 20U, again);
+	for (int i = 0; i < 20; ++i)
+		EXPECT_EQ(again[i], ptrs[i]);
+	allocator.free_batch(16U, 20U, again);
+	EXPECT_EQ(allocator.allocate(16U), ptrs[0]);
+}
+
+TEST_F(PoolAllocatorTest, BatchContainers)
+{
+	// Copy and clear take nodes in batches
+	Allocator allocator(16U);
+	nostd::map<int, int> map(&allocator);
+	for (int i = 0; i < 100; ++i)
+		map[i] = i * 2;
+	nostd::map<int, int> copy(map);
+	EXPECT_EQ(copy.size(), 100U);
+	int expected = 0;
+	for (nostd::map<int, int>::iterator it = copy.begin(); it != copy.end(); ++it, ++expected)
+		EXPECT_EQ((*it).second, expected * 2);
+	EXPECT_EQ(expected, 100);
+	map.clear();
+	copy.clear();
+	// List nodes have other size, so they need own pool
+	Allocator list_allocator(16U);
+	nostd::list<int> list(&list_allocator);
+	for (int i = 0; i < 50; ++i)
+		list.push_back(i);
+	nostd::list<int> list_copy(list);
+	EXPECT_EQ(list_copy.size(), 50U);
+	EXPECT_EQ(list_copy.front(), 0);
+	EXPECT_EQ(list_copy.back(), 49);
+}
+
+TEST_F(PoolAllocatorTest, ReleaseEmpty)
+{
+	nostd::page_allocator pages;
+	Allocator allocator(256U, 16U, &pages);
+	void * ptrs[1024];
+	for (int i = 0; i < 1024; ++i)
+		ptrs[i] = allocator.allocate(16U);
+	EXPECT_EQ(allocator.num_buffers(), 4U);
+	EXPECT_EQ(allocator.num_free(), 0U);
+	EXPECT_EQ(pages.mapped_size(), 4U * 4096U);
+	// Nothing is released while every buffer has allocated chunks
+	for (int i = 0; i < 1024; i += 2)
+		allocator.free(ptrs[i]);
+	EXPECT_EQ(allocator.release_empty(), 0U);
+	EXPECT_EQ(allocator.num_free(), 512U);
+	// Buffers of the second half become empty
+	for (int i = 513; i < 1024; i += 2)
+		allocator.free(ptrs[i]);
+	EXPECT_EQ(allocator.release_empty(), 2U);
+	EXPECT_EQ(allocator.num_buffers(), 2U);
+	EXPECT_EQ(allocator.num_free(), 256U);
+	EXPECT_EQ(pages.mapped_size(), 2U * 4096U);
+	// Remaining free chunks are still handed out
+	for (int i = 0; i < 256; ++i)
+	{
+		byte_type * ptr = reinterpret_cast<byte_type*>(allocator.allocate(16U));
+		std::memset(ptr, 0xab, 16U);
+	}
+	EXPECT_EQ(allocator.num_buffers(), 2U);
+	EXPECT_EQ(allocator.num_free(), 0U);
+}
+
+TEST_F(PoolAllocatorTest, ReleasePolicy)
+{
+	nostd::page_allocator pages;
+	Allocator allocator(256U, 16U, &pages);
+	nostd::pool_release_policy policy = {1U, 512U};
+	allocator.set_release_policy(policy);
+	EXPECT_EQ(allocator.release_policy().keep_buffers, 1U);
+	void * ptrs[1024];
+	allocator.allocate_batch(16U, 1024U, ptrs);
+	EXPECT_EQ(allocator.num_buffers(), 4U);
+	// Release starts when half of chunks are free, one empty buffer is kept
+	allocator.free_batch(16U, 256U, ptrs);
+	allocator.free_batch(16U, 255U, ptrs + 256);
+	EXPECT_EQ(allocator.num_buffers(), 4U);
+	allocator.free(ptrs[511]);
+	EXPECT_EQ(allocator.num_buffers(), 3U);
+	EXPECT_EQ(allocator.num_free(), 256U);
+	allocator.free_batch(16U, 512U, ptrs + 512);
+	EXPECT_EQ(allocator.num_buffers(), 1U);
+	EXPECT_EQ(pages.mapped_size(), 4096U);
+}
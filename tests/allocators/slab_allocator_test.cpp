@@ -0,0 +1,125 @@
+#include <nostd/slab_allocator.h>
+#include <nostd/test_allocator.h>
+#include <nostd/list.h>
+#include <nostd/map.h>
+#include <nostd/vector.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+class SlabAllocatorTest : public testing::Test {
+public:
+	typedef nostd::slab_allocator Allocator;
+	typedef nostd::test_allocator Parent;
+
+	using size_type = Allocator::size_type;
+	using byte_type = Allocator::byte_type;
+
+protected:
+	void SetUp() override
+	{
+		parent = new Parent();
+		allocator = new Allocator(parent);
+	}
+	void TearDown() override
+	{
+		delete allocator;
+		EXPECT_EQ(parent->count(), 0U);
+		delete parent;
+	}
+	Parent * parent;
+	Allocator * allocator;
+};
+
+TEST_F(SlabAllocatorTest, SizeClasses)
+{
+	size_type prev = 0U;
+	for (size_type i = 0; i < Allocator::num_size_classes; ++i)
+	{
+		size_type size = Allocator::class_size(i);
+		EXPECT_GT(size, prev);
+		EXPECT_EQ(Allocator::size_class(size), i);
+		EXPECT_EQ(Allocator::size_class(prev + 1U), i);
+		prev = size;
+	}
+	EXPECT_EQ(prev, Allocator::max_size);
+	EXPECT_EQ(Allocator::class_size(Allocator::size_class(100U)), 128U);
+}
+
+TEST_F(SlabAllocatorTest, MixedSizes)
+{
+	const size_type count = 300U;
+	void * ptrs[count];
+	for (size_type i = 0; i < count; ++i)
+	{
+		size_type size = 1U + (i * 37U) % Allocator::max_size;
+		ptrs[i] = allocator->allocate(size);
+		std::memset(ptrs[i], static_cast<int>(i), size);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptrs[i]) % 8U, 0U);
+	}
+	for (size_type i = 0; i < count; ++i)
+	{
+		EXPECT_EQ(*reinterpret_cast<byte_type*>(ptrs[i]), static_cast<byte_type>(i));
+		allocator->free(ptrs[i]);
+	}
+}
+
+TEST_F(SlabAllocatorTest, Reuse)
+{
+	void * ptr = allocator->allocate(40U);
+	allocator->free(ptr);
+	EXPECT_EQ(allocator->allocate(48U), ptr);
+	allocator->free(ptr);
+}
+
+TEST_F(SlabAllocatorTest, LargeBlocks)
+{
+	size_type initial = parent->count();
+	void * ptr = allocator->allocate(Allocator::max_size + 1U);
+	EXPECT_EQ(parent->count(), initial + 1U);
+	allocator->free(ptr);
+	EXPECT_EQ(parent->count(), initial);
+}
+
+TEST_F(SlabAllocatorTest, Containers)
+{
+	nostd::vector<int> vector(allocator);
+	nostd::list<int> list(allocator);
+	nostd::map<int, int> map(allocator);
+	for (int i = 0; i < 1000; ++i)
+	{
+		vector.push_back(i);
+		list.push_back(i);
+		map[i] = i;
+	}
+	EXPECT_EQ(vector.size(), 1000U);
+	EXPECT_EQ(vector[999], 999);
+	EXPECT_EQ(list.back(), 999);
+	EXPECT_EQ(map[500], 500);
+}
+TEST_F(SlabAllocatorTest, Batch)
+{
+	void * small[100];
+	allocator->allocate_batch(40U, 100U, small);
+	for (int i = 0; i < 100; ++i)
+	{
+		std::memset(small[i], i, 40U);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small[i]) % 8U, 0U);
+	}
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(*reinterpret_cast<byte_type*>(small[i]), static_cast<byte_type>(i));
+	allocator->free_batch(40U, 100U, small);
+	// Blocks of the same size class are reused
+	void * ptr = allocator->allocate(48U);
+	EXPECT_EQ(ptr, small[0]);
+	allocator->free(ptr);
+	// Large blocks go to the parent
+	size_type initial = parent->count();
+	void * large[3];
+	allocator->allocate_batch(Allocator::max_size + 1U, 3U, large);
+	EXPECT_EQ(parent->count(), initial + 3U);
+	allocator->free_batch(Allocator::max_size + 1U, 3U, large);
+	EXPECT_EQ(parent->count(), initial);
+}
@@ -0,0 +1,210 @@
+#include <nostd/stats_allocator.h>
+#include <nostd/default_allocator.h>
+#include <nostd/test_allocator.h>
+#include <nostd/map.h>
+#include <nostd/vector.h>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+
+class StatsAllocatorTest : public testing::Test {
+public:
+	typedef nostd::stats_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+
+protected:
+	void SetUp() override
+	{
+		upstream = new nostd::test_allocator();
+	}
+	void TearDown() override
+	{
+		EXPECT_EQ(upstream->count(), 0U);
+		delete upstream;
+	}
+	nostd::test_allocator * upstream;
+};
+
+TEST_F(StatsAllocatorTest, Creation)
+{
+	Allocator allocator(upstream);
+	EXPECT_EQ(allocator.upstream(), upstream);
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.live_bytes, 0U);
+	EXPECT_EQ(stats.peak_bytes, 0U);
+	EXPECT_EQ(stats.allocations, 0U);
+	EXPECT_EQ(stats.live_blocks(), 0U);
+	EXPECT_EQ(upstream->count(), 0U);
+}
+
+TEST_F(StatsAllocatorTest, Counts)
+{
+	Allocator allocator(upstream);
+	void * first = allocator.allocate(100U);
+	void * second = allocator.allocate(28U);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % alignof(std::max_align_t), 0U);
+	EXPECT_EQ(upstream->count(), 2U);
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.allocations, 2U);
+	EXPECT_EQ(stats.live_blocks(), 2U);
+	EXPECT_EQ(stats.live_bytes, 128U);
+	EXPECT_EQ(stats.allocated_bytes, 128U);
+	// Free without size knows the size too
+	allocator.free(first);
+	allocator.free(second, 28U);
+	stats = allocator.stats();
+	EXPECT_EQ(stats.frees, 2U);
+	EXPECT_EQ(stats.live_blocks(), 0U);
+	EXPECT_EQ(stats.live_bytes, 0U);
+	EXPECT_EQ(stats.peak_bytes, 128U);
+	EXPECT_EQ(stats.allocated_bytes, 128U);
+}
+
+TEST_F(StatsAllocatorTest, Peak)
+{
+	Allocator allocator(upstream);
+	// Large enough to be folded into shared counter several times
+	const size_type size = 50000U;
+	void * blocks[8];
+	for (int i = 0; i < 8; ++i)
+		blocks[i] = allocator.allocate(size);
+	for (int i = 0; i < 6; ++i)
+		allocator.free(blocks[i]);
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.peak_bytes, 8U * size);
+	EXPECT_EQ(stats.live_bytes, 2U * size);
+	allocator.free(blocks[6]);
+	allocator.free(blocks[7]);
+	EXPECT_EQ(allocator.stats().live_bytes, 0U);
+}
+
+TEST_F(StatsAllocatorTest, Histogram)
+{
+	Allocator allocator(upstream);
+	const size_type sizes[] = {0U, 1U, 2U, 3U, 4U, 1000U, 1024U, 1025U};
+	void * blocks[8];
+	for (int i = 0; i < 8; ++i)
+		blocks[i] = allocator.allocate(sizes[i]);
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.size_histogram[0], 2U); // zero and one
+	EXPECT_EQ(stats.size_histogram[1], 2U);
+	EXPECT_EQ(stats.size_histogram[2], 1U);
+	EXPECT_EQ(stats.size_histogram[9], 1U);
+	EXPECT_EQ(stats.size_histogram[10], 2U);
+	for (int i = 0; i < 8; ++i)
+		allocator.free(blocks[i]);
+}
+
+TEST_F(StatsAllocatorTest, Latency)
+{
+	Allocator every(upstream, 1U);
+	Allocator sampled(upstream, 4U);
+	Allocator disabled(upstream, 0U);
+	for (int i = 0; i < 8; ++i)
+	{
+		every.free(every.allocate(16U));
+		sampled.free(sampled.allocate(16U));
+		disabled.free(disabled.allocate(16U));
+	}
+	nostd::allocator_stats stats = every.stats();
+	EXPECT_EQ(stats.latency_samples, 8U);
+	std::uint64_t histogram_total = 0U;
+	for (size_type i = 0U; i < nostd::allocator_stats::latency_classes; ++i)
+		histogram_total += stats.latency_histogram[i];
+	EXPECT_EQ(histogram_total, 8U);
+	EXPECT_EQ(sampled.stats().latency_samples, 2U);
+	EXPECT_EQ(disabled.stats().latency_samples, 0U);
+}
+
+TEST_F(StatsAllocatorTest, Failure)
+{
+	Allocator allocator(upstream);
+	EXPECT_THROW(allocator.allocate(static_cast<size_type>(-1)), std::bad_alloc);
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.failures, 1U);
+	EXPECT_EQ(stats.allocations, 0U);
+}
+
+TEST_F(StatsAllocatorTest, Reallocate)
+{
+	Allocator allocator(upstream);
+	void * ptr = allocator.allocate(10U);
+	ptr = allocator.reallocate(ptr, 10U, 40U);
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.live_bytes, 40U);
+	EXPECT_EQ(stats.allocated_bytes, 50U);
+	EXPECT_EQ(stats.live_blocks(), 1U);
+	allocator.free(ptr, 40U);
+}
+
+TEST_F(StatsAllocatorTest, Containers)
+{
+	Allocator allocator(upstream);
+	{
+		nostd::map<int, int> map(&allocator);
+		for (int i = 0; i < 100; ++i)
+			map.emplace(i, i);
+		nostd::vector<int> vector(&allocator);
+		for (int i = 0; i < 100; ++i)
+			vector.push_back(i);
+		nostd::allocator_stats stats = allocator.stats();
+		EXPECT_GE(stats.live_blocks(), 101U);
+		EXPECT_GE(stats.live_bytes, 100U * sizeof(int));
+	}
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.live_blocks(), 0U);
+	EXPECT_EQ(stats.live_bytes, 0U);
+	EXPECT_GT(stats.peak_bytes, 0U);
+}
+
+TEST_F(StatsAllocatorTest, Threads)
+{
+	// Default allocator is thread-safe, so allocator may be shared
+	Allocator allocator(nostd::default_allocator::get_instance());
+	const int num_threads = 4;
+	const int num_allocations = 10000;
+	std::thread threads[num_threads];
+	for (int t = 0; t < num_threads; ++t)
+		threads[t] = std::thread([&allocator, t]() {
+			void * blocks[16];
+			for (int i = 0; i < num_allocations; ++i)
+			{
+				blocks[i % 16] = allocator.allocate(static_cast<size_type>(8 * (t + 1)));
+				if (i % 16 == 15)
+					for (int j = 0; j < 16; ++j)
+						allocator.free(blocks[j]);
+			}
+		});
+	for (int t = 0; t < num_threads; ++t)
+		threads[t].join();
+	nostd::allocator_stats stats = allocator.stats();
+	EXPECT_EQ(stats.allocations, static_cast<std::uint64_t>(num_threads * num_allocations));
+	EXPECT_EQ(stats.live_blocks(), 0U);
+	EXPECT_EQ(stats.live_bytes, 0U);
+	EXPECT_EQ(stats.allocated_bytes, 8U * (1U + 2U + 3U + 4U) * num_allocations);
+}
+
+TEST_F(StatsAllocatorTest, ManyAllocators)
+{
+	// More allocators than a thread keeps at hand, blocks are found again
+	const int num_allocators = 9;
+	Allocator * allocators[num_allocators];
+	for (int i = 0; i < num_allocators; ++i)
+		allocators[i] = new Allocator(upstream);
+	for (int round = 0; round < 3; ++round)
+		for (int i = 0; i < num_allocators; ++i)
+			allocators[i]->free(allocators[i]->allocate(static_cast<size_type>(i + 1)));
+	for (int i = 0; i < num_allocators; ++i)
+	{
+		nostd::allocator_stats stats = allocators[i]->stats();
+		EXPECT_EQ(stats.allocations, 3U);
+		EXPECT_EQ(stats.frees, 3U);
+		EXPECT_EQ(stats.allocated_bytes, 3U * static_cast<std::uint64_t>(i + 1));
+		delete allocators[i];
+	}
+}
@@ -0,0 +1,237 @@
+#include <nostd/btree_map.h>
+#include <nostd/pool_allocator.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+class BtreeMapTest : public testing::Test {
+public:
+	typedef nostd::btree_map<int, int> Map;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using pair_type = Map::pair_type;
+
+protected:
+
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		map = new Map(allocator);
+	}
+	void TearDown() override
+	{
+		delete map;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	void ExpectEqual(const std::map<int, int>& reference)
+	{
+		EXPECT_EQ(map->size(), reference.size());
+		auto expected = reference.begin();
+		for (auto it = map->begin(); it != map->end(); ++it, ++expected)
+		{
+			ASSERT_NE(expected, reference.end());
+			EXPECT_EQ(it->first, expected->first);
+			EXPECT_EQ(it->second, expected->second);
+		}
+		EXPECT_EQ(expected, reference.end());
+	}
+	Allocator * allocator;
+	Map * map;
+};
+
+TEST_F(BtreeMapTest, Creation)
+{
+	EXPECT_EQ(map->empty(), true);
+	EXPECT_EQ(map->begin(), map->end());
+	EXPECT_EQ(map->find(1), map->end());
+	// Empty map doesn't allocate
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(BtreeMapTest, Insert)
+{
+	auto result = map->insert(pair_type(1, 10));
+	EXPECT_EQ(result.second, true);
+	EXPECT_EQ(result.first->second, 10);
+	result = map->insert(pair_type(1, 20));
+	EXPECT_EQ(result.second, false);
+	EXPECT_EQ(result.first->second, 10);
+	EXPECT_EQ(map->size(), 1U);
+	// Single leaf holds many values
+	for (int i = 2; i <= 10; ++i)
+		map->insert(pair_type(i, i));
+	EXPECT_EQ(allocator->count(), 1U);
+}
+
+TEST_F(BtreeMapTest, ManyInsertions)
+{
+	const int count = 10000;
+	for (int i = 0; i < count; ++i)
+	{
+		const int key = (i * 7919) % count;
+		EXPECT_EQ(map->insert(pair_type(key, -key)).second, true);
+	}
+	EXPECT_EQ(map->size(), static_cast<size_type>(count));
+	int expected = 0;
+	for (auto it = map->begin(); it != map->end(); ++it, ++expected)
+	{
+		EXPECT_EQ(it->first, expected);
+		EXPECT_EQ(it->second, -expected);
+	}
+	EXPECT_EQ(expected, count);
+	for (int i = 0; i < count; ++i)
+	{
+		auto it = map->find(i);
+		ASSERT_NE(it, map->end());
+		EXPECT_EQ(it->second, -i);
+	}
+	EXPECT_EQ(map->find(count), map->end());
+	// Nodes are much fewer than elements
+	EXPECT_LT(allocator->count(), static_cast<size_type>(count / 8));
+}
+
+TEST_F(BtreeMapTest, Erase)
+{
+	std::map<int, int> reference;
+	for (int i = 0; i < 2000; ++i)
+	{
+		map->insert(pair_type(i, i));
+		reference[i] = i;
+	}
+	EXPECT_EQ(map->erase(2000), 0U);
+	// Every third key, touching leaves and internal nodes
+	for (int i = 0; i < 2000; i += 3)
+	{
+		EXPECT_EQ(map->erase(i), 1U);
+		reference.erase(i);
+	}
+	ExpectEqual(reference);
+	map->erase(map->begin());
+	reference.erase(reference.begin());
+	ExpectEqual(reference);
+	while (!map->empty())
+		map->erase(map->begin());
+	EXPECT_EQ(map->begin(), map->end());
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(BtreeMapTest, RandomOperations)
+{
+	std::map<int, int> reference;
+	std::mt19937 generator(12345U);
+	std::uniform_int_distribution<int> keys(0, 999);
+	for (int step = 0; step < 20000; ++step)
+	{
+		const int key = keys(generator);
+		if (generator() % 3U != 0U)
+		{
+			const bool inserted = map->insert(pair_type(key, step)).second;
+			EXPECT_EQ(inserted, reference.insert(std::make_pair(key, step)).second);
+		}
+		else
+		{
+			EXPECT_EQ(map->erase(key), static_cast<size_type>(reference.erase(key)));
+		}
+	}
+	ExpectEqual(reference);
+}
+
+TEST_F(BtreeMapTest, Bounds)
+{
+	for (int i = 0; i < 1000; i += 2)
+		map->insert(pair_type(i, i));
+	for (int i = -1; i < 1000; ++i)
+	{
+		auto lower = map->lower_bound(i);
+		auto upper = map->upper_bound(i);
+		const int expected_lower = i < 0 ? 0 : (i + 1) / 2 * 2;
+		const int expected_upper = i < 0 ? 0 : i / 2 * 2 + 2;
+		if (expected_lower < 1000)
+		{
+			ASSERT_NE(lower, map->end());
+			EXPECT_EQ(lower->first, expected_lower);
+		}
+		else
+			EXPECT_EQ(lower, map->end());
+		if (expected_upper < 1000)
+		{
+			ASSERT_NE(upper, map->end());
+			EXPECT_EQ(upper->first, expected_upper);
+		}
+		else
+			EXPECT_EQ(upper, map->end());
+	}
+	auto range = map->equal_range(10);
+	EXPECT_EQ(range.first->first, 10);
+	EXPECT_EQ(range.second->first, 12);
+	range = map->equal_range(11);
+	EXPECT_EQ(range.first, range.second);
+}
+
+TEST_F(BtreeMapTest, IndexOperator)
+{
+	for (int i = 0; i < 500; ++i)
+		(*map)[i] = i * 2;
+	for (int i = 0; i < 500; ++i)
+		(*map)[i] += 1;
+	EXPECT_EQ(map->size(), 500U);
+	for (int i = 0; i < 500; ++i)
+		EXPECT_EQ(map->find(i)->second, i * 2 + 1);
+}
+
+TEST_F(BtreeMapTest, CopyAndMove)
+{
+	for (int i = 0; i < 1000; ++i)
+		map->insert(pair_type(i, i));
+	const size_type nodes = allocator->count();
+	{
+		Map copy(*map);
+		EXPECT_EQ(allocator->count(), nodes * 2U);
+		EXPECT_EQ(copy.size(), 1000U);
+		int i = 0;
+		for (auto it = copy.begin(); it != copy.end(); ++it, ++i)
+			EXPECT_EQ(it->first, i);
+		EXPECT_EQ(i, 1000);
+		Map moved(nostd::utility::move(copy));
+		EXPECT_EQ(copy.empty(), true);
+		EXPECT_EQ(moved.size(), 1000U);
+		copy = moved;
+		EXPECT_EQ(copy.size(), 1000U);
+		moved = nostd::utility::move(copy);
+		EXPECT_EQ(moved.size(), 1000U);
+	}
+	EXPECT_EQ(allocator->count(), nodes);
+}
+
+TEST_F(BtreeMapTest, HeterogeneousLookup)
+{
+	nostd::btree_map<std::string, int, nostd::less<>> names(allocator);
+	for (int i = 0; i < 300; ++i)
+		names[std::to_string(i)] = i;
+	EXPECT_EQ(names.find("42")->second, 42);
+	EXPECT_EQ(names.find("x"), names.end());
+	EXPECT_EQ(names.lower_bound("299")->first, "299");
+	EXPECT_EQ(names.erase(std::string("42")), 1U);
+	EXPECT_EQ(names.find("42"), names.end());
+	EXPECT_EQ(names.size(), 299U);
+}
+
+TEST_F(BtreeMapTest, PoolAllocator)
+{
+	nostd::pool_allocator pool(16U);
+	{
+		Map pooled(&pool);
+		for (int i = 0; i < 5000; ++i)
+			pooled.insert(pair_type(i, i));
+		for (int i = 0; i < 5000; i += 2)
+			pooled.erase(i);
+		EXPECT_EQ(pooled.size(), 2500U);
+		EXPECT_EQ(pooled.begin()->first, 1);
+	}
+}
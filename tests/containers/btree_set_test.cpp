@@ -0,0 +1,81 @@
+#include <nostd/btree_set.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+
+class BtreeSetTest : public testing::Test {
+public:
+	typedef nostd::btree_set<int> Set;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+
+protected:
+
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		set = new Set(allocator);
+	}
+	void TearDown() override
+	{
+		delete set;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Set * set;
+};
+
+TEST_F(BtreeSetTest, InsertAndFind)
+{
+	EXPECT_EQ(set->insert(5).second, true);
+	EXPECT_EQ(set->insert(5).second, false);
+	EXPECT_EQ(set->contains(5), true);
+	EXPECT_EQ(set->contains(6), false);
+	EXPECT_EQ(*set->find(5), 5);
+	EXPECT_EQ(set->size(), 1U);
+}
+
+TEST_F(BtreeSetTest, RandomOperations)
+{
+	std::set<int> reference;
+	std::mt19937 generator(54321U);
+	std::uniform_int_distribution<int> values(0, 4999);
+	for (int step = 0; step < 30000; ++step)
+	{
+		const int value = values(generator);
+		if (generator() % 2U != 0U)
+			EXPECT_EQ(set->insert(value).second, reference.insert(value).second);
+		else
+			EXPECT_EQ(set->erase(value), static_cast<size_type>(reference.erase(value)));
+	}
+	EXPECT_EQ(set->size(), reference.size());
+	auto expected = reference.begin();
+	for (auto it = set->begin(); it != set->end(); ++it, ++expected)
+	{
+		ASSERT_NE(expected, reference.end());
+		EXPECT_EQ(*it, *expected);
+	}
+	EXPECT_EQ(expected, reference.end());
+	set->clear();
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(BtreeSetTest, Strings)
+{
+	nostd::btree_set<std::string> names(allocator);
+	for (int i = 0; i < 1000; ++i)
+		names.insert(std::string(40, 'a') + std::to_string(i));
+	for (int i = 0; i < 1000; i += 2)
+		EXPECT_EQ(names.erase(std::string(40, 'a') + std::to_string(i)), 1U);
+	EXPECT_EQ(names.size(), 500U);
+	nostd::btree_set<std::string> copy(names);
+	EXPECT_EQ(copy.size(), 500U);
+	EXPECT_EQ(*copy.begin(), *names.begin());
+	EXPECT_EQ(copy.contains(std::string(40, 'a') + "1"), true);
+}
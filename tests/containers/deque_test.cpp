@@ -0,0 +1,158 @@
+#include <nostd/deque.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+class DequeTest : public testing::Test {
+public:
+	typedef nostd::deque<int> Deque;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+
+protected:
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		deque = new Deque(allocator);
+	}
+	void TearDown() override
+	{
+		delete deque;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Deque * deque;
+};
+
+TEST_F(DequeTest, Creation)
+{
+	EXPECT_EQ(deque->empty(), true);
+	EXPECT_EQ(deque->begin(), deque->end());
+	EXPECT_EQ(allocator->count(), 0U);
+	EXPECT_THROW(deque->front(), std::range_error);
+	EXPECT_THROW(deque->back(), std::range_error);
+}
+
+TEST_F(DequeTest, PushBack)
+{
+	const int count = static_cast<int>(Deque::block_size) * 10 + 3;
+	for (int i = 0; i < count; ++i)
+		deque->push_back(i);
+	EXPECT_EQ(deque->size(), static_cast<size_type>(count));
+	EXPECT_EQ(deque->front(), 0);
+	EXPECT_EQ(deque->back(), count - 1);
+	for (int i = 0; i < count; ++i)
+		EXPECT_EQ((*deque)[i], i);
+	EXPECT_THROW(deque->at(count), std::range_error);
+	// Blocks and the map
+	EXPECT_EQ(allocator->count(), 12U);
+}
+
+TEST_F(DequeTest, PushFront)
+{
+	const int count = static_cast<int>(Deque::block_size) * 3 + 5;
+	for (int i = 0; i < count; ++i)
+		deque->push_front(i);
+	EXPECT_EQ(deque->size(), static_cast<size_type>(count));
+	EXPECT_EQ(deque->front(), count - 1);
+	EXPECT_EQ(deque->back(), 0);
+	int i = count;
+	for (auto it = deque->begin(); it != deque->end(); ++it)
+		EXPECT_EQ(*it, --i);
+	EXPECT_EQ(deque->end() - deque->begin(), count);
+}
+
+TEST_F(DequeTest, PopBothEnds)
+{
+	// Queue pattern runs through blocks
+	const int count = static_cast<int>(Deque::block_size) * 20;
+	int next = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		deque->push_back(i);
+		deque->push_back(i);
+		deque->pop_front();
+		EXPECT_EQ(deque->front(), (next + 1) / 2);
+		++next;
+	}
+	EXPECT_EQ(deque->size(), static_cast<size_type>(count));
+	// Blocks are recycled, so only a few of them stay allocated
+	EXPECT_LE(allocator->count(), 44U);
+	int prev = deque->back();
+	while (!deque->empty())
+	{
+		EXPECT_LE(deque->back(), prev);
+		prev = deque->back();
+		deque->pop_back();
+	}
+	deque->pop_back();
+	deque->pop_front();
+	EXPECT_EQ(deque->empty(), true);
+	// The map and the spare block
+	EXPECT_EQ(allocator->count(), 2U);
+	deque->push_front(1);
+	deque->push_back(2);
+	EXPECT_EQ(deque->front(), 1);
+	EXPECT_EQ(deque->back(), 2);
+}
+
+TEST_F(DequeTest, BlockBoundary)
+{
+	// Push/pop around block boundary doesn't allocate
+	for (size_type i = 0; i < Deque::block_size; ++i)
+		deque->push_back(static_cast<int>(i));
+	const size_type allocated = allocator->count();
+	for (int i = 0; i < 100; ++i)
+	{
+		deque->push_back(-1);
+		deque->pop_back();
+		deque->push_front(-1);
+		deque->pop_front();
+	}
+	EXPECT_EQ(allocator->count(), allocated + 1U);
+	EXPECT_EQ(deque->size(), Deque::block_size);
+}
+
+TEST_F(DequeTest, CopyMoveSwap)
+{
+	for (int i = 0; i < 1000; ++i)
+		deque->push_front(i);
+	Deque copy(*deque);
+	EXPECT_EQ(copy.size(), 1000U);
+	for (int i = 0; i < 1000; ++i)
+		EXPECT_EQ(copy[i], 999 - i);
+	Deque moved(nostd::utility::move(copy));
+	EXPECT_EQ(copy.empty(), true);
+	EXPECT_EQ(moved.size(), 1000U);
+	copy.push_back(5);
+	copy.swap(moved);
+	EXPECT_EQ(copy.size(), 1000U);
+	EXPECT_EQ(moved.size(), 1U);
+	moved = copy;
+	EXPECT_EQ(moved.size(), 1000U);
+	EXPECT_EQ(moved.back(), 0);
+	copy = nostd::utility::move(moved);
+	EXPECT_EQ(copy.front(), 999);
+	copy.clear();
+	EXPECT_EQ(copy.empty(), true);
+}
+
+TEST_F(DequeTest, NonTrivial)
+{
+	nostd::deque<std::string> strings(allocator);
+	for (int i = 0; i < 200; ++i)
+	{
+		strings.emplace_back(static_cast<size_t>(i), 'x');
+		strings.emplace_front("long enough string to be allocated on the heap");
+	}
+	EXPECT_EQ(strings.size(), 400U);
+	EXPECT_EQ(strings.back().size(), 199U);
+	EXPECT_EQ(strings.begin()->size(), 46U);
+	for (int i = 0; i < 100; ++i)
+		strings.pop_front();
+	EXPECT_EQ(strings.size(), 300U);
+}
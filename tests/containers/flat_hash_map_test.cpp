@@ -0,0 +1,160 @@
+#include <nostd/flat_hash_map.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+	struct StringHash {
+		std::size_t operator ()(const std::string& value) const noexcept
+		{
+			return nostd::hash_bytes(value.data(), value.size());
+		}
+	};
+
+} // namespace
+
+class FlatHashMapTest : public testing::Test {
+public:
+	typedef nostd::flat_hash_map<int, int> Map;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using pair_type = Map::pair_type;
+
+protected:
+
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		map = new Map(allocator);
+	}
+	void TearDown() override
+	{
+		delete map;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Map * map;
+};
+
+TEST_F(FlatHashMapTest, Creation)
+{
+	EXPECT_EQ(map->empty(), true);
+	EXPECT_EQ(map->begin(), map->end());
+	EXPECT_EQ(map->find(1), map->end());
+	// Empty map doesn't allocate
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(FlatHashMapTest, Insert)
+{
+	auto result = map->insert(pair_type(1, 10));
+	EXPECT_EQ(result.second, true);
+	EXPECT_EQ(result.first->second, 10);
+	result = map->insert(pair_type(1, 20));
+	EXPECT_EQ(result.second, false);
+	EXPECT_EQ(result.first->second, 10);
+	EXPECT_EQ(map->size(), 1U);
+}
+
+TEST_F(FlatHashMapTest, Find)
+{
+	for (int i = 0; i < 1000; ++i)
+		(*map)[i] = i * 2;
+	EXPECT_EQ(map->size(), 1000U);
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto it = map->find(i);
+		ASSERT_NE(it, map->end());
+		EXPECT_EQ(it->second, i * 2);
+	}
+	EXPECT_EQ(map->find(1000), map->end());
+	EXPECT_EQ(map->contains(-1), false);
+}
+
+TEST_F(FlatHashMapTest, Erase)
+{
+	for (int i = 0; i < 100; ++i)
+		(*map)[i] = i;
+	for (int i = 0; i < 100; i += 2)
+		EXPECT_EQ(map->erase(i), 1U);
+	EXPECT_EQ(map->erase(0), 0U);
+	EXPECT_EQ(map->size(), 50U);
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(map->contains(i), (i % 2) == 1);
+	map->erase(map->find(1));
+	EXPECT_EQ(map->contains(1), false);
+	EXPECT_EQ(map->size(), 49U);
+}
+
+TEST_F(FlatHashMapTest, Churn)
+{
+	// Erased slots are reused without unbounded growth
+	for (int i = 0; i < 10000; ++i)
+	{
+		(*map)[i] = i;
+		if (i >= 10)
+			map->erase(i - 10);
+	}
+	EXPECT_EQ(map->size(), 10U);
+	EXPECT_LE(map->capacity(), 63U);
+	for (int i = 9990; i < 10000; ++i)
+		EXPECT_EQ((*map)[i], i);
+}
+
+TEST_F(FlatHashMapTest, Iteration)
+{
+	for (int i = 0; i < 100; ++i)
+		(*map)[i] = 1;
+	int sum = 0;
+	size_type count = 0U;
+	for (auto it = map->begin(); it != map->end(); ++it)
+	{
+		sum += it->first;
+		++count;
+	}
+	EXPECT_EQ(count, 100U);
+	EXPECT_EQ(sum, 4950);
+}
+
+TEST_F(FlatHashMapTest, Reserve)
+{
+	map->reserve(1000U);
+	size_type capacity = map->capacity();
+	EXPECT_GE(capacity, 1000U);
+	for (int i = 0; i < 1000; ++i)
+		(*map)[i] = i;
+	EXPECT_EQ(map->capacity(), capacity);
+	map->clear();
+	EXPECT_EQ(map->empty(), true);
+	EXPECT_EQ(map->capacity(), capacity);
+}
+
+TEST_F(FlatHashMapTest, CopyAndMove)
+{
+	for (int i = 0; i < 100; ++i)
+		(*map)[i] = i;
+	Map copy(*map);
+	EXPECT_EQ(copy.size(), 100U);
+	EXPECT_EQ(copy[50], 50);
+	Map moved(nostd::utility::move(copy));
+	EXPECT_EQ(copy.empty(), true);
+	EXPECT_EQ(moved.size(), 100U);
+	copy = moved;
+	EXPECT_EQ(copy.size(), 100U);
+}
+
+TEST_F(FlatHashMapTest, StringKeys)
+{
+	nostd::flat_hash_map<std::string, std::string, StringHash> strings(allocator);
+	for (int i = 0; i < 100; ++i)
+		strings[std::to_string(i)] = std::string(50U, static_cast<char>('a' + i % 26));
+	EXPECT_EQ(strings.size(), 100U);
+	EXPECT_EQ(strings["27"], std::string(50U, 'b'));
+	strings.erase(std::string("27"));
+	EXPECT_EQ(strings.contains("27"), false);
+}
@@ -0,0 +1,50 @@
+#include <nostd/flat_hash_set.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+class FlatHashSetTest : public testing::Test {
+public:
+	typedef nostd::flat_hash_set<int> Set;
+	typedef nostd::test_allocator Allocator;
+
+protected:
+
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		set = new Set(allocator);
+	}
+	void TearDown() override
+	{
+		delete set;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Set * set;
+};
+
+TEST_F(FlatHashSetTest, Creation)
+{
+	EXPECT_EQ(set->empty(), true);
+	EXPECT_EQ(set->contains(0), false);
+}
+
+TEST_F(FlatHashSetTest, Insert)
+{
+	EXPECT_EQ(set->insert(5).second, true);
+	EXPECT_EQ(set->insert(5).second, false);
+	EXPECT_EQ(*set->find(5), 5);
+	EXPECT_EQ(set->size(), 1U);
+}
+
+TEST_F(FlatHashSetTest, Erase)
+{
+	for (int i = 0; i < 500; ++i)
+		set->insert(i * 7);
+	for (int i = 0; i < 500; i += 3)
+		EXPECT_EQ(set->erase(i * 7), 1U);
+	for (int i = 0; i < 500; ++i)
+		EXPECT_EQ(set->contains(i * 7), (i % 3) != 0);
+}
@@ -0,0 +1,172 @@
+#include <nostd/flat_map.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+class FlatMapTest : public testing::Test {
+public:
+	typedef nostd::flat_map<int, int> Map;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+	using pair_type = Map::pair_type;
+
+protected:
+
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		map = new Map(allocator);
+	}
+	void TearDown() override
+	{
+		delete map;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Map * map;
+};
+
+TEST_F(FlatMapTest, Creation)
+{
+	EXPECT_EQ(map->empty(), true);
+	EXPECT_EQ(map->begin(), map->end());
+	EXPECT_EQ(map->find(1), map->end());
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(FlatMapTest, Insert)
+{
+	const int keys[] = {5, 1, 9, 3, 7};
+	for (int key : keys)
+		EXPECT_EQ(map->insert(pair_type(key, key * 10)).second, true);
+	auto result = map->insert(pair_type(3, 0));
+	EXPECT_EQ(result.second, false);
+	EXPECT_EQ(result.first->second, 30);
+	EXPECT_EQ(map->size(), 5U);
+	// Elements share a single allocation
+	EXPECT_EQ(allocator->count(), 1U);
+	int previous = 0;
+	for (auto it = map->begin(); it != map->end(); ++it)
+	{
+		EXPECT_LT(previous, it->first);
+		EXPECT_EQ(it->second, it->first * 10);
+		previous = it->first;
+	}
+}
+
+TEST_F(FlatMapTest, BatchInsert)
+{
+	map->insert(pair_type(10, -1));
+	map->insert(pair_type(20, -1));
+	std::map<int, int> reference;
+	reference[10] = -1;
+	reference[20] = -1;
+	std::vector<pair_type> batch;
+	std::vector<std::pair<int, int>> batch_keys;
+	std::mt19937 generator(2024U);
+	for (int i = 0; i < 3000; ++i)
+	{
+		const int key = static_cast<int>(generator() % 1000U);
+		batch.push_back(pair_type(key, key));
+		batch_keys.push_back(std::make_pair(key, key));
+		reference.insert(std::make_pair(key, key));
+	}
+	map->insert(batch.begin(), batch.end());
+	ASSERT_EQ(map->size(), reference.size());
+	auto expected = reference.begin();
+	for (auto it = map->begin(); it != map->end(); ++it, ++expected)
+	{
+		EXPECT_EQ(it->first, expected->first);
+		EXPECT_EQ(it->second, expected->second);
+	}
+	// Existing values are kept
+	EXPECT_EQ(map->find(10)->second, -1);
+	// Batch into an empty map deduplicates as well
+	std::map<int, int> unique(batch_keys.begin(), batch_keys.end());
+	Map other(allocator);
+	other.insert(batch.begin(), batch.end());
+	EXPECT_EQ(other.size(), unique.size());
+}
+
+TEST_F(FlatMapTest, FindAndBounds)
+{
+	for (int i = 0; i < 100; i += 2)
+		(*map)[i] = i;
+	for (int i = -1; i <= 100; ++i)
+	{
+		auto it = map->find(i);
+		if (i >= 0 && i < 100 && i % 2 == 0)
+		{
+			ASSERT_NE(it, map->end());
+			EXPECT_EQ(it->second, i);
+		}
+		else
+			EXPECT_EQ(it, map->end());
+		const int lower = i < 0 ? 0 : (i + 1) / 2 * 2;
+		const int upper = i < 0 ? 0 : i / 2 * 2 + 2;
+		if (lower < 100)
+			EXPECT_EQ(map->lower_bound(i)->first, lower);
+		else
+			EXPECT_EQ(map->lower_bound(i), map->end());
+		if (upper < 100)
+			EXPECT_EQ(map->upper_bound(i)->first, upper);
+		else
+			EXPECT_EQ(map->upper_bound(i), map->end());
+	}
+	auto range = map->equal_range(4);
+	EXPECT_EQ(range.second - range.first, 1);
+	range = map->equal_range(5);
+	EXPECT_EQ(range.first, range.second);
+}
+
+TEST_F(FlatMapTest, Erase)
+{
+	for (int i = 0; i < 50; ++i)
+		(*map)[i] = i;
+	EXPECT_EQ(map->erase(50), 0U);
+	EXPECT_EQ(map->erase(10), 1U);
+	auto it = map->erase(map->find(20));
+	EXPECT_EQ(it->first, 21);
+	it = map->erase(map->lower_bound(30), map->lower_bound(40));
+	EXPECT_EQ(it->first, 40);
+	EXPECT_EQ(map->size(), 38U);
+	EXPECT_EQ(map->contains(35), false);
+	EXPECT_EQ(map->contains(45), true);
+}
+
+TEST_F(FlatMapTest, HeterogeneousLookup)
+{
+	nostd::flat_map<std::string, int, nostd::less<>> names(allocator);
+	names["one"] = 1;
+	names["two"] = 2;
+	names["three"] = 3;
+	EXPECT_EQ(names.find("two")->second, 2);
+	EXPECT_EQ(names.find("four"), names.end());
+	EXPECT_EQ(names.lower_bound("th")->first, "three");
+	EXPECT_EQ(names.equal_range("one").first->second, 1);
+}
+
+TEST_F(FlatMapTest, CopyAndMove)
+{
+	for (int i = 0; i < 20; ++i)
+		(*map)[i] = i;
+	Map copy(*map);
+	EXPECT_EQ(copy.size(), 20U);
+	EXPECT_EQ(copy.find(7)->second, 7);
+	Map moved(nostd::utility::move(copy));
+	EXPECT_EQ(moved.size(), 20U);
+	EXPECT_EQ(copy.empty(), true);
+	// Moved from map stays usable
+	copy[1] = 1;
+	EXPECT_EQ(copy.size(), 1U);
+	moved.swap(copy);
+	EXPECT_EQ(moved.size(), 1U);
+	EXPECT_EQ(copy.size(), 20U);
+}
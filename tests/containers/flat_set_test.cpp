@@ -0,0 +1,106 @@
+#include <nostd/flat_set.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+class FlatSetTest : public testing::Test {
+public:
+	typedef nostd::flat_set<int> Set;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+
+protected:
+
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		set = new Set(allocator);
+	}
+	void TearDown() override
+	{
+		delete set;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Set * set;
+};
+
+TEST_F(FlatSetTest, RandomOperations)
+{
+	std::set<int> reference;
+	std::mt19937 generator(99U);
+	for (int step = 0; step < 5000; ++step)
+	{
+		const int value = static_cast<int>(generator() % 500U);
+		if (generator() % 2U != 0U)
+			EXPECT_EQ(set->insert(value).second, reference.insert(value).second);
+		else
+			EXPECT_EQ(set->erase(value), static_cast<size_type>(reference.erase(value)));
+		EXPECT_EQ(set->contains(value), reference.count(value) != 0U);
+	}
+	ASSERT_EQ(set->size(), reference.size());
+	auto expected = reference.begin();
+	for (auto it = set->begin(); it != set->end(); ++it, ++expected)
+		EXPECT_EQ(*it, *expected);
+}
+
+TEST_F(FlatSetTest, BatchInsertStrings)
+{
+	nostd::flat_set<std::string> names(allocator);
+	names.insert(std::string("m"));
+	const std::string batch[] = {"z", "a", "m", "b", "a", "y", "z", "c"};
+	names.insert(batch, batch + sizeof(batch) / sizeof(batch[0]));
+	const char * expected[] = {"a", "b", "c", "m", "y", "z"};
+	ASSERT_EQ(names.size(), 6U);
+	size_type i = 0U;
+	for (auto it = names.begin(); it != names.end(); ++it, ++i)
+		EXPECT_EQ(*it, expected[i]);
+	EXPECT_EQ(names.data()[3], "m");
+}
+
+TEST_F(FlatSetTest, BatchInsertFailure)
+{
+	// Iterator that throws when it reaches the selected element
+	struct ThrowingIterator {
+		const int * ptr;
+		const int * fail;
+
+		int operator *() const
+		{
+			if (ptr == fail)
+				throw std::runtime_error("iterator failure");
+			return *ptr;
+		}
+		ThrowingIterator& operator ++()
+		{
+			++ptr;
+			return *this;
+		}
+		bool operator !=(const ThrowingIterator& other) const
+		{
+			return ptr != other.ptr;
+		}
+	};
+	set->insert(5);
+	set->insert(10);
+	const int batch[] = {9, 1, 7, 3};
+	EXPECT_THROW(set->insert(ThrowingIterator{batch, batch + 2}, ThrowingIterator{batch + 4, batch + 2}),
+		std::runtime_error);
+	ASSERT_EQ(set->size(), 2U);
+	EXPECT_EQ(set->contains(1), false);
+	EXPECT_EQ(set->contains(5), true);
+	EXPECT_EQ(set->contains(10), true);
+	set->insert(batch, batch + 4);
+	ASSERT_EQ(set->size(), 6U);
+	const int expected[] = {1, 3, 5, 7, 9, 10};
+	size_type i = 0U;
+	for (auto it = set->begin(); it != set->end(); ++it, ++i)
+		EXPECT_EQ(*it, expected[i]);
+}
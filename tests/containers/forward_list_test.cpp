@@ -1,7 +1,10 @@
 #include <nostd/forward_list.h>
+#include <nostd/pool_allocator.h>
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 class ForwardListTest : public testing::Test {
 	typedef nostd::forward_list<int> List;
 protected:
@@ -47,4 +50,33 @@ TEST_F(ForwardListTest, PopFront)
 
 	list->pop_front();
 	EXPECT_EQ(list->size(), 0U);
-}
\ No newline at end of file
+}
+
+TEST(ForwardListEmplaceTest, EmplaceFront)
+{
+	// Values owning memory show that popped elements are destroyed
+	nostd::forward_list<std::string> list;
+	EXPECT_EQ(list.emplace_front(3U, 'a'), "aaa");
+	list.emplace_front("long enough string to be allocated on the heap");
+	EXPECT_EQ(list.size(), 2U);
+	EXPECT_EQ(list.front().size(), 46U);
+	list.pop_front();
+	EXPECT_EQ(list.front(), "aaa");
+}
+
+TEST_F(ForwardListTest, StaticAllocator)
+{
+	// Pool calls are resolved at compile time
+	typedef nostd::forward_list<int, nostd::pool_allocator> StaticList;
+	nostd::pool_allocator pool(4);
+	StaticList typed(&pool);
+	for (int i = 0; i < 10; ++i)
+		typed.push_front(i);
+	StaticList copy(typed);
+	EXPECT_EQ(copy.size(), 10U);
+	EXPECT_EQ(copy.front(), 9);
+	copy.pop_front();
+	EXPECT_EQ(copy.front(), 8);
+	typed.clear();
+	EXPECT_EQ(typed.empty(), true);
+}
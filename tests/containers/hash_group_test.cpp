@@ -0,0 +1,87 @@
+#include <nostd/hash_group.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+namespace {
+
+	const nostd::ctrl_t kSpecial[] = {nostd::ctrl_empty, nostd::ctrl_deleted, nostd::ctrl_sentinel};
+
+	/**
+	 * Compares group masks with expected ones computed byte by byte
+	 */
+	template <typename Group>
+	void CheckGroup(const nostd::ctrl_t * ctrl)
+	{
+		Group group(ctrl);
+		unsigned empty = 0U;
+		unsigned empty_or_deleted = 0U;
+		for (auto mask = group.match_empty(); mask; mask.clear_lowest())
+			empty |= 1U << mask.lowest();
+		for (auto mask = group.match_empty_or_deleted(); mask; mask.clear_lowest())
+			empty_or_deleted |= 1U << mask.lowest();
+		for (unsigned i = 0U; i < Group::width; ++i)
+		{
+			EXPECT_EQ((empty >> i) & 1U, ctrl[i] == nostd::ctrl_empty ? 1U : 0U);
+			EXPECT_EQ((empty_or_deleted >> i) & 1U, ctrl[i] < nostd::ctrl_sentinel ? 1U : 0U);
+		}
+		for (unsigned i = 0U; i < Group::width; ++i)
+		{
+			if (ctrl[i] < 0)
+				continue;
+			unsigned matched = 0U;
+			for (auto mask = group.match(ctrl[i]); mask; mask.clear_lowest())
+				matched |= 1U << mask.lowest();
+			EXPECT_NE((matched >> i) & 1U, 0U);
+			// False positives may only point to full slots
+			for (unsigned j = 0U; j < Group::width; ++j)
+			{
+				if ((matched >> j) & 1U)
+				{
+					EXPECT_GE(ctrl[j], 0);
+				}
+			}
+		}
+	}
+
+	template <typename Group>
+	void CheckRandomGroups()
+	{
+		std::srand(1U);
+		nostd::ctrl_t ctrl[16];
+		for (int n = 0; n < 1000; ++n)
+		{
+			for (unsigned i = 0U; i < 16U; ++i)
+			{
+				int r = std::rand() % 8;
+				ctrl[i] = (r < 3) ? kSpecial[r] : static_cast<nostd::ctrl_t>(std::rand() % 128);
+			}
+			CheckGroup<Group>(ctrl);
+		}
+	}
+
+} // namespace
+
+TEST(HashGroupTest, Swar)
+{
+	CheckRandomGroups<nostd::group_swar>();
+}
+
+TEST(HashGroupTest, Native)
+{
+	CheckRandomGroups<nostd::hash_group>();
+}
+
+TEST(HashGroupTest, Mask)
+{
+	nostd::group_mask<8U, 3U> mask(0x0000800000008000ULL);
+	EXPECT_EQ(mask.lowest(), 1U);
+	EXPECT_EQ(mask.highest(), 5U);
+	EXPECT_EQ(mask.leading_zeros(), 2U);
+	mask.clear_lowest();
+	EXPECT_EQ(mask.trailing_zeros(), 5U);
+	mask.clear_lowest();
+	EXPECT_EQ(static_cast<bool>(mask), false);
+	EXPECT_EQ(mask.trailing_zeros(), 8U);
+}
@@ -0,0 +1,92 @@
+#include <nostd/intrusive_forward_list.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+	struct Block {
+		int id;
+		nostd::forward_list_hook hook;
+
+		explicit Block(int id) : id(id) {}
+	};
+
+} // namespace
+
+class IntrusiveForwardListTest : public testing::Test {
+public:
+	typedef nostd::intrusive_forward_list<Block, &Block::hook> List;
+protected:
+	void SetUp() override
+	{
+		for (int i = 0; i < 4; ++i)
+			blocks[i] = new Block(i);
+	}
+	void TearDown() override
+	{
+		list.clear();
+		for (int i = 0; i < 4; ++i)
+			delete blocks[i];
+	}
+	List list;
+	Block * blocks[4];
+};
+
+TEST_F(IntrusiveForwardListTest, Creation)
+{
+	EXPECT_EQ(list.empty(), true);
+	EXPECT_EQ(list.begin(), list.end());
+	EXPECT_THROW(list.pop_front(), std::range_error);
+}
+
+TEST_F(IntrusiveForwardListTest, PushAndPop)
+{
+	for (int i = 0; i < 4; ++i)
+		list.push_front(*blocks[i]);
+	EXPECT_EQ(list.size(), 4U);
+	EXPECT_EQ(&list.front(), blocks[3]);
+	int expected = 3;
+	for (List::iterator it = list.begin(); it != list.end(); ++it)
+		EXPECT_EQ(it->id, expected--);
+	// The last element is linked too
+	EXPECT_EQ(blocks[0]->hook.linked(), true);
+	list.pop_front();
+	EXPECT_EQ(blocks[3]->hook.linked(), false);
+	EXPECT_EQ(&list.front(), blocks[2]);
+}
+
+TEST_F(IntrusiveForwardListTest, InsertAndEraseAfter)
+{
+	List::iterator it = list.insert_after(list.before_begin(), *blocks[0]);
+	it = list.insert_after(it, *blocks[1]);
+	list.insert_after(it, *blocks[3]);
+	list.insert_after(list.iterator_to(*blocks[1]), *blocks[2]);
+	int expected = 0;
+	for (Block& block : list)
+		EXPECT_EQ(block.id, expected++);
+	EXPECT_EQ(expected, 4);
+	it = list.erase_after(list.iterator_to(*blocks[1]));
+	EXPECT_EQ(&*it, blocks[3]);
+	EXPECT_EQ(blocks[2]->hook.linked(), false);
+	list.erase_after(list.before_begin());
+	EXPECT_EQ(list.size(), 2U);
+	EXPECT_EQ(&list.front(), blocks[1]);
+}
+
+TEST_F(IntrusiveForwardListTest, Move)
+{
+	for (int i = 0; i < 3; ++i)
+		list.push_front(*blocks[i]);
+	List moved(nostd::utility::move(list));
+	EXPECT_EQ(list.empty(), true);
+	EXPECT_EQ(moved.size(), 3U);
+	int count = 0;
+	for (List::iterator it = moved.begin(); it != moved.end(); ++it)
+		++count;
+	EXPECT_EQ(count, 3);
+	list.push_front(*blocks[3]);
+	list.swap(moved);
+	EXPECT_EQ(list.size(), 3U);
+	EXPECT_EQ(&moved.front(), blocks[3]);
+	moved.clear();
+}
@@ -0,0 +1,119 @@
+#include <nostd/intrusive_list.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+	struct Timer {
+		int deadline;
+		nostd::list_hook hook;
+
+		explicit Timer(int deadline) : deadline(deadline) {}
+	};
+
+} // namespace
+
+class IntrusiveListTest : public testing::Test {
+public:
+	typedef nostd::intrusive_list<Timer, &Timer::hook> List;
+protected:
+	void SetUp() override
+	{
+		for (int i = 0; i < 5; ++i)
+			timers[i] = new Timer(i);
+	}
+	void TearDown() override
+	{
+		// Elements may be destroyed once they are unlinked
+		list.clear();
+		for (int i = 0; i < 5; ++i)
+			delete timers[i];
+	}
+	List list;
+	Timer * timers[5];
+};
+
+TEST_F(IntrusiveListTest, Creation)
+{
+	EXPECT_EQ(list.empty(), true);
+	EXPECT_EQ(list.begin(), list.end());
+	EXPECT_THROW(list.front(), std::range_error);
+	EXPECT_THROW(list.pop_back(), std::range_error);
+}
+
+TEST_F(IntrusiveListTest, PushAndPop)
+{
+	list.push_back(*timers[1]);
+	list.push_back(*timers[2]);
+	list.push_front(*timers[0]);
+	EXPECT_EQ(list.size(), 3U);
+	EXPECT_EQ(&list.front(), timers[0]);
+	EXPECT_EQ(&list.back(), timers[2]);
+	EXPECT_EQ(timers[1]->hook.linked(), true);
+	int expected = 0;
+	for (List::iterator it = list.begin(); it != list.end(); ++it)
+		EXPECT_EQ(it->deadline, expected++);
+	EXPECT_EQ(expected, 3);
+
+	list.pop_front();
+	EXPECT_EQ(timers[0]->hook.linked(), false);
+	list.pop_back();
+	EXPECT_EQ(list.size(), 1U);
+	EXPECT_EQ(&list.front(), timers[1]);
+}
+
+TEST_F(IntrusiveListTest, EraseByElement)
+{
+	for (int i = 0; i < 5; ++i)
+		list.push_back(*timers[i]);
+	// Element is unlinked without search
+	list.erase(*timers[2]);
+	EXPECT_EQ(list.size(), 4U);
+	EXPECT_EQ(timers[2]->hook.linked(), false);
+	List::iterator it = list.erase(list.iterator_to(*timers[3]));
+	EXPECT_EQ(&*it, timers[4]);
+	--it;
+	EXPECT_EQ(&*it, timers[1]);
+	it = list.insert(it, *timers[2]);
+	EXPECT_EQ(&*it, timers[2]);
+	EXPECT_EQ(&*(++it), timers[1]);
+}
+
+TEST_F(IntrusiveListTest, Splice)
+{
+	List other;
+	for (int i = 0; i < 3; ++i)
+		list.push_back(*timers[i]);
+	other.push_back(*timers[3]);
+	other.push_back(*timers[4]);
+	list.splice(list.begin(), other);
+	EXPECT_EQ(other.empty(), true);
+	EXPECT_EQ(list.size(), 5U);
+	EXPECT_EQ(&list.front(), timers[3]);
+	// Single element moves back
+	other.splice(other.end(), list, list.iterator_to(*timers[0]));
+	EXPECT_EQ(other.size(), 1U);
+	EXPECT_EQ(list.size(), 4U);
+	EXPECT_EQ(&other.front(), timers[0]);
+	other.swap(list);
+	EXPECT_EQ(other.size(), 4U);
+	EXPECT_EQ(list.size(), 1U);
+	other.clear();
+	EXPECT_EQ(timers[3]->hook.linked(), false);
+}
+
+TEST_F(IntrusiveListTest, Move)
+{
+	for (int i = 0; i < 3; ++i)
+		list.push_back(*timers[i]);
+	List moved(nostd::utility::move(list));
+	EXPECT_EQ(list.empty(), true);
+	EXPECT_EQ(moved.size(), 3U);
+	EXPECT_EQ(&moved.back(), timers[2]);
+	// Copied element isn't linked
+	Timer copy(*timers[1]);
+	EXPECT_EQ(copy.hook.linked(), false);
+	moved.push_back(copy);
+	EXPECT_EQ(moved.size(), 4U);
+	moved.erase(copy);
+}
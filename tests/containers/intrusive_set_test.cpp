@@ -0,0 +1,151 @@
+#include <nostd/intrusive_set.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+	struct Connection {
+		int id;
+		nostd::set_hook hook;
+
+		explicit Connection(int id) : id(id) {}
+	};
+
+	/**
+	 * Orders connections by id, transparent to look them up by id.
+	 */
+	struct ById {
+		using is_transparent = void;
+
+		bool operator ()(const Connection& a, const Connection& b) const { return a.id < b.id; }
+		bool operator ()(const Connection& a, int b) const { return a.id < b; }
+		bool operator ()(int a, const Connection& b) const { return a < b.id; }
+	};
+
+} // namespace
+
+class IntrusiveSetTest : public testing::Test {
+public:
+	typedef nostd::intrusive_set<Connection, &Connection::hook, ById> Set;
+protected:
+	void SetUp() override
+	{
+		for (int i = 0; i < 100; ++i)
+			connections.push_back(new Connection(i));
+	}
+	void TearDown() override
+	{
+		set.clear();
+		for (Connection * connection : connections)
+			delete connection;
+	}
+	void CheckOrder()
+	{
+		int count = 0;
+		int previous = -1;
+		for (Set::iterator it = set.begin(); it != set.end(); ++it, ++count)
+		{
+			EXPECT_LT(previous, it->id);
+			previous = it->id;
+		}
+		EXPECT_EQ(static_cast<unsigned>(count), set.size());
+	}
+	Set set;
+	std::vector<Connection*> connections;
+};
+
+TEST_F(IntrusiveSetTest, Creation)
+{
+	EXPECT_EQ(set.empty(), true);
+	EXPECT_EQ(set.begin(), set.end());
+	EXPECT_EQ(set.find(1), set.end());
+}
+
+TEST_F(IntrusiveSetTest, Insert)
+{
+	std::mt19937 random(7);
+	std::vector<Connection*> shuffled(connections);
+	std::shuffle(shuffled.begin(), shuffled.end(), random);
+	for (Connection * connection : shuffled)
+		EXPECT_EQ(set.insert(*connection).second, true);
+	EXPECT_EQ(set.size(), 100U);
+	CheckOrder();
+	// Equivalent element isn't linked
+	Connection duplicate(42);
+	nostd::utility::pair<Set::iterator, bool> result = set.insert(duplicate);
+	EXPECT_EQ(result.second, false);
+	EXPECT_EQ(&*result.first, connections[42]);
+	EXPECT_EQ(duplicate.hook.linked(), false);
+}
+
+TEST_F(IntrusiveSetTest, Lookup)
+{
+	for (int i = 0; i < 100; i += 2)
+		set.insert(*connections[i]);
+	EXPECT_EQ(&*set.find(10), connections[10]);
+	EXPECT_EQ(set.find(11), set.end());
+	EXPECT_EQ(set.contains(*connections[20]), true);
+	EXPECT_EQ(set.contains(21), false);
+	EXPECT_EQ(set.lower_bound(11)->id, 12);
+	EXPECT_EQ(set.upper_bound(12)->id, 14);
+	EXPECT_EQ(set.lower_bound(99), set.end());
+	Set::iterator last = set.end();
+	--last;
+	EXPECT_EQ(last->id, 98);
+}
+
+TEST_F(IntrusiveSetTest, Erase)
+{
+	for (Connection * connection : connections)
+		set.insert(*connection);
+	// Erase every third element by address
+	for (int i = 0; i < 100; i += 3)
+	{
+		set.erase(*connections[i]);
+		EXPECT_EQ(connections[i]->hook.linked(), false);
+	}
+	EXPECT_EQ(set.size(), 66U);
+	CheckOrder();
+	Set::iterator it = set.erase(set.find(1));
+	EXPECT_EQ(it->id, 2);
+	// Unlinked element may be inserted again
+	set.insert(*connections[0]);
+	EXPECT_EQ(set.begin()->id, 0);
+	CheckOrder();
+}
+
+TEST_F(IntrusiveSetTest, InsertEqual)
+{
+	nostd::intrusive_set<Connection, &Connection::hook, ById> multi;
+	Connection a(5), b(5), c(3);
+	multi.insert_equal(a);
+	multi.insert_equal(b);
+	multi.insert_equal(c);
+	EXPECT_EQ(multi.size(), 3U);
+	Set::iterator it = multi.lower_bound(5);
+	EXPECT_EQ(&*it, &a);
+	++it;
+	EXPECT_EQ(&*it, &b);
+	multi.clear();
+	EXPECT_EQ(a.hook.linked(), false);
+}
+
+TEST_F(IntrusiveSetTest, MoveAndSwap)
+{
+	for (int i = 0; i < 10; ++i)
+		set.insert(*connections[i]);
+	Set moved(nostd::utility::move(set));
+	EXPECT_EQ(set.empty(), true);
+	EXPECT_EQ(moved.size(), 10U);
+	EXPECT_EQ(moved.find(5)->id, 5);
+	set.insert(*connections[50]);
+	set.swap(moved);
+	EXPECT_EQ(set.size(), 10U);
+	EXPECT_EQ(moved.begin()->id, 50);
+	CheckOrder();
+	moved.clear();
+}
@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 class ListWithDefaultAllocatorTest : public testing::Test {
 	typedef nostd::list<int> List;
 protected:
@@ -152,6 +154,107 @@ TEST_F(ListWithDefaultAllocatorTest, Find)
 }
 
 
+TEST_F(ListWithDefaultAllocatorTest, Splice)
+{
+	nostd::list<int> other;
+	for (int i = 0; i < 3; ++i)
+	{
+		list->push_back(i);
+		other.push_back(10 + i);
+	}
+	// Single element into the middle
+	auto pos = list->begin();
+	++pos;
+	list->splice(pos, other, other.begin());
+	EXPECT_EQ(list->size(), 4U);
+	EXPECT_EQ(other.size(), 2U);
+	EXPECT_EQ(other.front(), 11);
+	// The rest to the end
+	list->splice(list->end(), other);
+	EXPECT_EQ(list->size(), 6U);
+	EXPECT_EQ(other.empty(), true);
+	const int expected[] = {0, 10, 1, 2, 11, 12};
+	int i = 0;
+	for (auto it = list->begin(); it != list->end(); ++it, ++i)
+		EXPECT_EQ(*it, expected[i]);
+	EXPECT_EQ(i, 6);
+	EXPECT_EQ(list->back(), 12);
+	// Move the last element to the front within the same list
+	auto last = list->find(12);
+	list->splice(list->begin(), *list, last);
+	EXPECT_EQ(list->size(), 6U);
+	EXPECT_EQ(list->front(), 12);
+	EXPECT_EQ(list->back(), 11);
+	// Range back to other list
+	other.splice(other.end(), *list, list->find(1), list->end());
+	EXPECT_EQ(list->size(), 3U);
+	EXPECT_EQ(other.size(), 3U);
+	EXPECT_EQ(list->back(), 10);
+	EXPECT_EQ(other.front(), 1);
+	EXPECT_EQ(other.back(), 11);
+	// Whole list to the front, then into empty list
+	list->splice(list->begin(), other);
+	EXPECT_EQ(list->size(), 6U);
+	EXPECT_EQ(other.empty(), true);
+	EXPECT_EQ(list->front(), 1);
+	EXPECT_EQ(list->back(), 10);
+	other.splice(other.begin(), *list);
+	EXPECT_EQ(list->empty(), true);
+	EXPECT_TRUE(list->begin() == list->end());
+	EXPECT_EQ(other.size(), 6U);
+	EXPECT_EQ(other.front(), 1);
+	EXPECT_EQ(other.back(), 10);
+	// Empty list changes nothing
+	other.splice(other.end(), *list);
+	EXPECT_EQ(other.size(), 6U);
+}
+
+TEST_F(ListWithDefaultAllocatorTest, Extract)
+{
+	for (int i = 0; i < 3; ++i)
+		list->push_back(i);
+	auto node = list->extract(list->find(1));
+	EXPECT_EQ(static_cast<bool>(node), true);
+	EXPECT_EQ(node.value(), 1);
+	EXPECT_EQ(list->size(), 2U);
+	EXPECT_EQ(list->extract(list->end()).empty(), true);
+	node.value() = 5;
+	auto it = list->insert(list->begin(), nostd::utility::move(node));
+	EXPECT_EQ(node.empty(), true);
+	EXPECT_EQ(*it, 5);
+	EXPECT_EQ(list->size(), 3U);
+	EXPECT_EQ(list->front(), 5);
+	// Handle frees node it still owns
+	nostd::list<int> other;
+	other.insert(other.end(), list->extract(list->begin()));
+	EXPECT_EQ(other.size(), 1U);
+	{
+		auto dropped = list->extract(list->begin());
+	}
+	EXPECT_EQ(list->size(), 1U);
+	EXPECT_EQ(list->front(), 2);
+}
+
+TEST_F(ListWithDefaultAllocatorTest, Emplace)
+{
+	list->emplace_back(2);
+	list->emplace_front(0);
+	auto it = list->emplace(list->find(2), 1);
+	EXPECT_EQ(*it, 1);
+	EXPECT_EQ(list->size(), 3U);
+	int i = 0;
+	for (auto it = list->begin(); it != list->end(); ++it, ++i)
+		EXPECT_EQ(*it, i);
+
+	nostd::list<std::string> strings;
+	strings.emplace_back(3U, 'c');
+	strings.emplace_front("long enough string to be allocated on the heap");
+	strings.erase(strings.begin());
+	EXPECT_EQ(strings.front(), "ccc");
+	strings.pop_back();
+	EXPECT_EQ(strings.empty(), true);
+}
+
 /**
  * The same test, but with pool allocator
  */
@@ -238,4 +341,22 @@ TEST_F(ListWithPoolAllocatorTest, PopBack)
 
 	list->pop_back();
 	EXPECT_EQ(list->size(), 0U);
-}
\ No newline at end of file
+}
+TEST_F(ListWithPoolAllocatorTest, StaticAllocator)
+{
+	// Pool calls are resolved at compile time
+	typedef nostd::list<int, nostd::pool_allocator> StaticList;
+	nostd::pool_allocator pool(4);
+	StaticList typed(&pool);
+	for (int i = 0; i < 10; ++i)
+		typed.push_back(i);
+	StaticList copy(typed);
+	EXPECT_EQ(copy.size(), 10U);
+	EXPECT_EQ(copy.front(), 0);
+	EXPECT_EQ(copy.back(), 9);
+	typed.clear();
+	EXPECT_EQ(typed.empty(), true);
+	typed.splice(typed.end(), copy);
+	EXPECT_EQ(typed.size(), 10U);
+	EXPECT_EQ(copy.empty(), true);
+}
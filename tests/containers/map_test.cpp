@@ -3,6 +3,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <type_traits>
+
 class MapTest : public testing::Test {
 public:
 	typedef nostd::map<int, int> Map;
@@ -35,6 +38,16 @@ TEST_F(MapTest, Creation)
 	EXPECT_EQ(map->begin(), map->end());
 }
 
+TEST_F(MapTest, EndIterator)
+{
+	(*map)[1] = 1;
+	auto it = map->end();
+	EXPECT_THROW(++it, std::runtime_error);
+	EXPECT_THROW(it++, std::runtime_error);
+	EXPECT_THROW(*it, std::runtime_error);
+	EXPECT_EQ(it, map->end());
+}
+
 TEST_F(MapTest, Insert)
 {
 	size_type i;
@@ -148,4 +161,396 @@ TEST_F(MapTest, Clear)
 		EXPECT_EQ(map->begin(), map->end());
 		EXPECT_EQ(allocator->count(), initial_allocated);
 	}
-}
\ No newline at end of file
+}
+TEST_F(MapTest, EraseByKey)
+{
+	for (int i = 0; i < 1000; ++i)
+		(*map)[i] = i;
+	for (int i = 0; i < 1000; i += 2)
+		EXPECT_EQ(map->erase(i), 1U);
+	EXPECT_EQ(map->erase(0), 0U);
+	EXPECT_EQ(map->size(), 500U);
+	EXPECT_EQ(allocator->count(), initial_allocated + 500U);
+	for (int i = 0; i < 1000; ++i)
+		EXPECT_EQ(map->find(i) != map->end(), (i % 2) == 1);
+}
+
+TEST_F(MapTest, Compare)
+{
+	struct greater {
+		bool operator ()(int lhs, int rhs) const { return lhs > rhs; }
+	};
+	nostd::map<int, int, greater> reversed(allocator);
+	for (int i = 0; i < 10; ++i)
+		reversed[i] = i;
+	int expected = 9;
+	for (auto it = reversed.begin(); it != reversed.end(); ++it)
+		EXPECT_EQ((*it).first, expected--);
+	EXPECT_EQ(reversed.erase(5), 1U);
+	EXPECT_EQ(reversed.find(5), reversed.end());
+}
+
+TEST_F(MapTest, HeterogeneousLookup)
+{
+	nostd::map<std::string, int, nostd::less<>> strings(allocator);
+	strings["alpha"] = 1;
+	strings["beta"] = 2;
+	auto it = strings.find("beta");
+	ASSERT_NE(it, strings.end());
+	EXPECT_EQ((*it).second, 2);
+	EXPECT_EQ(strings.find("gamma"), strings.end());
+}
+
+TEST_F(MapTest, Bounds)
+{
+	for (int i = 0; i < 100; i += 10)
+		(*map)[i] = i;
+	EXPECT_EQ((*map->lower_bound(20)).first, 20);
+	EXPECT_EQ((*map->lower_bound(21)).first, 30);
+	EXPECT_EQ((*map->upper_bound(20)).first, 30);
+	EXPECT_EQ(map->lower_bound(91), map->end());
+	EXPECT_EQ(map->upper_bound(90), map->end());
+	EXPECT_EQ(map->lower_bound(-5), map->begin());
+
+	auto range = map->equal_range(40);
+	EXPECT_EQ((*range.first).first, 40);
+	EXPECT_EQ((*range.second).first, 50);
+	range = map->equal_range(45);
+	EXPECT_EQ(range.first, range.second);
+}
+
+TEST_F(MapTest, EraseRange)
+{
+	for (int i = 0; i < 100; ++i)
+		(*map)[i] = i;
+	auto it = map->erase(map->lower_bound(10), map->lower_bound(90));
+	EXPECT_EQ((*it).first, 90);
+	EXPECT_EQ(map->size(), 20U);
+	EXPECT_EQ(allocator->count(), initial_allocated + 20U);
+	int expected = 0;
+	for (it = map->begin(); it != map->end(); ++it)
+	{
+		EXPECT_EQ((*it).first, expected);
+		expected = (expected == 9) ? 90 : expected + 1;
+	}
+	map->erase(map->begin(), map->end());
+	EXPECT_EQ(map->empty(), true);
+}
+
+TEST_F(MapTest, HintedInsert)
+{
+	// Sorted input with end hint and with previous result as hint
+	for (int i = 0; i < 100; i += 2)
+		map->insert(map->end(), pair_type(i, i));
+	auto hint = map->begin();
+	for (int i = 1; i < 100; i += 2)
+		hint = map->insert(hint, pair_type(i, i));
+	// Wrong hint and existing key
+	map->insert(map->begin(), pair_type(200, 200));
+	auto it = map->insert(map->end(), pair_type(50, -1));
+	EXPECT_EQ((*it).second, 50);
+
+	EXPECT_EQ(map->size(), 101U);
+	int expected = 0;
+	for (it = map->begin(); it != map->end(); ++it)
+	{
+		EXPECT_EQ((*it).first, expected);
+		expected = (expected == 99) ? 200 : expected + 1;
+	}
+	for (int i = 0; i < 100; ++i)
+		EXPECT_NE(map->find(i), map->end());
+}
+
+namespace {
+
+	/**
+	 * Counts comparisons of keys.
+	 */
+	struct CountingLess {
+		int * count;
+
+		bool operator ()(int a, int b) const
+		{
+			++*count;
+			return a < b;
+		}
+	};
+
+} // namespace
+
+TEST_F(MapTest, HintedInsertComparisons)
+{
+	// Sorted run with end hint and with previous result as hint does a constant number of comparisons per insert
+	int count = 0;
+	typedef nostd::map<int, int, CountingLess> CountingMap;
+	CountingMap counting(CountingLess{&count}, allocator);
+	for (int i = 0; i < 1000; ++i)
+		counting.insert(counting.end(), CountingMap::pair_type(i, i));
+	EXPECT_EQ(count, 999);
+	count = 0;
+	CountingMap::iterator hint = counting.end();
+	for (int i = 1000; i < 2000; ++i)
+		hint = counting.insert(hint, CountingMap::pair_type(i, i));
+	EXPECT_LE(count, 2 * 1000);
+	// Descending run with begin hint
+	count = 0;
+	for (int i = -1; i >= -1000; --i)
+		counting.insert(counting.begin(), CountingMap::pair_type(i, i));
+	EXPECT_EQ(count, 1000);
+	EXPECT_EQ((*counting.begin()).first, -1000);
+	// Bounds follow erasure, copy and move
+	counting.erase(counting.find(1999));
+	counting.erase(counting.find(-1000));
+	EXPECT_EQ((*counting.begin()).first, -999);
+	CountingMap copy(counting);
+	CountingMap moved(nostd::utility::move(copy));
+	count = 0;
+	moved.insert(moved.end(), CountingMap::pair_type(1999, 0));
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ((*moved.begin()).first, -999);
+	EXPECT_EQ(moved.size(), 2999U);
+}
+
+TEST_F(MapTest, FromSorted)
+{
+	pair_type values[100];
+	for (int i = 0; i < 100; ++i)
+		values[i] = pair_type(i * 3, i);
+	Map sorted = Map::from_sorted(values, values + 100, allocator);
+	EXPECT_EQ(sorted.size(), 100U);
+	EXPECT_EQ(allocator->count(), initial_allocated * 2U + 100U);
+	int expected = 0;
+	for (auto it = sorted.begin(); it != sorted.end(); ++it)
+	{
+		EXPECT_EQ((*it).first, expected * 3);
+		++expected;
+	}
+	EXPECT_EQ((*sorted.find(150)).second, 50);
+	// Tree stays valid for further modifications
+	sorted[1] = 1;
+	EXPECT_EQ(sorted.erase(0), 1U);
+	EXPECT_EQ(sorted.size(), 100U);
+	EXPECT_EQ((*sorted.begin()).first, 1);
+}
+
+TEST_F(MapTest, Copy)
+{
+	for (int i = 0; i < 100; ++i)
+		(*map)[i] = i * i;
+	Map copy(*map);
+	EXPECT_EQ(copy.size(), 100U);
+	EXPECT_EQ(allocator->count(), initial_allocated * 2U + 200U);
+	int expected = 0;
+	for (auto it = copy.begin(); it != copy.end(); ++it)
+	{
+		EXPECT_EQ((*it).first, expected);
+		EXPECT_EQ((*it).second, expected * expected);
+		++expected;
+	}
+	copy.erase(50);
+	copy = *map;
+	EXPECT_EQ(copy.size(), 100U);
+	copy = copy;
+	EXPECT_EQ(copy.size(), 100U);
+}
+
+TEST_F(MapTest, EmptyDoesNotAllocate)
+{
+	EXPECT_EQ(allocator->count(), 0U);
+	{
+		Map other(allocator);
+		Map moved(nostd::utility::move(other));
+		Map copy(moved);
+		EXPECT_EQ(copy.begin(), copy.end());
+		EXPECT_EQ(copy.find(1), copy.end());
+		EXPECT_EQ(copy.erase(1), 0U);
+	}
+	EXPECT_EQ(allocator->count(), 0U);
+	// Only elements allocate nodes
+	map->insert(pair_type(1, 1));
+	EXPECT_EQ(allocator->count(), 1U);
+	map->erase(1);
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(MapTest, MoveKeepsNodes)
+{
+	for (int i = 0; i < 100; ++i)
+		map->insert(pair_type(i, i));
+	const size_type nodes = allocator->count();
+	Map moved(nostd::utility::move(*map));
+	EXPECT_EQ(allocator->count(), nodes);
+	EXPECT_EQ(moved.size(), 100U);
+	EXPECT_EQ(map->empty(), true);
+	// Moved from map stays usable
+	map->insert(pair_type(5, 5));
+	EXPECT_EQ(map->size(), 1U);
+	map->swap(moved);
+	EXPECT_EQ(map->size(), 100U);
+	EXPECT_EQ(moved.size(), 1U);
+	int i = 0;
+	for (auto it = map->begin(); it != map->end(); ++it, ++i)
+		EXPECT_EQ((*it).first, i);
+	EXPECT_EQ(i, 100);
+	*map = nostd::utility::move(moved);
+	EXPECT_EQ(map->size(), 1U);
+	EXPECT_EQ((*map->begin()).first, 5);
+}
+
+TEST_F(MapTest, ExtractInsert)
+{
+	for (int i = 0; i < 10; ++i)
+		map->insert(pair_type(i, i * 10));
+	const size_type nodes = allocator->count();
+	Map::node_type node = map->extract(3);
+	EXPECT_EQ(node.empty(), false);
+	EXPECT_EQ(node.value().first, 3);
+	EXPECT_EQ(map->size(), 9U);
+	EXPECT_EQ(map->find(3), map->end());
+	EXPECT_EQ(allocator->count(), nodes);
+	EXPECT_EQ(map->extract(42).empty(), true);
+	// Key may be changed while node is out of the tree
+	node.value().first = 30;
+	Map::insert_return_type result = map->insert(nostd::utility::move(node));
+	EXPECT_EQ(result.inserted, true);
+	EXPECT_EQ(result.node.empty(), true);
+	EXPECT_EQ((*result.position).first, 30);
+	EXPECT_EQ(map->size(), 10U);
+	EXPECT_EQ(allocator->count(), nodes);
+	// Insertion of existing key gives the handle back
+	node = map->extract(map->find(5));
+	node.value().first = 1;
+	result = map->insert(nostd::utility::move(node));
+	EXPECT_EQ(result.inserted, false);
+	EXPECT_EQ(result.node.empty(), false);
+	EXPECT_EQ((*result.position).second, 10);
+	EXPECT_EQ(map->size(), 9U);
+	result.node = Map::node_type();
+	EXPECT_EQ(allocator->count(), nodes - 1U);
+}
+
+TEST_F(MapTest, Merge)
+{
+	Map other(allocator);
+	for (int i = 0; i < 10; ++i)
+	{
+		map->insert(pair_type(i * 2, i));
+		other.insert(pair_type(i * 3, -i));
+	}
+	const size_type nodes = allocator->count();
+	map->merge(other);
+	// Duplicate keys stay in the source
+	EXPECT_EQ(map->size(), 16U);
+	EXPECT_EQ(other.size(), 4U);
+	EXPECT_EQ(allocator->count(), nodes);
+	for (auto it = other.begin(); it != other.end(); ++it)
+		EXPECT_EQ((*it).first % 6, 0);
+	int prev = -1;
+	for (auto it = map->begin(); it != map->end(); ++it)
+	{
+		EXPECT_LT(prev, (*it).first);
+		prev = (*it).first;
+	}
+	EXPECT_EQ((*map->find(9)).second, -3);
+	// Nodes of different allocator are allocated again
+	Allocator foreign;
+	{
+		Map source(&foreign);
+		source.insert(pair_type(100, 1));
+		source.insert(pair_type(0, 1));
+		map->merge(source);
+		EXPECT_EQ(source.size(), 1U);
+		EXPECT_EQ(foreign.count(), 1U);
+		EXPECT_EQ(map->size(), 17U);
+		EXPECT_EQ(allocator->count(), nodes + 1U);
+		// The same goes for inserted handle
+		auto result = map->insert(source.extract(0));
+		EXPECT_EQ(result.inserted, false);
+		source.insert(pair_type(200, 1));
+		result = map->insert(source.extract(source.begin()));
+		EXPECT_EQ(result.inserted, true);
+		EXPECT_EQ(map->size(), 18U);
+		EXPECT_EQ(foreign.count(), 0U);
+	}
+	EXPECT_EQ(foreign.count(), 0U);
+}
+
+namespace {
+
+	/**
+	 * Value that counts its constructions.
+	 */
+	struct Heavy {
+		static int constructions;
+		static int copies;
+		int value;
+
+		Heavy() : value(0) { ++constructions; }
+		Heavy(int a, int b) : value(a + b) { ++constructions; }
+		Heavy(const Heavy& other) : value(other.value) { ++copies; }
+		Heavy(Heavy&& other) : value(other.value) { ++copies; }
+		Heavy& operator =(const Heavy& other) { value = other.value; ++copies; return *this; }
+	};
+	int Heavy::constructions = 0;
+	int Heavy::copies = 0;
+
+} // namespace
+
+TEST_F(MapTest, Emplace)
+{
+	typedef nostd::map<int, Heavy> HeavyMap;
+	HeavyMap heavy(allocator);
+	// Value is constructed right in the node
+	auto result = heavy.try_emplace(1, 2, 3);
+	EXPECT_EQ(result.second, true);
+	EXPECT_EQ((*result.first).second.value, 5);
+	// Nothing is constructed for existing key
+	result = heavy.try_emplace(1, 10, 10);
+	EXPECT_EQ(result.second, false);
+	EXPECT_EQ((*result.first).second.value, 5);
+	EXPECT_EQ(heavy[2].value, 0);
+	EXPECT_EQ(heavy[1].value, 5);
+	EXPECT_EQ(Heavy::constructions, 2);
+	EXPECT_EQ(Heavy::copies, 0);
+	EXPECT_EQ(heavy.size(), 2U);
+
+	EXPECT_EQ(map->emplace(1, 10).second, true);
+	EXPECT_EQ(map->emplace(1, 20).second, false);
+	EXPECT_EQ((*map->emplace_hint(map->end(), 2, 20)).first, 2);
+	EXPECT_EQ((*map->emplace_hint(map->begin(), 0, 0)).first, 0);
+	EXPECT_EQ(map->size(), 3U);
+	EXPECT_EQ((*map)[1], 10);
+	EXPECT_EQ(allocator->count(), 5U);
+
+	nostd::map<std::string, std::string> strings(allocator);
+	std::string key("long enough key to be allocated on the heap");
+	strings.try_emplace(nostd::utility::move(key), 3U, 'x');
+	EXPECT_EQ(strings.size(), 1U);
+	EXPECT_EQ((*strings.begin()).second, "xxx");
+	strings["key"] = "value";
+	EXPECT_EQ(strings["key"], "value");
+}
+
+TEST_F(MapTest, StaticAllocator)
+{
+	// Allocator type is known at compile time
+	typedef nostd::map<int, int, nostd::less<int>, Allocator> StaticMap;
+	static_assert(std::is_same<decltype(StaticMap::node_type().get_allocator()), Allocator*>::value, "Allocator type is kept");
+	{
+		StaticMap typed(allocator);
+		for (int i = 0; i < 10; ++i)
+			typed.emplace(i, i * i);
+		EXPECT_EQ(allocator->count(), initial_allocated + 10U);
+		StaticMap copy(typed);
+		EXPECT_EQ(copy.size(), 10U);
+		EXPECT_EQ((*copy.find(3)).second, 9);
+		EXPECT_EQ(allocator->count(), initial_allocated + 20U);
+		// Node moves between containers of the same type
+		StaticMap::node_type node = typed.extract(5);
+		EXPECT_EQ(node.get_allocator(), allocator);
+		copy.erase(5);
+		EXPECT_EQ(copy.insert(nostd::utility::move(node)).inserted, true);
+		EXPECT_EQ((*copy.find(5)).second, 25);
+	}
+	EXPECT_EQ(allocator->count(), initial_allocated);
+}
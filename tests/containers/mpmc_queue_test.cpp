@@ -0,0 +1,114 @@
+#include <nostd/mpmc_queue.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+class MpmcQueueTest : public testing::Test {
+public:
+	typedef nostd::mpmc_queue<int> Queue;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+
+protected:
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		queue = new Queue(100U, allocator);
+	}
+	void TearDown() override
+	{
+		delete queue;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Queue * queue;
+};
+
+TEST_F(MpmcQueueTest, Creation)
+{
+	EXPECT_EQ(queue->empty(), true);
+	EXPECT_EQ(queue->capacity(), 128U);
+	EXPECT_EQ(allocator->count(), 1U);
+	int value;
+	EXPECT_EQ(queue->try_pop(value), false);
+}
+
+TEST_F(MpmcQueueTest, PushPop)
+{
+	// Several laps over the ring
+	for (int lap = 0; lap < 5; ++lap)
+	{
+		for (int i = 0; i < 128; ++i)
+			EXPECT_EQ(queue->try_push(lap * 1000 + i), true);
+		EXPECT_EQ(queue->try_push(-1), false);
+		EXPECT_EQ(queue->size(), 128U);
+		for (int i = 0; i < 128; ++i)
+		{
+			int value = -1;
+			EXPECT_EQ(queue->try_pop(value), true);
+			EXPECT_EQ(value, lap * 1000 + i);
+		}
+		EXPECT_EQ(queue->empty(), true);
+	}
+}
+
+TEST_F(MpmcQueueTest, NonTrivial)
+{
+	nostd::mpmc_queue<std::string> strings(4U, allocator);
+	EXPECT_EQ(strings.try_emplace(3U, 'a'), true);
+	EXPECT_EQ(strings.try_push(std::string("long enough string to be allocated on the heap")), true);
+	std::string value;
+	EXPECT_EQ(strings.try_pop(value), true);
+	EXPECT_EQ(value, "aaa");
+	// Remaining element is destroyed with the queue
+	EXPECT_EQ(strings.try_push(value), true);
+}
+
+TEST_F(MpmcQueueTest, MultipleThreads)
+{
+	const int kNumProducers = 4;
+	const int kNumConsumers = 4;
+	const int kNumItems = 20000;
+	std::atomic<long long> sum(0);
+	std::atomic<int> popped(0);
+	std::thread producers[kNumProducers];
+	std::thread consumers[kNumConsumers];
+	for (int t = 0; t < kNumProducers; ++t)
+	{
+		producers[t] = std::thread([this, t]() {
+			for (int i = 1; i <= kNumItems; ++i)
+				while (!queue->try_push(t * kNumItems + i))
+					std::this_thread::yield();
+		});
+	}
+	for (int t = 0; t < kNumConsumers; ++t)
+	{
+		consumers[t] = std::thread([this, &sum, &popped]() {
+			int value;
+			while (popped.load() < kNumProducers * kNumItems)
+			{
+				if (queue->try_pop(value))
+				{
+					sum += value;
+					++popped;
+				}
+				else
+					std::this_thread::yield();
+			}
+		});
+	}
+	for (int t = 0; t < kNumProducers; ++t)
+		producers[t].join();
+	for (int t = 0; t < kNumConsumers; ++t)
+		consumers[t].join();
+	const long long n = static_cast<long long>(kNumProducers) * kNumItems;
+	EXPECT_EQ(popped.load(), n);
+	EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+	EXPECT_EQ(queue->empty(), true);
+}
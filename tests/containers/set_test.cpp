@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 class SetTest : public testing::Test {
 public:
 	typedef nostd::set<int> Set;
@@ -32,6 +34,16 @@ TEST_F(SetTest, Creation)
 	EXPECT_EQ(set->begin(), set->end());
 }
 
+TEST_F(SetTest, EndIterator)
+{
+	set->insert(1);
+	auto it = set->end();
+	EXPECT_THROW(++it, std::runtime_error);
+	EXPECT_THROW(it++, std::runtime_error);
+	EXPECT_THROW(*it, std::runtime_error);
+	EXPECT_EQ(it, set->end());
+}
+
 TEST_F(SetTest, Insert)
 {
 	size_type i;
@@ -138,4 +150,164 @@ TEST_F(SetTest, Clear)
 		EXPECT_EQ(set->begin(), set->end());
 		EXPECT_EQ(allocator->count(), initial_allocated);
 	}
-}
\ No newline at end of file
+}
+TEST_F(SetTest, EraseByValue)
+{
+	for (int i = 0; i < 1000; ++i)
+		set->insert(i);
+	for (int i = 0; i < 1000; i += 2)
+		EXPECT_EQ(set->erase(i), 1U);
+	EXPECT_EQ(set->erase(0), 0U);
+	EXPECT_EQ(set->size(), 500U);
+	EXPECT_EQ(allocator->count(), initial_allocated + 500U);
+	for (int i = 0; i < 1000; ++i)
+		EXPECT_EQ(set->find(i) != set->end(), (i % 2) == 1);
+}
+
+TEST_F(SetTest, HeterogeneousLookup)
+{
+	nostd::set<std::string, nostd::less<>> strings(allocator);
+	strings.insert(std::string("alpha"));
+	strings.insert(std::string("beta"));
+	EXPECT_NE(strings.find("alpha"), strings.end());
+	EXPECT_EQ(strings.find("gamma"), strings.end());
+}
+
+TEST_F(SetTest, Bounds)
+{
+	for (int i = 0; i < 100; i += 10)
+		set->insert(i);
+	EXPECT_EQ(*set->lower_bound(20), 20);
+	EXPECT_EQ(*set->lower_bound(21), 30);
+	EXPECT_EQ(*set->upper_bound(20), 30);
+	EXPECT_EQ(set->upper_bound(90), set->end());
+	auto range = set->equal_range(40);
+	EXPECT_EQ(*range.first, 40);
+	EXPECT_EQ(*range.second, 50);
+}
+
+TEST_F(SetTest, EraseRangeAndHint)
+{
+	auto hint = set->end();
+	for (int i = 0; i < 100; ++i)
+		hint = set->insert(hint, i);
+	EXPECT_EQ(set->size(), 100U);
+	set->erase(set->lower_bound(50), set->end());
+	EXPECT_EQ(set->size(), 50U);
+	EXPECT_EQ(allocator->count(), initial_allocated + 50U);
+	int expected = 0;
+	for (auto it = set->begin(); it != set->end(); ++it)
+		EXPECT_EQ(*it, expected++);
+	EXPECT_EQ(expected, 50);
+}
+
+TEST_F(SetTest, HintedInsertComparisons)
+{
+	// Previous result as hint doesn't search the tree
+	int count = 0;
+	auto less = [&count](int a, int b) {
+		++count;
+		return a < b;
+	};
+	nostd::set<int, decltype(less)> counting(less, allocator);
+	auto hint = counting.end();
+	for (int i = 0; i < 1000; ++i)
+		hint = counting.insert(hint, i);
+	EXPECT_LE(count, 2 * 1000);
+	count = 0;
+	counting.insert(counting.end(), 1000);
+	EXPECT_EQ(count, 1);
+	counting.clear();
+	counting.insert(counting.end(), 5);
+	EXPECT_EQ(*counting.begin(), 5);
+}
+
+TEST_F(SetTest, FromSortedAndCopy)
+{
+	int values[50];
+	for (int i = 0; i < 50; ++i)
+		values[i] = i;
+	Set sorted = Set::from_sorted(values, values + 50, allocator);
+	Set copy(sorted);
+	EXPECT_EQ(copy.size(), 50U);
+	int expected = 0;
+	for (auto it = copy.begin(); it != copy.end(); ++it)
+		EXPECT_EQ(*it, expected++);
+	EXPECT_EQ(expected, 50);
+	copy.insert(100);
+	EXPECT_NE(copy.find(100), copy.end());
+	EXPECT_EQ(sorted.find(100), sorted.end());
+}
+
+TEST_F(SetTest, EmptyDoesNotAllocate)
+{
+	EXPECT_EQ(allocator->count(), 0U);
+	{
+		Set other(allocator);
+		Set moved(nostd::utility::move(other));
+		moved.insert(1);
+		Set copy(moved);
+		EXPECT_EQ(allocator->count(), 2U);
+	}
+	EXPECT_EQ(allocator->count(), 0U);
+}
+
+TEST_F(SetTest, ExtractMerge)
+{
+	Set other(allocator);
+	for (int i = 0; i < 10; ++i)
+	{
+		set->insert(i);
+		other.insert(i + 5);
+	}
+	const size_type nodes = allocator->count();
+	Set::node_type node = set->extract(set->find(0));
+	EXPECT_EQ(node.value(), 0);
+	node.value() = 20;
+	EXPECT_EQ(set->insert(nostd::utility::move(node)).inserted, true);
+	EXPECT_NE(set->find(20), set->end());
+	EXPECT_EQ(set->find(0), set->end());
+	set->merge(other);
+	EXPECT_EQ(set->size(), 15U);
+	EXPECT_EQ(other.size(), 5U);
+	EXPECT_EQ(allocator->count(), nodes);
+	int prev = 0;
+	for (auto it = set->begin(); it != set->end(); ++it)
+	{
+		EXPECT_LT(prev, *it);
+		prev = *it;
+	}
+}
+
+TEST_F(SetTest, Emplace)
+{
+	EXPECT_EQ(set->emplace(5).second, true);
+	EXPECT_EQ(set->emplace(5).second, false);
+	EXPECT_EQ(*set->emplace_hint(set->end(), 7), 7);
+	EXPECT_EQ(*set->emplace_hint(set->begin(), 1), 1);
+	EXPECT_EQ(set->size(), 3U);
+	EXPECT_EQ(allocator->count(), 3U);
+
+	nostd::set<std::string> strings(allocator);
+	EXPECT_EQ(*strings.emplace(3U, 'z').first, "zzz");
+	EXPECT_EQ(strings.emplace("zzz").second, false);
+	EXPECT_EQ(strings.size(), 1U);
+}
+
+TEST_F(SetTest, StaticAllocator)
+{
+	// Allocator type is known at compile time
+	typedef nostd::set<int, nostd::less<int>, Allocator> StaticSet;
+	{
+		int values[] = {1, 2, 3, 4, 5};
+		StaticSet typed = StaticSet::from_sorted(values, values + 5, allocator);
+		EXPECT_EQ(typed.size(), 5U);
+		EXPECT_EQ(allocator->count(), initial_allocated + 5U);
+		typed.insert(0);
+		EXPECT_EQ(*typed.begin(), 0);
+		typed.clear();
+		EXPECT_EQ(allocator->count(), initial_allocated);
+		typed.insert(7);
+	}
+	EXPECT_EQ(allocator->count(), initial_allocated);
+}
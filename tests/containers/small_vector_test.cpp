@@ -0,0 +1,94 @@
+#include <nostd/small_vector.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+class SmallVectorTest : public testing::Test {
+public:
+	typedef nostd::small_vector<int, 8U> Vector;
+
+	using size_type = Vector::size_type;
+protected:
+	void TearDown() override
+	{
+		EXPECT_EQ(allocator.count(), 0U);
+	}
+	nostd::test_allocator allocator;
+};
+
+TEST_F(SmallVectorTest, Creation)
+{
+	Vector array(&allocator);
+	EXPECT_EQ(array.empty(), true);
+	EXPECT_EQ(array.capacity(), Vector::inline_capacity);
+	EXPECT_EQ(array.is_inline(), true);
+}
+
+TEST_F(SmallVectorTest, Inline)
+{
+	Vector array(&allocator);
+	for (int i = 0; i < 8; ++i)
+		array.push_back(i);
+	EXPECT_EQ(allocator.count(), 0U);
+	EXPECT_EQ(array.is_inline(), true);
+	array.pop_back();
+	EXPECT_EQ(array.size(), 7U);
+	EXPECT_EQ(array.back(), 6);
+}
+
+TEST_F(SmallVectorTest, Spill)
+{
+	Vector array(&allocator);
+	for (int i = 0; i < 100; ++i)
+		array.push_back(i);
+	EXPECT_EQ(array.is_inline(), false);
+	EXPECT_EQ(allocator.count(), 1U);
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(array[i], i);
+}
+
+TEST_F(SmallVectorTest, CopyAndMove)
+{
+	Vector small(&allocator);
+	Vector large(&allocator);
+	for (int i = 0; i < 4; ++i)
+		small.push_back(i);
+	for (int i = 0; i < 20; ++i)
+		large.push_back(i);
+
+	Vector copy(small);
+	EXPECT_EQ(copy.is_inline(), true);
+	EXPECT_EQ(copy.size(), 4U);
+
+	const int * data = large.data();
+	Vector moved(nostd::utility::move(large));
+	// Out of line buffer is taken as is
+	EXPECT_EQ(moved.data(), data);
+	EXPECT_EQ(moved.size(), 20U);
+	EXPECT_EQ(large.empty(), true);
+	EXPECT_EQ(large.is_inline(), true);
+
+	copy = moved;
+	EXPECT_EQ(copy.size(), 20U);
+	EXPECT_EQ(copy[19], 19);
+	moved.swap(small);
+	EXPECT_EQ(moved.size(), 4U);
+	EXPECT_EQ(small.size(), 20U);
+	EXPECT_EQ(small.data(), data);
+}
+
+TEST_F(SmallVectorTest, NonTrivial)
+{
+	nostd::small_vector<std::string, 2U> array(&allocator);
+	array.emplace_back("first");
+	array.emplace_back(3U, 'a');
+	array.push_back(std::string(100U, 'b'));
+	EXPECT_EQ(array.is_inline(), false);
+	EXPECT_EQ(array[0], "first");
+	EXPECT_EQ(array[1], "aaa");
+	EXPECT_EQ(array[2].size(), 100U);
+	nostd::small_vector<std::string, 2U> moved(nostd::utility::move(array));
+	EXPECT_EQ(moved[0], "first");
+}
@@ -0,0 +1,194 @@
+#include <nostd/snapshot.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+	struct Record {
+		std::int32_t id;
+		double weight;
+	};
+
+} // namespace
+
+class SnapshotTest : public testing::Test {
+protected:
+	void SetUp() override
+	{
+		const testing::TestInfo * info = testing::UnitTest::GetInstance()->current_test_info();
+		path = testing::TempDir() + "nostd_snapshot_" + info->name() + ".bin";
+	}
+	void TearDown() override
+	{
+		std::remove(path.c_str());
+	}
+	void Corrupt(long offset)
+	{
+		std::FILE * file = std::fopen(path.c_str(), "r+b");
+		ASSERT_NE(file, nullptr);
+		std::fseek(file, offset, SEEK_SET);
+		int byte = std::fgetc(file);
+		std::fseek(file, offset, SEEK_SET);
+		std::fputc(byte ^ 0xff, file);
+		std::fclose(file);
+	}
+	std::string path;
+};
+
+TEST_F(SnapshotTest, Vector)
+{
+	nostd::vector<Record> records;
+	for (int i = 0; i < 1000; ++i)
+		records.push_back(Record{i, i * 0.5});
+	nostd::save_snapshot(path.c_str(), records);
+
+	nostd::snapshot snapshot(path.c_str());
+	EXPECT_EQ(snapshot.kind(), nostd::snapshot_kind::vector);
+	EXPECT_EQ(snapshot.size(), 1000U);
+	nostd::vector_view<Record> view = snapshot.as_vector<Record>();
+	ASSERT_EQ(view.size(), 1000U);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(view.data()) % alignof(Record), 0U);
+	int expected = 0;
+	for (const Record& record : view)
+	{
+		EXPECT_EQ(record.id, expected);
+		EXPECT_EQ(record.weight, expected * 0.5);
+		++expected;
+	}
+	EXPECT_EQ(view.at(999).id, 999);
+	EXPECT_THROW(view.at(1000), std::range_error);
+}
+
+TEST_F(SnapshotTest, Empty)
+{
+	nostd::vector<int> array;
+	nostd::save_snapshot(path.c_str(), array);
+	nostd::snapshot snapshot(path.c_str());
+	EXPECT_EQ(snapshot.as_vector<int>().empty(), true);
+
+	nostd::flat_hash_map<int, int> map;
+	nostd::save_snapshot(path.c_str(), map);
+	nostd::snapshot map_snapshot(path.c_str());
+	nostd::hash_map_view<int, int> view = map_snapshot.as_hash_map<int, int>();
+	EXPECT_EQ(view.empty(), true);
+	EXPECT_EQ(view.find(1), nullptr);
+}
+
+TEST_F(SnapshotTest, FlatMap)
+{
+	nostd::flat_map<int, Record> map;
+	for (int i = 0; i < 500; ++i)
+		map[i * 3] = Record{i, i * 2.0};
+	nostd::save_snapshot(path.c_str(), map);
+
+	nostd::snapshot snapshot(path.c_str());
+	nostd::flat_map_view<int, Record> view = snapshot.as_flat_map<int, Record>();
+	ASSERT_EQ(view.size(), 500U);
+	for (int key = -1; key < 1502; ++key)
+	{
+		const Record * record = view.find(key);
+		if (key >= 0 && key < 1500 && key % 3 == 0)
+		{
+			ASSERT_NE(record, nullptr);
+			EXPECT_EQ(record->id, key / 3);
+		}
+		else
+			EXPECT_EQ(record, nullptr);
+	}
+	EXPECT_EQ(view.keys()[0], 0);
+	EXPECT_EQ(view.keys()[499], 1497);
+	EXPECT_EQ(view.values()[499].weight, 998.0);
+}
+
+TEST_F(SnapshotTest, HashMap)
+{
+	nostd::flat_hash_map<std::uint64_t, int> map;
+	for (int i = 0; i < 2000; ++i)
+		map[static_cast<std::uint64_t>(i) * 7919U] = i;
+	nostd::save_snapshot(path.c_str(), map);
+
+	nostd::snapshot snapshot(path.c_str(), false);
+	EXPECT_EQ(snapshot.verify(), true);
+	nostd::hash_map_view<std::uint64_t, int> view = snapshot.as_hash_map<std::uint64_t, int>();
+	ASSERT_EQ(view.size(), 2000U);
+	for (int i = 0; i < 2000; ++i)
+	{
+		const int * value = view.find(static_cast<std::uint64_t>(i) * 7919U);
+		ASSERT_NE(value, nullptr);
+		EXPECT_EQ(*value, i);
+		EXPECT_EQ(view.contains(static_cast<std::uint64_t>(i) * 7919U + 1U), false);
+	}
+}
+
+TEST_F(SnapshotTest, TypeMismatch)
+{
+	nostd::vector<int> array;
+	array.push_back(1);
+	nostd::save_snapshot(path.c_str(), array);
+	nostd::snapshot snapshot(path.c_str());
+	EXPECT_THROW(snapshot.as_vector<double>(), std::runtime_error);
+	EXPECT_THROW((snapshot.as_flat_map<int, int>()), std::runtime_error);
+	EXPECT_EQ(snapshot.as_vector<unsigned int>()[0], 1U);
+}
+
+TEST_F(SnapshotTest, Corruption)
+{
+	nostd::vector<int> array;
+	for (int i = 0; i < 100; ++i)
+		array.push_back(i);
+	nostd::save_snapshot(path.c_str(), array);
+
+	// Payload damage is found by checksum
+	Corrupt(static_cast<long>(nostd::snapshot_detail::section_alignment * 2U + 5U));
+	EXPECT_THROW(nostd::snapshot(path.c_str(), true), std::runtime_error);
+	{
+		nostd::snapshot unverified(path.c_str());
+		EXPECT_EQ(unverified.verify(), false);
+	}
+	// Header damage is found on open
+	Corrupt(static_cast<long>(nostd::snapshot_detail::section_alignment * 2U + 5U));
+	Corrupt(0);
+	EXPECT_THROW(nostd::snapshot(path.c_str(), false), std::runtime_error);
+	EXPECT_THROW(nostd::snapshot((path + ".missing").c_str()), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, HashIndexCorruption)
+{
+	nostd::flat_hash_map<int, int> map;
+	for (int i = 0; i < 100; ++i)
+		map[i] = i;
+	nostd::save_snapshot(path.c_str(), map);
+	nostd::snapshot_detail::header_t header;
+	std::FILE * file = std::fopen(path.c_str(), "r+b");
+	ASSERT_NE(file, nullptr);
+	ASSERT_EQ(std::fread(&header, sizeof(header), 1U, file), 1U);
+	const long offset = static_cast<long>(header.sections[2].offset);
+	const std::uint64_t slots = header.sections[2].size / sizeof(std::uint32_t);
+	std::uint32_t entry = 0U;
+	long free_slot = -1;
+	for (std::uint64_t i = 0U; i < slots && free_slot < 0; ++i)
+	{
+		std::fseek(file, offset + static_cast<long>(i * sizeof(entry)), SEEK_SET);
+		ASSERT_EQ(std::fread(&entry, sizeof(entry), 1U, file), 1U);
+		if (entry == 0U)
+			free_slot = offset + static_cast<long>(i * sizeof(entry));
+	}
+	ASSERT_GE(free_slot, 0);
+	// Entry referring to a key past the end is found without verification
+	entry = 1000U;
+	std::fseek(file, free_slot, SEEK_SET);
+	std::fwrite(&entry, sizeof(entry), 1U, file);
+	std::fflush(file);
+	EXPECT_THROW(nostd::snapshot(path.c_str(), false), std::runtime_error);
+	// So is an extra entry, table without free slots would never stop probing
+	entry = 1U;
+	std::fseek(file, free_slot, SEEK_SET);
+	std::fwrite(&entry, sizeof(entry), 1U, file);
+	std::fclose(file);
+	EXPECT_THROW(nostd::snapshot(path.c_str(), false), std::runtime_error);
+}
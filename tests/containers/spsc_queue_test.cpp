@@ -0,0 +1,99 @@
+#include <nostd/spsc_queue.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+class SpscQueueTest : public testing::Test {
+public:
+	typedef nostd::spsc_queue<int> Queue;
+	typedef nostd::test_allocator Allocator;
+
+	using size_type = Allocator::size_type;
+
+protected:
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		queue = new Queue(60U, allocator);
+	}
+	void TearDown() override
+	{
+		delete queue;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Queue * queue;
+};
+
+TEST_F(SpscQueueTest, Creation)
+{
+	EXPECT_EQ(queue->empty(), true);
+	EXPECT_EQ(queue->capacity(), 64U);
+	EXPECT_EQ(queue->front(), nullptr);
+	int value;
+	EXPECT_EQ(queue->try_pop(value), false);
+}
+
+TEST_F(SpscQueueTest, PushPop)
+{
+	for (int lap = 0; lap < 5; ++lap)
+	{
+		for (int i = 0; i < 64; ++i)
+			EXPECT_EQ(queue->try_push(lap * 1000 + i), true);
+		EXPECT_EQ(queue->try_push(-1), false);
+		EXPECT_EQ(queue->size(), 64U);
+		EXPECT_EQ(*queue->front(), lap * 1000);
+		for (int i = 0; i < 64; ++i)
+		{
+			int value = -1;
+			EXPECT_EQ(queue->try_pop(value), true);
+			EXPECT_EQ(value, lap * 1000 + i);
+		}
+		EXPECT_EQ(queue->empty(), true);
+	}
+}
+
+TEST_F(SpscQueueTest, NonTrivial)
+{
+	nostd::spsc_queue<std::string> strings(2U, allocator);
+	EXPECT_EQ(strings.try_emplace(3U, 'b'), true);
+	EXPECT_EQ(strings.try_push(std::string("long enough string to be allocated on the heap")), true);
+	EXPECT_EQ(strings.try_push(std::string()), false);
+	EXPECT_EQ(*strings.front(), "bbb");
+	strings.pop();
+	EXPECT_EQ(strings.front()->size(), 46U);
+}
+
+TEST_F(SpscQueueTest, TwoThreads)
+{
+	const int kNumItems = 100000;
+	long long sum = 0;
+	bool ordered = true;
+	std::thread consumer([this, &sum, &ordered]() {
+		int expected = 1;
+		while (expected <= kNumItems)
+		{
+			int * value = queue->front();
+			if (value == nullptr)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			if (*value != expected)
+				ordered = false;
+			sum += *value;
+			queue->pop();
+			++expected;
+		}
+	});
+	for (int i = 1; i <= kNumItems; ++i)
+		while (!queue->try_push(i))
+			std::this_thread::yield();
+	consumer.join();
+	EXPECT_EQ(ordered, true);
+	EXPECT_EQ(sum, static_cast<long long>(kNumItems) * (kNumItems + 1) / 2);
+}
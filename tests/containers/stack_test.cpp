@@ -1,7 +1,10 @@
 #include <nostd/stack.h>
+#include <nostd/test_allocator.h>
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 class StackTest : public testing::Test {
 	typedef nostd::stack<int> Stack;
 protected:
@@ -58,4 +61,52 @@ TEST_F(StackTest, Clear)
 
 	stack->clear();
 	EXPECT_EQ(stack->size(), 0U);
-}
\ No newline at end of file
+}
+
+TEST(StackEmplaceTest, Emplace)
+{
+	nostd::stack<std::string> stack;
+	stack.emplace(2U, 'b');
+	stack.push(std::string("long enough string to be allocated on the heap"));
+	EXPECT_EQ(stack.size(), 2U);
+	stack.pop();
+	EXPECT_EQ(stack.top(), "bb");
+	stack.clear();
+	EXPECT_EQ(stack.empty(), true);
+}
+
+TEST(StackAllocationTest, BlockAllocation)
+{
+	// Stack stores elements in blocks, so pushes don't allocate per element
+	nostd::test_allocator allocator;
+	{
+		nostd::stack<int> stack(&allocator);
+		for (int i = 0; i < 1000; ++i)
+			stack.push(i);
+		EXPECT_LT(allocator.count(), 10U);
+		nostd::stack<int> copy(stack);
+		for (int i = 999; i >= 0; --i)
+		{
+			EXPECT_EQ(copy.top(), i);
+			copy.pop();
+		}
+		EXPECT_EQ(copy.empty(), true);
+	}
+	EXPECT_EQ(allocator.count(), 0U);
+}
+
+TEST_F(StackTest, StaticAllocator)
+{
+	// Allocator type is passed to the underlying deque
+	nostd::test_allocator allocator;
+	{
+		nostd::stack<int, nostd::test_allocator> typed(&allocator);
+		for (int i = 0; i < 1000; ++i)
+			typed.push(i);
+		EXPECT_NE(allocator.count(), 0U);
+		EXPECT_EQ(typed.top(), 999);
+		typed.pop();
+		EXPECT_EQ(typed.top(), 998);
+	}
+	EXPECT_EQ(allocator.count(), 0U);
+}
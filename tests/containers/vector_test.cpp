@@ -1,7 +1,50 @@
 #include <nostd/vector.h>
+#include <nostd/monotonic_arena.h>
 
 #include <gtest/gtest.h>
 
+#include <string>
+
+namespace {
+
+	/**
+	 * Type with counting move constructor that opts in to relocation
+	 */
+	struct Relocatable {
+		static int moves;
+		int value;
+
+		Relocatable() : value(0) {}
+		Relocatable(int v) : value(v) {}
+		Relocatable(const Relocatable& other) : value(other.value) {}
+		Relocatable(Relocatable&& other) : value(other.value) { ++moves; }
+		Relocatable& operator =(const Relocatable& other) { value = other.value; return *this; }
+		Relocatable& operator =(Relocatable&& other) { value = other.value; return *this; }
+	};
+	int Relocatable::moves = 0;
+
+	struct Record {
+		int key;
+		int data[3];
+	};
+
+	/**
+	 * Type without default constructor
+	 */
+	struct Point {
+		int x;
+		int y;
+
+		Point(int x, int y) : x(x), y(y) {}
+	};
+
+} // namespace
+
+namespace nostd {
+	template <>
+	struct is_trivially_relocatable<Relocatable> : std::true_type {};
+} // namespace nostd
+
 class VectorTest : public testing::Test {
 public:
 	typedef nostd::vector<int> Vector;
@@ -69,4 +112,150 @@ TEST_F(VectorTest, Resize)
 	array->resize(size);
 	EXPECT_EQ(array->size(), size);
 	EXPECT_GE(array->capacity(), size);
-}
\ No newline at end of file
+}
+
+TEST_F(VectorTest, ExpandInPlace)
+{
+	nostd::monotonic_arena arena(1024U);
+	Vector vector(&arena);
+	vector.reserve(4U);
+	int * data = vector.data();
+	for (int i = 0; i < 100; ++i)
+		vector.push_back(i);
+	// The buffer is the last block in arena, so it grows in place
+	EXPECT_EQ(vector.data(), data);
+	EXPECT_EQ(vector.size(), 100U);
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(vector[i], i);
+}
+
+TEST_F(VectorTest, RelocatableGrowth)
+{
+	nostd::vector<Relocatable> vector;
+	Relocatable::moves = 0;
+	for (int i = 0; i < 100; ++i)
+		vector.push_back(Relocatable(i));
+	Relocatable::moves = 0;
+	vector.reserve(1000U);
+	// Growth doesn't call move constructor
+	EXPECT_EQ(Relocatable::moves, 0);
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(vector[i].value, i);
+}
+
+TEST_F(VectorTest, TrivialCopy)
+{
+	nostd::vector<Record> vector;
+	for (int i = 0; i < 50; ++i)
+	{
+		Record record = {i, {i, i + 1, i + 2}};
+		vector.push_back(record);
+	}
+	nostd::vector<Record> copy(vector);
+	EXPECT_EQ(copy.size(), vector.size());
+	for (int i = 0; i < 50; ++i)
+	{
+		EXPECT_EQ(copy[i].key, i);
+		EXPECT_EQ(copy[i].data[2], i + 2);
+	}
+	copy.resize(10U);
+	EXPECT_EQ(copy.size(), 10U);
+	copy.clear();
+	EXPECT_EQ(copy.empty(), true);
+}
+TEST_F(VectorTest, EmplaceBack)
+{
+	nostd::vector<Point> points;
+	for (int i = 0; i < 20; ++i)
+	{
+		Point& point = points.emplace_back(i, -i);
+		EXPECT_EQ(point.x, i);
+	}
+	EXPECT_EQ(points.size(), 20U);
+	EXPECT_EQ(points.back().y, -19);
+	points.pop_back();
+	EXPECT_EQ(points.size(), 19U);
+}
+
+TEST_F(VectorTest, PushBackSelf)
+{
+	array->push_back(42);
+	for (int i = 0; i < 100; ++i)
+		array->push_back((*array)[0]);
+	EXPECT_EQ(array->size(), 101U);
+	for (size_type i = 0U; i < array->size(); ++i)
+		EXPECT_EQ((*array)[i], 42);
+}
+
+TEST_F(VectorTest, Growth)
+{
+	nostd::vector<int, nostd::growth_factor<2U, 1U>> vector;
+	size_type reallocations = 0U;
+	size_type capacity = vector.capacity();
+	for (int i = 0; i < 1000; ++i)
+	{
+		vector.push_back(i);
+		if (vector.capacity() != capacity)
+		{
+			capacity = vector.capacity();
+			++reallocations;
+		}
+	}
+	// 1, 2, 4, ..., 1024
+	EXPECT_EQ(capacity, 1024U);
+	EXPECT_EQ(reallocations, 11U);
+}
+
+TEST_F(VectorTest, InsertAndErase)
+{
+	for (int i = 0; i < 10; ++i)
+		array->push_back(i);
+	auto it = array->insert(array->begin() + 5, 100);
+	EXPECT_EQ(*it, 100);
+	array->insert(array->begin(), (*array)[9]);
+	array->insert(array->end(), -1);
+	const int expected[] = {8, 0, 1, 2, 3, 4, 100, 5, 6, 7, 8, 9, -1};
+	ASSERT_EQ(array->size(), 13U);
+	for (size_type i = 0U; i < array->size(); ++i)
+		EXPECT_EQ((*array)[i], expected[i]);
+	it = array->erase(array->begin() + 6);
+	EXPECT_EQ(*it, 5);
+	it = array->erase(array->begin(), array->begin() + 2);
+	EXPECT_EQ(*it, 1);
+	it = array->erase(array->end() - 1, array->end());
+	EXPECT_EQ(it, array->end());
+	ASSERT_EQ(array->size(), 9U);
+	for (size_type i = 0U; i < array->size(); ++i)
+		EXPECT_EQ((*array)[i], static_cast<int>(i) + 1);
+}
+
+TEST_F(VectorTest, InsertNonTrivial)
+{
+	nostd::vector<std::string> strings;
+	for (int i = 0; i < 8; ++i)
+		strings.push_back(std::to_string(i));
+	strings.emplace(strings.begin() + 3, 20U, 'x');
+	strings.insert(strings.begin() + 1, strings[7]);
+	EXPECT_EQ(strings.size(), 10U);
+	EXPECT_EQ(strings[1], "6");
+	EXPECT_EQ(strings[4], std::string(20U, 'x'));
+	strings.erase(strings.begin() + 1, strings.begin() + 5);
+	EXPECT_EQ(strings.size(), 6U);
+	for (size_type i = 0U; i < strings.size(); ++i)
+		EXPECT_EQ(strings[i], std::to_string(i < 1U ? 0U : i + 2U));
+}
+
+TEST_F(VectorTest, StaticAllocator)
+{
+	// Arena calls are resolved at compile time
+	typedef nostd::vector<int, nostd::default_growth, nostd::monotonic_arena> ArenaVector;
+	nostd::monotonic_arena arena(1024U);
+	ArenaVector typed(&arena);
+	for (int i = 0; i < 100; ++i)
+		typed.push_back(i);
+	EXPECT_EQ(typed.get_allocator(), &arena);
+	ArenaVector copy(typed);
+	EXPECT_EQ(copy.size(), 100U);
+	EXPECT_EQ(copy[99], 99);
+	EXPECT_EQ(copy.get_allocator(), &arena);
+}
@@ -0,0 +1,95 @@
+#include <nostd/work_stealing_deque.h>
+#include <nostd/test_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+class WorkStealingDequeTest : public testing::Test {
+public:
+	typedef nostd::work_stealing_deque<int> Deque;
+	typedef nostd::test_allocator Allocator;
+
+protected:
+	void SetUp() override
+	{
+		allocator = new Allocator();
+		deque = new Deque(4U, allocator);
+	}
+	void TearDown() override
+	{
+		delete deque;
+		EXPECT_EQ(allocator->count(), 0U);
+		delete allocator;
+	}
+	Allocator * allocator;
+	Deque * deque;
+};
+
+TEST_F(WorkStealingDequeTest, PushPop)
+{
+	int value;
+	EXPECT_EQ(deque->pop(value), false);
+	EXPECT_EQ(deque->steal(value), false);
+	// Buffer grows, old one is retired
+	for (int i = 0; i < 100; ++i)
+		deque->push(i);
+	EXPECT_EQ(deque->size(), 100U);
+	EXPECT_GT(allocator->count(), 1U);
+	EXPECT_EQ(deque->pop(value), true);
+	EXPECT_EQ(value, 99);
+	EXPECT_EQ(deque->steal(value), true);
+	EXPECT_EQ(value, 0);
+	for (int i = 98; i >= 1; --i)
+	{
+		EXPECT_EQ(deque->pop(value), true);
+		EXPECT_EQ(value, i);
+	}
+	EXPECT_EQ(deque->empty(), true);
+	EXPECT_EQ(deque->pop(value), false);
+}
+
+TEST_F(WorkStealingDequeTest, ConcurrentSteal)
+{
+	const int kNumThieves = 3;
+	const int kNumItems = 50000;
+	std::atomic<long long> sum(0);
+	std::atomic<int> taken(0);
+	std::thread thieves[kNumThieves];
+	for (int t = 0; t < kNumThieves; ++t)
+	{
+		thieves[t] = std::thread([this, &sum, &taken]() {
+			int value;
+			while (taken.load() < kNumItems)
+			{
+				if (deque->steal(value))
+				{
+					sum += value;
+					++taken;
+				}
+			}
+		});
+	}
+	// Owner pushes and pops concurrently with thieves
+	for (int i = 1; i <= kNumItems; ++i)
+	{
+		deque->push(i);
+		int value;
+		if (i % 3 == 0 && deque->pop(value))
+		{
+			sum += value;
+			++taken;
+		}
+	}
+	int value;
+	while (deque->pop(value))
+	{
+		sum += value;
+		++taken;
+	}
+	for (int t = 0; t < kNumThieves; ++t)
+		thieves[t].join();
+	EXPECT_EQ(taken.load(), kNumItems);
+	EXPECT_EQ(sum.load(), static_cast<long long>(kNumItems) * (kNumItems + 1) / 2);
+}
@@ -0,0 +1,168 @@
+#include <nostd/thread_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+	/**
+	 * Allocator that throws on request, used to break queue pushes.
+	 */
+	class FailingAllocator final : public nostd::allocator {
+	public:
+		FailingAllocator() noexcept
+		: failing(false)
+		{
+		}
+		ptr_type allocate(size_type size) noexcept(false) final
+		{
+			if (failing.load())
+				throw std::bad_alloc();
+			return std::malloc(size);
+		}
+		void free(ptr_type ptr) noexcept final
+		{
+			std::free(ptr);
+		}
+		using nostd::allocator::free;
+
+		std::atomic<bool> failing;
+	};
+
+} // namespace
+
+class ThreadPoolTest : public testing::Test {
+protected:
+	void SetUp() override
+	{
+		pool = new nostd::thread_pool(4U);
+	}
+	void TearDown() override
+	{
+		delete pool;
+	}
+	nostd::thread_pool * pool;
+};
+
+TEST_F(ThreadPoolTest, Creation)
+{
+	EXPECT_EQ(pool->size(), 4U);
+	nostd::thread_pool hardware;
+	EXPECT_GT(hardware.size(), 0U);
+}
+
+TEST_F(ThreadPoolTest, Submit)
+{
+	std::atomic<int> counter(0);
+	nostd::wait_group group;
+	for (int i = 0; i < 1000; ++i)
+		pool->submit(group, [&counter]() { ++counter; });
+	pool->wait(group);
+	EXPECT_EQ(group.finished(), true);
+	EXPECT_EQ(counter.load(), 1000);
+	// Tasks without group are finished before destruction
+	{
+		nostd::thread_pool other(2U);
+		for (int i = 0; i < 100; ++i)
+			other.submit([&counter]() { ++counter; });
+	}
+	EXPECT_EQ(counter.load(), 1100);
+}
+
+TEST_F(ThreadPoolTest, LargeTask)
+{
+	// Closure larger than pooled task is allocated on the heap
+	struct {
+		char data[nostd::thread_pool::task_size * 2U];
+	} payload;
+	payload.data[0] = 7;
+	std::atomic<int> result(0);
+	nostd::wait_group group;
+	std::string text("long enough string to be allocated on the heap");
+	pool->submit(group, [payload, text, &result]() { result = payload.data[0] + static_cast<int>(text.size()); });
+	group.wait();
+	EXPECT_EQ(result.load(), 53);
+}
+
+TEST_F(ThreadPoolTest, NestedTasks)
+{
+	// Tasks wait for subtasks, waiting workers run pending tasks
+	std::atomic<int> counter(0);
+	nostd::wait_group group;
+	for (int i = 0; i < 16; ++i)
+	{
+		pool->submit(group, [this, &counter]() {
+			nostd::wait_group inner;
+			for (int j = 0; j < 16; ++j)
+				pool->submit(inner, [&counter]() { ++counter; });
+			pool->wait(inner);
+		});
+	}
+	pool->wait(group);
+	EXPECT_EQ(counter.load(), 256);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor)
+{
+	const unsigned kSize = 100000U;
+	unsigned * values = new unsigned[kSize];
+	std::atomic<unsigned> calls(0);
+	std::atomic<bool> grained(true);
+	pool->parallel_for(0U, kSize, 1000U, [values, &calls, &grained](unsigned first, unsigned last) {
+		if (last - first > 1000U)
+			grained = false;
+		for (unsigned i = first; i < last; ++i)
+			values[i] = i * 2U;
+		++calls;
+	});
+	EXPECT_EQ(grained.load(), true);
+	EXPECT_GE(calls.load(), 100U);
+	for (unsigned i = 0; i < kSize; ++i)
+		ASSERT_EQ(values[i], i * 2U);
+	delete[] values;
+	// Nested parallel loops don't deadlock
+	std::atomic<unsigned> sum(0);
+	pool->parallel_for(0U, 8U, 1U, [this, &sum](unsigned, unsigned) {
+		pool->parallel_for(0U, 100U, 10U, [&sum](unsigned first, unsigned last) {
+			sum += last - first;
+		});
+	});
+	EXPECT_EQ(sum.load(), 800U);
+	// Empty range
+	pool->parallel_for(5U, 5U, 1U, [&sum](unsigned, unsigned) { ++sum; });
+	EXPECT_EQ(sum.load(), 800U);
+}
+
+TEST_F(ThreadPoolTest, FailedPushDestroysTask)
+{
+	FailingAllocator allocator;
+	nostd::thread_pool failing_pool(2U, &allocator);
+	allocator.failing = true;
+	std::shared_ptr<int> value = std::make_shared<int>(1);
+	EXPECT_THROW(failing_pool.submit([value]() { ++*value; }), std::bad_alloc);
+	EXPECT_EQ(value.use_count(), 1);
+	// Group is released as well
+	nostd::wait_group group;
+	EXPECT_THROW(failing_pool.submit(group, [value]() { ++*value; }), std::bad_alloc);
+	EXPECT_EQ(value.use_count(), 1);
+	EXPECT_EQ(group.finished(), true);
+	EXPECT_EQ(*value, 1);
+	allocator.failing = false;
+}
+
+TEST_F(ThreadPoolTest, FailedParallelFor)
+{
+	FailingAllocator allocator;
+	nostd::thread_pool failing_pool(2U, &allocator);
+	allocator.failing = true;
+	std::atomic<unsigned> processed(0U);
+	EXPECT_THROW(failing_pool.parallel_for(0U, 100U, 10U, [&processed](unsigned first, unsigned last) {
+		processed += last - first;
+	}), std::bad_alloc);
+	EXPECT_EQ(processed.load(), 0U);
+	allocator.failing = false;
+}